@@ -300,6 +300,11 @@ static duk_ret_t wrapped_compile_execute(duk_context *ctx, void *udata) {
 	duk_push_global_object(ctx);  /* 'this' binding */
 	duk_call_method(ctx, 0);
 
+	/* Run Promise jobs queued by the code (and by the jobs themselves)
+	 * to completion, like an event loop would after each task.
+	 */
+	(void) duk_run_jobs(ctx, -1);
+
 #if defined(DUK_CMDLINE_LOWMEM)
 	lowmem_clear_exec_timeout();
 #endif
@@ -90,6 +90,7 @@ DUK_LOCAL duk_uint8_t *duk__dump_string_prop(duk_hthread *thr, duk_uint8_t *p, d
 	if (tv != NULL && DUK_TVAL_IS_STRING(tv)) {
 		h_str = DUK_TVAL_GET_STRING(tv);
 		DUK_ASSERT(h_str != NULL);
+		h_str = DUK_HSTRING_FLATTEN(thr, h_str);
 	} else {
 		h_str = DUK_HTHREAD_STRING_EMPTY_STRING(thr);
 		DUK_ASSERT(h_str != NULL);
@@ -448,6 +449,8 @@ static duk_uint8_t *duk__load_func(duk_hthread *thr, duk_uint8_t *p, duk_uint8_t
 
 	/* duk_hcompfunc flags; quite version specific */
 	tmp32 = DUK_RAW_READ_U32_BE(p);
+	tmp32 &= ~(DUK_HEAPHDR_FLAG_REACHABLE | DUK_HEAPHDR_FLAG_TEMPROOT);
+	tmp32 |= DUK_HEAPHDR_GET_FLAGS_RAW((duk_heaphdr *) h_fun) & (DUK_HEAPHDR_FLAG_REACHABLE | DUK_HEAPHDR_FLAG_TEMPROOT);  /* keep mark state */
 	DUK_HEAPHDR_SET_FLAGS((duk_heaphdr *) h_fun, tmp32);  /* masks flags to only change duk_hobject flags */
 
 	/* standard prototype (no need to set here, already set) */
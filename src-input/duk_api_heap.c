@@ -143,6 +143,22 @@ DUK_EXTERNAL void duk_resume(duk_hthread *thr, const duk_thread_state *state) {
 	duk_pop_2(thr);
 }
 
+/* Run queued Promise jobs: at most 'max_jobs' jobs, or until the queue is
+ * empty if 'max_jobs' is negative.  Jobs queued by the jobs themselves are
+ * run in the same call if the limit allows.  Returns the number of jobs
+ * still queued.
+ */
+DUK_EXTERNAL duk_int_t duk_run_jobs(duk_hthread *thr, duk_int_t max_jobs) {
+	DUK_ASSERT_API_ENTRY(thr);
+
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	return duk_promise_run_jobs(thr, max_jobs);
+#else
+	DUK_UNREF(max_jobs);
+	return 0;
+#endif
+}
+
 /* XXX: better place for this */
 DUK_EXTERNAL void duk_set_global_object(duk_hthread *thr) {
 	duk_hobject *h_glob;
@@ -227,3 +227,36 @@ DUK_EXTERNAL void duk_inspect_callstack_entry(duk_hthread *thr, duk_int_t level)
 	 * is only asserted for, not checked for.
 	 */
 }
+
+DUK_EXTERNAL void duk_inspect_heap(duk_hthread *thr) {
+	DUK_ASSERT_API_ENTRY(thr);
+
+	duk_push_bare_object(thr);
+
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	{
+		duk_heap *heap = thr->heap;
+
+		duk_push_uint(thr, (duk_uint_t) heap->ms_incr_cycles);
+		duk_put_prop_literal(thr, -2, "gcCycles");
+		duk_push_uint(thr, (duk_uint_t) heap->ms_incr_slices);
+		duk_put_prop_literal(thr, -2, "gcSlices");
+		duk_push_number(thr, heap->ms_incr_pause_last);
+		duk_put_prop_literal(thr, -2, "gcPauseLast");
+		duk_push_number(thr, heap->ms_incr_pause_max);
+		duk_put_prop_literal(thr, -2, "gcPauseMax");
+		duk_push_number(thr, heap->ms_incr_pause_total);
+		duk_put_prop_literal(thr, -2, "gcPauseTotal");
+	}
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	{
+		duk_heap *heap = thr->heap;
+
+		duk_push_uint(thr, (duk_uint_t) heap->ms_minor_cycles);
+		duk_put_prop_literal(thr, -2, "gcMinorCycles");
+		duk_push_uint(thr, (duk_uint_t) heap->ms_minor_freed);
+		duk_put_prop_literal(thr, -2, "gcMinorFreed");
+	}
+#endif
+}
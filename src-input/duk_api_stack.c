@@ -1410,6 +1410,16 @@ DUK_EXTERNAL void duk_xcopymove_raw(duk_hthread *to_thr, duk_hthread *from_thr,
 		}
 	} else {
 		/* No net refcount change. */
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+		/* 'from_thr' may not have been scanned by an incremental
+		 * mark-and-sweep yet, so moved values need a write barrier.
+		 */
+		q = to_thr->valstack_top;
+		while (p < q) {
+			DUK_TVAL_MS_INCR_BARRIER(to_thr->heap, p);
+			p++;
+		}
+#endif
 		p = from_thr->valstack_top;
 		q = (duk_tval *) (void *) (((duk_uint8_t *) p) - nbytes);
 		from_thr->valstack_top = q;
@@ -2081,9 +2091,24 @@ DUK_LOCAL duk_heaphdr *duk__get_tagged_heaphdr_raw(duk_hthread *thr, duk_idx_t i
 
 }
 
+/* Get a string from the value stack, flattening a rope so that callers see
+ * an ordinary interned string.  The result stays reachable through the rope.
+ */
+DUK_LOCAL duk_hstring *duk__get_hstring_raw(duk_hthread *thr, duk_idx_t idx) {
+	duk_hstring *h;
+
+	h = (duk_hstring *) duk__get_tagged_heaphdr_raw(thr, idx, DUK_TAG_STRING);
+#if defined(DUK_USE_HSTRING_ROPES)
+	if (h != NULL) {
+		h = DUK_HSTRING_FLATTEN(thr, h);
+	}
+#endif
+	return h;
+}
+
 DUK_INTERNAL duk_hstring *duk_get_hstring(duk_hthread *thr, duk_idx_t idx) {
 	DUK_ASSERT_API_ENTRY(thr);
-	return (duk_hstring *) duk__get_tagged_heaphdr_raw(thr, idx, DUK_TAG_STRING);
+	return duk__get_hstring_raw(thr, idx);
 }
 
 DUK_INTERNAL duk_hstring *duk_get_hstring_notsymbol(duk_hthread *thr, duk_idx_t idx) {
@@ -2091,7 +2116,7 @@ DUK_INTERNAL duk_hstring *duk_get_hstring_notsymbol(duk_hthread *thr, duk_idx_t
 
 	DUK_ASSERT_API_ENTRY(thr);
 
-	h = (duk_hstring *) duk__get_tagged_heaphdr_raw(thr, idx, DUK_TAG_STRING);
+	h = duk__get_hstring_raw(thr, idx);
 	if (DUK_UNLIKELY(h && DUK_HSTRING_HAS_SYMBOL(h))) {
 		return NULL;
 	}
@@ -2103,7 +2128,7 @@ DUK_INTERNAL duk_hstring *duk_require_hstring(duk_hthread *thr, duk_idx_t idx) {
 
 	DUK_ASSERT_API_ENTRY(thr);
 
-	h = (duk_hstring *) duk__get_tagged_heaphdr_raw(thr, idx, DUK_TAG_STRING);
+	h = duk__get_hstring_raw(thr, idx);
 	if (DUK_UNLIKELY(h == NULL)) {
 		DUK_ERROR_REQUIRE_TYPE_INDEX(thr, idx, "string", DUK_STR_NOT_STRING);
 		DUK_WO_NORETURN(return NULL;);
@@ -2116,7 +2141,7 @@ DUK_INTERNAL duk_hstring *duk_require_hstring_notsymbol(duk_hthread *thr, duk_id
 
 	DUK_ASSERT_API_ENTRY(thr);
 
-	h = (duk_hstring *) duk__get_tagged_heaphdr_raw(thr, idx, DUK_TAG_STRING);
+	h = duk__get_hstring_raw(thr, idx);
 	if (DUK_UNLIKELY(h == NULL || DUK_HSTRING_HAS_SYMBOL(h))) {
 		DUK_ERROR_REQUIRE_TYPE_INDEX(thr, idx, "string", DUK_STR_NOT_STRING);
 		DUK_WO_NORETURN(return NULL;);
@@ -2363,6 +2388,12 @@ DUK_EXTERNAL void *duk_get_heapptr(duk_hthread *thr, duk_idx_t idx) {
 
 	ret = (void *) DUK_TVAL_GET_HEAPHDR(tv);
 	DUK_ASSERT(ret != NULL);
+#if defined(DUK_USE_HSTRING_ROPES)
+	if (DUK_TVAL_IS_STRING(tv)) {
+		/* Ropes are internal, expose the flattened string. */
+		ret = (void *) DUK_HSTRING_FLATTEN(thr, (duk_hstring *) ret);
+	}
+#endif
 	return ret;
 }
 
@@ -2403,6 +2434,12 @@ DUK_EXTERNAL void *duk_require_heapptr(duk_hthread *thr, duk_idx_t idx) {
 
 	ret = (void *) DUK_TVAL_GET_HEAPHDR(tv);
 	DUK_ASSERT(ret != NULL);
+#if defined(DUK_USE_HSTRING_ROPES)
+	if (DUK_TVAL_IS_STRING(tv)) {
+		/* Ropes are internal, expose the flattened string. */
+		ret = (void *) DUK_HSTRING_FLATTEN(thr, (duk_hstring *) ret);
+	}
+#endif
 	return ret;
 }
 
@@ -2601,9 +2638,12 @@ DUK_LOCAL duk_heaphdr *duk__known_heaphdr(duk_hthread *thr, duk_idx_t idx) {
 }
 
 DUK_INTERNAL duk_hstring *duk_known_hstring(duk_hthread *thr, duk_idx_t idx) {
+	duk_hstring *h;
+
 	DUK_ASSERT_API_ENTRY(thr);
 	DUK_ASSERT(duk_get_hstring(thr, idx) != NULL);
-	return (duk_hstring *) duk__known_heaphdr(thr, idx);
+	h = (duk_hstring *) duk__known_heaphdr(thr, idx);
+	return DUK_HSTRING_FLATTEN(thr, h);
 }
 
 DUK_INTERNAL duk_hobject *duk_known_hobject(duk_hthread *thr, duk_idx_t idx) {
@@ -3420,6 +3460,12 @@ DUK_EXTERNAL const char *duk_to_string(duk_hthread *thr, duk_idx_t idx) {
 		if (DUK_UNLIKELY(DUK_HSTRING_HAS_SYMBOL(h))) {
 			DUK_ERROR_TYPE(thr, DUK_STR_CANNOT_STRING_COERCE_SYMBOL);
 			DUK_WO_NORETURN(goto skip_replace;);
+#if defined(DUK_USE_HSTRING_ROPES)
+		} else if (DUK_HSTRING_IS_ROPE(h)) {
+			/* Coercion result is the flattened string. */
+			duk_push_hstring(thr, duk_hstring_rope_flatten(thr, h));
+			break;
+#endif
 		} else {
 			goto skip_replace;
 		}
@@ -3720,6 +3766,10 @@ DUK_EXTERNAL void duk_to_object(duk_hthread *thr, duk_idx_t idx) {
 			        DUK_HOBJECT_FLAG_EXOTIC_STRINGOBJ |
 			        DUK_HOBJECT_CLASS_AS_FLAGS(DUK_HOBJECT_CLASS_STRING);
 			proto = DUK_BIDX_STRING_PROTOTYPE;
+#if defined(DUK_USE_HSTRING_ROPES)
+			/* String object internal value is never a rope. */
+			duk_to_string(thr, idx);
+#endif
 		}
 		goto create_object;
 	}
@@ -5810,6 +5860,9 @@ DUK_EXTERNAL duk_idx_t duk_push_heapptr(duk_hthread *thr, void *ptr) {
 #endif
 		DUK_HEAP_REMOVE_FROM_FINALIZE_LIST(thr->heap, curr);
 		DUK_HEAP_INSERT_INTO_HEAP_ALLOCATED(thr->heap, curr);
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+		duk_heap_ms_incr_requeue(thr->heap, curr);
+#endif
 
 		/* Continue with the rest. */
 	}
@@ -6706,6 +6759,7 @@ DUK_LOCAL const char *duk__push_string_tval_readable(duk_hthread *thr, duk_tval
 		switch (DUK_TVAL_GET_TAG(tv)) {
 		case DUK_TAG_STRING: {
 			duk_hstring *h = DUK_TVAL_GET_STRING(tv);
+			h = DUK_HSTRING_FLATTEN(thr, h);
 			if (DUK_HSTRING_HAS_SYMBOL(h)) {
 				/* XXX: string summary produces question marks
 				 * so this is not very ideal.
@@ -6740,7 +6794,7 @@ DUK_LOCAL const char *duk__push_string_tval_readable(duk_hthread *thr, duk_tval
 					/* It's critical to avoid recursion so
 					 * only summarize a string .message.
 					 */
-					duk__push_hstring_readable_unicode(thr, DUK_TVAL_GET_STRING(tv_msg), DUK__READABLE_ERRMSG_MAXCHARS);
+					duk__push_hstring_readable_unicode(thr, DUK_HSTRING_FLATTEN(thr, DUK_TVAL_GET_STRING(tv_msg)), DUK__READABLE_ERRMSG_MAXCHARS);
 					break;
 				}
 			}
@@ -476,6 +476,7 @@ DUK_LOCAL duk_ret_t duk__array_pop_fastpath(duk_hthread *thr, duk_harray *h_arr)
 		DUK_ASSERT(DUK_TVAL_IS_UNUSED(tv_val));
 	} else {
 		/* No net refcount change. */
+		DUK_TVAL_MS_INCR_BARRIER(thr->heap, tv_val);
 		DUK_TVAL_SET_TVAL(thr->valstack_top, tv_val);
 		DUK_TVAL_SET_UNUSED(tv_val);
 	}
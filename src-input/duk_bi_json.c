@@ -2163,7 +2163,7 @@ DUK_LOCAL duk_bool_t duk__enc_value(duk_json_enc_ctx *js_ctx, duk_idx_t idx_hold
 		if (DUK_UNLIKELY(DUK_HSTRING_HAS_SYMBOL(h))) {
 			goto pop2_undef;
 		}
-		duk__enc_quote_string(js_ctx, h);
+		duk__enc_quote_string(js_ctx, DUK_HSTRING_FLATTEN(thr, h));
 		break;
 	}
 	case DUK_TAG_OBJECT: {
@@ -2329,7 +2329,7 @@ DUK_LOCAL duk_bool_t duk__json_stringify_fast_value(duk_json_enc_ctx *js_ctx, du
 		if (DUK_UNLIKELY(DUK_HSTRING_HAS_SYMBOL(h))) {
 			goto emit_undefined;
 		}
-		duk__enc_quote_string(js_ctx, h);
+		duk__enc_quote_string(js_ctx, DUK_HSTRING_FLATTEN(js_ctx->thr, h));
 		break;
 	}
 	case DUK_TAG_OBJECT: {
@@ -0,0 +1,686 @@
+/*
+ *  Map, Set, WeakMap, and WeakSet built-ins (ES2015 Sections 23.1-23.4).
+ *
+ *  All variants are backed by a duk_hmapset, see duk_hmapset.h for the
+ *  table layout.  The 'magic' of each native is the DUK_HMAPSET_KIND_xxx
+ *  of the constructor or prototype it belongs to.
+ *
+ *  Differences to ES2015:
+ *
+ *    - Iterators (keys(), values(), entries(), @@iterator) are not
+ *      provided; iteration happens through forEach().
+ *
+ *    - Constructors accept array-like values and Map/Set instances
+ *      instead of arbitrary iterables.
+ *
+ *    - No @@species.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+
+#define DUK__MAPSET_NOT_FOUND       0xffffffffUL
+
+/* Minimum growth step for the entry part, in entries. */
+#define DUK__MAPSET_MIN_GROW        8
+
+/* Limit for the entry part size so that allocation size computations
+ * can't wrap.
+ */
+#define DUK__MAPSET_MAX_SIZE        0x10000000UL
+
+DUK_LOCAL const duk_uint8_t duk__mapset_proto_bidx[4] = {
+	DUK_BIDX_MAP_PROTOTYPE,
+	DUK_BIDX_SET_PROTOTYPE,
+	DUK_BIDX_WEAKMAP_PROTOTYPE,
+	DUK_BIDX_WEAKSET_PROTOTYPE
+};
+
+/*
+ *  Helpers
+ */
+
+/* Hash a key so that keys equal under SameValueZero get the same hash.
+ * Strings use their string table hash, other heap values and pointers
+ * their address.
+ */
+DUK_LOCAL duk_uint32_t duk__mapset_hash(duk_tval *tv) {
+	duk_uint32_t res;
+
+	if (DUK_TVAL_IS_NUMBER(tv)) {
+		duk_double_union du;
+
+		du.d = DUK_TVAL_GET_NUMBER(tv);
+		if (du.d == 0.0) {
+			du.d = 0.0;  /* -0 and +0 are equal */
+		} else if (DUK_ISNAN(du.d)) {
+			DUK_DBLUNION_SET_NAN(&du);
+		}
+		res = du.ui[DUK_DBL_IDX_UI0] ^ du.ui[DUK_DBL_IDX_UI1];
+	} else if (DUK_TVAL_IS_STRING(tv)) {
+		res = (duk_uint32_t) DUK_HSTRING_GET_HASH(DUK_TVAL_GET_STRING(tv));
+	} else if (DUK_TVAL_IS_HEAP_ALLOCATED(tv)) {
+		res = (duk_uint32_t) (((duk_uintptr_t) DUK_TVAL_GET_HEAPHDR(tv)) >> 3);
+	} else if (DUK_TVAL_IS_POINTER(tv)) {
+		res = (duk_uint32_t) (duk_uintptr_t) DUK_TVAL_GET_POINTER(tv);
+	} else if (DUK_TVAL_IS_BOOLEAN(tv)) {
+		res = 0x100UL + (duk_uint32_t) DUK_TVAL_GET_BOOLEAN(tv);
+	} else if (DUK_TVAL_IS_LIGHTFUNC(tv)) {
+		/* Function pointers can't be portably cast to integers. */
+		res = 0x200UL + (duk_uint32_t) DUK_TVAL_GET_LIGHTFUNC_FLAGS(tv);
+	} else {
+		res = (duk_uint32_t) DUK_TVAL_GET_TAG(tv);
+	}
+
+	/* Final mix so that the low bits used for the hash index depend on
+	 * all input bits (pointers are aligned, doubles vary in high bits).
+	 */
+	res ^= res >> 16;
+	res *= 0x85ebca6bUL;
+	res ^= res >> 13;
+	res *= 0xc2b2ae35UL;
+	res ^= res >> 16;
+	return res;
+}
+
+/* SameValueZero comparison. */
+DUK_LOCAL duk_bool_t duk__mapset_key_equals(duk_tval *tv_x, duk_tval *tv_y) {
+	if (DUK_TVAL_IS_NUMBER(tv_x)) {
+		duk_double_t d1, d2;
+
+		if (!DUK_TVAL_IS_NUMBER(tv_y)) {
+			return 0;
+		}
+		d1 = DUK_TVAL_GET_NUMBER(tv_x);
+		d2 = DUK_TVAL_GET_NUMBER(tv_y);
+		return (d1 == d2 || (DUK_ISNAN(d1) && DUK_ISNAN(d2)));
+	}
+	if (DUK_TVAL_IS_HEAP_ALLOCATED(tv_x)) {
+		/* Strings are interned so pointer comparison suffices. */
+		return (DUK_TVAL_IS_HEAP_ALLOCATED(tv_y) &&
+		        DUK_TVAL_GET_HEAPHDR(tv_x) == DUK_TVAL_GET_HEAPHDR(tv_y));
+	}
+	return duk_js_samevalue(tv_x, tv_y);
+}
+
+#if defined(DUK_USE_HSTRING_ROPES)
+/* Keys are compared by interned string identity so a rope key is replaced
+ * with its flattened string, which the rope keeps reachable.
+ */
+DUK_LOCAL void duk__mapset_flatten_key(duk_hthread *thr, duk_tval *tv_key) {
+	if (DUK_TVAL_IS_STRING(tv_key)) {
+		duk_hstring *h;
+
+		h = DUK_TVAL_GET_STRING(tv_key);
+		DUK_TVAL_SET_STRING(tv_key, DUK_HSTRING_FLATTEN(thr, h));
+	}
+}
+#endif
+
+/* Find the entry index of a key, DUK__MAPSET_NOT_FOUND if missing. */
+DUK_LOCAL duk_uint32_t duk__mapset_find(duk_hmapset *m, duk_tval *tv_key, duk_uint32_t hash) {
+	duk_uint32_t *h_base;
+	duk_uint32_t mask;
+	duk_uint32_t i;
+
+	if (m->h_size == 0) {
+		return DUK__MAPSET_NOT_FOUND;
+	}
+
+	h_base = DUK_HMAPSET_GET_HASH(m);
+	mask = m->h_size - 1;
+	i = hash & mask;
+	for (;;) {
+		duk_uint32_t t;
+		duk_tval *tv;
+
+		/* The hash part is at most half full so there's always an
+		 * unused slot terminating the probe sequence.
+		 */
+		t = h_base[i];
+		if (t == DUK_HMAPSET_HASH_UNUSED) {
+			return DUK__MAPSET_NOT_FOUND;
+		}
+		DUK_ASSERT(t - 1 < m->e_used);
+		tv = DUK_HMAPSET_GET_KEY_PTR(m, t - 1);
+		if (!DUK_TVAL_IS_UNUSED(tv) && duk__mapset_key_equals(tv, tv_key)) {
+			return t - 1;
+		}
+		i = (i + 1) & mask;
+	}
+	DUK_UNREACHABLE();
+}
+
+DUK_LOCAL void duk__mapset_hash_insert(duk_hmapset *m, duk_uint32_t hash, duk_uint32_t idx) {
+	duk_uint32_t *h_base;
+	duk_uint32_t mask;
+	duk_uint32_t i;
+
+	DUK_ASSERT(m->h_size > 0);
+	h_base = DUK_HMAPSET_GET_HASH(m);
+	mask = m->h_size - 1;
+	i = hash & mask;
+	while (h_base[i] != DUK_HMAPSET_HASH_UNUSED) {
+		i = (i + 1) & mask;
+	}
+	h_base[i] = idx + 1;
+}
+
+/* Reallocate the entry and hash parts.  Deleted entries are dropped unless
+ * a forEach() loop is active, in which case entry indices must be kept.
+ * Entry values are moved as is so there are no refcount changes.
+ */
+DUK_LOCAL void duk__mapset_resize(duk_hthread *thr, duk_hmapset *m, duk_uint32_t new_e_size) {
+	duk_small_uint_t stride;
+	duk_uint32_t new_h_size;
+	duk_size_t alloc_size;
+	duk_tval *new_entries;
+	duk_uint32_t i;
+	duk_uint32_t j;
+
+	DUK_ASSERT_HMAPSET_VALID(m);
+
+	if (new_e_size > DUK__MAPSET_MAX_SIZE) {
+		DUK_ERROR_RANGE_INVALID_COUNT(thr);
+		DUK_WO_NORETURN(return;);
+	}
+
+	stride = DUK_HMAPSET_GET_STRIDE(m);
+	new_h_size = 0;
+	if (new_e_size > 0) {
+		new_h_size = 8;
+		while (new_h_size < 2 * new_e_size) {
+			new_h_size <<= 1;
+		}
+	}
+	alloc_size = (duk_size_t) new_e_size * stride * sizeof(duk_tval) +
+	             (duk_size_t) new_h_size * sizeof(duk_uint32_t);
+
+	DUK_DD(DUK_DDPRINT("resize mapset %p: e_size %ld -> %ld, h_size %ld -> %ld, count %ld, e_used %ld",
+	                   (void *) m, (long) m->e_size, (long) new_e_size, (long) m->h_size,
+	                   (long) new_h_size, (long) m->count, (long) m->e_used));
+
+	/* Allocation may trigger a mark-and-sweep which may drop weak
+	 * entries but won't otherwise change the table.  Prevent finalizers
+	 * from running and modifying the table in the middle of the copy.
+	 */
+	new_entries = NULL;
+	if (alloc_size > 0) {
+		thr->heap->pf_prevent_count++;
+		new_entries = (duk_tval *) DUK_ALLOC(thr->heap, alloc_size);
+		DUK_ASSERT(thr->heap->pf_prevent_count > 0);
+		thr->heap->pf_prevent_count--;
+		if (DUK_UNLIKELY(new_entries == NULL)) {
+			DUK_ERROR_ALLOC_FAILED(thr);
+			DUK_WO_NORETURN(return;);
+		}
+	}
+
+	DUK_ASSERT(new_e_size >= (m->iter_count > 0 ? m->e_used : m->count));
+	for (i = 0, j = 0; i < m->e_used; i++) {
+		duk_tval *tv_src;
+
+		tv_src = DUK_HMAPSET_GET_KEY_PTR(m, i);
+		if (DUK_TVAL_IS_UNUSED(tv_src) && m->iter_count == 0) {
+			continue;
+		}
+		DUK_ASSERT(new_entries != NULL);
+		duk_memcpy((void *) (new_entries + (duk_size_t) j * stride),
+		           (const void *) tv_src,
+		           sizeof(duk_tval) * stride);
+		j++;
+	}
+
+	DUK_FREE(thr->heap, m->entries);
+	m->entries = new_entries;
+	m->e_size = new_e_size;
+	m->e_used = j;
+	m->h_size = new_h_size;
+
+	if (new_h_size > 0) {
+		duk_memzero((void *) DUK_HMAPSET_GET_HASH(m), sizeof(duk_uint32_t) * new_h_size);
+		for (i = 0; i < j; i++) {
+			duk_tval *tv_key;
+
+			tv_key = DUK_HMAPSET_GET_KEY_PTR(m, i);
+			if (!DUK_TVAL_IS_UNUSED(tv_key)) {
+				duk__mapset_hash_insert(m, duk__mapset_hash(tv_key), i);
+			}
+		}
+	}
+
+	DUK_ASSERT_HMAPSET_VALID(m);
+}
+
+/* Add or update an entry.  'tv_value_in' is ignored for sets.  The key
+ * and value must be reachable through the value stack; they're copied
+ * because a resize may have side effects.
+ */
+DUK_LOCAL void duk__mapset_put(duk_hthread *thr, duk_hmapset *m, duk_tval *tv_key_in, duk_tval *tv_value_in) {
+	duk_tval tv_key;
+	duk_tval tv_value;
+	duk_tval *tv;
+	duk_uint32_t hash;
+	duk_uint32_t idx;
+
+	DUK_ASSERT_HMAPSET_VALID(m);
+
+	if (DUK_HMAPSET_IS_WEAK(m) && !DUK_TVAL_IS_OBJECT(tv_key_in)) {
+		DUK_ERROR_TYPE(thr, DUK_STR_NOT_OBJECT);
+		DUK_WO_NORETURN(return;);
+	}
+
+	DUK_TVAL_SET_TVAL(&tv_key, tv_key_in);
+	DUK_TVAL_SET_TVAL(&tv_value, tv_value_in);
+	if (DUK_TVAL_IS_NUMBER(&tv_key) && DUK_TVAL_GET_NUMBER(&tv_key) == 0.0) {
+		DUK_TVAL_SET_NUMBER(&tv_key, 0.0);  /* normalize -0 */
+	}
+#if defined(DUK_USE_HSTRING_ROPES)
+	duk__mapset_flatten_key(thr, &tv_key);
+#endif
+	hash = duk__mapset_hash(&tv_key);
+
+	idx = duk__mapset_find(m, &tv_key, hash);
+	if (idx != DUK__MAPSET_NOT_FOUND) {
+		if (DUK_HMAPSET_HAS_VALUES(m)) {
+			tv = DUK_HMAPSET_GET_KEY_PTR(m, idx) + 1;
+			DUK_TVAL_SET_TVAL_UPDREF(thr, tv, &tv_value);  /* side effects */
+		}
+		return;
+	}
+
+	if (m->e_used >= m->e_size) {
+		duk_uint32_t base;
+
+		base = (m->iter_count > 0 ? m->e_used : m->count);
+		duk__mapset_resize(thr, m, base + base / 2 + DUK__MAPSET_MIN_GROW);
+	}
+	DUK_ASSERT(m->e_used < m->e_size);
+
+	idx = m->e_used++;
+	tv = DUK_HMAPSET_GET_KEY_PTR(m, idx);
+	DUK_TVAL_SET_TVAL(tv, &tv_key);
+	DUK_TVAL_INCREF(thr, tv);
+	if (DUK_HMAPSET_HAS_VALUES(m)) {
+		DUK_TVAL_SET_TVAL(tv + 1, &tv_value);
+		DUK_TVAL_INCREF(thr, tv + 1);
+	}
+	duk__mapset_hash_insert(m, hash, idx);
+	m->count++;
+
+	DUK_ASSERT_HMAPSET_VALID(m);
+}
+
+DUK_LOCAL duk_uint32_t duk__mapset_lookup(duk_hthread *thr, duk_hmapset *m, duk_tval *tv_key_in) {
+	duk_tval tv_key;
+
+	DUK_UNREF(thr);
+
+	if (DUK_HMAPSET_IS_WEAK(m) && !DUK_TVAL_IS_OBJECT(tv_key_in)) {
+		return DUK__MAPSET_NOT_FOUND;
+	}
+	DUK_TVAL_SET_TVAL(&tv_key, tv_key_in);
+#if defined(DUK_USE_HSTRING_ROPES)
+	duk__mapset_flatten_key(thr, &tv_key);
+#endif
+	return duk__mapset_find(m, &tv_key, duk__mapset_hash(&tv_key));
+}
+
+/* Push a new empty table of given kind. */
+DUK_LOCAL duk_hmapset *duk__push_hmapset(duk_hthread *thr, duk_small_uint_t kind) {
+	duk_hmapset *res;
+
+	DUK_ASSERT(kind <= DUK_HMAPSET_KIND_WEAKSET);
+
+	/* Reserve space first so that the push below can't trigger a GC
+	 * while the new object is unreachable.
+	 */
+	duk_require_stack(thr, 1);
+	res = duk_hmapset_alloc(thr,
+	                        DUK_HOBJECT_FLAG_EXTENSIBLE |
+	                        DUK_HOBJECT_CLASS_AS_FLAGS(DUK_HOBJECT_CLASS_MAPSET));
+	DUK_ASSERT(res != NULL);
+	res->kind = kind;
+	duk_push_hobject(thr, (duk_hobject *) res);
+	DUK_HOBJECT_SET_PROTOTYPE_INIT_INCREF(thr, (duk_hobject *) res, thr->builtins[duk__mapset_proto_bidx[kind]]);
+	DUK_ASSERT_HMAPSET_VALID(res);
+	return res;
+}
+
+DUK_LOCAL duk_hmapset *duk__get_hmapset(duk_hthread *thr, duk_idx_t idx) {
+	duk_hobject *h;
+
+	h = duk_get_hobject(thr, idx);
+	if (h != NULL && DUK_HOBJECT_IS_MAPSET(h)) {
+		DUK_ASSERT_HMAPSET_VALID((duk_hmapset *) h);
+		return (duk_hmapset *) h;
+	}
+	return NULL;
+}
+
+/* Require 'this' to be a table of the kind given by the current magic. */
+DUK_LOCAL duk_hmapset *duk__require_hmapset_this(duk_hthread *thr) {
+	duk_tval *tv;
+	duk_hobject *h;
+
+	tv = DUK_HTHREAD_THIS_PTR(thr);
+	if (DUK_TVAL_IS_OBJECT(tv)) {
+		h = DUK_TVAL_GET_OBJECT(tv);
+		DUK_ASSERT(h != NULL);
+		if (DUK_HOBJECT_IS_MAPSET(h) &&
+		    ((duk_hmapset *) h)->kind == (duk_small_uint_t) duk_get_current_magic(thr)) {
+			DUK_ASSERT_HMAPSET_VALID((duk_hmapset *) h);
+			return (duk_hmapset *) h;
+		}
+	}
+
+	DUK_ERROR_TYPE(thr, DUK_STR_UNEXPECTED_TYPE);
+	DUK_WO_NORETURN(return NULL;);
+}
+
+/* Push an array of the items a Map or Set would produce when iterated:
+ * [ key, value ] pairs for maps and values for sets.
+ */
+DUK_LOCAL void duk__mapset_push_items(duk_hthread *thr, duk_hmapset *m) {
+	duk_uint32_t i;
+	duk_uarridx_t n = 0;
+
+	duk_push_array(thr);
+	for (i = 0; i < m->e_used; i++) {
+		duk_tval *tv;
+
+		/* Re-lookup on every round, side effects may resize.  Copy
+		 * the entry to the value stack before allocating anything.
+		 */
+		tv = DUK_HMAPSET_GET_KEY_PTR(m, i);
+		if (DUK_TVAL_IS_UNUSED(tv)) {
+			continue;
+		}
+		if (DUK_HMAPSET_HAS_VALUES(m)) {
+			duk_push_tval(thr, tv);
+			duk_push_tval(thr, tv + 1);
+			duk_push_array(thr);
+			duk_insert(thr, -3);
+			duk_put_prop_index(thr, -3, 1);
+			duk_put_prop_index(thr, -2, 0);
+		} else {
+			duk_push_tval(thr, tv);
+		}
+		duk_put_prop_index(thr, -2, n++);
+	}
+}
+
+/*
+ *  Constructors
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_mapset_constructor(duk_hthread *thr) {
+	duk_small_uint_t kind;
+	duk_hmapset *m;
+	duk_hmapset *m_src;
+	duk_hobject *h_adder;
+	duk_bool_t fast;
+	duk_uarridx_t i;
+	duk_uarridx_t len;
+
+	duk_require_constructor_call(thr);
+
+	kind = (duk_small_uint_t) duk_get_current_magic(thr);
+	m = duk__push_hmapset(thr, kind);
+	if (duk_is_null_or_undefined(thr, 0)) {
+		return 1;
+	}
+
+	/* [ init map ] */
+
+	(void) duk_get_prop_stridx_short(thr, 1, DUK_HMAPSET_HAS_VALUES(m) ? DUK_STRIDX_SET : DUK_STRIDX_ADD);
+	duk_require_callable(thr, 2);
+	h_adder = duk_get_hobject(thr, 2);
+	fast = (h_adder != NULL && DUK_HOBJECT_IS_NATFUNC(h_adder) &&
+	        ((duk_hnatfunc *) h_adder)->func == duk_bi_mapset_prototype_set &&
+	        ((duk_hnatfunc *) h_adder)->magic == (duk_int16_t) kind);
+
+	/* [ init map adder ] */
+
+	m_src = duk__get_hmapset(thr, 0);
+	if (m_src != NULL && !DUK_HMAPSET_IS_WEAK(m_src)) {
+		if (fast && DUK_HMAPSET_HAS_VALUES(m_src) == DUK_HMAPSET_HAS_VALUES(m)) {
+			/* Copy entries directly.  Values may be updated with
+			 * side effects (a weak target rejecting a key throws)
+			 * so re-lookup entries on every round.
+			 */
+			for (i = 0; i < m_src->e_used; i++) {
+				duk_tval *tv;
+
+				tv = DUK_HMAPSET_GET_KEY_PTR(m_src, i);
+				if (DUK_TVAL_IS_UNUSED(tv)) {
+					continue;
+				}
+				duk_push_tval(thr, tv);
+				if (DUK_HMAPSET_HAS_VALUES(m)) {
+					duk_push_tval(thr, tv + 1);
+				} else {
+					duk_push_undefined(thr);
+				}
+				duk__mapset_put(thr, m, DUK_GET_TVAL_NEGIDX(thr, -2), DUK_GET_TVAL_NEGIDX(thr, -1));
+				duk_pop_2(thr);
+			}
+			duk_set_top(thr, 2);
+			return 1;
+		}
+		duk__mapset_push_items(thr, m_src);
+		duk_replace(thr, 0);
+	} else if (!duk_is_object(thr, 0) && !duk_is_string(thr, 0)) {
+		DUK_DCERROR_TYPE_INVALID_ARGS(thr);
+	}
+
+	/* Array-like: [ init map adder ] */
+
+	len = (duk_uarridx_t) duk_get_length(thr, 0);
+	for (i = 0; i < len; i++) {
+		(void) duk_get_prop_index(thr, 0, i);
+		if (DUK_HMAPSET_HAS_VALUES(m)) {
+			/* [ init map adder item ] */
+			if (!duk_is_object(thr, 3)) {
+				DUK_DCERROR_TYPE_INVALID_ARGS(thr);
+			}
+			(void) duk_get_prop_index(thr, 3, 0);
+			(void) duk_get_prop_index(thr, 3, 1);
+		} else {
+			duk_push_undefined(thr);
+		}
+
+		/* [ init map adder item key value ] */
+		if (fast) {
+			duk__mapset_put(thr, m, DUK_GET_TVAL_NEGIDX(thr, -2), DUK_GET_TVAL_NEGIDX(thr, -1));
+		} else {
+			duk_dup(thr, 2);
+			duk_dup(thr, 1);
+			if (DUK_HMAPSET_HAS_VALUES(m)) {
+				duk_dup(thr, -4);
+				duk_dup(thr, -4);
+				duk_call_method(thr, 2);
+			} else {
+				duk_dup(thr, -4);
+				duk_call_method(thr, 1);
+			}
+			duk_pop(thr);
+		}
+		duk_set_top(thr, 3);
+	}
+
+	duk_set_top(thr, 2);
+	return 1;
+}
+
+/*
+ *  Prototype methods
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_mapset_prototype_get(duk_hthread *thr) {
+	duk_hmapset *m;
+	duk_uint32_t idx;
+
+	m = duk__require_hmapset_this(thr);
+	DUK_ASSERT(DUK_HMAPSET_HAS_VALUES(m));
+
+	idx = duk__mapset_lookup(thr, m, duk_require_tval(thr, 0));
+	if (idx == DUK__MAPSET_NOT_FOUND) {
+		return 0;
+	}
+	duk_push_tval(thr, DUK_HMAPSET_GET_KEY_PTR(m, idx) + 1);
+	return 1;
+}
+
+/* Map.prototype.set() and Set.prototype.add(), value is ignored for sets. */
+DUK_INTERNAL duk_ret_t duk_bi_mapset_prototype_set(duk_hthread *thr) {
+	duk_hmapset *m;
+
+	m = duk__require_hmapset_this(thr);
+	duk__mapset_put(thr, m, duk_require_tval(thr, 0), duk_require_tval(thr, 1));
+	duk_push_this(thr);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_mapset_prototype_has(duk_hthread *thr) {
+	duk_hmapset *m;
+
+	m = duk__require_hmapset_this(thr);
+	duk_push_boolean(thr, duk__mapset_lookup(thr, m, duk_require_tval(thr, 0)) != DUK__MAPSET_NOT_FOUND);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_mapset_prototype_delete(duk_hthread *thr) {
+	duk_hmapset *m;
+	duk_uint32_t idx;
+	duk_tval *tv;
+
+	m = duk__require_hmapset_this(thr);
+	idx = duk__mapset_lookup(thr, m, duk_require_tval(thr, 0));
+	if (idx == DUK__MAPSET_NOT_FOUND) {
+		duk_push_false(thr);
+		return 1;
+	}
+
+	/* The hash slot keeps pointing to the deleted entry until the next
+	 * resize.  Finalizers may only run once the table is consistent.
+	 */
+	tv = DUK_HMAPSET_GET_KEY_PTR(m, idx);
+	DUK_TVAL_DECREF_NORZ(thr, tv);
+	DUK_TVAL_SET_UNUSED(tv);
+	if (DUK_HMAPSET_HAS_VALUES(m)) {
+		DUK_TVAL_DECREF_NORZ(thr, tv + 1);
+		DUK_TVAL_SET_UNDEFINED(tv + 1);
+	}
+	DUK_ASSERT(m->count > 0);
+	m->count--;
+	DUK_REFZERO_CHECK_SLOW(thr);
+
+	/* Give memory back once the table is mostly deleted entries. */
+	if (m->iter_count == 0 && m->e_size > 4 * DUK__MAPSET_MIN_GROW && m->count < m->e_size / 4) {
+		duk__mapset_resize(thr, m, m->count + m->count / 2 + DUK__MAPSET_MIN_GROW);
+	}
+
+	duk_push_true(thr);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_mapset_prototype_clear(duk_hthread *thr) {
+	duk_hmapset *m;
+	duk_tval *tv;
+	duk_uint32_t i;
+	duk_uint32_t n;
+
+	m = duk__require_hmapset_this(thr);
+
+	n = m->e_used * DUK_HMAPSET_GET_STRIDE(m);
+	if (m->iter_count > 0) {
+		/* Keep indices stable for active loops: mark all entries
+		 * deleted, new entries are appended after them.
+		 */
+		for (i = 0, tv = m->entries; i < n; i++, tv++) {
+			DUK_TVAL_DECREF_NORZ(thr, tv);
+			DUK_TVAL_SET_UNDEFINED(tv);
+		}
+		for (i = 0, tv = m->entries; i < m->e_used; i++, tv += DUK_HMAPSET_GET_STRIDE(m)) {
+			DUK_TVAL_SET_UNUSED(tv);
+		}
+		m->count = 0;
+	} else {
+		tv = m->entries;
+		m->entries = NULL;
+		m->e_size = 0;
+		m->e_used = 0;
+		m->count = 0;
+		m->h_size = 0;
+		DUK_ASSERT_HMAPSET_VALID(m);
+		for (i = 0; i < n; i++) {
+			DUK_TVAL_DECREF_NORZ(thr, tv + i);
+		}
+		DUK_FREE(thr->heap, tv);
+	}
+	DUK_REFZERO_CHECK_SLOW(thr);
+
+	return 0;
+}
+
+DUK_LOCAL duk_ret_t duk__mapset_foreach_raw(duk_hthread *thr, void *udata) {
+	duk_hmapset *m;
+	duk_uint32_t i;
+
+	m = (duk_hmapset *) udata;
+
+	/* Entries added during the loop are visited, deleted ones are not.
+	 * The table is not compacted while iter_count > 0 so indices stay
+	 * valid even if the table is resized.
+	 */
+	for (i = 0; i < m->e_used; i++) {
+		duk_tval *tv;
+
+		tv = DUK_HMAPSET_GET_KEY_PTR(m, i);
+		if (DUK_TVAL_IS_UNUSED(tv)) {
+			continue;
+		}
+
+		/* [ callback thisArg ] */
+		duk_dup_0(thr);
+		duk_dup_1(thr);
+		duk_push_tval(thr, DUK_HMAPSET_HAS_VALUES(m) ? tv + 1 : tv);
+		duk_push_tval(thr, tv);
+		duk_push_this(thr);
+		duk_call_method(thr, 3);
+		duk_pop(thr);
+	}
+
+	return 0;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_mapset_prototype_foreach(duk_hthread *thr) {
+	duk_hmapset *m;
+	duk_int_t rc;
+
+	m = duk__require_hmapset_this(thr);
+	duk_require_callable(thr, 0);
+	duk_set_top(thr, 2);
+
+	/* Protected call so that iter_count is restored on error. */
+	m->iter_count++;
+	rc = duk_safe_call(thr, duk__mapset_foreach_raw, (void *) m, 0 /*nargs*/, 1 /*nrets*/);
+	DUK_ASSERT(m->iter_count > 0);
+	m->iter_count--;
+	if (rc != DUK_EXEC_SUCCESS) {
+		(void) duk_throw(thr);
+	}
+	return 0;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_mapset_prototype_size_getter(duk_hthread *thr) {
+	duk_hmapset *m;
+
+	m = duk__require_hmapset_this(thr);
+	duk_push_uint(thr, (duk_uint_t) m->count);
+	return 1;
+}
+
+#endif  /* DUK_USE_MAP_SET_BUILTIN */
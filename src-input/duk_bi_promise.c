@@ -1,44 +1,970 @@
 /*
  *  Promise built-in
+ *
+ *  Native promises are duk_hpromise objects which keep their state and
+ *  pending reactions in the object itself, see duk_hpromise.h.  Promise
+ *  jobs (ES2015 PromiseJobs) are queued into heap->job_queue and executed
+ *  when the host calls duk_run_jobs(); Duktape never runs them on its own.
+ *
+ *  Differences to ES2015+:
+ *
+ *    - @@species is not supported: .then() always creates a native promise.
+ *
+ *    - Promise.all() and Promise.race() accept array-like values instead
+ *      of iterables as there's no iterator protocol support yet.
+ *
+ *    - No unhandled rejection tracking.
  */
 
 #include "duk_internal.h"
 
 #if defined(DUK_USE_PROMISE_BUILTIN)
 
+/* Job types, stored as the first duk_tval of a queued job.  Remaining
+ * entries depend on the job type:
+ *
+ *   FULFILL, REJECT:  [ type derived handler argument ]
+ *   THENABLE:         [ type promise then thenable ]
+ */
+#define DUK__JOB_FULFILL    0
+#define DUK__JOB_REJECT     1
+#define DUK__JOB_THENABLE   2
+
+DUK_LOCAL_DECL void duk__promise_resolve(duk_hthread *thr, duk_hpromise *p, duk_idx_t idx_value);
+DUK_LOCAL_DECL void duk__promise_settle(duk_hthread *thr, duk_hpromise *p, duk_small_uint_t state, duk_idx_t idx_value);
+
+/*
+ *  Helpers
+ */
+
+DUK_LOCAL duk_hpromise *duk__get_hpromise(duk_hthread *thr, duk_idx_t idx) {
+	duk_hobject *h;
+
+	h = duk_get_hobject(thr, idx);
+	if (h != NULL && DUK_HOBJECT_IS_PROMISE(h)) {
+		return (duk_hpromise *) h;
+	}
+	return NULL;
+}
+
+DUK_LOCAL duk_bool_t duk__is_builtin_natfunc(duk_hthread *thr, duk_idx_t idx, duk_c_function func) {
+	duk_hobject *h;
+
+	h = duk_get_hobject(thr, idx);
+	return (h != NULL && DUK_HOBJECT_IS_NATFUNC(h) && ((duk_hnatfunc *) h)->func == func);
+}
+
+/* Push a new pending native promise inheriting from Promise.prototype. */
+DUK_LOCAL duk_hpromise *duk__push_hpromise(duk_hthread *thr) {
+	duk_hpromise *res;
+
+	/* Reserve space first so that the push below can't trigger a GC
+	 * while the new object is unreachable.
+	 */
+	duk_require_stack(thr, 1);
+	res = duk_hpromise_alloc(thr,
+	                         DUK_HOBJECT_FLAG_EXTENSIBLE |
+	                         DUK_HOBJECT_CLASS_AS_FLAGS(DUK_HOBJECT_CLASS_PROMISE));
+	DUK_ASSERT(res != NULL);
+	duk_push_hobject(thr, (duk_hobject *) res);
+	DUK_HOBJECT_SET_PROTOTYPE_INIT_INCREF(thr, (duk_hobject *) res, thr->builtins[DUK_BIDX_PROMISE_PROTOTYPE]);
+	DUK_ASSERT_HPROMISE_VALID(res);
+	return res;
+}
+
+/* Push an anonymous built-in function with an own .length like ES2015
+ * requires for promise related functions.
+ */
+DUK_LOCAL void duk__push_promise_function(duk_hthread *thr, duk_c_function func, duk_idx_t nargs, duk_small_int_t magic) {
+	duk_push_c_function_builtin_noconstruct(thr, func, nargs);
+	duk_set_magic(thr, -1, magic);
+	duk_push_int(thr, (duk_int_t) nargs);
+	duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_LENGTH, DUK_PROPDESC_FLAGS_C);
+}
+
+/*
+ *  Job queue
+ */
+
+/* Ensure there's room for 'count' more jobs at the end of the queue.  The
+ * queue is compacted first; reallocation may trigger a GC (which marks the
+ * current queue contents) but not finalizers, so the queue can't change
+ * during the call.
+ */
+DUK_LOCAL void duk__promise_reserve_jobs(duk_hthread *thr, duk_size_t count) {
+	duk_heap *heap;
+	duk_tval *new_queue;
+	duk_size_t new_size;
+
+	heap = thr->heap;
+	DUK_ASSERT(heap->job_head <= heap->job_tail);
+	DUK_ASSERT(heap->job_tail <= heap->job_size);
+
+	if (DUK_LIKELY(count <= (heap->job_size - heap->job_tail) / DUK_HEAP_JOB_SIZE)) {
+		return;
+	}
+
+	if (heap->job_head > 0) {
+		duk_memmove((void *) heap->job_queue,
+		            (const void *) (heap->job_queue + heap->job_head),
+		            (size_t) ((heap->job_tail - heap->job_head) * sizeof(duk_tval)));
+		heap->job_tail -= heap->job_head;
+		heap->job_head = 0;
+		if (count <= (heap->job_size - heap->job_tail) / DUK_HEAP_JOB_SIZE) {
+			return;
+		}
+	}
+
+	/* Grow by 50% plus a constant, in whole jobs. */
+	if (count > DUK_SIZE_MAX / sizeof(duk_tval) / DUK_HEAP_JOB_SIZE / 4) {
+		DUK_ERROR_RANGE(thr, DUK_STR_INVALID_COUNT);
+		DUK_WO_NORETURN(return;);
+	}
+	new_size = heap->job_tail / DUK_HEAP_JOB_SIZE + count;
+	new_size = (new_size + (new_size >> 1) + 16) * DUK_HEAP_JOB_SIZE;
+	if (new_size > DUK_SIZE_MAX / sizeof(duk_tval)) {
+		DUK_ERROR_RANGE(thr, DUK_STR_INVALID_COUNT);
+		DUK_WO_NORETURN(return;);
+	}
+
+	heap->pf_prevent_count++;
+	new_queue = (duk_tval *) DUK_REALLOC(heap, (void *) heap->job_queue, new_size * sizeof(duk_tval));
+	DUK_ASSERT(heap->pf_prevent_count > 0);
+	heap->pf_prevent_count--;
+	if (DUK_UNLIKELY(new_queue == NULL)) {
+		DUK_ERROR_ALLOC_FAILED(thr);
+		DUK_WO_NORETURN(return;);
+	}
+
+	DUK_DD(DUK_DDPRINT("resized job queue: %ld -> %ld entries", (long) heap->job_size, (long) new_size));
+	heap->job_queue = new_queue;
+	heap->job_size = new_size;
+}
+
+/* Append a job to a queue with reserved space, taking new references to
+ * the values.  No side effects.
+ */
+DUK_LOCAL void duk__promise_append_job(duk_hthread *thr, duk_small_uint_t type, duk_tval *tv_a, duk_tval *tv_b, duk_tval *tv_c) {
+	duk_heap *heap;
+	duk_tval *tv;
+
+	heap = thr->heap;
+	DUK_ASSERT(heap->job_size - heap->job_tail >= DUK_HEAP_JOB_SIZE);
+	tv = heap->job_queue + heap->job_tail;
+
+	DUK_TVAL_SET_NUMBER(tv, (duk_double_t) type);
+	DUK_TVAL_SET_TVAL(tv + 1, tv_a);
+	DUK_TVAL_INCREF(thr, tv + 1);
+	DUK_TVAL_SET_TVAL(tv + 2, tv_b);
+	DUK_TVAL_INCREF(thr, tv + 2);
+	DUK_TVAL_SET_TVAL(tv + 3, tv_c);
+	DUK_TVAL_INCREF(thr, tv + 3);
+	heap->job_tail += DUK_HEAP_JOB_SIZE;
+}
+
+DUK_LOCAL void duk__promise_enqueue_job(duk_hthread *thr, duk_small_uint_t type, duk_idx_t idx_a, duk_idx_t idx_b, duk_idx_t idx_c) {
+	duk__promise_reserve_jobs(thr, 1);
+	duk__promise_append_job(thr,
+	                        type,
+	                        duk_require_tval(thr, idx_a),
+	                        duk_require_tval(thr, idx_b),
+	                        duk_require_tval(thr, idx_c));
+}
+
+/*
+ *  Promise operations
+ */
+
+/* PerformPromiseThen() with a native derived promise (or undefined) at
+ * 'idx_derived'.  Non-callable handlers are ignored.
+ */
+DUK_LOCAL void duk__promise_perform_then(duk_hthread *thr, duk_hpromise *p, duk_idx_t idx_onfulfilled, duk_idx_t idx_onrejected, duk_idx_t idx_derived) {
+	duk_tval tv_undef;
+	duk_tval *tv_onfulfilled;
+	duk_tval *tv_onrejected;
+	duk_tval *tv;
+
+	DUK_ASSERT_HPROMISE_VALID(p);
+
+	DUK_TVAL_SET_UNDEFINED(&tv_undef);
+	idx_onfulfilled = duk_require_normalize_index(thr, idx_onfulfilled);
+	idx_onrejected = duk_require_normalize_index(thr, idx_onrejected);
+	idx_derived = duk_require_normalize_index(thr, idx_derived);
+
+	if (p->state == DUK_HPROMISE_STATE_PENDING) {
+		if (p->reactions_count >= p->reactions_size) {
+			duk_tval *new_reactions;
+			duk_uint32_t new_size;
+
+			if (p->reactions_size >= DUK_UINT32_MAX / 2 / DUK_HPROMISE_REACTION_SIZE / sizeof(duk_tval)) {
+				DUK_ERROR_RANGE(thr, DUK_STR_INVALID_COUNT);
+				DUK_WO_NORETURN(return;);
+			}
+			new_size = p->reactions_size * 2 + 1;
+
+			/* GC may run during the resize and mark the current
+			 * reactions; finalizers are prevented so that they
+			 * can't modify 'p' behind our back.
+			 */
+			thr->heap->pf_prevent_count++;
+			new_reactions = (duk_tval *) DUK_REALLOC(thr->heap,
+			                                         (void *) p->reactions,
+			                                         sizeof(duk_tval) * DUK_HPROMISE_REACTION_SIZE * new_size);
+			DUK_ASSERT(thr->heap->pf_prevent_count > 0);
+			thr->heap->pf_prevent_count--;
+			if (DUK_UNLIKELY(new_reactions == NULL)) {
+				DUK_ERROR_ALLOC_FAILED(thr);
+				DUK_WO_NORETURN(return;);
+			}
+			p->reactions = new_reactions;
+			p->reactions_size = new_size;
+		}
+
+		tv_onfulfilled = duk_is_callable(thr, idx_onfulfilled) ? duk_get_tval(thr, idx_onfulfilled) : &tv_undef;
+		tv_onrejected = duk_is_callable(thr, idx_onrejected) ? duk_get_tval(thr, idx_onrejected) : &tv_undef;
+
+		tv = p->reactions + p->reactions_count * DUK_HPROMISE_REACTION_SIZE;
+		DUK_TVAL_SET_TVAL(tv + 0, duk_get_tval(thr, idx_derived));
+		DUK_TVAL_INCREF(thr, tv + 0);
+		DUK_TVAL_SET_TVAL(tv + 1, tv_onfulfilled);
+		DUK_TVAL_INCREF(thr, tv + 1);
+		DUK_TVAL_SET_TVAL(tv + 2, tv_onrejected);
+		DUK_TVAL_INCREF(thr, tv + 2);
+		p->reactions_count++;
+	} else {
+		duk_small_uint_t fulfilled;
+		duk_idx_t idx_handler;
+
+		fulfilled = (p->state == DUK_HPROMISE_STATE_FULFILLED);
+		idx_handler = fulfilled ? idx_onfulfilled : idx_onrejected;
+
+		duk__promise_reserve_jobs(thr, 1);
+		duk__promise_append_job(thr,
+		                        fulfilled ? DUK__JOB_FULFILL : DUK__JOB_REJECT,
+		                        duk_get_tval(thr, idx_derived),
+		                        duk_is_callable(thr, idx_handler) ? duk_get_tval(thr, idx_handler) : &tv_undef,
+		                        &p->result);
+	}
+
+	DUK_ASSERT_HPROMISE_VALID(p);
+}
+
+/* FulfillPromise() / RejectPromise(): settle 'p' and move its reactions to
+ * the job queue.
+ */
+DUK_LOCAL void duk__promise_settle(duk_hthread *thr, duk_hpromise *p, duk_small_uint_t state, duk_idx_t idx_value) {
+	duk_tval *reactions;
+	duk_tval *tv;
+	duk_tval *tv_value;
+	duk_uint32_t count;
+	duk_uint32_t i;
+	duk_small_uint_t type;
+
+	DUK_ASSERT_HPROMISE_VALID(p);
+	DUK_ASSERT(p->state == DUK_HPROMISE_STATE_PENDING);
+	DUK_ASSERT(state == DUK_HPROMISE_STATE_FULFILLED || state == DUK_HPROMISE_STATE_REJECTED);
+
+	/* Reserve first: afterwards there are no side effects until the
+	 * reactions have been moved.
+	 */
+	count = p->reactions_count;
+	duk__promise_reserve_jobs(thr, (duk_size_t) count);
+
+	tv_value = duk_require_tval(thr, idx_value);
+	p->state = state;
+	p->resolve_id = 0;
+	DUK_ASSERT(DUK_TVAL_IS_UNDEFINED(&p->result));
+	DUK_TVAL_SET_TVAL(&p->result, tv_value);
+	DUK_TVAL_INCREF(thr, &p->result);
+
+	reactions = p->reactions;
+	p->reactions = NULL;
+	p->reactions_count = 0;
+	p->reactions_size = 0;
+
+	type = (state == DUK_HPROMISE_STATE_FULFILLED ? DUK__JOB_FULFILL : DUK__JOB_REJECT);
+	for (i = 0, tv = reactions; i < count; i++, tv += DUK_HPROMISE_REACTION_SIZE) {
+		duk__promise_append_job(thr,
+		                        type,
+		                        tv + 0,
+		                        (type == DUK__JOB_FULFILL ? tv + 1 : tv + 2),
+		                        tv_value);
+	}
+
+	/* The reactions array is no longer reachable so only side effect
+	 * free DECREFs are allowed until it has been freed.
+	 */
+	for (i = 0, tv = reactions; i < count * DUK_HPROMISE_REACTION_SIZE; i++, tv++) {
+		DUK_TVAL_DECREF_NORZ(thr, tv);
+	}
+	DUK_FREE(thr->heap, (void *) reactions);
+	DUK_REFZERO_CHECK_SLOW(thr);
+
+	DUK_ASSERT_HPROMISE_VALID(p);
+}
+
+DUK_LOCAL duk_ret_t duk__promise_get_then_raw(duk_hthread *thr, void *udata) {
+	DUK_UNREF(udata);
+	(void) duk_get_prop_stridx_short(thr, -1, DUK_STRIDX_THEN);
+	return 1;
+}
+
+/* Promise Resolve Functions steps 6-15 (ES2015 Section 25.4.1.3.2), the
+ * caller has checked [[AlreadyResolved]].
+ */
+DUK_LOCAL void duk__promise_resolve(duk_hthread *thr, duk_hpromise *p, duk_idx_t idx_value) {
+	duk_tval *tv;
+
+	DUK_ASSERT(p->state == DUK_HPROMISE_STATE_PENDING);
+	idx_value = duk_require_normalize_index(thr, idx_value);
+
+	tv = duk_get_tval(thr, idx_value);
+	if (DUK_TVAL_IS_OBJECT(tv)) {
+		if (DUK_TVAL_GET_OBJECT(tv) == (duk_hobject *) p) {
+			(void) duk_push_error_object(thr, DUK_ERR_TYPE_ERROR, "promise resolved with itself");
+			duk__promise_settle(thr, p, DUK_HPROMISE_STATE_REJECTED, -1);
+			duk_pop_unsafe(thr);
+			return;
+		}
+
+		/* Getting .then may throw (getter, Proxy). */
+		duk_dup(thr, idx_value);
+		if (duk_safe_call(thr, duk__promise_get_then_raw, NULL, 1 /*nargs*/, 1 /*nrets*/) != DUK_EXEC_SUCCESS) {
+			duk__promise_settle(thr, p, DUK_HPROMISE_STATE_REJECTED, -1);
+			duk_pop_unsafe(thr);
+			return;
+		}
+		if (duk_is_callable(thr, -1)) {
+			/* No settling functions are live while the thenable
+			 * job is pending, the job creates a new pair.
+			 */
+			p->resolve_id = 0;
+			duk_push_hobject(thr, (duk_hobject *) p);
+			duk__promise_enqueue_job(thr, DUK__JOB_THENABLE, -1, -2, idx_value);
+			duk_pop_2_unsafe(thr);
+			return;
+		}
+		duk_pop_unsafe(thr);
+	}
+
+	duk__promise_settle(thr, p, DUK_HPROMISE_STATE_FULFILLED, idx_value);
+}
+
+/* Promise Resolve Functions and Promise Reject Functions, magic 0 for
+ * resolve and 1 for reject.  The function's _Target is the promise and
+ * _Value the resolving function pair id.
+ */
+DUK_LOCAL duk_ret_t duk__promise_resolving_function(duk_hthread *thr) {
+	duk_hpromise *p;
+	duk_uint32_t resolve_id;
+
+	duk_push_current_function(thr);
+	(void) duk_get_prop_stridx_short(thr, -1, DUK_STRIDX_INT_TARGET);
+	(void) duk_get_prop_stridx_short(thr, -2, DUK_STRIDX_INT_VALUE);
+	p = duk__get_hpromise(thr, -2);
+	resolve_id = (duk_uint32_t) duk_get_uint(thr, -1);
+	DUK_ASSERT(p != NULL);
+
+	if (p->resolve_id == 0 || p->resolve_id != resolve_id) {
+		/* [[AlreadyResolved]] is true. */
+		return 0;
+	}
+	DUK_ASSERT(p->state == DUK_HPROMISE_STATE_PENDING);
+	p->resolve_id = 0;
+
+	if (duk_get_current_magic(thr) == 0) {
+		duk__promise_resolve(thr, p, 0);
+	} else {
+		duk__promise_settle(thr, p, DUK_HPROMISE_STATE_REJECTED, 0);
+	}
+	return 0;
+}
+
+/* CreateResolvingFunctions() for promise at 'idx_promise': push [ resolve
+ * reject ] and return the pair id.  Earlier pairs become no-ops.
+ */
+DUK_LOCAL duk_uint32_t duk__promise_push_resolving_functions(duk_hthread *thr, duk_idx_t idx_promise) {
+	duk_hpromise *p;
+	duk_uint32_t resolve_id;
+	duk_small_int_t i;
+
+	idx_promise = duk_require_normalize_index(thr, idx_promise);
+	p = duk__get_hpromise(thr, idx_promise);
+	DUK_ASSERT(p != NULL);
+
+	for (i = 0; i < 2; i++) {
+		duk__push_promise_function(thr, duk__promise_resolving_function, 1, i);
+		duk_dup(thr, idx_promise);
+		duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_TARGET, DUK_PROPDESC_FLAGS_NONE);
+	}
+
+	/* Only now mark the pair live so that an error above doesn't leave
+	 * the promise without a reachable pair.
+	 */
+	resolve_id = ++p->resolve_id_next;
+	if (DUK_UNLIKELY(resolve_id == 0)) {
+		resolve_id = ++p->resolve_id_next;
+	}
+	duk_push_uint(thr, (duk_uint_t) resolve_id);
+	duk_xdef_prop_stridx_short(thr, -3, DUK_STRIDX_INT_VALUE, DUK_PROPDESC_FLAGS_NONE);
+	duk_push_uint(thr, (duk_uint_t) resolve_id);
+	duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_VALUE, DUK_PROPDESC_FLAGS_NONE);
+	p->resolve_id = resolve_id;
+
+	return resolve_id;
+}
+
+/* Reject 'p' with the value at stack top if resolving function pair
+ * 'resolve_id' is still live, used when a call made with the pair throws.
+ */
+DUK_LOCAL void duk__promise_reject_if_live(duk_hthread *thr, duk_hpromise *p, duk_uint32_t resolve_id) {
+	if (p->resolve_id == resolve_id) {
+		DUK_ASSERT(p->state == DUK_HPROMISE_STATE_PENDING);
+		p->resolve_id = 0;
+		duk__promise_settle(thr, p, DUK_HPROMISE_STATE_REJECTED, -1);
+	}
+}
+
+/*
+ *  Job execution
+ */
+
+/* PromiseReactionJob, ES2015 Section 25.4.2.1.
+ * [ type derived handler argument ]
+ */
+DUK_LOCAL void duk__promise_run_reaction_job(duk_hthread *thr, duk_idx_t idx_job, duk_small_uint_t type) {
+	duk_hpromise *derived;
+	duk_small_uint_t state;
+
+	if (duk_is_undefined(thr, idx_job + 2)) {
+		duk_dup(thr, idx_job + 3);
+		state = (type == DUK__JOB_FULFILL ? DUK_HPROMISE_STATE_FULFILLED : DUK_HPROMISE_STATE_REJECTED);
+	} else {
+		duk_dup(thr, idx_job + 2);
+		duk_push_undefined(thr);
+		duk_dup(thr, idx_job + 3);
+		if (duk_pcall_method(thr, 1) == DUK_EXEC_SUCCESS) {
+			state = DUK_HPROMISE_STATE_FULFILLED;
+		} else {
+			state = DUK_HPROMISE_STATE_REJECTED;
+		}
+	}
+
+	/* The derived promise was created by .then() and is only settled
+	 * here, so its state is still pending.
+	 */
+	derived = duk__get_hpromise(thr, idx_job + 1);
+	if (derived != NULL) {
+		DUK_ASSERT(derived->state == DUK_HPROMISE_STATE_PENDING);
+		if (state == DUK_HPROMISE_STATE_FULFILLED) {
+			duk__promise_resolve(thr, derived, -1);
+		} else {
+			duk__promise_settle(thr, derived, DUK_HPROMISE_STATE_REJECTED, -1);
+		}
+	}
+}
+
+/* PromiseResolveThenableJob, ES2015 Section 25.4.2.2.
+ * [ type promise then thenable ]
+ */
+DUK_LOCAL void duk__promise_run_thenable_job(duk_hthread *thr, duk_idx_t idx_job) {
+	duk_hpromise *p;
+	duk_hpromise *thenable;
+	duk_uint32_t resolve_id;
+
+	p = duk__get_hpromise(thr, idx_job + 1);
+	DUK_ASSERT(p != NULL);
+	DUK_ASSERT(p->state == DUK_HPROMISE_STATE_PENDING);
+	DUK_ASSERT(p->resolve_id == 0);
+
+	/* Native thenable with the built-in .then(): the resolving functions
+	 * would only be visible to our own .then(), so settle 'p' through a
+	 * plain reaction instead of creating them.
+	 */
+	thenable = duk__get_hpromise(thr, idx_job + 3);
+	if (thenable != NULL && duk__is_builtin_natfunc(thr, idx_job + 2, duk_bi_promise_then)) {
+		duk_push_undefined(thr);
+		duk__promise_perform_then(thr, thenable, -1, -1, idx_job + 1);
+		return;
+	}
+
+	duk_dup(thr, idx_job + 2);
+	duk_dup(thr, idx_job + 3);
+	resolve_id = duk__promise_push_resolving_functions(thr, idx_job + 1);
+	if (duk_pcall_method(thr, 2) != DUK_EXEC_SUCCESS) {
+		duk__promise_reject_if_live(thr, p, resolve_id);
+	}
+}
+
+DUK_INTERNAL duk_int_t duk_promise_run_jobs(duk_hthread *thr, duk_int_t max_jobs) {
+	duk_heap *heap;
+	duk_size_t remain;
+
+	DUK_ASSERT(thr != NULL);
+	heap = thr->heap;
+
+	while (max_jobs != 0 && heap->job_head < heap->job_tail) {
+		duk_idx_t idx_job;
+		duk_small_uint_t type;
+		duk_small_uint_t i;
+		duk_tval *tv;
+
+		if (max_jobs > 0) {
+			max_jobs--;
+		}
+
+		/* Move the job to the value stack; the pushes can't have side
+		 * effects once space has been reserved.
+		 */
+		duk_require_stack(thr, DUK_HEAP_JOB_SIZE + 8);
+		idx_job = duk_get_top(thr);
+		tv = heap->job_queue + heap->job_head;
+		for (i = 0; i < DUK_HEAP_JOB_SIZE; i++) {
+			duk_push_tval(thr, tv + i);
+			DUK_TVAL_DECREF_NORZ(thr, tv + i);
+		}
+		heap->job_head += DUK_HEAP_JOB_SIZE;
+		if (heap->job_head == heap->job_tail) {
+			heap->job_head = 0;
+			heap->job_tail = 0;
+		}
+
+		type = (duk_small_uint_t) duk_get_uint(thr, idx_job);
+		DUK_DDD(DUK_DDDPRINT("run promise job, type %ld", (long) type));
+		if (type == DUK__JOB_THENABLE) {
+			duk__promise_run_thenable_job(thr, idx_job);
+		} else {
+			duk__promise_run_reaction_job(thr, idx_job, type);
+		}
+		duk_set_top(thr, idx_job);
+	}
+
+	remain = (heap->job_tail - heap->job_head) / DUK_HEAP_JOB_SIZE;
+	return (remain > (duk_size_t) DUK_INT_MAX ? DUK_INT_MAX : (duk_int_t) remain);
+}
+
+/*
+ *  Generic promise capabilities for non-native constructors.
+ */
+
+/* GetCapabilitiesExecutor Functions, ES2015 Section 25.4.1.5.1.  _Target
+ * is an array receiving [ resolve reject ].
+ */
+DUK_LOCAL duk_ret_t duk__promise_capability_executor(duk_hthread *thr) {
+	duk_push_current_function(thr);
+	(void) duk_get_prop_stridx_short(thr, -1, DUK_STRIDX_INT_TARGET);
+	(void) duk_get_prop_index(thr, -1, 0);
+	(void) duk_get_prop_index(thr, -2, 1);
+	if (!duk_is_undefined(thr, -1) || !duk_is_undefined(thr, -2)) {
+		DUK_DCERROR_TYPE_INVALID_STATE(thr);
+	}
+	duk_dup_0(thr);
+	duk_put_prop_index(thr, -4, 0);
+	duk_dup_1(thr);
+	duk_put_prop_index(thr, -4, 1);
+	return 0;
+}
+
+/* NewPromiseCapability(C), ES2015 Section 25.4.1.5: push [ promise resolve
+ * reject ].  For the built-in constructor a native promise is created and
+ * the resolving functions are created directly.
+ */
+DUK_LOCAL void duk__promise_push_capability(duk_hthread *thr, duk_idx_t idx_ctor) {
+	idx_ctor = duk_require_normalize_index(thr, idx_ctor);
+
+	if (duk_get_hobject(thr, idx_ctor) == thr->builtins[DUK_BIDX_PROMISE_CONSTRUCTOR]) {
+		(void) duk__push_hpromise(thr);
+		(void) duk__promise_push_resolving_functions(thr, -1);
+		return;
+	}
+
+	if (!duk_is_constructable(thr, idx_ctor)) {
+		DUK_ERROR_TYPE(thr, DUK_STR_NOT_CONSTRUCTABLE);
+		DUK_WO_NORETURN(return;);
+	}
+
+	duk_push_array(thr);
+	duk_dup(thr, idx_ctor);
+	duk__push_promise_function(thr, duk__promise_capability_executor, 2, 0);
+	duk_dup(thr, -3);
+	duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_TARGET, DUK_PROPDESC_FLAGS_NONE);
+	duk_new(thr, 1);  /* [ ... holder promise ] */
+
+	(void) duk_get_prop_index(thr, -2, 0);
+	(void) duk_get_prop_index(thr, -3, 1);
+	if (!duk_is_callable(thr, -1) || !duk_is_callable(thr, -2)) {
+		DUK_ERROR_TYPE(thr, DUK_STR_NOT_CALLABLE);
+		DUK_WO_NORETURN(return;);
+	}
+	duk_remove(thr, -4);  /* [ ... promise resolve reject ] */
+}
+
+/*
+ *  Constructor
+ */
+
 DUK_INTERNAL duk_ret_t duk_bi_promise_constructor(duk_hthread *thr) {
-	DUK_ERROR_TYPE(thr, "unimplemented");
-	DUK_WO_NORETURN(return 0;);
+	duk_hpromise *p;
+	duk_uint32_t resolve_id;
+
+	duk_require_constructor_call(thr);
+	duk_require_callable(thr, 0);
+
+	p = duk__push_hpromise(thr);
+	resolve_id = duk__promise_push_resolving_functions(thr, -1);
+
+	/* [ executor promise resolve reject ] */
+	duk_dup_0(thr);
+	duk_push_undefined(thr);
+	duk_dup(thr, 2);
+	duk_dup(thr, 3);
+	if (duk_pcall_method(thr, 2) != DUK_EXEC_SUCCESS) {
+		duk__promise_reject_if_live(thr, p, resolve_id);
+	}
+
+	duk_set_top(thr, 2);
+	return 1;
+}
+
+/*
+ *  Promise.all() and Promise.race()
+ */
+
+/* Promise.all Resolve Element Functions, ES2015 Section 25.4.4.1.2.
+ * _Target is the shared record [ values remaining resolve ] and _Value
+ * the element index.  _Target is cleared when called ([[AlreadyCalled]]).
+ */
+DUK_LOCAL duk_ret_t duk__promise_all_resolve_element(duk_hthread *thr) {
+	duk_uint_t remaining;
+
+	duk_set_top(thr, 1);
+	duk_push_current_function(thr);
+	(void) duk_get_prop_stridx_short(thr, 1, DUK_STRIDX_INT_TARGET);
+	if (!duk_is_object(thr, 2)) {
+		return 0;
+	}
+	duk_push_undefined(thr);
+	duk_put_prop_stridx_short(thr, 1, DUK_STRIDX_INT_TARGET);
+
+	/* [ x func record ] */
+	(void) duk_get_prop_index(thr, 2, 0);
+	(void) duk_get_prop_stridx_short(thr, 1, DUK_STRIDX_INT_VALUE);
+	duk_dup_0(thr);
+	duk_put_prop(thr, 3);
+
+	(void) duk_get_prop_index(thr, 2, 1);
+	remaining = duk_get_uint(thr, -1) - 1;
+	duk_push_uint(thr, remaining);
+	duk_put_prop_index(thr, 2, 1);
+	if (remaining == 0) {
+		(void) duk_get_prop_index(thr, 2, 2);
+		duk_push_undefined(thr);
+		duk_dup(thr, 3);
+		duk_call_method(thr, 1);
+	}
+	return 0;
+}
+
+/* Iterate over the array-like at index 0 with constructor at index 1 and
+ * capability [ promise resolve reject ] at indices 2-4, udata points to
+ * the 'is_all' flag.  Called using duk_safe_call() which shares the
+ * caller's value stack frame.
+ */
+DUK_LOCAL duk_ret_t duk__promise_all_race_raw(duk_hthread *thr, void *udata) {
+	duk_bool_t is_all;
+	duk_uarridx_t i, len;
+
+	is_all = *((duk_bool_t *) udata);
+
+	duk_to_object(thr, 0);
+	len = (duk_uarridx_t) duk_get_length(thr, 0);
+
+	if (is_all) {
+		/* Record: [ values remaining resolve ], remaining starts at 1. */
+		duk_push_array(thr);
+		duk_push_array(thr);
+		duk_put_prop_index(thr, 5, 0);
+		duk_push_uint(thr, 1);
+		duk_put_prop_index(thr, 5, 1);
+		duk_dup(thr, 3);
+		duk_put_prop_index(thr, 5, 2);
+	}
+
+	for (i = 0; i < len; i++) {
+		/* nextPromise = C.resolve(nextValue) */
+		(void) duk_get_prop_stridx_short(thr, 1, DUK_STRIDX_RESOLVE);
+		duk_dup_1(thr);
+		(void) duk_get_prop_index(thr, 0, i);
+		duk_call_method(thr, 1);
+
+		/* nextPromise.then(resolveElement, reject) */
+		(void) duk_get_prop_stridx_short(thr, -1, DUK_STRIDX_THEN);
+		duk_insert(thr, -2);
+		if (is_all) {
+			duk__push_promise_function(thr, duk__promise_all_resolve_element, 1, 0);
+			duk_dup(thr, 5);
+			duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_TARGET, DUK_PROPDESC_FLAGS_W);
+			duk_push_uint(thr, (duk_uint_t) i);
+			duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_VALUE, DUK_PROPDESC_FLAGS_NONE);
+
+			(void) duk_get_prop_index(thr, 5, 1);
+			duk_push_uint(thr, duk_get_uint(thr, -1) + 1);
+			duk_put_prop_index(thr, 5, 1);
+			duk_pop_unsafe(thr);
+		} else {
+			duk_dup(thr, 3);
+		}
+		duk_dup(thr, 4);
+		duk_call_method(thr, 2);
+		duk_pop_unsafe(thr);
+	}
+
+	if (is_all) {
+		duk_uint_t remaining;
+
+		(void) duk_get_prop_index(thr, 5, 1);
+		remaining = duk_get_uint(thr, -1) - 1;
+		duk_push_uint(thr, remaining);
+		duk_put_prop_index(thr, 5, 1);
+		if (remaining == 0) {
+			duk_dup(thr, 3);
+			duk_push_undefined(thr);
+			(void) duk_get_prop_index(thr, 5, 0);
+			duk_call_method(thr, 1);
+		}
+	}
+	return 0;
+}
+
+DUK_LOCAL duk_ret_t duk__promise_all_race(duk_hthread *thr, duk_bool_t is_all) {
+	duk_set_top(thr, 1);
+	duk_push_this(thr);
+	duk_require_hobject(thr, 1);
+	duk__promise_push_capability(thr, 1);
+
+	/* [ iterable C promise resolve reject ] */
+	if (duk_safe_call(thr, duk__promise_all_race_raw, (void *) &is_all, 0 /*nargs*/, 1 /*nrets*/) != DUK_EXEC_SUCCESS) {
+		/* IfAbruptRejectPromise */
+		duk_dup(thr, 4);
+		duk_push_undefined(thr);
+		duk_dup(thr, -3);
+		duk_call_method(thr, 1);
+	}
+
+	duk_set_top(thr, 3);
+	return 1;
 }
 
 DUK_INTERNAL duk_ret_t duk_bi_promise_all(duk_hthread *thr) {
-	DUK_ERROR_TYPE(thr, "unimplemented");
-	DUK_WO_NORETURN(return 0;);
+	return duk__promise_all_race(thr, 1 /*is_all*/);
 }
 
 DUK_INTERNAL duk_ret_t duk_bi_promise_race(duk_hthread *thr) {
-	DUK_ERROR_TYPE(thr, "unimplemented");
-	DUK_WO_NORETURN(return 0;);
+	return duk__promise_all_race(thr, 0 /*is_all*/);
 }
 
+/*
+ *  Promise.reject() and Promise.resolve()
+ */
+
 DUK_INTERNAL duk_ret_t duk_bi_promise_reject(duk_hthread *thr) {
-	DUK_ERROR_TYPE(thr, "unimplemented");
-	DUK_WO_NORETURN(return 0;);
+	duk_hpromise *p;
+
+	duk_set_top(thr, 1);
+	duk_push_this(thr);
+	duk_require_hobject(thr, 1);
+
+	if (duk_get_hobject(thr, 1) == thr->builtins[DUK_BIDX_PROMISE_CONSTRUCTOR]) {
+		p = duk__push_hpromise(thr);
+		duk__promise_settle(thr, p, DUK_HPROMISE_STATE_REJECTED, 0);
+		return 1;
+	}
+
+	duk__promise_push_capability(thr, 1);
+	duk_push_undefined(thr);
+	duk_dup_0(thr);
+	duk_call_method(thr, 1);
+	duk_pop_2_unsafe(thr);
+	return 1;
 }
 
 DUK_INTERNAL duk_ret_t duk_bi_promise_resolve(duk_hthread *thr) {
-	DUK_ERROR_TYPE(thr, "unimplemented");
-	DUK_WO_NORETURN(return 0;);
+	duk_hpromise *p;
+
+	duk_set_top(thr, 1);
+	duk_push_this(thr);
+	duk_require_hobject(thr, 1);
+
+	/* A promise whose .constructor is 'this' is returned as is. */
+	if (duk__get_hpromise(thr, 0) != NULL) {
+		(void) duk_get_prop_stridx_short(thr, 0, DUK_STRIDX_CONSTRUCTOR);
+		if (duk_strict_equals(thr, 1, 2)) {
+			duk_dup_0(thr);
+			return 1;
+		}
+		duk_pop_unsafe(thr);
+	}
+
+	if (duk_get_hobject(thr, 1) == thr->builtins[DUK_BIDX_PROMISE_CONSTRUCTOR]) {
+		p = duk__push_hpromise(thr);
+		duk__promise_resolve(thr, p, 0);
+		return 1;
+	}
+
+	duk__promise_push_capability(thr, 1);
+	duk_pop_unsafe(thr);
+	duk_push_undefined(thr);
+	duk_dup_0(thr);
+	duk_call_method(thr, 1);
+	duk_pop_unsafe(thr);
+	return 1;
 }
 
-DUK_INTERNAL duk_ret_t duk_bi_promise_catch(duk_hthread *thr) {
-	DUK_ERROR_TYPE(thr, "unimplemented");
-	DUK_WO_NORETURN(return 0;);
+/* Promise.try(callback, ...args), https://github.com/tc39/proposal-promise-try */
+DUK_INTERNAL duk_ret_t duk_bi_promise_try(duk_hthread *thr) {
+	duk_hpromise *p;
+	duk_idx_t nargs;
+	duk_idx_t idx_promise;
+	duk_idx_t i;
+	duk_int_t rc;
+
+	nargs = duk_get_top(thr);
+	if (nargs == 0) {
+		duk_push_undefined(thr);
+		nargs = 1;
+	}
+	duk_push_this(thr);
+	duk_require_hobject(thr, -1);
+
+	/* [ callback args C ] */
+	if (duk_get_hobject(thr, -1) == thr->builtins[DUK_BIDX_PROMISE_CONSTRUCTOR]) {
+		p = duk__push_hpromise(thr);
+	} else {
+		p = NULL;
+		duk__promise_push_capability(thr, -1);
+	}
+	idx_promise = nargs + 1;
+
+	duk_dup_0(thr);
+	duk_push_undefined(thr);
+	for (i = 1; i < nargs; i++) {
+		duk_dup(thr, i);
+	}
+	rc = duk_pcall_method(thr, nargs - 1);
+
+	if (p != NULL) {
+		if (rc == DUK_EXEC_SUCCESS) {
+			duk__promise_resolve(thr, p, -1);
+		} else {
+			duk__promise_settle(thr, p, DUK_HPROMISE_STATE_REJECTED, -1);
+		}
+	} else {
+		/* [ callback args C promise resolve reject result ] */
+		duk_dup(thr, rc == DUK_EXEC_SUCCESS ? idx_promise + 1 : idx_promise + 2);
+		duk_push_undefined(thr);
+		duk_dup(thr, -3);
+		duk_call_method(thr, 1);
+	}
+
+	duk_set_top(thr, idx_promise + 1);
+	return 1;
 }
 
+/*
+ *  Promise.prototype.then(), .catch() and .finally()
+ */
+
 DUK_INTERNAL duk_ret_t duk_bi_promise_then(duk_hthread *thr) {
-	DUK_ERROR_TYPE(thr, "unimplemented");
-	DUK_WO_NORETURN(return 0;);
+	duk_hpromise *p;
+
+	duk_set_top(thr, 2);
+	duk_push_this(thr);
+	p = duk__get_hpromise(thr, 2);
+	if (p == NULL) {
+		DUK_DCERROR_TYPE_INVALID_ARGS(thr);
+	}
+
+	(void) duk__push_hpromise(thr);
+	duk__promise_perform_then(thr, p, 0, 1, 3);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_promise_catch(duk_hthread *thr) {
+	/* Invoke(promise, "then", undefined, onRejected) */
+	duk_set_top(thr, 1);
+	duk_push_this(thr);
+	(void) duk_get_prop_stridx_short(thr, 1, DUK_STRIDX_THEN);
+	duk_dup(thr, 1);
+	duk_push_undefined(thr);
+	duk_dup_0(thr);
+	duk_call_method(thr, 2);
+	return 1;
+}
+
+/* Value thunk (magic 0) and thrower (magic 1) for .finally(), the value
+ * is in _Value.
+ */
+DUK_LOCAL duk_ret_t duk__promise_finally_thunk(duk_hthread *thr) {
+	duk_push_current_function(thr);
+	(void) duk_get_prop_stridx_short(thr, -1, DUK_STRIDX_INT_VALUE);
+	if (duk_get_current_magic(thr) != 0) {
+		(void) duk_throw(thr);
+	}
+	return 1;
+}
+
+/* thenFinally (magic 0) and catchFinally (magic 1) functions, the
+ * onFinally callback is in _Target.
+ */
+DUK_LOCAL duk_ret_t duk__promise_finally_function(duk_hthread *thr) {
+	duk_hpromise *p;
+	duk_small_int_t magic;
+
+	magic = (duk_small_int_t) duk_get_current_magic(thr);
+	duk_set_top(thr, 1);
+	duk_push_current_function(thr);
+	(void) duk_get_prop_stridx_short(thr, 1, DUK_STRIDX_INT_TARGET);
+	duk_push_undefined(thr);
+	duk_call_method(thr, 0);
+
+	/* promise = PromiseResolve(%Promise%, result) */
+	if (duk__get_hpromise(thr, 2) == NULL) {
+		p = duk__push_hpromise(thr);
+		duk__promise_resolve(thr, p, 2);
+		duk_replace(thr, 2);
+	}
+
+	/* promise.then(thunk) */
+	(void) duk_get_prop_stridx_short(thr, 2, DUK_STRIDX_THEN);
+	duk_dup(thr, 2);
+	duk__push_promise_function(thr, duk__promise_finally_thunk, 0, magic);
+	duk_dup_0(thr);
+	duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_VALUE, DUK_PROPDESC_FLAGS_NONE);
+	duk_call_method(thr, 1);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_promise_finally(duk_hthread *thr) {
+	duk_small_int_t i;
+
+	duk_set_top(thr, 1);
+	duk_push_this(thr);
+	duk_require_hobject(thr, 1);
+
+	/* Invoke(promise, "then", thenFinally, catchFinally) */
+	(void) duk_get_prop_stridx_short(thr, 1, DUK_STRIDX_THEN);
+	duk_dup(thr, 1);
+	for (i = 0; i < 2; i++) {
+		if (duk_is_callable(thr, 0)) {
+			duk__push_promise_function(thr, duk__promise_finally_function, 1, i);
+			duk_dup_0(thr);
+			duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_TARGET, DUK_PROPDESC_FLAGS_NONE);
+		} else {
+			duk_dup_0(thr);
+		}
+	}
+	duk_call_method(thr, 2);
+	return 1;
 }
 
 #endif  /* DUK_USE_PROMISE_BUILTIN */
@@ -74,6 +74,10 @@ void duk_bi_json_stringify_helper(duk_hthread *thr,
 
 DUK_INTERNAL_DECL duk_ret_t duk_textdecoder_decode_utf8_nodejs(duk_hthread *thr);
 
+#if defined(DUK_USE_PROMISE_BUILTIN)
+DUK_INTERNAL_DECL duk_int_t duk_promise_run_jobs(duk_hthread *thr, duk_int_t max_jobs);
+#endif
+
 #if defined(DUK_USE_ES6_PROXY)
 DUK_INTERNAL_DECL void duk_proxy_ownkeys_postprocess(duk_hthread *thr, duk_hobject *h_proxy_target, duk_uint_t flags);
 #endif
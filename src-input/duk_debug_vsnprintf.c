@@ -106,11 +106,11 @@ DUK_LOCAL const char * const duk__bc_optab[256] = {
 
 	"NEWOBJ", "NEWARR", "MPUTOBJ", "MPUTOBJI", "INITSET", "INITGET", "MPUTARR", "MPUTARRI",
 	"SETALEN", "INITENUM", "NEXTENUM", "NEWTARGET", "DEBUGGER", "NOP", "INVALID", "UNUSED207",
-	"GETPROPC_RR", "GETPROPC_CR", "GETPROPC_RC", "GETPROPC_CC", "UNUSED212", "UNUSED213", "UNUSED214", "UNUSED215",
-	"UNUSED216", "UNUSED217", "UNUSED218", "UNUSED219", "UNUSED220", "UNUSED221", "UNUSED222", "UNUSED223",
+	"GETPROPC_RR", "GETPROPC_CR", "GETPROPC_RC", "GETPROPC_CC", "IFLT_RR", "IFLT_CR", "IFLT_RC", "IFLT_CC",
+	"IFGT_RR", "IFGT_CR", "IFGT_RC", "IFGT_CC", "IFLE_RR", "IFLE_CR", "IFLE_RC", "IFLE_CC",
 
-	"UNUSED224", "UNUSED225", "UNUSED226", "UNUSED227", "UNUSED228", "UNUSED229", "UNUSED230", "UNUSED231",
-	"UNUSED232", "UNUSED233", "UNUSED234", "UNUSED235", "UNUSED236", "UNUSED237", "UNUSED238", "UNUSED239",
+	"IFGE_RR", "IFGE_CR", "IFGE_RC", "IFGE_CC", "IFSEQ_RR", "IFSEQ_CR", "IFSEQ_RC", "IFSEQ_CC",
+	"IFSNEQ_RR", "IFSNEQ_CR", "IFSNEQ_RC", "IFSNEQ_CC", "UNUSED236", "UNUSED237", "UNUSED238", "UNUSED239",
 	"UNUSED240", "UNUSED241", "UNUSED242", "UNUSED243", "UNUSED244", "UNUSED245", "UNUSED246", "UNUSED247",
 	"UNUSED248", "UNUSED249", "UNUSED250", "UNUSED251", "UNUSED252", "UNUSED253", "UNUSED254", "UNUSED255"
 };
@@ -257,6 +257,17 @@ DUK_LOCAL void duk__print_hstring(duk__dprint_state *st, duk_hstring *h, duk_boo
 		return;
 	}
 
+#if defined(DUK_USE_HSTRING_ROPES)
+	if (DUK_HSTRING_IS_ROPE(h)) {
+		/* Debug printing must not allocate, so don't flatten. */
+		if (((duk_hstring_rope *) h)->flat == NULL) {
+			duk_fb_sprintf(fb, "[rope:%ld]", (long) DUK_HSTRING_GET_BYTELEN(h));
+			return;
+		}
+		h = ((duk_hstring_rope *) h)->flat;
+	}
+#endif
+
 	p = DUK_HSTRING_GET_DATA(h);
 	p_end = p + DUK_HSTRING_GET_BYTELEN(h);
 
@@ -535,6 +546,22 @@ DUK_LOCAL void duk__print_hobject(duk__dprint_state *st, duk_hobject *h) {
 		duk__print_hobject(st, p->target);
 		DUK__COMMA(); duk_fb_sprintf(fb, "__handler:");
 		duk__print_hobject(st, p->handler);
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	} else if (st->internal && DUK_HOBJECT_IS_PROMISE(h)) {
+		duk_hpromise *p = (duk_hpromise *) h;
+		DUK__COMMA(); duk_fb_sprintf(fb, "__state:%ld", (long) p->state);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__reactions_count:%ld", (long) p->reactions_count);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__resolve_id:%ld", (long) p->resolve_id);
+#endif
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	} else if (st->internal && DUK_HOBJECT_IS_MAPSET(h)) {
+		duk_hmapset *m = (duk_hmapset *) h;
+		DUK__COMMA(); duk_fb_sprintf(fb, "__kind:%ld", (long) m->kind);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__count:%ld", (long) m->count);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__e_used:%ld", (long) m->e_used);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__e_size:%ld", (long) m->e_size);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__h_size:%ld", (long) m->h_size);
+#endif
 	} else if (st->internal && DUK_HOBJECT_IS_THREAD(h)) {
 		duk_hthread *t = (duk_hthread *) h;
 		DUK__COMMA(); duk_fb_sprintf(fb, "__ptr_curr_pc:%p", (void *) t->ptr_curr_pc);
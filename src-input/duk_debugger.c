@@ -922,7 +922,7 @@ DUK_INTERNAL void duk_debug_write_tval(duk_hthread *thr, duk_tval *tv) {
 		duk_debug_write_bytes(thr, (const duk_uint8_t *) &lf_func, sizeof(lf_func));
 		break;
 	case DUK_TAG_STRING:
-		duk_debug_write_hstring(thr, DUK_TVAL_GET_STRING(tv));
+		duk_debug_write_hstring(thr, DUK_HSTRING_FLATTEN(thr, DUK_TVAL_GET_STRING(tv)));
 		break;
 	case DUK_TAG_OBJECT:
 		duk_debug_write_hobject(thr, DUK_TVAL_GET_OBJECT(tv));
@@ -21,6 +21,7 @@ struct duk_heaphdr_string;
 struct duk_harray;
 struct duk_hstring;
 struct duk_hstring_external;
+struct duk_hstring_rope;
 struct duk_hobject;
 struct duk_hcompfunc;
 struct duk_hnatfunc;
@@ -30,6 +31,9 @@ struct duk_hbufobj;
 struct duk_hdecenv;
 struct duk_hobjenv;
 struct duk_hproxy;
+struct duk_hpromise;
+struct duk_hmapset;
+struct duk_hshape;
 struct duk_hbuffer;
 struct duk_hbuffer_fixed;
 struct duk_hbuffer_dynamic;
@@ -48,6 +52,12 @@ struct duk_ljstate;
 struct duk_strcache_entry;
 struct duk_litcache_entry;
 struct duk_strtab_entry;
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+struct duk_ms_markchunk;
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+struct duk_ms_bgfree;
+#endif
 
 #if defined(DUK_USE_DEBUG)
 struct duk_fixedbuffer;
@@ -67,6 +77,10 @@ struct duk_compiler_instr;
 struct duk_compiler_func;
 struct duk_compiler_ctx;
 
+struct duk_propic;
+struct duk_propic_entry;
+struct duk_jitfunc;
+
 struct duk_re_matcher_ctx;
 struct duk_re_compiler_ctx;
 
@@ -82,6 +96,7 @@ typedef struct duk_heaphdr_string duk_heaphdr_string;
 typedef struct duk_harray duk_harray;
 typedef struct duk_hstring duk_hstring;
 typedef struct duk_hstring_external duk_hstring_external;
+typedef struct duk_hstring_rope duk_hstring_rope;
 typedef struct duk_hobject duk_hobject;
 typedef struct duk_hcompfunc duk_hcompfunc;
 typedef struct duk_hnatfunc duk_hnatfunc;
@@ -91,6 +106,9 @@ typedef struct duk_hbufobj duk_hbufobj;
 typedef struct duk_hdecenv duk_hdecenv;
 typedef struct duk_hobjenv duk_hobjenv;
 typedef struct duk_hproxy duk_hproxy;
+typedef struct duk_hpromise duk_hpromise;
+typedef struct duk_hmapset duk_hmapset;
+typedef struct duk_hshape duk_hshape;
 typedef struct duk_hbuffer duk_hbuffer;
 typedef struct duk_hbuffer_fixed duk_hbuffer_fixed;
 typedef struct duk_hbuffer_dynamic duk_hbuffer_dynamic;
@@ -109,6 +127,12 @@ typedef struct duk_ljstate duk_ljstate;
 typedef struct duk_strcache_entry duk_strcache_entry;
 typedef struct duk_litcache_entry duk_litcache_entry;
 typedef struct duk_strtab_entry duk_strtab_entry;
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+typedef struct duk_ms_markchunk duk_ms_markchunk;
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+typedef struct duk_ms_bgfree duk_ms_bgfree;
+#endif
 
 #if defined(DUK_USE_DEBUG)
 typedef struct duk_fixedbuffer duk_fixedbuffer;
@@ -128,6 +152,10 @@ typedef struct duk_compiler_instr duk_compiler_instr;
 typedef struct duk_compiler_func duk_compiler_func;
 typedef struct duk_compiler_ctx duk_compiler_ctx;
 
+typedef struct duk_propic duk_propic;
+typedef struct duk_propic_entry duk_propic_entry;
+typedef struct duk_jitfunc duk_jitfunc;
+
 typedef struct duk_re_matcher_ctx duk_re_matcher_ctx;
 typedef struct duk_re_compiler_ctx duk_re_compiler_ctx;
 
@@ -197,6 +197,20 @@ struct duk_hcompfunc {
 	duk_hobject *var_env;
 #endif
 
+#if defined(DUK_USE_PROP_IC)
+	/* Property access inline caches, shared by a template and all its
+	 * closures; NULL if not allocated.  See duk_js_propic.h.
+	 */
+	duk_propic *propic;
+#endif
+
+#if defined(DUK_USE_JIT_X64)
+	/* JIT state and native code, shared by a template and all its
+	 * closures; NULL if not allocated.  See duk_js_jit_x64.h.
+	 */
+	duk_jitfunc *jit;
+#endif
+
 	/*
 	 *  'nregs' registers are allocated on function entry, at most 'nargs'
 	 *  are initialized to arguments, and the rest to undefined.  Arguments
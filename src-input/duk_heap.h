@@ -83,6 +83,72 @@
  */
 #define DUK_MS_FLAG_NO_OBJECT_COMPACTION     (1U << 3)
 
+/*
+ *  Incremental mark-and-sweep phases
+ *
+ *  A cycle proceeds through the phases in order; each voluntary GC trigger
+ *  runs one budgeted slice.  While heap->ms_incr_marking is set INCREF acts
+ *  as a write barrier and shades its target (see duk_refcount.h).
+ */
+
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+#if !defined(DUK_USE_REFERENCE_COUNTING) || !defined(DUK_USE_DOUBLE_LINKED_HEAP)
+#error DUK_USE_MARK_AND_SWEEP_INCREMENTAL requires DUK_USE_REFERENCE_COUNTING and DUK_USE_DOUBLE_LINKED_HEAP
+#endif
+#if !defined(DUK_USE_VOLUNTARY_GC)
+#error DUK_USE_MARK_AND_SWEEP_INCREMENTAL requires DUK_USE_VOLUNTARY_GC
+#endif
+#endif
+
+#define DUK_MS_INCR_PHASE_IDLE               0  /* no cycle in progress */
+#define DUK_MS_INCR_PHASE_MARK               1  /* drain grey list, then mark WeakMap values */
+#define DUK_MS_INCR_PHASE_FINSCAN            2  /* walk heap_allocated for unreachable finalizable objects */
+#define DUK_MS_INCR_PHASE_MARK2              3  /* drain grey list, then finish marking atomically */
+#define DUK_MS_INCR_PHASE_SWEEP              4  /* walk heap_allocated, move garbage aside */
+#define DUK_MS_INCR_PHASE_REFCOUNT           5  /* refcount finalize garbage */
+#define DUK_MS_INCR_PHASE_FREE               6  /* free garbage */
+#define DUK_MS_INCR_PHASE_STRSWEEP           7  /* sweep string table buckets */
+
+/*
+ *  Nursery (minor) collection
+ *
+ *  While a minor collection is running heap->ms_minor_op selects what the
+ *  marking functions do to the nursery objects they visit; other objects
+ *  are not visited.
+ */
+
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+#if !defined(DUK_USE_REFERENCE_COUNTING) || !defined(DUK_USE_DOUBLE_LINKED_HEAP)
+#error DUK_USE_MARK_AND_SWEEP_NURSERY requires DUK_USE_REFERENCE_COUNTING and DUK_USE_DOUBLE_LINKED_HEAP
+#endif
+#if !defined(DUK_USE_VOLUNTARY_GC)
+#error DUK_USE_MARK_AND_SWEEP_NURSERY requires DUK_USE_VOLUNTARY_GC
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+#error DUK_USE_MARK_AND_SWEEP_NURSERY and DUK_USE_MARK_AND_SWEEP_INCREMENTAL cannot be used together
+#endif
+#endif
+
+/*
+ *  Background freeing
+ *
+ *  Garbage found by a sweep is detached from shared heap state on the
+ *  calling thread and chained into heap->ms_bgfree_batch.  At the end of
+ *  the collection the batch is handed to a helper thread which releases
+ *  the memory using heap->free_func.
+ */
+
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+#if defined(DUK_USE_HEAPPTR16)
+#error DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE cannot be used with DUK_USE_HEAPPTR16
+#endif
+#endif
+
+#define DUK_MS_MINOR_OP_NONE                 0  /* no minor collection running, normal marking */
+#define DUK_MS_MINOR_OP_DECREF               1  /* subtract references from nursery objects */
+#define DUK_MS_MINOR_OP_MARK                 2  /* mark nursery objects reachable */
+#define DUK_MS_MINOR_OP_INCREF               3  /* restore subtracted references */
+
 /*
  *  Thread switching
  *
@@ -91,7 +157,7 @@
  *  happens e.g. in call handling.
  */
 
-#if defined(DUK_USE_INTERRUPT_COUNTER)
+#if defined(DUK_USE_INTERRUPT_COUNTER) || defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
 #define DUK_HEAP_SWITCH_THREAD(heap,newthr)  duk_heap_switch_thread((heap), (newthr))
 #else
 #define DUK_HEAP_SWITCH_THREAD(heap,newthr)  do { \
@@ -135,6 +201,18 @@
 #define DUK_HEAP_MARK_AND_SWEEP_TRIGGER_SKIP              256L
 #endif
 
+/* Number of (re)allocations between incremental mark-and-sweep slices
+ * while a cycle is in progress.  Each slice does DUK_USE_MARK_AND_SWEEP_INCR_BUDGET
+ * units of work, so the budget must comfortably exceed this interval for
+ * a cycle to finish while the application keeps allocating.
+ */
+#define DUK_HEAP_MARK_AND_SWEEP_INCR_TRIGGER              256L
+
+/* Number of values whose refzero handling executor register writes may
+ * defer before the table is reconciled, see DUK_USE_REFZERO_DEFER.
+ */
+#define DUK_HEAP_REFZERO_DEFER_SIZE                       256
+
 /* GC torture. */
 #if defined(DUK_USE_GC_TORTURE)
 #define DUK_GC_TORTURE(heap) do { duk_heap_mark_and_sweep((heap), 0); } while (0)
@@ -148,6 +226,11 @@
 #define DUK_HEAP_STRCACHE_SIZE                            4
 #define DUK_HEAP_STRINGCACHE_NOCACHE_LIMIT                16  /* strings up to the this length are not cached */
 
+/* Number of duk_tvals per Promise job in heap->job_queue, see
+ * duk_bi_promise.c.
+ */
+#define DUK_HEAP_JOB_SIZE                                 4
+
 /* Some list management macros. */
 #define DUK_HEAP_INSERT_INTO_HEAP_ALLOCATED(heap,hdr)     duk_heap_insert_into_heap_allocated((heap), (hdr))
 #if defined(DUK_USE_REFERENCE_COUNTING)
@@ -300,6 +383,21 @@ struct duk_strcache_entry {
 	duk_uint32_t cidx;
 };
 
+/*
+ *  Mark stack for mark-and-sweep.  Objects whose children still need to
+ *  be marked are pushed onto a stack of fixed size chunks; the bottom
+ *  chunk is kept allocated between mark-and-sweep rounds.
+ */
+
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+#define DUK_MS_MARKCHUNK_SIZE  1024
+
+struct duk_ms_markchunk {
+	duk_ms_markchunk *prev;   /* next chunk down the stack, NULL for bottom chunk */
+	duk_heaphdr *items[DUK_MS_MARKCHUNK_SIZE];
+};
+#endif
+
 /*
  *  Longjmp state, contains the information needed to perform a longjmp.
  *  Longjmp related values are written to value1, value2, and iserror.
@@ -374,11 +472,23 @@ struct duk_heap {
 	duk_heaphdr *refzero_list;
 #endif
 
+	/* Values whose refcount dropped to zero in an executor register
+	 * write.  Each entry holds one counted reference which is released
+	 * when the table is reconciled; duplicates are allowed.
+	 */
+#if defined(DUK_USE_REFZERO_DEFER)
+	duk_heaphdr *refzero_defer[DUK_HEAP_REFZERO_DEFER_SIZE];
+	duk_uint_t refzero_defer_top;
+#endif
+
 #if defined(DUK_USE_FINALIZER_SUPPORT)
 	/* Work list for objects to be finalized. */
 	duk_heaphdr *finalize_list;
-#if defined(DUK_USE_ASSERTIONS)
-	/* Object whose finalizer is executing right now (no nesting). */
+#if defined(DUK_USE_ASSERTIONS) || defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* Object whose finalizer is executing right now (no nesting).  It's
+	 * on finalize_list without FINALIZABLE, so the incremental write
+	 * barrier must recognize it.
+	 */
 	duk_heaphdr *currently_finalizing;
 #endif
 #endif
@@ -404,6 +514,16 @@ struct duk_heap {
 	 */
 	duk_uint_t ms_recursion_depth;
 
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+	/* Explicit mark stack: current (topmost) chunk, number of used
+	 * entries in it, and a spare chunk to avoid allocation churn when
+	 * the stack size oscillates around a chunk boundary.
+	 */
+	duk_ms_markchunk *ms_mark_chunk;
+	duk_size_t ms_mark_top;
+	duk_ms_markchunk *ms_mark_spare;
+#endif
+
 	/* Mark-and-sweep flags automatically active (used for critical sections). */
 	duk_small_uint_t ms_base_flags;
 
@@ -420,6 +540,65 @@ struct duk_heap {
 	 */
 	duk_uint_t ms_prevent_count;
 
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* Incremental mark-and-sweep state.  Grey objects (REACHABLE and
+	 * TEMPROOT set) are moved from heap_allocated to ms_incr_grey until
+	 * scanned; scanned WeakMaps/WeakSets are kept on ms_incr_weak until
+	 * marking finishes.  ms_incr_cursor is the walk position in
+	 * heap_allocated or ms_incr_garbage, depending on the phase.
+	 */
+	duk_small_uint_t ms_incr_phase;
+	duk_small_uint_t ms_incr_marking;    /* write barrier active */
+	duk_small_uint_t ms_incr_flags;      /* DUK_MS_FLAG_xxx for the sweep */
+	duk_heaphdr *ms_incr_grey;
+	duk_heaphdr *ms_incr_weak;
+	duk_heaphdr *ms_incr_finalizable;
+	duk_heaphdr *ms_incr_garbage;
+	duk_heaphdr *ms_incr_cursor;
+#if defined(DUK_USE_HSTRING_ROPES)
+	duk_hstring_rope *ms_incr_rope_garbage;
+#endif
+	duk_uint32_t ms_incr_st_index;
+	duk_size_t ms_incr_count_keep;
+
+	/* Pause time statistics (milliseconds), see duk_inspect_heap(). */
+	duk_uint32_t ms_incr_cycles;
+	duk_uint32_t ms_incr_slices;
+	duk_double_t ms_incr_pause_last;
+	duk_double_t ms_incr_pause_max;
+	duk_double_t ms_incr_pause_total;
+#endif
+
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	/* Nursery: objects inserted into heap_allocated since the previous
+	 * collection are the list prefix before ms_old_head (NULL if the
+	 * whole list is young).  During a minor collection nursery objects
+	 * have TEMPROOT set and are moved to ms_minor_list and ms_minor_grey.
+	 */
+	duk_heaphdr *ms_old_head;
+	duk_uint32_t ms_young_count;
+	duk_small_uint_t ms_minor_op;
+	duk_heaphdr *ms_minor_list;
+	duk_heaphdr *ms_minor_grey;
+
+	/* Statistics, see duk_inspect_heap(). */
+	duk_uint32_t ms_minor_cycles;
+	duk_uint32_t ms_minor_freed;
+#endif
+
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+	/* Garbage swept by the current collection, not yet handed over. */
+	duk_heaphdr *ms_bgfree_batch;
+	duk_heaphdr *ms_bgfree_tail;     /* first queued header, valid if batch != NULL */
+
+	/* Helper thread state, created on first hand-over; NULL if not
+	 * started yet.  ms_bgfree_disabled is set if the thread could not
+	 * be started, garbage is then freed inline.
+	 */
+	duk_ms_bgfree *ms_bgfree;
+	duk_bool_t ms_bgfree_disabled;
+#endif
+
 	/* Finalizer processing prevent count, stacking.  Bumped when finalizers
 	 * are processed to prevent recursive finalizer processing (first call site
 	 * processing finalizers handles all finalizers until the list is empty).
@@ -562,6 +741,13 @@ struct duk_heap {
 	 */
 	duk_strcache_entry strcache[DUK_HEAP_STRCACHE_SIZE];
 
+#if defined(DUK_USE_HSTRING_ROPES)
+	/* Ropes are not in the string table; they're tracked in a doubly
+	 * linked list for mark-and-sweep and heap destruction.
+	 */
+	duk_hstring_rope *rope_list;
+#endif
+
 #if defined(DUK_USE_LITCACHE_SIZE)
 	/* Literal intern cache.  When enabled, strings interned as literals
 	 * (e.g. duk_push_literal()) will be pinned and cached for the lifetime
@@ -570,6 +756,30 @@ struct duk_heap {
 	duk_litcache_entry litcache[DUK_USE_LITCACHE_SIZE];
 #endif
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* Object shapes: empty root shape and the shape transition table
+	 * (weak refs), see duk_hshape.h.
+	 */
+	duk_hshape shape_root;
+	duk_hshape **shape_trans;
+	duk_uint32_t shape_trans_size;   /* number of buckets, power of two */
+	duk_uint32_t shape_trans_count;  /* number of shapes in table */
+	duk_uint32_t shape_mark_gen;     /* current mark-and-sweep marking round */
+	duk_uint32_t shape_next_id;      /* next shared shape id, DUK_HSHAPE_ID_NONE when exhausted */
+#endif
+
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	/* Promise job queue (ES2015 PromiseJobs), a FIFO of jobs of
+	 * DUK_HEAP_JOB_SIZE strong duk_tval references each.  Jobs are
+	 * appended by Promise built-ins and executed by duk_run_jobs().
+	 * Indices are in duk_tvals.
+	 */
+	duk_tval *job_queue;
+	duk_size_t job_head;             /* first queued entry */
+	duk_size_t job_tail;             /* one past last queued entry */
+	duk_size_t job_size;             /* allocated size */
+#endif
+
 	/* Built-in strings. */
 #if defined(DUK_USE_ROM_STRINGS)
 	/* No field needed when strings are in ROM. */
@@ -603,6 +813,8 @@ struct duk_heap {
 	duk_int_t stats_strtab_litcache_hit;
 	duk_int_t stats_strtab_litcache_miss;
 	duk_int_t stats_strtab_litcache_pin;
+	duk_int_t stats_strtab_rope_create;
+	duk_int_t stats_strtab_rope_flatten;
 	duk_int_t stats_object_realloc_props;
 	duk_int_t stats_object_abandon_array;
 	duk_int_t stats_getownpropdesc_count;
@@ -625,6 +837,8 @@ struct duk_heap {
 	duk_int_t stats_putprop_bufobjidx;
 	duk_int_t stats_putprop_bufferidx;
 	duk_int_t stats_putprop_proxy;
+	duk_int_t stats_propic_hit;
+	duk_int_t stats_propic_miss;
 	duk_int_t stats_getvar_all;
 	duk_int_t stats_putvar_all;
 #endif
@@ -657,7 +871,7 @@ DUK_INTERNAL_DECL void duk_heap_remove_from_finalize_list(duk_heap *heap, duk_he
 #if defined(DUK_USE_ASSERTIONS)
 DUK_INTERNAL_DECL duk_bool_t duk_heap_in_heap_allocated(duk_heap *heap, duk_heaphdr *ptr);
 #endif
-#if defined(DUK_USE_INTERRUPT_COUNTER)
+#if defined(DUK_USE_INTERRUPT_COUNTER) || defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
 DUK_INTERNAL_DECL void duk_heap_switch_thread(duk_heap *heap, duk_hthread *new_thr);
 #endif
 
@@ -703,6 +917,22 @@ DUK_INTERNAL_DECL void duk_heap_process_finalize_list(duk_heap *heap);
 #endif  /* DUK_USE_FINALIZER_SUPPORT */
 
 DUK_INTERNAL_DECL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags);
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+DUK_INTERNAL_DECL void duk_heap_mark_and_sweep_minor(duk_heap *heap);
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+DUK_INTERNAL_DECL void duk_heap_bgfree_heaphdr(duk_heap *heap, duk_heaphdr *hdr);
+DUK_INTERNAL_DECL void duk_heap_bgfree_flush(duk_heap *heap, duk_bool_t wait);
+DUK_INTERNAL_DECL void duk_heap_bgfree_shutdown(duk_heap *heap);
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+DUK_INTERNAL_DECL void duk_heap_ms_incr_shade(duk_heap *heap, duk_heaphdr *h);
+DUK_INTERNAL_DECL void duk_heap_ms_incr_blacken_thread(duk_heap *heap, duk_hthread *thr);
+DUK_INTERNAL_DECL void duk_heap_ms_incr_unlink(duk_heap *heap, duk_heaphdr *hdr);
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+DUK_INTERNAL_DECL void duk_heap_ms_incr_requeue(duk_heap *heap, duk_heaphdr *hdr);
+#endif
+#endif
 
 DUK_INTERNAL_DECL duk_uint32_t duk_heap_hashstring(duk_heap *heap, const duk_uint8_t *str, duk_size_t len);
 
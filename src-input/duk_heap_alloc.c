@@ -23,11 +23,31 @@ DUK_INTERNAL void duk_free_hobject(duk_heap *heap, duk_hobject *h) {
 	DUK_ASSERT(h != NULL);
 
 	DUK_FREE(heap, DUK_HOBJECT_GET_PROPS(heap, h));
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* Shape is normally released by refcount finalization; if not (heap
+	 * destruction, no refcounting) release it without touching keys.
+	 */
+	if (h->shape != NULL) {
+		duk_hshape_decref(heap, h->shape, 0 /*decref_keys*/);
+	}
+#endif
 
 	if (DUK_HOBJECT_IS_COMPFUNC(h)) {
 		duk_hcompfunc *f = (duk_hcompfunc *) h;
 		DUK_UNREF(f);
-		/* Currently nothing to free; 'data' is a heap object */
+		/* 'data' is a heap object, only the inline cache and JIT
+		 * state are freed here.
+		 */
+#if defined(DUK_USE_PROP_IC)
+		if (f->propic != NULL) {
+			duk_propic_decref(heap, f->propic);
+		}
+#endif
+#if defined(DUK_USE_JIT_X64)
+		if (f->jit != NULL) {
+			duk_jit_x64_decref(heap, f->jit);
+		}
+#endif
 	} else if (DUK_HOBJECT_IS_NATFUNC(h)) {
 		duk_hnatfunc *f = (duk_hnatfunc *) h;
 		DUK_UNREF(f);
@@ -69,6 +89,18 @@ DUK_INTERNAL void duk_free_hobject(duk_heap *heap, duk_hobject *h) {
 		duk_hboundfunc *f = (duk_hboundfunc *) (void *) h;
 
 		DUK_FREE(heap, f->args);
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	} else if (DUK_HOBJECT_IS_PROMISE(h)) {
+		duk_hpromise *p = (duk_hpromise *) h;
+
+		DUK_FREE(heap, p->reactions);
+#endif
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	} else if (DUK_HOBJECT_IS_MAPSET(h)) {
+		duk_hmapset *m = (duk_hmapset *) h;
+
+		DUK_FREE(heap, m->entries);
+#endif
 	}
 
 	DUK_FREE(heap, (void *) h);
@@ -398,6 +430,11 @@ DUK_INTERNAL void duk_heap_free(duk_heap *heap) {
 	 * are on the heap allocated list.
 	 */
 
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+	DUK_D(DUK_DPRINT("stopping background free thread"));
+	duk_heap_bgfree_shutdown(heap);
+#endif
+
 	DUK_D(DUK_DPRINT("freeing temporary freelists"));
 	duk_heap_free_freelists(heap);
 
@@ -413,6 +450,31 @@ DUK_INTERNAL void duk_heap_free(duk_heap *heap) {
 	duk__free_finalize_list(heap);
 #endif
 
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	/* Queued jobs are not executed, the values they reference have
+	 * already been freed above.
+	 */
+	DUK_D(DUK_DPRINT("freeing job queue of heap: %p", (void *) heap));
+	DUK_FREE(heap, heap->job_queue);
+#endif
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	DUK_D(DUK_DPRINT("freeing shape transition table of heap: %p", (void *) heap));
+	duk_hshape_heap_free(heap);
+#endif
+
+#if defined(DUK_USE_HSTRING_ROPES)
+	DUK_D(DUK_DPRINT("freeing rope list of heap: %p", (void *) heap));
+	duk_hstring_rope_free_all(heap);
+#endif
+
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+	DUK_D(DUK_DPRINT("freeing mark stack of heap: %p", (void *) heap));
+	DUK_ASSERT(heap->ms_mark_chunk == NULL || heap->ms_mark_chunk->prev == NULL);
+	DUK_ASSERT(heap->ms_mark_spare == NULL);
+	DUK_FREE_RAW(heap, heap->ms_mark_chunk);
+#endif
+
 	DUK_D(DUK_DPRINT("freeing string table of heap: %p", (void *) heap));
 	duk__free_stringtable(heap);
 
@@ -503,10 +565,13 @@ DUK_LOCAL duk_bool_t duk__init_heap_strings(duk_heap *heap) {
 
 		DUK_DDD(DUK_DDDPRINT("interned: %!O", (duk_heaphdr *) h));
 
-		/* XXX: The incref macro takes a thread pointer but doesn't
-		 * use it right now.
+		/* No thread exists yet so the INCREF macros (which use the
+		 * thread for the write barrier) can't be used; there's no
+		 * mark-and-sweep in progress during heap init.
 		 */
-		DUK_HSTRING_INCREF(_never_referenced_, h);
+#if defined(DUK_USE_REFERENCE_COUNTING)
+		DUK_HEAPHDR_PREINC_REFCOUNT((duk_heaphdr *) h);
+#endif
 
 #if defined(DUK_USE_HEAPPTR16)
 		heap->strs16[i] = DUK_USE_HEAPPTR_ENC16(heap->heap_udata, (void *) h);
@@ -675,6 +740,12 @@ DUK_LOCAL void duk__dump_type_sizes(void) {
 	DUK__DUMPSZ(duk_hbufobj);
 #endif
 	DUK__DUMPSZ(duk_hproxy);
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	DUK__DUMPSZ(duk_hpromise);
+#endif
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	DUK__DUMPSZ(duk_hmapset);
+#endif
 	DUK__DUMPSZ(duk_hbuffer);
 	DUK__DUMPSZ(duk_hbuffer_fixed);
 	DUK__DUMPSZ(duk_hbuffer_dynamic);
@@ -909,10 +980,34 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 #endif
 #if defined(DUK_USE_FINALIZER_SUPPORT)
 	res->finalize_list = NULL;
-#if defined(DUK_USE_ASSERTIONS)
+#if defined(DUK_USE_ASSERTIONS) || defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
 	res->currently_finalizing = NULL;
 #endif
 #endif
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	res->ms_old_head = NULL;
+	res->ms_minor_list = NULL;
+	res->ms_minor_grey = NULL;
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+	res->ms_mark_chunk = NULL;
+	res->ms_mark_spare = NULL;
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+	res->ms_bgfree_batch = NULL;
+	res->ms_bgfree_tail = NULL;
+	res->ms_bgfree = NULL;
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	res->ms_incr_grey = NULL;
+	res->ms_incr_weak = NULL;
+	res->ms_incr_finalizable = NULL;
+	res->ms_incr_garbage = NULL;
+	res->ms_incr_cursor = NULL;
+#if defined(DUK_USE_HSTRING_ROPES)
+	res->ms_incr_rope_garbage = NULL;
+#endif
+#endif
 #if defined(DUK_USE_CACHE_ACTIVATION)
 	res->activation_free = NULL;
 #endif
@@ -922,6 +1017,12 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	res->heap_thread = NULL;
 	res->curr_thread = NULL;
 	res->heap_object = NULL;
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	res->job_queue = NULL;
+#endif
+#if defined(DUK_USE_HSTRING_ROPES)
+	res->rope_list = NULL;
+#endif
 #if defined(DUK_USE_STRTAB_PTRCOMP)
 	res->strtable16 = NULL;
 #else
@@ -978,6 +1079,11 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	res->call_recursion_depth = 0;
 	res->call_recursion_limit = DUK_USE_NATIVE_CALL_RECLIMIT;
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* Root shape must be ready before any objects are created. */
+	duk_hshape_heap_init(res);
+#endif
+
 	/* XXX: use the pointer as a seed for now: mix in time at least */
 
 	/* The casts through duk_uintptr_t is to avoid the following GCC warning:
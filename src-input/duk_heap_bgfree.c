@@ -0,0 +1,251 @@
+/*
+ *  Background freeing of mark-and-sweep garbage (DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE).
+ *
+ *  Marking, refcount finalization and unlinking garbage from the heap
+ *  lists and the string table all happen on the thread running the
+ *  collection as before.  Only the final release of the memory (object
+ *  property tables, value stacks, callstacks, buffer data and the heap
+ *  headers themselves) is handed to a helper thread.
+ *
+ *  Before an object is queued everything which points to shared heap
+ *  state (shape, property inline cache, JIT code) is released on the
+ *  calling thread, so that the helper only touches memory owned by the
+ *  garbage itself and calls heap->free_func.  The allocation functions
+ *  must therefore be thread safe, which is the case for the default
+ *  malloc() based providers.
+ *
+ *  Garbage is chained through the heap header 'next' pointers into a
+ *  batch during the sweep and the batch is handed over once per
+ *  collection, so the mutex is taken only once per collection.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+
+#include <pthread.h>
+
+struct duk_ms_bgfree {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond_work;   /* signaled when 'pending' or 'stop' changes */
+	pthread_cond_t cond_idle;   /* signaled when the helper finishes a batch */
+	pthread_t thread;
+	duk_heap *heap;
+	duk_heaphdr *pending;       /* batches handed over, not yet taken */
+	duk_bool_t busy;            /* helper is freeing a batch */
+	duk_bool_t stop;
+};
+
+DUK_LOCAL void duk__bgfree_list(duk_heap *heap, duk_heaphdr *curr) {
+	duk_heaphdr *next;
+
+	while (curr != NULL) {
+		next = DUK_HEAPHDR_GET_NEXT(heap, curr);
+		duk_heap_free_heaphdr_raw(heap, curr);
+		curr = next;
+	}
+}
+
+DUK_LOCAL void *duk__bgfree_main(void *udata) {
+	duk_ms_bgfree *bg;
+	duk_heaphdr *list;
+
+	bg = (duk_ms_bgfree *) udata;
+
+	pthread_mutex_lock(&bg->mutex);
+	for (;;) {
+		while (bg->pending == NULL && !bg->stop) {
+			pthread_cond_wait(&bg->cond_work, &bg->mutex);
+		}
+		if (bg->pending == NULL) {
+			DUK_ASSERT(bg->stop);
+			break;
+		}
+		list = bg->pending;
+		bg->pending = NULL;
+		bg->busy = 1;
+		pthread_mutex_unlock(&bg->mutex);
+
+		duk__bgfree_list(bg->heap, list);
+
+		pthread_mutex_lock(&bg->mutex);
+		bg->busy = 0;
+		pthread_cond_broadcast(&bg->cond_idle);
+	}
+	pthread_mutex_unlock(&bg->mutex);
+
+	return NULL;
+}
+
+DUK_LOCAL duk_ms_bgfree *duk__bgfree_start(duk_heap *heap) {
+	duk_ms_bgfree *bg;
+
+	bg = (duk_ms_bgfree *) DUK_ALLOC_RAW(heap, sizeof(duk_ms_bgfree));
+	if (bg == NULL) {
+		return NULL;
+	}
+	bg->heap = heap;
+	bg->pending = NULL;
+	bg->busy = 0;
+	bg->stop = 0;
+
+	if (pthread_mutex_init(&bg->mutex, NULL) != 0) {
+		goto fail_mutex;
+	}
+	if (pthread_cond_init(&bg->cond_work, NULL) != 0) {
+		goto fail_cond_work;
+	}
+	if (pthread_cond_init(&bg->cond_idle, NULL) != 0) {
+		goto fail_cond_idle;
+	}
+	if (pthread_create(&bg->thread, NULL, duk__bgfree_main, (void *) bg) != 0) {
+		goto fail_thread;
+	}
+	DUK_D(DUK_DPRINT("started background free thread"));
+	return bg;
+
+ fail_thread:
+	pthread_cond_destroy(&bg->cond_idle);
+ fail_cond_idle:
+	pthread_cond_destroy(&bg->cond_work);
+ fail_cond_work:
+	pthread_mutex_destroy(&bg->mutex);
+ fail_mutex:
+	DUK_FREE_RAW(heap, (void *) bg);
+	return NULL;
+}
+
+/* Queue an unreachable heap header, already unlinked from all heap lists
+ * and the string table, for freeing.  Equivalent to duk_heap_free_heaphdr_raw()
+ * once duk_heap_bgfree_flush() has been called.
+ */
+DUK_INTERNAL void duk_heap_bgfree_heaphdr(duk_heap *heap, duk_heaphdr *hdr) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(hdr != NULL);
+
+	switch (DUK_HEAPHDR_GET_TYPE(hdr)) {
+	case DUK_HTYPE_STRING:
+#if defined(DUK_USE_HSTRING_EXTDATA) && defined(DUK_USE_EXTSTR_FREE)
+		/* The extstr free callback is user code, call it here. */
+		if (DUK_HSTRING_HAS_EXTDATA((duk_hstring *) hdr)) {
+			duk_free_hstring(heap, (duk_hstring *) hdr);
+			return;
+		}
+#endif
+		break;
+	case DUK_HTYPE_OBJECT: {
+		duk_hobject *h = (duk_hobject *) hdr;
+		DUK_UNREF(h);
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+		if (h->shape != NULL) {
+			duk_hshape_decref(heap, h->shape, 0 /*decref_keys*/);
+			h->shape = NULL;
+		}
+#endif
+		if (DUK_HOBJECT_IS_COMPFUNC(h)) {
+			duk_hcompfunc *f = (duk_hcompfunc *) h;
+			DUK_UNREF(f);
+#if defined(DUK_USE_PROP_IC)
+			if (f->propic != NULL) {
+				duk_propic_decref(heap, f->propic);
+				f->propic = NULL;
+			}
+#endif
+#if defined(DUK_USE_JIT_X64)
+			if (f->jit != NULL) {
+				duk_jit_x64_decref(heap, f->jit);
+				f->jit = NULL;
+			}
+#endif
+		}
+		break;
+	}
+	default:
+		DUK_ASSERT(DUK_HEAPHDR_GET_TYPE(hdr) == DUK_HTYPE_BUFFER);
+		break;
+	}
+
+	if (heap->ms_bgfree_batch == NULL) {
+		heap->ms_bgfree_tail = hdr;
+	}
+	DUK_HEAPHDR_SET_NEXT(heap, hdr, heap->ms_bgfree_batch);
+	heap->ms_bgfree_batch = hdr;
+}
+
+/* Hand the current batch over to the helper thread, starting it if
+ * necessary.  With 'wait' set, return only when all garbage queued so
+ * far has been freed, e.g. so that an allocation retried after an
+ * emergency GC can use the memory.
+ */
+DUK_INTERNAL void duk_heap_bgfree_flush(duk_heap *heap, duk_bool_t wait) {
+	duk_ms_bgfree *bg;
+	duk_heaphdr *batch;
+
+	DUK_ASSERT(heap != NULL);
+
+	batch = heap->ms_bgfree_batch;
+	heap->ms_bgfree_batch = NULL;
+
+	bg = heap->ms_bgfree;
+	if (bg == NULL && batch != NULL && !heap->ms_bgfree_disabled) {
+		bg = duk__bgfree_start(heap);
+		if (bg == NULL) {
+			DUK_D(DUK_DPRINT("failed to start background free thread, free inline"));
+			heap->ms_bgfree_disabled = 1;
+		}
+		heap->ms_bgfree = bg;
+	}
+	if (bg == NULL) {
+		duk__bgfree_list(heap, batch);
+		return;
+	}
+
+	pthread_mutex_lock(&bg->mutex);
+	if (batch != NULL) {
+		DUK_ASSERT(DUK_HEAPHDR_GET_NEXT(heap, heap->ms_bgfree_tail) == NULL);
+		DUK_HEAPHDR_SET_NEXT(heap, heap->ms_bgfree_tail, bg->pending);
+		bg->pending = batch;
+		pthread_cond_signal(&bg->cond_work);
+	}
+	if (wait) {
+		while (bg->pending != NULL || bg->busy) {
+			pthread_cond_wait(&bg->cond_idle, &bg->mutex);
+		}
+	}
+	pthread_mutex_unlock(&bg->mutex);
+}
+
+/* Free all queued garbage and stop the helper thread, called in heap
+ * destruction before heap->free_func() becomes unusable.
+ */
+DUK_INTERNAL void duk_heap_bgfree_shutdown(duk_heap *heap) {
+	duk_ms_bgfree *bg;
+
+	DUK_ASSERT(heap != NULL);
+
+	bg = heap->ms_bgfree;
+	if (bg == NULL) {
+		duk__bgfree_list(heap, heap->ms_bgfree_batch);
+		heap->ms_bgfree_batch = NULL;
+		return;
+	}
+
+	duk_heap_bgfree_flush(heap, 0 /*wait*/);
+
+	pthread_mutex_lock(&bg->mutex);
+	bg->stop = 1;
+	pthread_cond_signal(&bg->cond_work);
+	pthread_mutex_unlock(&bg->mutex);
+	pthread_join(bg->thread, NULL);  /* Helper exits only when 'pending' is empty. */
+	DUK_ASSERT(bg->pending == NULL);
+
+	pthread_cond_destroy(&bg->cond_idle);
+	pthread_cond_destroy(&bg->cond_work);
+	pthread_mutex_destroy(&bg->mutex);
+	DUK_FREE_RAW(heap, (void *) bg);
+	heap->ms_bgfree = NULL;
+	DUK_D(DUK_DPRINT("stopped background free thread"));
+}
+
+#endif  /* DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE */
@@ -182,7 +182,7 @@ DUK_INTERNAL void duk_heap_process_finalize_list(duk_heap *heap) {
 		DUK_ASSERT(!DUK_HEAPHDR_HAS_FINALIZED(curr));   /* Queueing code ensures. */
 		DUK_ASSERT(!DUK_HEAPHDR_HAS_READONLY(curr));  /* ROM objects never get freed (or finalized). */
 
-#if defined(DUK_USE_ASSERTIONS)
+#if defined(DUK_USE_ASSERTIONS) || defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
 		DUK_ASSERT(heap->currently_finalizing == NULL);
 		heap->currently_finalizing = curr;
 #endif
@@ -211,6 +211,15 @@ DUK_INTERNAL void duk_heap_process_finalize_list(duk_heap *heap) {
 			had_zero_refcount = (DUK_HEAPHDR_GET_REFCOUNT(curr) == 1);  /* Preincremented on finalize_list insert. */
 #endif
 
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+			/* The finalizer may touch (and thus shade) finalized
+			 * objects which are otherwise unreachable, so their
+			 * rescue decisions must wait for the next cycle.
+			 */
+			if (heap->ms_incr_marking) {
+				heap->ms_incr_flags |= DUK_MS_FLAG_POSTPONE_RESCUE;
+			}
+#endif
 			DUK_ASSERT(!DUK_HEAPHDR_HAS_FINALIZED(curr));
 			duk_heap_run_finalizer(heap, (duk_hobject *) curr);  /* must never longjmp */
 			DUK_ASSERT(DUK_HEAPHDR_HAS_FINALIZED(curr));
@@ -278,6 +287,9 @@ DUK_INTERNAL void duk_heap_process_finalize_list(duk_heap *heap) {
 			DUK_HEAPHDR_PREDEC_REFCOUNT(curr);  /* Remove artificial refcount bump. */
 			DUK_HEAPHDR_CLEAR_FINALIZABLE(curr);
 			DUK_HEAP_INSERT_INTO_HEAP_ALLOCATED(heap, curr);
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+			duk_heap_ms_incr_requeue(heap, curr);
+#endif
 		} else {
 			/* No need to remove the refcount bump here. */
 			DUK_ASSERT(DUK_HEAPHDR_GET_TYPE(curr) == DUK_HTYPE_OBJECT);  /* currently, always the case */
@@ -295,7 +307,7 @@ DUK_INTERNAL void duk_heap_process_finalize_list(duk_heap *heap) {
 		count++;
 #endif
 
-#if defined(DUK_USE_ASSERTIONS)
+#if defined(DUK_USE_ASSERTIONS) || defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
 		DUK_ASSERT(heap->currently_finalizing != NULL);
 		heap->currently_finalizing = NULL;
 #endif
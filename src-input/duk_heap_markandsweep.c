@@ -8,6 +8,9 @@ DUK_LOCAL_DECL void duk__mark_heaphdr(duk_heap *heap, duk_heaphdr *h);
 DUK_LOCAL_DECL void duk__mark_heaphdr_nonnull(duk_heap *heap, duk_heaphdr *h);
 DUK_LOCAL_DECL void duk__mark_tval(duk_heap *heap, duk_tval *tv);
 DUK_LOCAL_DECL void duk__mark_tvals(duk_heap *heap, duk_tval *tv, duk_idx_t count);
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+DUK_LOCAL_DECL void duk__ms_minor_visit(duk_heap *heap, duk_heaphdr *h);
+#endif
 
 /*
  *  Marking functions for heap types: mark children recursively.
@@ -20,8 +23,58 @@ DUK_LOCAL void duk__mark_hstring(duk_heap *heap, duk_hstring *h) {
 	DUK_DDD(DUK_DDDPRINT("duk__mark_hstring: %p", (void *) h));
 	DUK_ASSERT(h);
 
+#if defined(DUK_USE_HSTRING_ROPES)
+	/* Ropes reference other strings.  The right child and the flattened
+	 * result are plain strings; the left spine may be arbitrarily long
+	 * so it's walked iteratively, inlining duk__mark_heaphdr().
+	 */
+	while (DUK_HSTRING_IS_ROPE(h)) {
+		duk_hstring_rope *r = (duk_hstring_rope *) h;
+
+		duk__mark_heaphdr(heap, (duk_heaphdr *) r->right);
+		duk__mark_heaphdr(heap, (duk_heaphdr *) r->flat);
+
+		h = r->left;
+		if (h == NULL) {
+			break;
+		}
+#if defined(DUK_USE_ASSERTIONS) && defined(DUK_USE_REFERENCE_COUNTING)
+		if (!DUK_HEAPHDR_HAS_READONLY((duk_heaphdr *) h)) {
+			((duk_heaphdr *) h)->h_assert_refcount++;
+		}
+#endif
+		if (DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) h)) {
+			break;
+		}
+		DUK_HEAPHDR_SET_REACHABLE((duk_heaphdr *) h);
+	}
+#else
 	/* nothing to process */
+#endif
+}
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+/* Mark the keys of a shape and its ancestors.  Shapes are shared, so each
+ * key table is marked only once per mark-and-sweep round; this keeps the
+ * comparison refcounts exact (one reference per key table slot).
+ */
+DUK_LOCAL void duk__mark_hshape(duk_heap *heap, duk_hshape *s) {
+	duk_uint32_t gen;
+
+	gen = heap->shape_mark_gen;
+	while (s != NULL && s->mark_gen != gen) {
+		s->mark_gen = gen;
+		if (s->owner == s) {
+			duk_uint32_t i;
+
+			for (i = 0; i < s->tab_size; i++) {
+				duk__mark_heaphdr(heap, (duk_heaphdr *) s->keys[i]);
+			}
+		}
+		s = s->parent;
+	}
 }
+#endif  /* DUK_USE_HOBJECT_SHAPES */
 
 DUK_LOCAL void duk__mark_hobject(duk_heap *heap, duk_hobject *h) {
 	duk_uint_fast32_t i;
@@ -32,12 +85,17 @@ DUK_LOCAL void duk__mark_hobject(duk_heap *heap, duk_hobject *h) {
 
 	/* XXX: use advancing pointers instead of index macros -> faster and smaller? */
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	duk__mark_hshape(heap, h->shape);
+#endif
 	for (i = 0; i < (duk_uint_fast32_t) DUK_HOBJECT_GET_ENEXT(h); i++) {
 		duk_hstring *key = DUK_HOBJECT_E_GET_KEY(heap, h, i);
 		if (key == NULL) {
 			continue;
 		}
+#if !defined(DUK_USE_HOBJECT_SHAPES)
 		duk__mark_heaphdr_nonnull(heap, (duk_heaphdr *) key);
+#endif
 		if (DUK_HOBJECT_E_SLOT_IS_ACCESSOR(heap, h, i)) {
 			duk__mark_heaphdr(heap, (duk_heaphdr *) DUK_HOBJECT_E_GET_VALUE_PTR(heap, h, i)->a.get);
 			duk__mark_heaphdr(heap, (duk_heaphdr *) DUK_HOBJECT_E_GET_VALUE_PTR(heap, h, i)->a.set);
@@ -126,6 +184,22 @@ DUK_LOCAL void duk__mark_hobject(duk_heap *heap, duk_hobject *h) {
 		duk__mark_heaphdr_nonnull(heap, (duk_heaphdr *) p->target);
 		duk__mark_heaphdr_nonnull(heap, (duk_heaphdr *) p->handler);
 #endif  /* DUK_USE_ES6_PROXY */
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	} else if (DUK_HOBJECT_IS_PROMISE(h)) {
+		duk_hpromise *p = (duk_hpromise *) h;
+		DUK_ASSERT_HPROMISE_VALID(p);
+		duk__mark_tval(heap, &p->result);
+		duk__mark_tvals(heap, p->reactions, (duk_idx_t) (p->reactions_count * DUK_HPROMISE_REACTION_SIZE));
+#endif  /* DUK_USE_PROMISE_BUILTIN */
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	} else if (DUK_HOBJECT_IS_MAPSET(h)) {
+		duk_hmapset *m = (duk_hmapset *) h;
+		DUK_ASSERT_HMAPSET_VALID(m);
+		/* Weak entries are handled by duk__mark_weak_mapsets(). */
+		if (!DUK_HMAPSET_IS_WEAK(m)) {
+			duk__mark_tvals(heap, m->entries, (duk_idx_t) (m->e_used * DUK_HMAPSET_GET_STRIDE(m)));
+		}
+#endif  /* DUK_USE_MAP_SET_BUILTIN */
 	} else if (DUK_HOBJECT_IS_THREAD(h)) {
 		duk_hthread *t = (duk_hthread *) h;
 		duk_activation *act;
@@ -167,6 +241,93 @@ DUK_LOCAL void duk__mark_hobject(duk_heap *heap, duk_hobject *h) {
 	}
 }
 
+/*
+ *  Explicit mark stack.
+ *
+ *  With DUK_USE_MARK_AND_SWEEP_MARK_STACK duk__mark_heaphdr() doesn't
+ *  recurse into objects: it marks them reachable and pushes them onto the
+ *  mark stack, and duk__mark_stack_drain() marks their children later.
+ *  The stack grows in chunks allocated with raw allocation calls, which
+ *  never trigger GC.  If a chunk allocation fails, the object is marked
+ *  as a temproot instead, like when hitting the recursion limit, and the
+ *  heap scan in duk__mark_temproots_by_heap_scan() picks it up.
+ */
+
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+DUK_LOCAL void duk__mark_stack_push(duk_heap *heap, duk_heaphdr *h) {
+	duk_ms_markchunk *c;
+
+	DUK_ASSERT(h != NULL);
+	DUK_ASSERT(DUK_HEAPHDR_IS_OBJECT(h));
+
+	c = heap->ms_mark_chunk;
+	if (DUK_UNLIKELY(c == NULL || heap->ms_mark_top >= DUK_MS_MARKCHUNK_SIZE)) {
+		duk_ms_markchunk *c_new;
+
+		c_new = heap->ms_mark_spare;
+		if (c_new != NULL) {
+			heap->ms_mark_spare = NULL;
+		} else {
+			c_new = (duk_ms_markchunk *) DUK_ALLOC_RAW(heap, sizeof(duk_ms_markchunk));
+			if (DUK_UNLIKELY(c_new == NULL)) {
+				DUK_D(DUK_DPRINT("failed to grow mark stack, marking as temproot: %p", (void *) h));
+				DUK_HEAP_SET_MARKANDSWEEP_RECLIMIT_REACHED(heap);
+				DUK_HEAPHDR_SET_TEMPROOT(h);
+				return;
+			}
+			DUK_DD(DUK_DDPRINT("allocated mark stack chunk: %p", (void *) c_new));
+		}
+		c_new->prev = c;
+		heap->ms_mark_chunk = c_new;
+		heap->ms_mark_top = 0;
+		c = c_new;
+	}
+
+	c->items[heap->ms_mark_top++] = h;
+}
+
+/* Mark children of queued objects until the stack is empty.  Marking may
+ * push more objects, so this is a single pass over the reachable graph.
+ */
+DUK_LOCAL void duk__mark_stack_drain(duk_heap *heap) {
+	duk_ms_markchunk *c;
+	duk_heaphdr *h;
+
+	for (;;) {
+		c = heap->ms_mark_chunk;
+		if (c == NULL) {
+			break;
+		}
+		if (heap->ms_mark_top == 0) {
+			if (c->prev == NULL) {
+				break;
+			}
+			/* Top chunk is empty, continue with the one below it
+			 * and keep the empty chunk as a spare.
+			 */
+			if (heap->ms_mark_spare != NULL) {
+				DUK_FREE_RAW(heap, heap->ms_mark_spare);
+			}
+			heap->ms_mark_spare = c;
+			heap->ms_mark_chunk = c->prev;
+			heap->ms_mark_top = DUK_MS_MARKCHUNK_SIZE;
+			continue;
+		}
+
+		h = c->items[--heap->ms_mark_top];
+		DUK_ASSERT(h != NULL);
+		DUK_ASSERT(DUK_HEAPHDR_HAS_REACHABLE(h));
+		duk__mark_hobject(heap, (duk_hobject *) h);
+	}
+
+	/* Only the bottom chunk is kept between mark-and-sweep rounds. */
+	if (heap->ms_mark_spare != NULL) {
+		DUK_FREE_RAW(heap, heap->ms_mark_spare);
+		heap->ms_mark_spare = NULL;
+	}
+}
+#endif  /* DUK_USE_MARK_AND_SWEEP_MARK_STACK */
+
 /* Mark any duk_heaphdr type.  Recursion tracking happens only here. */
 DUK_LOCAL void duk__mark_heaphdr(duk_heap *heap, duk_heaphdr *h) {
 	DUK_DDD(DUK_DDDPRINT("duk__mark_heaphdr %p, type %ld",
@@ -178,6 +339,24 @@ DUK_LOCAL void duk__mark_heaphdr(duk_heap *heap, duk_heaphdr *h) {
 		return;
 	}
 
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	/* Minor collection only looks at nursery objects. */
+	if (heap->ms_minor_op != DUK_MS_MINOR_OP_NONE) {
+		duk__ms_minor_visit(heap, h);
+		return;
+	}
+#endif
+
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* Incremental marking never recurses: children are just shaded. */
+	if (heap->ms_incr_marking) {
+		if (!DUK_HEAPHDR_HAS_REACHABLE(h)) {
+			duk_heap_ms_incr_shade(heap, h);
+		}
+		return;
+	}
+#endif
+
 	DUK_ASSERT(!DUK_HEAPHDR_HAS_READONLY(h) || DUK_HEAPHDR_HAS_REACHABLE(h));
 
 #if defined(DUK_USE_ASSERTIONS) && defined(DUK_USE_REFERENCE_COUNTING)
@@ -198,6 +377,34 @@ DUK_LOCAL void duk__mark_heaphdr(duk_heap *heap, duk_heaphdr *h) {
 
 	DUK_HEAPHDR_SET_REACHABLE(h);
 
+#if defined(DUK_USE_HSTRING_ROPES)
+	/* Strings are not on heap_allocated so they can't be temproots, but
+	 * marking them never recurses more than one level.
+	 */
+	if (DUK_HEAPHDR_IS_STRING(h)) {
+		duk__mark_hstring(heap, (duk_hstring *) h);
+		return;
+	}
+#endif
+
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+	/* Objects are queued, strings and buffers never recurse. */
+	switch (DUK_HEAPHDR_GET_TYPE(h)) {
+	case DUK_HTYPE_STRING:
+		duk__mark_hstring(heap, (duk_hstring *) h);
+		break;
+	case DUK_HTYPE_OBJECT:
+		duk__mark_stack_push(heap, h);
+		break;
+	case DUK_HTYPE_BUFFER:
+		/* nothing to mark */
+		break;
+	default:
+		DUK_D(DUK_DPRINT("attempt to mark heaphdr %p with invalid htype %ld", (void *) h, (long) DUK_HEAPHDR_GET_TYPE(h)));
+		DUK_UNREACHABLE();
+	}
+	return;
+#else  /* DUK_USE_MARK_AND_SWEEP_MARK_STACK */
 	if (heap->ms_recursion_depth >= DUK_USE_MARK_AND_SWEEP_RECLIMIT) {
 		DUK_D(DUK_DPRINT("mark-and-sweep recursion limit reached, marking as temproot: %p", (void *) h));
 		DUK_HEAP_SET_MARKANDSWEEP_RECLIMIT_REACHED(heap);
@@ -225,6 +432,7 @@ DUK_LOCAL void duk__mark_heaphdr(duk_heap *heap, duk_heaphdr *h) {
 
 	DUK_ASSERT(heap->ms_recursion_depth > 0);
 	heap->ms_recursion_depth--;
+#endif  /* DUK_USE_MARK_AND_SWEEP_MARK_STACK */
 }
 
 DUK_LOCAL void duk__mark_tval(duk_heap *heap, duk_tval *tv) {
@@ -282,6 +490,10 @@ DUK_LOCAL void duk__mark_roots_heap(duk_heap *heap) {
 	duk__mark_tval(heap, &heap->lj.value1);
 	duk__mark_tval(heap, &heap->lj.value2);
 
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	duk__mark_tvals(heap, heap->job_queue + heap->job_head, (duk_idx_t) (heap->job_tail - heap->job_head));
+#endif
+
 #if defined(DUK_USE_DEBUGGER_SUPPORT)
 	for (i = 0; i < heap->dbg_breakpoint_count; i++) {
 		duk__mark_heaphdr(heap, (duk_heaphdr *) heap->dbg_breakpoints[i].filename);
@@ -443,6 +655,13 @@ DUK_LOCAL void duk__mark_temproots_by_heap_scan(duk_heap *heap) {
 
 	DUK_DD(DUK_DDPRINT("duk__mark_temproots_by_heap_scan: %p", (void *) heap));
 
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+	/* Finish marking queued objects first; temproots only remain if the
+	 * mark stack couldn't be grown.
+	 */
+	duk__mark_stack_drain(heap);
+#endif
+
 	while (DUK_HEAP_HAS_MARKANDSWEEP_RECLIMIT_REACHED(heap)) {
 		DUK_DD(DUK_DDPRINT("recursion limit reached, doing heap scan to continue from temproots"));
 
@@ -473,12 +692,156 @@ DUK_LOCAL void duk__mark_temproots_by_heap_scan(duk_heap *heap) {
 		}
 #endif
 
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+		duk__mark_stack_drain(heap);
+#endif
+
 #if defined(DUK_USE_DEBUG)
 		DUK_DD(DUK_DDPRINT("temproot mark heap scan processed %ld temp roots", (long) count));
 #endif
 	}
 }
 
+/*
+ *  WeakMap and WeakSet handling.
+ *
+ *  Weak keys are not marked.  A WeakMap value is marked only when both the
+ *  WeakMap and the key are reachable through other references, which may
+ *  make further keys reachable, so iterate until no new values get marked
+ *  (ephemeron fixpoint).  The loop is potentially quadratic but each round
+ *  is a plain heap scan and weak tables are rare.
+ *
+ *  Once marking is complete, entries with unreachable keys are removed from
+ *  surviving weak tables before sweeping; the keys are then freed normally.
+ */
+
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+DUK_LOCAL duk_bool_t duk__mark_weak_mapset_values(duk_heap *heap, duk_heaphdr *hdr) {
+	duk_bool_t marked = 0;
+
+	for (; hdr != NULL; hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr)) {
+		duk_hmapset *m;
+		duk_tval *tv;
+		duk_uint32_t i;
+
+		if (!DUK_HEAPHDR_HAS_REACHABLE(hdr) ||
+		    !DUK_HEAPHDR_IS_OBJECT(hdr) ||
+		    !DUK_HOBJECT_IS_MAPSET((duk_hobject *) hdr)) {
+			continue;
+		}
+		m = (duk_hmapset *) hdr;
+		DUK_ASSERT_HMAPSET_VALID(m);
+		if (m->kind != DUK_HMAPSET_KIND_WEAKMAP) {
+			continue;
+		}
+
+		for (i = 0, tv = m->entries; i < m->e_used; i++, tv += 2) {
+			duk_heaphdr *h_value;
+
+			if (DUK_TVAL_IS_UNUSED(tv) ||
+			    !DUK_HEAPHDR_HAS_REACHABLE(DUK_TVAL_GET_HEAPHDR(tv)) ||
+			    !DUK_TVAL_IS_HEAP_ALLOCATED(tv + 1)) {
+				continue;
+			}
+			h_value = DUK_TVAL_GET_HEAPHDR(tv + 1);
+			if (DUK_HEAPHDR_HAS_REACHABLE(h_value)) {
+				continue;
+			}
+			duk__mark_heaphdr_nonnull(heap, h_value);
+#if defined(DUK_USE_ASSERTIONS) && defined(DUK_USE_REFERENCE_COUNTING)
+			h_value->h_assert_refcount--;  /* Counted in duk__clear_weak_mapsets(). */
+#endif
+			marked = 1;
+		}
+	}
+
+	return marked;
+}
+
+DUK_LOCAL void duk__mark_weak_mapsets(duk_heap *heap) {
+	duk_bool_t marked;
+
+	DUK_DD(DUK_DDPRINT("duk__mark_weak_mapsets: %p", (void *) heap));
+
+	do {
+		marked = duk__mark_weak_mapset_values(heap, heap->heap_allocated);
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+		marked |= duk__mark_weak_mapset_values(heap, heap->finalize_list);
+#endif
+		duk__mark_temproots_by_heap_scan(heap);
+	} while (marked);
+}
+
+DUK_LOCAL void duk__clear_weak_mapset_list(duk_heap *heap, duk_heaphdr *hdr) {
+	for (; hdr != NULL; hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr)) {
+		duk_hmapset *m;
+		duk_tval *tv;
+		duk_uint32_t i;
+		duk_small_uint_t stride;
+
+		if (!DUK_HEAPHDR_HAS_REACHABLE(hdr) ||
+		    !DUK_HEAPHDR_IS_OBJECT(hdr) ||
+		    !DUK_HOBJECT_IS_MAPSET((duk_hobject *) hdr)) {
+			continue;
+		}
+		m = (duk_hmapset *) hdr;
+		DUK_ASSERT_HMAPSET_VALID(m);
+		if (!DUK_HMAPSET_IS_WEAK(m)) {
+			continue;
+		}
+
+		stride = DUK_HMAPSET_GET_STRIDE(m);
+		for (i = 0, tv = m->entries; i < m->e_used; i++, tv += stride) {
+			duk_heaphdr *h_key;
+
+			if (DUK_TVAL_IS_UNUSED(tv)) {
+				continue;
+			}
+			DUK_ASSERT(DUK_TVAL_IS_OBJECT(tv));
+			h_key = DUK_TVAL_GET_HEAPHDR(tv);
+
+			if (DUK_HEAPHDR_HAS_REACHABLE(h_key)) {
+#if defined(DUK_USE_ASSERTIONS) && defined(DUK_USE_REFERENCE_COUNTING)
+				/* Weak references are INCREF'd but not marked. */
+				if (!DUK_HEAPHDR_HAS_READONLY(h_key)) {
+					h_key->h_assert_refcount++;
+				}
+				if (stride == 2 && DUK_TVAL_IS_HEAP_ALLOCATED(tv + 1) &&
+				    !DUK_HEAPHDR_HAS_READONLY(DUK_TVAL_GET_HEAPHDR(tv + 1))) {
+					DUK_TVAL_GET_HEAPHDR(tv + 1)->h_assert_refcount++;
+				}
+#endif
+				continue;
+			}
+
+			/* Hash slot is left pointing to the deleted entry. */
+			DUK_DDD(DUK_DDDPRINT("drop weak entry with unreachable key %p", (void *) h_key));
+#if defined(DUK_USE_REFERENCE_COUNTING)
+			DUK_TVAL_DECREF_NORZ(heap->heap_thread, tv);
+			if (stride == 2) {
+				DUK_TVAL_DECREF_NORZ(heap->heap_thread, tv + 1);
+			}
+#endif
+			DUK_TVAL_SET_UNUSED(tv);
+			if (stride == 2) {
+				DUK_TVAL_SET_UNDEFINED(tv + 1);
+			}
+			DUK_ASSERT(m->count > 0);
+			m->count--;
+		}
+	}
+}
+
+DUK_LOCAL void duk__clear_weak_mapsets(duk_heap *heap) {
+	DUK_DD(DUK_DDPRINT("duk__clear_weak_mapsets: %p", (void *) heap));
+
+	duk__clear_weak_mapset_list(heap, heap->heap_allocated);
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	duk__clear_weak_mapset_list(heap, heap->finalize_list);
+#endif
+}
+#endif  /* DUK_USE_MAP_SET_BUILTIN */
+
 /*
  *  Finalize refcounts for heap elements just about to be freed.
  *  This must be done for all objects before freeing to avoid any
@@ -520,6 +883,21 @@ DUK_LOCAL void duk__finalize_refcounts(duk_heap *heap) {
 
 		hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr);
 	}
+
+#if defined(DUK_USE_HSTRING_ROPES)
+	{
+		duk_hstring_rope *r;
+
+		for (r = heap->rope_list; r != NULL; r = r->next) {
+			if (DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) r)) {
+				continue;
+			}
+			DUK_HEAPHDR_DECREF_NORZ_ALLOWNULL(heap->heap_thread, (duk_heaphdr *) r->left);
+			DUK_HEAPHDR_DECREF_NORZ_ALLOWNULL(heap->heap_thread, (duk_heaphdr *) r->right);
+			DUK_HEAPHDR_DECREF_NORZ_ALLOWNULL(heap->heap_thread, (duk_heaphdr *) r->flat);
+		}
+	}
+#endif
 }
 #endif  /* DUK_USE_REFERENCE_COUNTING */
 
@@ -558,13 +936,88 @@ DUK_LOCAL void duk__clear_finalize_list_flags(duk_heap *heap) {
  *  Sweep stringtable.
  */
 
-DUK_LOCAL void duk__sweep_stringtable(duk_heap *heap, duk_size_t *out_count_keep) {
+DUK_LOCAL void duk__sweep_stringtable_bucket(duk_heap *heap, duk_uint32_t i, duk_size_t *p_count_keep, duk_size_t *p_count_free) {
 	duk_hstring *h;
 	duk_hstring *prev;
+
+#if defined(DUK_USE_STRTAB_PTRCOMP)
+	h = DUK_USE_HEAPPTR_DEC16(heap->heap_udata, heap->strtable16[i]);
+#else
+	h = heap->strtable[i];
+#endif
+	prev = NULL;
+	while (h != NULL) {
+		duk_hstring *next;
+		duk_bool_t keep;
+
+		next = h->hdr.h_next;
+
+		keep = DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) h);
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+		/* An incremental sweep runs interleaved with execution, so
+		 * strings created or referenced after marking finished are
+		 * unmarked but alive; their refcount tells them apart.
+		 */
+		if (heap->ms_incr_phase == DUK_MS_INCR_PHASE_STRSWEEP &&
+		    DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) h) > (DUK_HSTRING_HAS_PINNED_LITERAL(h) ? 1U : 0U)) {
+			keep = 1;
+		}
+#endif
+
+		if (keep) {
+			DUK_HEAPHDR_CLEAR_REACHABLE((duk_heaphdr *) h);
+			(*p_count_keep)++;
+			prev = h;
+		} else {
+			(*p_count_free)++;
+
+			/* For pinned strings the refcount has been
+			 * bumped.  We could unbump it here before
+			 * freeing, but that's actually not necessary
+			 * except for assertions.
+			 */
+#if 0
+			if (DUK_HSTRING_HAS_PINNED_LITERAL(h)) {
+				DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) h) > 0U);
+				DUK_HSTRING_DECREF_NORZ(heap->heap_thread, h);
+				DUK_HSTRING_CLEAR_PINNED_LITERAL(h);
+			}
+#endif
+#if defined(DUK_USE_REFERENCE_COUNTING)
+			/* Non-zero refcounts should not happen for unreachable strings,
+			 * because we refcount finalize all unreachable objects which
+			 * should have decreased unreachable string refcounts to zero
+			 * (even for cycles).  However, pinned strings have a +1 bump.
+			 */
+			DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) h) ==
+			           DUK_HSTRING_HAS_PINNED_LITERAL(h) ? 1U : 0U);
+#endif
+
+			/* Deal with weak references first. */
+			duk_heap_strcache_string_remove(heap, (duk_hstring *) h);
+
+			/* Remove the string from the string table. */
+			duk_heap_strtable_unlink_prev(heap, (duk_hstring *) h, (duk_hstring *) prev);
+
+			/* Free inner references (these exist e.g. when external
+			 * strings are enabled) and the struct itself.
+			 */
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+			duk_heap_bgfree_heaphdr(heap, (duk_heaphdr *) h);
+#else
+			duk_free_hstring(heap, (duk_hstring *) h);
+#endif
+
+			/* Don't update 'prev'; it should be last string kept. */
+		}
+
+		h = next;
+	}
+}
+
+DUK_LOCAL void duk__sweep_stringtable(duk_heap *heap, duk_size_t *out_count_keep) {
 	duk_uint32_t i;
-#if defined(DUK_USE_DEBUG)
 	duk_size_t count_free = 0;
-#endif
 	duk_size_t count_keep = 0;
 
 	DUK_DD(DUK_DDPRINT("duk__sweep_stringtable: %p", (void *) heap));
@@ -578,73 +1031,56 @@ DUK_LOCAL void duk__sweep_stringtable(duk_heap *heap, duk_size_t *out_count_keep
 	}
 
 	for (i = 0; i < heap->st_size; i++) {
-#if defined(DUK_USE_STRTAB_PTRCOMP)
-		h = DUK_USE_HEAPPTR_DEC16(heap->heap_udata, heap->strtable16[i]);
-#else
-		h = heap->strtable[i];
-#endif
-		prev = NULL;
-		while (h != NULL) {
-			duk_hstring *next;
-			next = h->hdr.h_next;
+		duk__sweep_stringtable_bucket(heap, i, &count_keep, &count_free);
+	}
 
-			if (DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) h))
-			{
-				DUK_HEAPHDR_CLEAR_REACHABLE((duk_heaphdr *) h);
-				count_keep++;
-				prev = h;
-			} else {
+ done:
+	DUK_D(DUK_DPRINT("mark-and-sweep sweep stringtable: %ld freed, %ld kept",
+	                 (long) count_free, (long) count_keep));
+	DUK_UNREF(count_free);
+	*out_count_keep = count_keep;
+}
+
+/*
+ *  Sweep ropes.
+ */
+
+#if defined(DUK_USE_HSTRING_ROPES)
+DUK_LOCAL void duk__sweep_ropes(duk_heap *heap) {
+	duk_hstring_rope *r;
+	duk_hstring_rope *next;
 #if defined(DUK_USE_DEBUG)
-				count_free++;
+	duk_size_t count_free = 0;
+	duk_size_t count_keep = 0;
 #endif
 
-				/* For pinned strings the refcount has been
-				 * bumped.  We could unbump it here before
-				 * freeing, but that's actually not necessary
-				 * except for assertions.
-				 */
-#if 0
-				if (DUK_HSTRING_HAS_PINNED_LITERAL(h)) {
-					DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) h) > 0U);
-					DUK_HSTRING_DECREF_NORZ(heap->heap_thread, h);
-					DUK_HSTRING_CLEAR_PINNED_LITERAL(h);
-				}
+	DUK_DD(DUK_DDPRINT("duk__sweep_ropes: %p", (void *) heap));
+
+	for (r = heap->rope_list; r != NULL; r = next) {
+		next = r->next;
+		if (DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) r)) {
+			DUK_HEAPHDR_CLEAR_REACHABLE((duk_heaphdr *) r);
+#if defined(DUK_USE_DEBUG)
+			count_keep++;
 #endif
+		} else {
 #if defined(DUK_USE_REFERENCE_COUNTING)
-				/* Non-zero refcounts should not happen for unreachable strings,
-				 * because we refcount finalize all unreachable objects which
-				 * should have decreased unreachable string refcounts to zero
-				 * (even for cycles).  However, pinned strings have a +1 bump.
-				 */
-				DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) h) ==
-				           DUK_HSTRING_HAS_PINNED_LITERAL(h) ? 1U : 0U);
+			DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) r) == 0);
+#endif
+			/* Children may have been freed already, don't touch them. */
+			duk_hstring_rope_free(heap, r);
+#if defined(DUK_USE_DEBUG)
+			count_free++;
 #endif
-
-				/* Deal with weak references first. */
-				duk_heap_strcache_string_remove(heap, (duk_hstring *) h);
-
-				/* Remove the string from the string table. */
-				duk_heap_strtable_unlink_prev(heap, (duk_hstring *) h, (duk_hstring *) prev);
-
-				/* Free inner references (these exist e.g. when external
-				 * strings are enabled) and the struct itself.
-				 */
-				duk_free_hstring(heap, (duk_hstring *) h);
-
-				/* Don't update 'prev'; it should be last string kept. */
-			}
-
-			h = next;
 		}
 	}
 
- done:
 #if defined(DUK_USE_DEBUG)
-	DUK_D(DUK_DPRINT("mark-and-sweep sweep stringtable: %ld freed, %ld kept",
+	DUK_D(DUK_DPRINT("mark-and-sweep sweep ropes: %ld freed, %ld kept",
 	                 (long) count_free, (long) count_keep));
 #endif
-	*out_count_keep = count_keep;
 }
+#endif  /* DUK_USE_HSTRING_ROPES */
 
 /*
  *  Sweep heap.
@@ -802,7 +1238,11 @@ DUK_LOCAL void duk__sweep_heap(duk_heap *heap, duk_small_uint_t flags, duk_size_
 			 */
 
 			/* Free object and all auxiliary (non-heap) allocs. */
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+			duk_heap_bgfree_heaphdr(heap, curr);
+#else
 			duk_heap_free_heaphdr_raw(heap, curr);
+#endif
 		}
 
 		curr = next;
@@ -1020,6 +1460,16 @@ DUK_LOCAL void duk__clear_assert_refcounts(duk_heap *heap) {
 			h = h->hdr.h_next;
 		}
 	}
+
+#if defined(DUK_USE_HSTRING_ROPES)
+	{
+		duk_hstring_rope *r;
+
+		for (r = heap->rope_list; r != NULL; r = r->next) {
+			((duk_heaphdr *) r)->h_assert_refcount = 0;
+		}
+	}
+#endif
 }
 
 DUK_LOCAL void duk__check_refcount_heaphdr(duk_heaphdr *hdr) {
@@ -1080,6 +1530,16 @@ DUK_LOCAL void duk__check_assert_refcounts(duk_heap *heap) {
 			h = h->hdr.h_next;
 		}
 	}
+
+#if defined(DUK_USE_HSTRING_ROPES)
+	{
+		duk_hstring_rope *r;
+
+		for (r = heap->rope_list; r != NULL; r = r->next) {
+			duk__check_refcount_heaphdr((duk_heaphdr *) r);
+		}
+	}
+#endif
 }
 #endif  /* DUK_USE_REFERENCE_COUNTING */
 
@@ -1101,30 +1561,836 @@ DUK_LOCAL void duk__assert_litcache_nulls(duk_heap *heap) {
 #endif  /* DUK_USE_ASSERTIONS */
 
 /*
- *  Stats dump.
+ *  List helpers for mark-and-sweep work lists (doubly linked).
  */
 
-#if defined(DUK_USE_DEBUG)
-DUK_LOCAL void duk__dump_stats(duk_heap *heap) {
-	DUK_D(DUK_DPRINT("stats executor: opcodes=%ld, interrupt=%ld, throw=%ld",
-	                 (long) heap->stats_exec_opcodes, (long) heap->stats_exec_interrupt,
-	                 (long) heap->stats_exec_throw));
-	DUK_D(DUK_DPRINT("stats call: all=%ld, tailcall=%ld, ecmatoecma=%ld",
-	                 (long) heap->stats_call_all, (long) heap->stats_call_tailcall,
-	                 (long) heap->stats_call_ecmatoecma));
-	DUK_D(DUK_DPRINT("stats safecall: all=%ld, nothrow=%ld, throw=%ld",
-	                 (long) heap->stats_safecall_all, (long) heap->stats_safecall_nothrow,
-	                 (long) heap->stats_safecall_throw));
-	DUK_D(DUK_DPRINT("stats mark-and-sweep: try_count=%ld, skip_count=%ld, emergency_count=%ld",
-	                 (long) heap->stats_ms_try_count, (long) heap->stats_ms_skip_count,
-	                 (long) heap->stats_ms_emergency_count));
-	DUK_D(DUK_DPRINT("stats stringtable: intern_hit=%ld, intern_miss=%ld, "
-	                 "resize_check=%ld, resize_grow=%ld, resize_shrink=%ld, "
-	                 "litcache_hit=%ld, litcache_miss=%ld, litcache_pin=%ld",
-	                 (long) heap->stats_strtab_intern_hit, (long) heap->stats_strtab_intern_miss,
-	                 (long) heap->stats_strtab_resize_check, (long) heap->stats_strtab_resize_grow,
-	                 (long) heap->stats_strtab_resize_shrink, (long) heap->stats_strtab_litcache_hit,
-	                 (long) heap->stats_strtab_litcache_miss, (long) heap->stats_strtab_litcache_pin));
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL) || defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+DUK_LOCAL void duk__ms_list_insert(duk_heap *heap, duk_heaphdr **p_head, duk_heaphdr *hdr) {
+	duk_heaphdr *root;
+
+	root = *p_head;
+	DUK_HEAPHDR_SET_PREV(heap, hdr, NULL);
+	DUK_HEAPHDR_SET_NEXT(heap, hdr, root);
+	if (root != NULL) {
+		DUK_HEAPHDR_SET_PREV(heap, root, hdr);
+	}
+	*p_head = hdr;
+}
+
+DUK_LOCAL void duk__ms_list_remove(duk_heap *heap, duk_heaphdr **p_head, duk_heaphdr *hdr) {
+	duk_heaphdr *prev;
+	duk_heaphdr *next;
+
+	prev = DUK_HEAPHDR_GET_PREV(heap, hdr);
+	next = DUK_HEAPHDR_GET_NEXT(heap, hdr);
+	if (prev != NULL) {
+		DUK_ASSERT(*p_head != hdr);
+		DUK_HEAPHDR_SET_NEXT(heap, prev, next);
+	} else {
+		DUK_ASSERT(*p_head == hdr);
+		*p_head = next;
+	}
+	if (next != NULL) {
+		DUK_HEAPHDR_SET_PREV(heap, next, prev);
+	}
+}
+#endif  /* DUK_USE_MARK_AND_SWEEP_INCREMENTAL || DUK_USE_MARK_AND_SWEEP_NURSERY */
+
+/*
+ *  Incremental mark-and-sweep.
+ *
+ *  A cycle is split into slices of DUK_USE_MARK_AND_SWEEP_INCR_BUDGET work
+ *  units which are run from the voluntary GC trigger, interleaved with
+ *  execution.  Marking is tri-color: unmarked objects are white, grey
+ *  objects have REACHABLE and TEMPROOT set and wait on ms_incr_grey for
+ *  their children to be marked, and black objects are REACHABLE and back
+ *  in heap_allocated.  INCREF shades its target while marking is active,
+ *  so a black object never points to a white one.  The running thread is
+ *  kept black so that its value stack needs no barriers.
+ *
+ *  Finalizable objects are looked up once the first marking fixpoint has
+ *  been reached.  finalize_list, WeakMap ephemerons and rope spines are
+ *  handled atomically at the end of marking because they change outside
+ *  INCREF.  The sweep walks heap_allocated with a cursor; objects created
+ *  after marking finished are inserted behind the cursor and are kept.
+ *  Garbage is moved aside, refcount finalized and freed in later slices,
+ *  and the string table is swept last, one bucket at a time.
+ *
+ *  Explicit and emergency GC finish any cycle in progress and then run a
+ *  normal full mark-and-sweep.
+ */
+
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+/* Remove from heap_allocated, keeping the walk cursor valid. */
+DUK_LOCAL void duk__ms_incr_remove_allocated(duk_heap *heap, duk_heaphdr *hdr) {
+	if (heap->ms_incr_cursor == hdr) {
+		heap->ms_incr_cursor = DUK_HEAPHDR_GET_NEXT(heap, hdr);
+	}
+	duk__ms_list_remove(heap, &heap->heap_allocated, hdr);
+}
+
+DUK_LOCAL void duk__ms_incr_push_grey(duk_heap *heap, duk_heaphdr *hdr) {
+	DUK_ASSERT(DUK_HEAPHDR_IS_OBJECT(hdr));
+	DUK_ASSERT(!DUK_HEAPHDR_HAS_REACHABLE(hdr));
+	DUK_ASSERT(!DUK_HEAPHDR_HAS_TEMPROOT(hdr));
+
+	duk__ms_incr_remove_allocated(heap, hdr);
+	DUK_HEAPHDR_SET_REACHABLE(hdr);
+	DUK_HEAPHDR_SET_TEMPROOT(hdr);
+	duk__ms_list_insert(heap, &heap->ms_incr_grey, hdr);
+}
+
+DUK_INTERNAL void duk_heap_ms_incr_shade(duk_heap *heap, duk_heaphdr *h) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(h != NULL);
+	DUK_ASSERT(heap->ms_incr_marking != 0U);
+
+	if (DUK_HEAPHDR_HAS_REACHABLE(h)) {
+		return;
+	}
+	DUK_ASSERT(!DUK_HEAPHDR_HAS_READONLY(h));
+
+	switch (DUK_HEAPHDR_GET_TYPE(h)) {
+	case DUK_HTYPE_STRING:
+		DUK_HEAPHDR_SET_REACHABLE(h);
+#if defined(DUK_USE_HSTRING_ROPES)
+		duk__mark_hstring(heap, (duk_hstring *) h);
+#endif
+		break;
+	case DUK_HTYPE_BUFFER:
+		DUK_HEAPHDR_SET_REACHABLE(h);
+		break;
+	default:
+		DUK_ASSERT(DUK_HEAPHDR_IS_OBJECT(h));
+		/* Objects on finalize_list and the object whose finalizer
+		 * is running are not on heap_allocated; they're dealt with
+		 * when marking finishes and when requeued, respectively.
+		 */
+		if (DUK_HEAPHDR_HAS_FINALIZABLE(h) || h == heap->currently_finalizing) {
+			break;
+		}
+		duk__ms_incr_push_grey(heap, h);
+		break;
+	}
+}
+
+/* Scan a grey object, returns the amount of work done. */
+DUK_LOCAL duk_int_t duk__ms_incr_scan(duk_heap *heap, duk_heaphdr *hdr) {
+	duk_hobject *obj;
+	duk_int_t cost;
+
+	DUK_ASSERT(DUK_HEAPHDR_HAS_REACHABLE(hdr));
+	DUK_ASSERT(DUK_HEAPHDR_HAS_TEMPROOT(hdr));
+
+	obj = (duk_hobject *) hdr;
+	duk__ms_list_remove(heap, &heap->ms_incr_grey, hdr);
+	DUK_HEAPHDR_CLEAR_TEMPROOT(hdr);
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	if (DUK_HOBJECT_IS_MAPSET(obj) && DUK_HMAPSET_IS_WEAK((duk_hmapset *) obj)) {
+		duk__ms_list_insert(heap, &heap->ms_incr_weak, hdr);
+	} else
+#endif
+	{
+		duk__ms_list_insert(heap, &heap->heap_allocated, hdr);
+	}
+
+	duk__mark_hobject(heap, obj);
+
+	cost = 1 + (duk_int_t) ((DUK_HOBJECT_GET_ENEXT(obj) + DUK_HOBJECT_GET_ASIZE(obj)) >> 4);
+	if (DUK_HOBJECT_IS_THREAD(obj)) {
+		duk_hthread *t = (duk_hthread *) obj;
+		cost += (duk_int_t) ((t->valstack_top - t->valstack) >> 4);
+	}
+	return cost;
+}
+
+DUK_LOCAL duk_int_t duk__ms_incr_drain(duk_heap *heap, duk_int_t budget) {
+	while (heap->ms_incr_grey != NULL && budget > 0) {
+		budget -= duk__ms_incr_scan(heap, heap->ms_incr_grey);
+	}
+	return budget;
+}
+
+DUK_INTERNAL void duk_heap_ms_incr_blacken_thread(duk_heap *heap, duk_hthread *thr) {
+	duk_heaphdr *hdr;
+
+	DUK_ASSERT(heap->ms_incr_marking != 0U);
+
+	hdr = (duk_heaphdr *) thr;
+	duk_heap_ms_incr_shade(heap, hdr);
+	if (DUK_HEAPHDR_HAS_TEMPROOT(hdr)) {
+		(void) duk__ms_incr_scan(heap, hdr);
+	}
+}
+
+DUK_INTERNAL void duk_heap_ms_incr_unlink(duk_heap *heap, duk_heaphdr *hdr) {
+	DUK_ASSERT(heap->ms_incr_phase != DUK_MS_INCR_PHASE_IDLE);
+	DUK_ASSERT(heap->ms_running == 0);
+
+	if (DUK_HEAPHDR_HAS_TEMPROOT(hdr)) {
+		DUK_ASSERT(heap->ms_incr_marking != 0U);
+		duk__ms_list_remove(heap, &heap->ms_incr_grey, hdr);
+	}
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	else if (heap->ms_incr_marking && DUK_HEAPHDR_HAS_REACHABLE(hdr) &&
+	         DUK_HEAPHDR_IS_OBJECT(hdr) && DUK_HOBJECT_IS_MAPSET((duk_hobject *) hdr) &&
+	         DUK_HMAPSET_IS_WEAK((duk_hmapset *) hdr)) {
+		duk__ms_list_remove(heap, &heap->ms_incr_weak, hdr);
+	}
+#endif
+	else {
+		duk__ms_incr_remove_allocated(heap, hdr);
+	}
+
+	/* Caller frees the object or moves it to finalize_list. */
+	DUK_HEAPHDR_CLEAR_TEMPROOT(hdr);
+	DUK_HEAPHDR_CLEAR_REACHABLE(hdr);
+}
+
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+/* Called when an object moves from finalize_list back to heap_allocated.
+ * A finalizer may have stored a reference to its own object, which the
+ * write barrier skipped, so treat the object as reachable for the rest
+ * of the cycle.
+ */
+DUK_INTERNAL void duk_heap_ms_incr_requeue(duk_heap *heap, duk_heaphdr *hdr) {
+	DUK_ASSERT(!DUK_HEAPHDR_HAS_FINALIZABLE(hdr));
+
+	if (heap->ms_incr_marking && !DUK_HEAPHDR_HAS_REACHABLE(hdr)) {
+		duk__ms_incr_push_grey(heap, hdr);
+	}
+}
+#endif  /* DUK_USE_FINALIZER_SUPPORT */
+
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+/* The object whose finalizer is running is on no heap list and the write
+ * barrier skips it, but it's reachable through the finalizer call.
+ */
+DUK_LOCAL void duk__ms_incr_mark_finalizing(duk_heap *heap) {
+	if (heap->currently_finalizing != NULL) {
+		duk__mark_hobject(heap, (duk_hobject *) heap->currently_finalizing);
+	}
+}
+#endif
+
+DUK_LOCAL void duk__ms_incr_start(duk_heap *heap) {
+	DUK_D(DUK_DPRINT("incremental mark-and-sweep cycle starting"));
+
+	DUK_ASSERT(heap->ms_incr_grey == NULL);
+	DUK_ASSERT(heap->ms_incr_weak == NULL);
+	DUK_ASSERT(heap->ms_incr_garbage == NULL);
+
+	duk_heap_free_freelists(heap);
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	heap->shape_mark_gen++;
+	if (DUK_UNLIKELY(heap->shape_mark_gen == 0)) {
+		heap->shape_mark_gen++;
+	}
+#endif
+
+	heap->ms_incr_flags = 0;
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	if (heap->finalize_list != NULL) {
+		heap->ms_incr_flags |= DUK_MS_FLAG_POSTPONE_RESCUE;
+	}
+#endif
+	heap->ms_incr_count_keep = 0;
+	heap->ms_incr_phase = DUK_MS_INCR_PHASE_MARK;
+	heap->ms_incr_marking = 1;
+
+	duk__mark_roots_heap(heap);
+	if (heap->curr_thread != NULL) {
+		duk_heap_ms_incr_blacken_thread(heap, heap->curr_thread);
+	}
+	duk_heap_ms_incr_blacken_thread(heap, heap->heap_thread);
+}
+
+/* Marking completion, done atomically: finalize_list is a root set that
+ * changes without barriers, and WeakMap entries must be cleared against
+ * final reachability.
+ */
+DUK_LOCAL void duk__ms_incr_finish_marking(duk_heap *heap) {
+	duk_heaphdr *hdr;
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	duk_bool_t marked;
+#endif
+
+	DUK_ASSERT(heap->ms_incr_grey == NULL);
+
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	duk__ms_incr_mark_finalizing(heap);
+	for (hdr = heap->finalize_list; hdr != NULL; hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr)) {
+		if (!DUK_HEAPHDR_HAS_REACHABLE(hdr)) {
+			DUK_HEAPHDR_SET_REACHABLE(hdr);
+			duk__mark_hobject(heap, (duk_hobject *) hdr);
+		}
+	}
+	(void) duk__ms_incr_drain(heap, DUK_INT_MAX);
+#endif
+
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	do {
+		marked = duk__mark_weak_mapset_values(heap, heap->ms_incr_weak);
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+		marked |= duk__mark_weak_mapset_values(heap, heap->finalize_list);
+#endif
+		(void) duk__ms_incr_drain(heap, DUK_INT_MAX);
+	} while (marked);
+
+	duk__clear_weak_mapset_list(heap, heap->ms_incr_weak);
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	duk__clear_weak_mapset_list(heap, heap->finalize_list);
+#endif
+	while ((hdr = heap->ms_incr_weak) != NULL) {
+		duk__ms_list_remove(heap, &heap->ms_incr_weak, hdr);
+		duk__ms_list_insert(heap, &heap->heap_allocated, hdr);
+	}
+#endif  /* DUK_USE_MAP_SET_BUILTIN */
+	DUK_ASSERT(heap->ms_incr_grey == NULL);
+	heap->ms_incr_marking = 0;
+
+#if defined(DUK_USE_HSTRING_ROPES)
+	{
+		duk_hstring_rope *r;
+		duk_hstring_rope *next;
+		duk_hstring_rope *prev = NULL;
+
+		for (r = heap->rope_list; r != NULL; r = next) {
+			next = r->next;
+			if (DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) r)) {
+				DUK_HEAPHDR_CLEAR_REACHABLE((duk_heaphdr *) r);
+				prev = r;
+				continue;
+			}
+			DUK_HEAPHDR_DECREF_NORZ_ALLOWNULL(heap->heap_thread, (duk_heaphdr *) r->left);
+			DUK_HEAPHDR_DECREF_NORZ_ALLOWNULL(heap->heap_thread, (duk_heaphdr *) r->right);
+			DUK_HEAPHDR_DECREF_NORZ_ALLOWNULL(heap->heap_thread, (duk_heaphdr *) r->flat);
+			if (prev != NULL) {
+				prev->next = next;
+			} else {
+				heap->rope_list = next;
+			}
+			r->next = heap->ms_incr_rope_garbage;
+			heap->ms_incr_rope_garbage = r;
+		}
+	}
+#endif
+
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	if (heap->finalize_list != NULL) {
+		heap->ms_incr_flags |= DUK_MS_FLAG_POSTPONE_RESCUE;
+	}
+	duk__clear_finalize_list_flags(heap);
+#endif
+
+	heap->ms_incr_cursor = heap->heap_allocated;
+	heap->ms_incr_phase = DUK_MS_INCR_PHASE_SWEEP;
+}
+
+/* Sweep one object, mirrors duk__sweep_heap(). */
+DUK_LOCAL void duk__ms_incr_sweep_one(duk_heap *heap, duk_heaphdr *curr) {
+	DUK_ASSERT(!DUK_HEAPHDR_HAS_TEMPROOT(curr));
+
+	if (!DUK_HEAPHDR_HAS_REACHABLE(curr)) {
+		DUK_ASSERT(!DUK_HEAPHDR_HAS_FINALIZABLE(curr));
+		duk__ms_incr_remove_allocated(heap, curr);
+		duk__ms_list_insert(heap, &heap->ms_incr_garbage, curr);
+		return;
+	}
+
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	if (DUK_UNLIKELY(DUK_HEAPHDR_HAS_FINALIZABLE(curr))) {
+		DUK_ASSERT(!DUK_HEAPHDR_HAS_FINALIZED(curr));
+		duk__ms_incr_remove_allocated(heap, curr);
+		DUK_HEAPHDR_CLEAR_REACHABLE(curr);
+		DUK_HEAPHDR_PREINC_REFCOUNT(curr);  /* Bump refcount so that refzero never occurs when pending a finalizer call. */
+		DUK_HEAP_INSERT_INTO_FINALIZE_LIST(heap, curr);
+		return;
+	}
+#endif
+
+	if (DUK_UNLIKELY(DUK_HEAPHDR_HAS_FINALIZED(curr))) {
+		if (heap->ms_incr_flags & DUK_MS_FLAG_POSTPONE_RESCUE) {
+			heap->ms_incr_count_keep++;
+		} else {
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+			DUK_HEAPHDR_CLEAR_FINALIZED(curr);
+#endif
+		}
+	} else {
+		heap->ms_incr_count_keep++;
+	}
+
+	if (DUK_HEAPHDR_IS_OBJECT(curr) && DUK_HOBJECT_IS_THREAD((duk_hobject *) curr)) {
+		duk_valstack_shrink_check_nothrow((duk_hthread *) curr, 0 /*snug*/);
+	}
+	DUK_HEAPHDR_CLEAR_REACHABLE(curr);
+}
+
+DUK_LOCAL void duk__ms_incr_end_cycle(duk_heap *heap) {
+	duk_size_t tmp;
+
+	heap->ms_incr_phase = DUK_MS_INCR_PHASE_IDLE;
+	heap->ms_incr_cycles++;
+
+	tmp = heap->ms_incr_count_keep / 256;
+	heap->ms_trigger_counter = (duk_int_t) (
+	    (tmp * DUK_HEAP_MARK_AND_SWEEP_TRIGGER_MULT) +
+	    DUK_HEAP_MARK_AND_SWEEP_TRIGGER_ADD);
+	DUK_D(DUK_DPRINT("incremental mark-and-sweep cycle finished: %ld objects and strings kept, trigger reset to %ld",
+	                 (long) heap->ms_incr_count_keep, (long) heap->ms_trigger_counter));
+}
+
+/* Run incremental work until 'budget' is used up or the cycle ends. */
+DUK_LOCAL void duk__ms_incr_step(duk_heap *heap, duk_int_t budget) {
+	duk_heaphdr *curr;
+
+	while (budget > 0) {
+		switch (heap->ms_incr_phase) {
+		case DUK_MS_INCR_PHASE_MARK: {
+			budget = duk__ms_incr_drain(heap, budget);
+			if (heap->ms_incr_grey != NULL) {
+				break;
+			}
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+			if (duk__mark_weak_mapset_values(heap, heap->ms_incr_weak)) {
+				break;
+			}
+#endif
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+			heap->ms_incr_cursor = heap->heap_allocated;
+			heap->ms_incr_phase = DUK_MS_INCR_PHASE_FINSCAN;
+#else
+			heap->ms_incr_phase = DUK_MS_INCR_PHASE_MARK2;
+#endif
+			break;
+		}
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+		case DUK_MS_INCR_PHASE_FINSCAN: {
+			/* The grey list must be empty whenever an object is
+			 * classified, otherwise a reachable object could be
+			 * mistaken for garbage.
+			 */
+			duk__ms_incr_mark_finalizing(heap);
+			budget = duk__ms_incr_drain(heap, budget);
+			while (budget > 0 && heap->ms_incr_grey == NULL && (curr = heap->ms_incr_cursor) != NULL) {
+				heap->ms_incr_cursor = DUK_HEAPHDR_GET_NEXT(heap, curr);
+				budget--;
+				if (!DUK_HEAPHDR_HAS_REACHABLE(curr) &&
+				    DUK_HEAPHDR_IS_OBJECT(curr) &&
+				    !DUK_HEAPHDR_HAS_FINALIZED(curr) &&
+				    DUK_HOBJECT_HAS_FINALIZER_FAST(heap, (duk_hobject *) curr)) {
+					/* Set aside so that marking from other
+					 * finalizable objects doesn't hide it.
+					 */
+					duk__ms_incr_remove_allocated(heap, curr);
+					DUK_HEAPHDR_SET_FINALIZABLE(curr);
+					duk__ms_list_insert(heap, &heap->ms_incr_finalizable, curr);
+				}
+			}
+			if (heap->ms_incr_grey != NULL || heap->ms_incr_cursor != NULL) {
+				break;
+			}
+			while ((curr = heap->ms_incr_finalizable) != NULL) {
+				duk__ms_list_remove(heap, &heap->ms_incr_finalizable, curr);
+				DUK_HEAPHDR_SET_REACHABLE(curr);
+				DUK_HEAPHDR_SET_TEMPROOT(curr);
+				duk__ms_list_insert(heap, &heap->ms_incr_grey, curr);
+			}
+			heap->ms_incr_phase = DUK_MS_INCR_PHASE_MARK2;
+			break;
+		}
+#endif  /* DUK_USE_FINALIZER_SUPPORT */
+		case DUK_MS_INCR_PHASE_MARK2: {
+			budget = duk__ms_incr_drain(heap, budget);
+			if (heap->ms_incr_grey == NULL) {
+				duk__ms_incr_finish_marking(heap);
+			}
+			break;
+		}
+		case DUK_MS_INCR_PHASE_SWEEP: {
+			while (budget > 0 && (curr = heap->ms_incr_cursor) != NULL) {
+				heap->ms_incr_cursor = DUK_HEAPHDR_GET_NEXT(heap, curr);
+				duk__ms_incr_sweep_one(heap, curr);
+				budget--;
+			}
+			if (heap->ms_incr_cursor == NULL) {
+				heap->ms_incr_cursor = heap->ms_incr_garbage;
+				heap->ms_incr_phase = DUK_MS_INCR_PHASE_REFCOUNT;
+			}
+			break;
+		}
+		case DUK_MS_INCR_PHASE_REFCOUNT: {
+			/* Garbage is only referenced by other garbage, so
+			 * nothing can unlink it behind our back.
+			 */
+			while (budget > 0 && (curr = heap->ms_incr_cursor) != NULL) {
+				heap->ms_incr_cursor = DUK_HEAPHDR_GET_NEXT(heap, curr);
+				duk_heaphdr_refcount_finalize_norz(heap, curr);
+				budget--;
+				if (DUK_HEAPHDR_IS_OBJECT(curr)) {
+					budget -= (duk_int_t) (DUK_HOBJECT_GET_ENEXT((duk_hobject *) curr) >> 4);
+				}
+			}
+			if (heap->ms_incr_cursor == NULL) {
+				heap->ms_incr_phase = DUK_MS_INCR_PHASE_FREE;
+			}
+			break;
+		}
+		case DUK_MS_INCR_PHASE_FREE: {
+			while (budget > 0 && (curr = heap->ms_incr_garbage) != NULL) {
+				heap->ms_incr_garbage = DUK_HEAPHDR_GET_NEXT(heap, curr);
+				DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT(curr) == 0);
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+				duk_heap_bgfree_heaphdr(heap, curr);
+#else
+				duk_heap_free_heaphdr_raw(heap, curr);
+#endif
+				budget--;
+			}
+			if (heap->ms_incr_garbage != NULL) {
+				break;
+			}
+#if defined(DUK_USE_HSTRING_ROPES)
+			while (heap->ms_incr_rope_garbage != NULL) {
+				duk_hstring_rope *r = heap->ms_incr_rope_garbage;
+				heap->ms_incr_rope_garbage = r->next;
+				DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) r) == 0);
+				duk_hstring_rope_free(heap, r);
+				budget--;
+			}
+#endif
+			heap->ms_incr_st_index = 0;
+			heap->ms_incr_phase = DUK_MS_INCR_PHASE_STRSWEEP;
+			break;
+		}
+		case DUK_MS_INCR_PHASE_STRSWEEP: {
+			duk_size_t count_keep = 0;
+			duk_size_t count_free = 0;
+
+			/* Literal cache entries would keep pointers to swept
+			 * strings; re-pinned strings have a refcount and are
+			 * kept.
+			 */
+#if defined(DUK_USE_LITCACHE_SIZE)
+			duk__wipe_litcache(heap);
+#endif
+#if defined(DUK_USE_STRTAB_PTRCOMP)
+			if (heap->strtable16 != NULL) {
+#else
+			if (heap->strtable != NULL) {
+#endif
+				while (budget > 0 && heap->ms_incr_st_index < heap->st_size) {
+					duk__sweep_stringtable_bucket(heap, heap->ms_incr_st_index, &count_keep, &count_free);
+					heap->ms_incr_st_index++;
+					budget -= (duk_int_t) (1 + count_keep + count_free);
+					heap->ms_incr_count_keep += count_keep;
+					count_keep = 0;
+					count_free = 0;
+				}
+				if (heap->ms_incr_st_index < heap->st_size) {
+					break;
+				}
+			}
+			duk__ms_incr_end_cycle(heap);
+			return;
+		}
+		default: {
+			DUK_ASSERT(heap->ms_incr_phase == DUK_MS_INCR_PHASE_IDLE);
+			return;
+		}
+		}
+	}
+}
+
+DUK_LOCAL void duk__ms_incr_record_pause(duk_heap *heap, duk_double_t t_start) {
+	duk_double_t t;
+
+	t = duk_time_get_monotonic_time(heap->heap_thread) - t_start;
+	heap->ms_incr_pause_last = t;
+	if (t > heap->ms_incr_pause_max) {
+		heap->ms_incr_pause_max = t;
+	}
+	heap->ms_incr_pause_total += t;
+}
+
+/* Run one slice, starting a new cycle if necessary. */
+DUK_LOCAL void duk__ms_incr_slice(duk_heap *heap) {
+	duk_double_t t_start;
+
+	DUK_ASSERT(heap->ms_prevent_count == 0);
+	DUK_ASSERT(heap->ms_running == 0);
+
+	t_start = duk_time_get_monotonic_time(heap->heap_thread);
+
+	heap->ms_prevent_count = 1;
+	heap->ms_running = 1;
+	if (heap->ms_incr_phase == DUK_MS_INCR_PHASE_IDLE) {
+		duk__ms_incr_start(heap);
+	}
+	duk__ms_incr_step(heap, DUK_USE_MARK_AND_SWEEP_INCR_BUDGET);
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+	duk_heap_bgfree_flush(heap, 0 /*wait*/);
+#endif
+	DUK_ASSERT(heap->ms_prevent_count == 1);
+	heap->ms_prevent_count = 0;
+	DUK_ASSERT(heap->ms_running == 1);
+	heap->ms_running = 0;
+
+	heap->ms_incr_slices++;
+	if (heap->ms_incr_phase != DUK_MS_INCR_PHASE_IDLE) {
+		heap->ms_trigger_counter = DUK_HEAP_MARK_AND_SWEEP_INCR_TRIGGER;
+	}
+	duk__ms_incr_record_pause(heap, t_start);
+
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	duk_heap_process_finalize_list(heap);
+#endif
+}
+
+/* Finish a cycle in progress without a budget. */
+DUK_LOCAL void duk__ms_incr_complete(duk_heap *heap) {
+	DUK_ASSERT(heap->ms_prevent_count == 0);
+	DUK_ASSERT(heap->ms_running == 0);
+
+	DUK_D(DUK_DPRINT("finishing incremental mark-and-sweep cycle in phase %ld", (long) heap->ms_incr_phase));
+	heap->ms_prevent_count = 1;
+	heap->ms_running = 1;
+	while (heap->ms_incr_phase != DUK_MS_INCR_PHASE_IDLE) {
+		duk__ms_incr_step(heap, DUK_INT_MAX);
+	}
+	heap->ms_prevent_count = 0;
+	heap->ms_running = 0;
+}
+#endif  /* DUK_USE_MARK_AND_SWEEP_INCREMENTAL */
+
+/*
+ *  Nursery (minor) collection.
+ *
+ *  Objects and buffers inserted into heap_allocated since the previous
+ *  collection are young and form the prefix of heap_allocated before
+ *  heap->ms_old_head.  Reference counting frees most young garbage, but
+ *  reference cycles (e.g. a function and its prototype object) otherwise
+ *  stay around until a full mark-and-sweep.
+ *
+ *  A minor collection detaches the nursery and uses reference counts as
+ *  the remembered set: references from nursery objects to other nursery
+ *  objects are temporarily subtracted, so a nursery object with a nonzero
+ *  refcount left is referenced from old objects, value stacks, or other
+ *  roots.  Such objects and everything reachable from them inside the
+ *  nursery survive; the rest are unreachable cycles and are freed.  Old
+ *  objects are never scanned.  Survivors are promoted by moving the old
+ *  generation boundary to the head of heap_allocated.
+ *
+ *  The marking functions are reused: with heap->ms_minor_op set, the
+ *  duk__mark_heaphdr() calls for an object's children are routed to
+ *  duk__ms_minor_visit() which only acts on nursery objects (TEMPROOT set).
+ */
+
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+DUK_LOCAL void duk__ms_minor_visit(duk_heap *heap, duk_heaphdr *h) {
+	/* Strings are never in the nursery; they may have a stale TEMPROOT
+	 * flag from a recursion limited mark-and-sweep.
+	 */
+	if (!DUK_HEAPHDR_HAS_TEMPROOT(h) || DUK_HEAPHDR_IS_STRING(h)) {
+		return;
+	}
+
+	switch (heap->ms_minor_op) {
+	case DUK_MS_MINOR_OP_DECREF:
+		DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT(h) > 0);
+		DUK_HEAPHDR_PREDEC_REFCOUNT(h);
+		break;
+	case DUK_MS_MINOR_OP_MARK:
+		if (!DUK_HEAPHDR_HAS_REACHABLE(h)) {
+			DUK_HEAPHDR_SET_REACHABLE(h);
+			duk__ms_list_remove(heap, &heap->ms_minor_list, h);
+			duk__ms_list_insert(heap, &heap->ms_minor_grey, h);
+		}
+		break;
+	default:
+		DUK_ASSERT(heap->ms_minor_op == DUK_MS_MINOR_OP_INCREF);
+		DUK_HEAPHDR_PREINC_REFCOUNT(h);
+		break;
+	}
+}
+
+/* Visit the children of each object in a list with the given operation. */
+DUK_LOCAL void duk__ms_minor_visit_list(duk_heap *heap, duk_heaphdr *hdr, duk_small_uint_t op) {
+	heap->ms_minor_op = op;
+	for (; hdr != NULL; hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr)) {
+		if (DUK_HEAPHDR_IS_OBJECT(hdr)) {
+			duk__mark_hobject(heap, (duk_hobject *) hdr);
+		}
+	}
+	heap->ms_minor_op = DUK_MS_MINOR_OP_NONE;
+}
+
+/* Objects which must survive regardless of their refcount: heap level
+ * roots which may not be refcounted, and objects with finalizers which
+ * are left to full mark-and-sweep.
+ */
+DUK_LOCAL duk_bool_t duk__ms_minor_is_root(duk_heap *heap, duk_heaphdr *hdr) {
+	if (DUK_HEAPHDR_GET_REFCOUNT(hdr) > 0) {
+		return 1;
+	}
+	if (!DUK_HEAPHDR_IS_OBJECT(hdr)) {
+		return 0;
+	}
+	if (hdr == (duk_heaphdr *) heap->heap_thread ||
+	    hdr == (duk_heaphdr *) heap->heap_object ||
+	    hdr == (duk_heaphdr *) heap->curr_thread) {
+		return 1;
+	}
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	if (DUK_HEAPHDR_HAS_FINALIZED(hdr) ||
+	    DUK_HOBJECT_HAS_FINALIZER_FAST(heap, (duk_hobject *) hdr)) {
+		return 1;
+	}
+#endif
+	return 0;
+}
+
+DUK_INTERNAL void duk_heap_mark_and_sweep_minor(duk_heap *heap) {
+	duk_heaphdr *hdr;
+	duk_heaphdr *next;
+	duk_heaphdr *survivors;
+	duk_uint32_t count_free;
+
+	if (heap->ms_prevent_count != 0) {
+		DUK_DD(DUK_DDPRINT("gc blocked -> skip minor collection now"));
+		return;
+	}
+	DUK_ASSERT(heap->ms_running == 0);
+	DUK_ASSERT(heap->heap_thread != NULL);
+	DUK_ASSERT(heap->ms_minor_op == DUK_MS_MINOR_OP_NONE);
+	DUK_ASSERT(heap->ms_minor_list == NULL);
+	DUK_ASSERT(heap->ms_minor_grey == NULL);
+
+	DUK_D(DUK_DPRINT("minor collection starting, %ld objects allocated", (long) heap->ms_young_count));
+
+	heap->ms_prevent_count = 1;
+	heap->ms_running = 1;
+	heap->ms_young_count = 0;
+
+	/* Detach the nursery from heap_allocated. */
+	hdr = heap->ms_old_head;
+	if (hdr == heap->heap_allocated) {
+		goto done;
+	}
+	heap->ms_minor_list = heap->heap_allocated;
+	if (hdr != NULL) {
+		DUK_ASSERT(DUK_HEAPHDR_GET_PREV(heap, hdr) != NULL);
+		DUK_HEAPHDR_SET_NEXT(heap, DUK_HEAPHDR_GET_PREV(heap, hdr), NULL);
+		DUK_HEAPHDR_SET_PREV(heap, hdr, NULL);
+	}
+	heap->heap_allocated = hdr;
+
+	for (hdr = heap->ms_minor_list; hdr != NULL; hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr)) {
+		DUK_ASSERT(!DUK_HEAPHDR_HAS_REACHABLE(hdr));
+		DUK_ASSERT(!DUK_HEAPHDR_HAS_TEMPROOT(hdr));
+		DUK_ASSERT(!DUK_HEAPHDR_HAS_READONLY(hdr));
+		DUK_HEAPHDR_SET_TEMPROOT(hdr);
+	}
+
+	/* Subtract references internal to the nursery. */
+	duk__ms_minor_visit_list(heap, heap->ms_minor_list, DUK_MS_MINOR_OP_DECREF);
+
+	/* Mark from objects referenced from outside the nursery. */
+	heap->ms_minor_op = DUK_MS_MINOR_OP_MARK;
+	for (hdr = heap->ms_minor_list; hdr != NULL; hdr = next) {
+		next = DUK_HEAPHDR_GET_NEXT(heap, hdr);
+		if (duk__ms_minor_is_root(heap, hdr)) {
+			duk__ms_minor_visit(heap, hdr);
+		}
+	}
+	survivors = NULL;
+	while ((hdr = heap->ms_minor_grey) != NULL) {
+		duk__ms_list_remove(heap, &heap->ms_minor_grey, hdr);
+		duk__ms_list_insert(heap, &survivors, hdr);
+		if (DUK_HEAPHDR_IS_OBJECT(hdr)) {
+			duk__mark_hobject(heap, (duk_hobject *) hdr);
+		}
+	}
+	heap->ms_minor_op = DUK_MS_MINOR_OP_NONE;
+
+	/* Restore refcounts, then drop references held by the garbage. */
+	duk__ms_minor_visit_list(heap, survivors, DUK_MS_MINOR_OP_INCREF);
+	duk__ms_minor_visit_list(heap, heap->ms_minor_list, DUK_MS_MINOR_OP_INCREF);
+
+	for (hdr = heap->ms_minor_list; hdr != NULL; hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr)) {
+		DUK_HEAPHDR_CLEAR_TEMPROOT(hdr);
+	}
+	for (hdr = heap->ms_minor_list; hdr != NULL; hdr = DUK_HEAPHDR_GET_NEXT(heap, hdr)) {
+		/* Old objects whose refcount drops to zero here are freed
+		 * by the next full mark-and-sweep.
+		 */
+		duk_heaphdr_refcount_finalize_norz(heap, hdr);
+	}
+	count_free = 0;
+	while ((hdr = heap->ms_minor_list) != NULL) {
+		heap->ms_minor_list = DUK_HEAPHDR_GET_NEXT(heap, hdr);
+		DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT(hdr) == 0);
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+		duk_heap_bgfree_heaphdr(heap, hdr);
+#else
+		duk_heap_free_heaphdr_raw(heap, hdr);
+#endif
+		count_free++;
+	}
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+	duk_heap_bgfree_flush(heap, 0 /*wait*/);
+#endif
+
+	/* Promote survivors. */
+	while ((hdr = survivors) != NULL) {
+		duk__ms_list_remove(heap, &survivors, hdr);
+		DUK_HEAPHDR_CLEAR_REACHABLE(hdr);
+		DUK_HEAPHDR_CLEAR_TEMPROOT(hdr);
+		duk__ms_list_insert(heap, &heap->heap_allocated, hdr);
+	}
+
+	heap->ms_minor_cycles++;
+	heap->ms_minor_freed += count_free;
+	DUK_D(DUK_DPRINT("minor collection finished, %ld objects freed", (long) count_free));
+
+ done:
+	heap->ms_old_head = heap->heap_allocated;
+
+	DUK_ASSERT(heap->ms_prevent_count == 1);
+	heap->ms_prevent_count = 0;
+	DUK_ASSERT(heap->ms_running == 1);
+	heap->ms_running = 0;
+}
+#endif  /* DUK_USE_MARK_AND_SWEEP_NURSERY */
+
+/*
+ *  Stats dump.
+ */
+
+#if defined(DUK_USE_DEBUG)
+DUK_LOCAL void duk__dump_stats(duk_heap *heap) {
+	DUK_D(DUK_DPRINT("stats executor: opcodes=%ld, interrupt=%ld, throw=%ld",
+	                 (long) heap->stats_exec_opcodes, (long) heap->stats_exec_interrupt,
+	                 (long) heap->stats_exec_throw));
+	DUK_D(DUK_DPRINT("stats call: all=%ld, tailcall=%ld, ecmatoecma=%ld",
+	                 (long) heap->stats_call_all, (long) heap->stats_call_tailcall,
+	                 (long) heap->stats_call_ecmatoecma));
+	DUK_D(DUK_DPRINT("stats safecall: all=%ld, nothrow=%ld, throw=%ld",
+	                 (long) heap->stats_safecall_all, (long) heap->stats_safecall_nothrow,
+	                 (long) heap->stats_safecall_throw));
+	DUK_D(DUK_DPRINT("stats mark-and-sweep: try_count=%ld, skip_count=%ld, emergency_count=%ld",
+	                 (long) heap->stats_ms_try_count, (long) heap->stats_ms_skip_count,
+	                 (long) heap->stats_ms_emergency_count));
+	DUK_D(DUK_DPRINT("stats stringtable: intern_hit=%ld, intern_miss=%ld, "
+	                 "resize_check=%ld, resize_grow=%ld, resize_shrink=%ld, "
+	                 "litcache_hit=%ld, litcache_miss=%ld, litcache_pin=%ld, "
+	                 "rope_create=%ld, rope_flatten=%ld",
+	                 (long) heap->stats_strtab_intern_hit, (long) heap->stats_strtab_intern_miss,
+	                 (long) heap->stats_strtab_resize_check, (long) heap->stats_strtab_resize_grow,
+	                 (long) heap->stats_strtab_resize_shrink, (long) heap->stats_strtab_litcache_hit,
+	                 (long) heap->stats_strtab_litcache_miss, (long) heap->stats_strtab_litcache_pin,
+	                 (long) heap->stats_strtab_rope_create, (long) heap->stats_strtab_rope_flatten));
 	DUK_D(DUK_DPRINT("stats object: realloc_props=%ld, abandon_array=%ld",
 	                 (long) heap->stats_object_realloc_props, (long) heap->stats_object_abandon_array));
 	DUK_D(DUK_DPRINT("stats getownpropdesc: count=%ld, hit=%ld, miss=%ld",
@@ -1146,10 +2412,17 @@ DUK_LOCAL void duk__dump_stats(duk_heap *heap) {
 	                 (long) heap->stats_putprop_all, (long) heap->stats_putprop_arrayidx,
 	                 (long) heap->stats_putprop_bufobjidx, (long) heap->stats_putprop_bufferidx,
 	                 (long) heap->stats_putprop_proxy));
+	DUK_D(DUK_DPRINT("stats propic: hit=%ld, miss=%ld",
+	                 (long) heap->stats_propic_hit, (long) heap->stats_propic_miss));
 	DUK_D(DUK_DPRINT("stats getvar: all=%ld",
 	                 (long) heap->stats_getvar_all));
 	DUK_D(DUK_DPRINT("stats putvar: all=%ld",
 	                 (long) heap->stats_putvar_all));
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	DUK_D(DUK_DPRINT("stats incremental mark-and-sweep: cycles=%ld, slices=%ld, pause_max=%lf, pause_total=%lf",
+	                 (long) heap->ms_incr_cycles, (long) heap->ms_incr_slices,
+	                 (double) heap->ms_incr_pause_max, (double) heap->ms_incr_pause_total));
+#endif
 }
 #endif  /* DUK_USE_DEBUG */
 
@@ -1191,6 +2464,29 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 	}
 	DUK_ASSERT(heap->ms_running == 0);  /* ms_prevent_count is bumped when ms_running is set */
 
+#if defined(DUK_USE_REFZERO_DEFER)
+	/* Deferred table entries are counted references which mark-and-sweep
+	 * doesn't know about; release them first.  Finalizers are queued and
+	 * run at the end as for any other garbage.
+	 */
+	if (heap->refzero_defer_top != 0U) {
+		duk_heap_refzero_defer_flush(heap, 1 /*skip_finalizers*/);
+	}
+#endif
+
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* Voluntary GC runs a bounded slice of an incremental cycle; other
+	 * requests complete the cycle in progress and then do a full pass.
+	 */
+	if ((flags & (DUK_MS_FLAG_VOLUNTARY | DUK_MS_FLAG_EMERGENCY)) == DUK_MS_FLAG_VOLUNTARY) {
+		duk__ms_incr_slice(heap);
+		return;
+	}
+	if (heap->ms_incr_phase != DUK_MS_INCR_PHASE_IDLE) {
+		duk__ms_incr_complete(heap);
+	}
+#endif
+
 	/* Heap_thread is used during mark-and-sweep for refcount finalization
 	 * (it's also used for finalizer execution once mark-and-sweep is
 	 * complete).  Heap allocation code ensures heap_thread is set and
@@ -1219,6 +2515,10 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 	DUK_ASSERT(!DUK_HEAP_HAS_DEBUGGER_PAUSED(heap));
 	DUK_ASSERT(!DUK_HEAP_HAS_MARKANDSWEEP_RECLIMIT_REACHED(heap));
 	DUK_ASSERT(heap->ms_recursion_depth == 0);
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+	DUK_ASSERT(heap->ms_mark_chunk == NULL || (heap->ms_mark_top == 0 && heap->ms_mark_chunk->prev == NULL));
+	DUK_ASSERT(heap->ms_mark_spare == NULL);
+#endif
 	duk__assert_heaphdr_flags(heap);
 #if defined(DUK_USE_REFERENCE_COUNTING)
 	/* Note: heap->refzero_free_running may be true; a refcount
@@ -1267,18 +2567,32 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 #endif
 #if defined(DUK_USE_LITCACHE_SIZE)
 	duk__wipe_litcache(heap);
+#endif
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	heap->shape_mark_gen++;                   /* Shapes marked during this round have mark_gen == shape_mark_gen. */
+	if (DUK_UNLIKELY(heap->shape_mark_gen == 0)) {
+		/* Zero is the initial mark_gen of new shapes, skip it. */
+		heap->shape_mark_gen++;
+	}
 #endif
 	duk__mark_roots_heap(heap);               /* Mark main reachability roots. */
 #if defined(DUK_USE_REFERENCE_COUNTING)
 	DUK_ASSERT(heap->refzero_list == NULL);   /* Always handled to completion inline in DECREF. */
 #endif
 	duk__mark_temproots_by_heap_scan(heap);   /* Temproots. */
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	duk__mark_weak_mapsets(heap);             /* WeakMap values with reachable keys. */
+#endif
 
 #if defined(DUK_USE_FINALIZER_SUPPORT)
 	duk__mark_finalizable(heap);              /* Mark finalizable as reachability roots. */
 	duk__mark_finalize_list(heap);            /* Mark finalizer work list as reachability roots. */
 #endif
 	duk__mark_temproots_by_heap_scan(heap);   /* Temproots. */
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	duk__mark_weak_mapsets(heap);             /* Again, finalizable objects may be weak keys. */
+	duk__clear_weak_mapsets(heap);            /* Drop weak entries with unreachable keys. */
+#endif
 
 	/*
 	 *  Sweep garbage and remove marking flags, and move objects with
@@ -1300,7 +2614,14 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 	duk__finalize_refcounts(heap);
 #endif
 	duk__sweep_heap(heap, flags, &count_keep_obj);
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	heap->ms_old_head = heap->heap_allocated;  /* Everything kept is now old. */
+	heap->ms_young_count = 0;
+#endif
 	duk__sweep_stringtable(heap, &count_keep_str);
+#if defined(DUK_USE_HSTRING_ROPES)
+	duk__sweep_ropes(heap);
+#endif
 #if defined(DUK_USE_ASSERTIONS) && defined(DUK_USE_REFERENCE_COUNTING)
 	duk__check_assert_refcounts(heap);
 #endif
@@ -1310,6 +2631,12 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 #if defined(DUK_USE_FINALIZER_SUPPORT)
 	duk__clear_finalize_list_flags(heap);
 #endif
+#if defined(DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE)
+	/* Only voluntary GC lets the helper thread finish on its own; other
+	 * callers, e.g. allocation retry, expect the memory to be available.
+	 */
+	duk_heap_bgfree_flush(heap, (flags & DUK_MS_FLAG_VOLUNTARY) ? 0 : 1 /*wait*/);
+#endif
 
 	/*
 	 *  Object compaction (emergency only).
@@ -1366,6 +2693,10 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 	DUK_ASSERT(heap->ms_prevent_count == 0);
 	DUK_ASSERT(!DUK_HEAP_HAS_MARKANDSWEEP_RECLIMIT_REACHED(heap));
 	DUK_ASSERT(heap->ms_recursion_depth == 0);
+#if defined(DUK_USE_MARK_AND_SWEEP_MARK_STACK)
+	DUK_ASSERT(heap->ms_mark_chunk == NULL || (heap->ms_mark_top == 0 && heap->ms_mark_chunk->prev == NULL));
+	DUK_ASSERT(heap->ms_mark_spare == NULL);
+#endif
 	duk__assert_heaphdr_flags(heap);
 #if defined(DUK_USE_REFERENCE_COUNTING)
 	/* Note: heap->refzero_free_running may be true; a refcount
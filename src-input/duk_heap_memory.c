@@ -10,6 +10,14 @@
 
 #if defined(DUK_USE_VOLUNTARY_GC)
 DUK_LOCAL DUK_INLINE void duk__check_voluntary_gc(duk_heap *heap) {
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	/* A minor collection is retried on every allocation while GC is
+	 * prevented; the count is reset only when it actually runs.
+	 */
+	if (DUK_UNLIKELY(heap->ms_young_count >= DUK_USE_MARK_AND_SWEEP_NURSERY_SIZE)) {
+		duk_heap_mark_and_sweep_minor(heap);
+	}
+#endif
 	if (DUK_UNLIKELY(--(heap)->ms_trigger_counter < 0)) {
 #if defined(DUK_USE_DEBUG)
 		if (heap->ms_prevent_count == 0) {
@@ -21,6 +21,9 @@ DUK_INTERNAL void duk_heap_insert_into_heap_allocated(duk_heap *heap, duk_heaphd
 	DUK_ASSERT_HEAPHDR_LINKS(heap, hdr);
 	DUK_ASSERT_HEAPHDR_LINKS(heap, root);
 	heap->heap_allocated = hdr;
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	heap->ms_young_count++;
+#endif
 }
 
 #if defined(DUK_USE_REFERENCE_COUNTING)
@@ -32,6 +35,16 @@ DUK_INTERNAL void duk_heap_remove_from_heap_allocated(duk_heap *heap, duk_heaphd
 	DUK_ASSERT(hdr != NULL);
 	DUK_ASSERT(DUK_HEAPHDR_GET_TYPE(hdr) != DUK_HTYPE_STRING);
 
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* During an incremental cycle the object may be on one of the
+	 * mark-and-sweep work lists, or be the sweep cursor.
+	 */
+	if (DUK_UNLIKELY(heap->ms_incr_phase != DUK_MS_INCR_PHASE_IDLE)) {
+		duk_heap_ms_incr_unlink(heap, hdr);
+		return;
+	}
+#endif
+
 	/* Target 'hdr' must be in heap_allocated (not e.g. finalize_list).
 	 * If not, heap lists will become corrupted so assert early for it.
 	 */
@@ -51,6 +64,12 @@ DUK_INTERNAL void duk_heap_remove_from_heap_allocated(duk_heap *heap, duk_heaphd
 	prev = DUK_HEAPHDR_GET_PREV(heap, hdr);
 	next = DUK_HEAPHDR_GET_NEXT(heap, hdr);
 
+#if defined(DUK_USE_MARK_AND_SWEEP_NURSERY)
+	if (DUK_UNLIKELY(hdr == heap->ms_old_head)) {
+		heap->ms_old_head = next;
+	}
+#endif
+
 	if (prev != NULL) {
 		DUK_ASSERT(heap->heap_allocated != hdr);
 		DUK_HEAPHDR_SET_NEXT(heap, prev, next);
@@ -145,12 +164,25 @@ DUK_INTERNAL duk_bool_t duk_heap_in_heap_allocated(duk_heap *heap, duk_heaphdr *
 }
 #endif  /* DUK_USE_ASSERTIONS */
 
-#if defined(DUK_USE_INTERRUPT_COUNTER)
+#if defined(DUK_USE_INTERRUPT_COUNTER) || defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
 DUK_INTERNAL void duk_heap_switch_thread(duk_heap *heap, duk_hthread *new_thr) {
+#if defined(DUK_USE_INTERRUPT_COUNTER)
 	duk_hthread *curr_thr;
+#endif
 
 	DUK_ASSERT(heap != NULL);
 
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* The current thread's value stack is manipulated without write
+	 * barriers (values are moved, not copied), so it must be fully
+	 * scanned while marking is in progress.
+	 */
+	if (DUK_UNLIKELY(heap->ms_incr_marking != 0U) && new_thr != NULL) {
+		duk_heap_ms_incr_blacken_thread(heap, new_thr);
+	}
+#endif
+
+#if defined(DUK_USE_INTERRUPT_COUNTER)
 	if (new_thr != NULL) {
 		curr_thr = heap->curr_thread;
 		if (curr_thr == NULL) {
@@ -175,7 +207,8 @@ DUK_INTERNAL void duk_heap_switch_thread(duk_heap *heap, duk_hthread *new_thr) {
 	} else {
 		DUK_DD(DUK_DDPRINT("switch thread, new thread is NULL, no interrupt counter changes"));
 	}
+#endif  /* DUK_USE_INTERRUPT_COUNTER */
 
 	heap->curr_thread = new_thr;  /* may be NULL */
 }
-#endif  /* DUK_USE_INTERRUPT_COUNTER */
+#endif  /* DUK_USE_INTERRUPT_COUNTER || DUK_USE_MARK_AND_SWEEP_INCREMENTAL */
@@ -70,7 +70,9 @@ DUK_INTERNAL void duk_hobject_refcount_finalize_norz(duk_heap *heap, duk_hobject
 		if (DUK_UNLIKELY(key == NULL)) {
 			continue;
 		}
+#if !defined(DUK_USE_HOBJECT_SHAPES)
 		DUK_HSTRING_DECREF_NORZ(thr, key);
+#endif
 		if (DUK_UNLIKELY(p_flag[n] & DUK_PROPDESC_FLAG_ACCESSOR)) {
 			duk_hobject *h_getset;
 			h_getset = p_val[n].a.get;
@@ -96,6 +98,15 @@ DUK_INTERNAL void duk_hobject_refcount_finalize_norz(duk_heap *heap, duk_hobject
 
 	/* Hash part is a 'weak reference' and doesn't contribute to refcounts. */
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* Keys are referenced by the shape; the shape may also be freed here,
+	 * which releases the keys.
+	 */
+	DUK_ASSERT(h->shape != NULL);
+	duk_hshape_decref(heap, h->shape, 1 /*decref_keys*/);
+	h->shape = NULL;
+#endif
+
 	h_proto = (duk_hobject *) DUK_HOBJECT_GET_PROTOTYPE(heap, h);
 	DUK_ASSERT(h_proto == NULL || DUK_HEAPHDR_IS_OBJECT((duk_heaphdr *) h_proto));
 	DUK_HOBJECT_DECREF_NORZ_ALLOWNULL(thr, h_proto);
@@ -182,6 +193,22 @@ DUK_INTERNAL void duk_hobject_refcount_finalize_norz(duk_heap *heap, duk_hobject
 		DUK_HOBJECT_DECREF_NORZ(thr, p->target);
 		DUK_HOBJECT_DECREF_NORZ(thr, p->handler);
 #endif  /* DUK_USE_ES6_PROXY */
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	} else if (DUK_HOBJECT_IS_PROMISE(h)) {
+		duk_hpromise *p = (duk_hpromise *) h;
+		DUK_ASSERT_HPROMISE_VALID(p);
+		DUK_TVAL_DECREF_NORZ(thr, &p->result);
+		duk__decref_tvals_norz(thr, p->reactions, (duk_idx_t) (p->reactions_count * DUK_HPROMISE_REACTION_SIZE));
+#endif  /* DUK_USE_PROMISE_BUILTIN */
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+	} else if (DUK_HOBJECT_IS_MAPSET(h)) {
+		duk_hmapset *m = (duk_hmapset *) h;
+		DUK_ASSERT_HMAPSET_VALID(m);
+		/* Weak keys are INCREF'd too, deleted (UNUSED) entries are
+		 * ignored by the decref.
+		 */
+		duk__decref_tvals_norz(thr, m->entries, (duk_idx_t) (m->e_used * DUK_HMAPSET_GET_STRIDE(m)));
+#endif  /* DUK_USE_MAP_SET_BUILTIN */
 	} else if (DUK_HOBJECT_IS_THREAD(h)) {
 		duk_hthread *t = (duk_hthread *) h;
 		duk_activation *act;
@@ -346,7 +373,13 @@ DUK_LOCAL DUK_INLINE void duk__refcount_refzero_hobject(duk_heap *heap, duk_hobj
 	 * artificial +1 refcount bump.
 	 */
 #if defined(DUK_USE_ASSERTIONS)
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* May also be on an incremental mark-and-sweep work list. */
+	DUK_ASSERT(heap->ms_incr_phase != DUK_MS_INCR_PHASE_IDLE ||
+	           duk_heap_in_heap_allocated(heap, (duk_heaphdr *) obj));
+#else
 	DUK_ASSERT(duk_heap_in_heap_allocated(heap, (duk_heaphdr *) obj));
+#endif
 #endif
 
 	DUK_HEAP_REMOVE_FROM_HEAP_ALLOCATED(heap, hdr);
@@ -458,6 +491,63 @@ DUK_INTERNAL void duk_refzero_check_slow(duk_hthread *thr) {
 }
 #endif  /* DUK_USE_FINALIZER_SUPPORT */
 
+/*
+ *  Deferred refzero (DUK_USE_REFZERO_DEFER).
+ *
+ *  Executor register writes call duk_heap_refzero_defer() instead of
+ *  refzero.  The refcount is bumped back to 1 so that the table entry is
+ *  a counted reference: the value can't be freed (e.g. by a DECREF after
+ *  it's been looked up again from the string table) while it's queued,
+ *  and a value queued more than once is simply DECREF'd more than once.
+ */
+
+#if defined(DUK_USE_REFZERO_DEFER)
+DUK_INTERNAL void duk_heap_refzero_defer_flush(duk_heap *heap, duk_bool_t skip_finalizers) {
+	duk_hthread *thr;
+	duk_heaphdr *h;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(heap->heap_thread != NULL);
+	DUK_ASSERT(heap->refzero_list == NULL);
+	thr = heap->heap_thread;
+
+	DUK_DD(DUK_DDPRINT("reconcile %ld deferred refzero entries", (long) heap->refzero_defer_top));
+
+	/* NORZ so that no finalizer can run and append to the table while
+	 * it is being processed; the free cascade itself never does that.
+	 */
+	while (heap->refzero_defer_top > 0U) {
+		h = heap->refzero_defer[--heap->refzero_defer_top];
+		DUK_ASSERT(h != NULL);
+		DUK_HEAPHDR_DECREF_NORZ(thr, h);
+	}
+
+	if (!skip_finalizers) {
+		DUK_REFZERO_CHECK_SLOW(thr);
+	}
+}
+
+DUK_INTERNAL void duk_heap_refzero_defer(duk_hthread *thr, duk_heaphdr *h) {
+	duk_heap *heap;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(h != NULL);
+	DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT(h) == 0);
+	heap = thr->heap;
+
+	DUK_HEAPHDR_PREINC_REFCOUNT(h);
+
+	/* Register writes may have side effects like an ordinary DECREF,
+	 * so a full table is reconciled with finalizers.  Finalizers may
+	 * defer more values, hence the loop.
+	 */
+	while (DUK_UNLIKELY(heap->refzero_defer_top >= DUK_HEAP_REFZERO_DEFER_SIZE)) {
+		duk_heap_refzero_defer_flush(heap, 0 /*skip_finalizers*/);
+	}
+	heap->refzero_defer[heap->refzero_defer_top++] = h;
+}
+#endif  /* DUK_USE_REFZERO_DEFER */
+
 /*
  *  Refzero processing for duk_hstring.
  */
@@ -468,6 +558,14 @@ DUK_LOCAL DUK_INLINE void duk__refcount_refzero_hstring(duk_heap *heap, duk_hstr
 	DUK_ASSERT(str != NULL);
 	DUK_ASSERT(DUK_HEAPHDR_GET_TYPE((duk_heaphdr *) str) == DUK_HTYPE_STRING);
 
+#if defined(DUK_USE_HSTRING_ROPES)
+	if (DUK_UNLIKELY(DUK_HSTRING_IS_ROPE(str))) {
+		/* Ropes are not in the string table or the string cache. */
+		duk_hstring_rope_free_refzero(heap, (duk_hstring_rope *) str);
+		return;
+	}
+#endif
+
 	duk_heap_strcache_string_remove(heap, str);
 	duk_heap_strtable_unlink(heap, str);
 	duk_free_hstring(heap, str);
@@ -482,6 +482,13 @@ DUK_LOCAL DUK_COLD DUK_NOINLINE void duk__strtable_resize_check(duk_heap *heap)
 		DUK_D(DUK_DPRINT("prevent recursive strtable resize"));
 		return;
 	}
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+	/* An incremental string table sweep walks buckets by index. */
+	if (DUK_UNLIKELY(heap->ms_incr_phase == DUK_MS_INCR_PHASE_STRSWEEP)) {
+		DUK_DD(DUK_DDPRINT("postpone strtable resize, incremental sweep in progress"));
+		return;
+	}
+#endif
 
 	heap->st_resizing = 1;
 
@@ -0,0 +1,92 @@
+/*
+ *  Map, Set, WeakMap, and WeakSet object representation.
+ *
+ *  All four variants share a single object class and differ only in
+ *  'kind'.  Entries live in an insertion ordered array, one duk_tval per
+ *  entry for sets and two (key, value) for maps.  Deleted entries are left
+ *  in place as UNUSED keys so that iteration order and indices of live
+ *  entries stay stable; they're dropped when the table is resized.
+ *
+ *  A separate open addressing hash part (linear probing, size a power of
+ *  two and at least twice the entry array size) maps key hashes to entry
+ *  indices.  Hash slots are never deleted: a slot pointing to a deleted
+ *  entry is simply skipped during lookup, which also allows mark-and-sweep
+ *  to drop weak entries without touching the hash part.  Both parts share
+ *  a single allocation:
+ *
+ *    [ entries: e_size * stride duk_tvals ][ hash: h_size duk_uint32_t ]
+ *
+ *  Keys are compared using SameValueZero; a -0 key is normalized to +0 on
+ *  insertion so that SameValue can be used for the comparison.
+ *
+ *  Keys of weak variants are objects which are INCREF'd like strong keys,
+ *  so reference counting never frees them while they're in the table.
+ *  Mark-and-sweep doesn't mark weak keys and only marks a WeakMap value
+ *  once its key is otherwise reachable (ephemeron semantics), and removes
+ *  entries with unreachable keys before sweeping.
+ */
+
+#if !defined(DUK_HMAPSET_H_INCLUDED)
+#define DUK_HMAPSET_H_INCLUDED
+
+#define DUK_HMAPSET_KIND_MAP             0
+#define DUK_HMAPSET_KIND_SET             1
+#define DUK_HMAPSET_KIND_WEAKMAP         2
+#define DUK_HMAPSET_KIND_WEAKSET         3
+
+#define DUK_HMAPSET_KIND_FLAG_NOVALUES   1
+#define DUK_HMAPSET_KIND_FLAG_WEAK       2
+
+#define DUK_HMAPSET_IS_WEAK(h)           (((h)->kind & DUK_HMAPSET_KIND_FLAG_WEAK) != 0)
+#define DUK_HMAPSET_HAS_VALUES(h)        (((h)->kind & DUK_HMAPSET_KIND_FLAG_NOVALUES) == 0)
+#define DUK_HMAPSET_GET_STRIDE(h)        (DUK_HMAPSET_HAS_VALUES((h)) ? 2 : 1)
+
+/* Hash slot value for an unused slot, used slots contain entry index + 1. */
+#define DUK_HMAPSET_HASH_UNUSED          0
+
+#define DUK_HMAPSET_GET_HASH(h) \
+	((duk_uint32_t *) (void *) ((h)->entries + (duk_size_t) (h)->e_size * DUK_HMAPSET_GET_STRIDE((h))))
+#define DUK_HMAPSET_GET_KEY_PTR(h,i) \
+	((h)->entries + (duk_size_t) (i) * DUK_HMAPSET_GET_STRIDE((h)))
+
+#define DUK_ASSERT_HMAPSET_VALID(h) do { \
+		DUK_ASSERT((h) != NULL); \
+		DUK_ASSERT(DUK_HOBJECT_IS_MAPSET((duk_hobject *) (h))); \
+		DUK_ASSERT((h)->kind <= DUK_HMAPSET_KIND_WEAKSET); \
+		DUK_ASSERT((h)->e_used <= (h)->e_size); \
+		DUK_ASSERT((h)->count <= (h)->e_used); \
+		DUK_ASSERT((h)->e_size == 0 || (h)->entries != NULL); \
+		DUK_ASSERT((h)->e_size == 0 || (h)->h_size >= 2 * (h)->e_size); \
+		DUK_ASSERT(((h)->h_size & ((h)->h_size - 1)) == 0); \
+	} while (0)
+
+struct duk_hmapset {
+	/* Shared object part. */
+	duk_hobject obj;
+
+	/* Entry and hash parts, see above. */
+	duk_tval *entries;
+
+	/* Entry array size and number of entries used (live and deleted),
+	 * counted in entries (not duk_tvals).  New entries are appended at
+	 * e_used.
+	 */
+	duk_uint32_t e_size;
+	duk_uint32_t e_used;
+
+	/* Number of live entries, i.e. .size. */
+	duk_uint32_t count;
+
+	/* Hash part size, zero or a power of two. */
+	duk_uint32_t h_size;
+
+	/* Number of active forEach() loops; deleted entries are not
+	 * compacted away while non-zero so that loop indices stay valid.
+	 */
+	duk_uint32_t iter_count;
+
+	/* DUK_HMAPSET_KIND_xxx. */
+	duk_small_uint_t kind;
+};
+
+#endif  /* DUK_HMAPSET_H_INCLUDED */
@@ -111,7 +111,9 @@
 #define DUK_HOBJECT_CLASS_FLOAT32ARRAY         28
 #define DUK_HOBJECT_CLASS_FLOAT64ARRAY         29
 #define DUK_HOBJECT_CLASS_BUFOBJ_MAX           29
-#define DUK_HOBJECT_CLASS_MAX                  29
+#define DUK_HOBJECT_CLASS_PROMISE              30  /* implies DUK_HOBJECT_IS_PROMISE */
+#define DUK_HOBJECT_CLASS_MAPSET               31  /* custom; implies DUK_HOBJECT_IS_MAPSET */
+#define DUK_HOBJECT_CLASS_MAX                  31
 
 /* Class masks. */
 #define DUK_HOBJECT_CMASK_ALL                  ((1UL << (DUK_HOBJECT_CLASS_MAX + 1)) - 1UL)
@@ -144,6 +146,8 @@
 #define DUK_HOBJECT_CMASK_UINT32ARRAY          (1UL << DUK_HOBJECT_CLASS_UINT32ARRAY)
 #define DUK_HOBJECT_CMASK_FLOAT32ARRAY         (1UL << DUK_HOBJECT_CLASS_FLOAT32ARRAY)
 #define DUK_HOBJECT_CMASK_FLOAT64ARRAY         (1UL << DUK_HOBJECT_CLASS_FLOAT64ARRAY)
+#define DUK_HOBJECT_CMASK_PROMISE              (1UL << DUK_HOBJECT_CLASS_PROMISE)
+#define DUK_HOBJECT_CMASK_MAPSET               (1UL << DUK_HOBJECT_CLASS_MAPSET)
 
 #define DUK_HOBJECT_CMASK_ALL_BUFOBJS \
 	(DUK_HOBJECT_CMASK_ARRAYBUFFER | \
@@ -176,6 +180,16 @@
 #else
 #define DUK_HOBJECT_IS_PROXY(h)                0
 #endif
+#if defined(DUK_USE_PROMISE_BUILTIN)
+#define DUK_HOBJECT_IS_PROMISE(h)              (DUK_HOBJECT_GET_CLASS_NUMBER((h)) == DUK_HOBJECT_CLASS_PROMISE)
+#else
+#define DUK_HOBJECT_IS_PROMISE(h)              0
+#endif
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+#define DUK_HOBJECT_IS_MAPSET(h)               (DUK_HOBJECT_GET_CLASS_NUMBER((h)) == DUK_HOBJECT_CLASS_MAPSET)
+#else
+#define DUK_HOBJECT_IS_MAPSET(h)               0
+#endif
 
 #define DUK_HOBJECT_IS_NONBOUND_FUNCTION(h)    DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, \
                                                         DUK_HOBJECT_FLAG_COMPFUNC | \
@@ -288,7 +302,7 @@
 #define DUK_HOBJECT_PROHIBITS_FASTREFS(h) \
 	(DUK_HOBJECT_IS_COMPFUNC((h)) || DUK_HOBJECT_IS_DECENV((h)) || DUK_HOBJECT_IS_OBJENV((h)) || \
 	 DUK_HOBJECT_IS_BUFOBJ((h)) || DUK_HOBJECT_IS_THREAD((h)) || DUK_HOBJECT_IS_PROXY((h)) || \
-	 DUK_HOBJECT_IS_BOUNDFUNC((h)))
+	 DUK_HOBJECT_IS_BOUNDFUNC((h)) || DUK_HOBJECT_IS_PROMISE((h)) || DUK_HOBJECT_IS_MAPSET((h)))
 #define DUK_HOBJECT_ALLOWS_FASTREFS(h) (!DUK_HOBJECT_PROHIBITS_FASTREFS((h)))
 
 /* Flags used for property attributes in duk_propdesc and packed flags.
@@ -372,7 +386,36 @@
 	} while (0)
 #endif
 
-#if defined(DUK_USE_HOBJECT_LAYOUT_1)
+#if defined(DUK_USE_HOBJECT_SHAPES)
+/* SHAPES: keys, flags, and the hash part live in the object's shape, see
+ * duk_hshape.h.  The 'props' allocation only contains entry part values
+ * followed by array part values, regardless of the layout selected.
+ */
+#define DUK_HOBJECT_E_GET_KEY_BASE(heap,h) \
+	((h)->shape->keys)
+#define DUK_HOBJECT_E_GET_VALUE_BASE(heap,h) \
+	((duk_propvalue *) (void *) ( \
+		DUK_HOBJECT_GET_PROPS((heap), (h)) \
+	))
+#define DUK_HOBJECT_E_GET_FLAGS_BASE(heap,h) \
+	((h)->shape->flags)
+#define DUK_HOBJECT_A_GET_BASE(heap,h) \
+	((duk_tval *) (void *) ( \
+		DUK_HOBJECT_GET_PROPS((heap), (h)) + \
+			DUK_HOBJECT_GET_ESIZE((h)) * sizeof(duk_propvalue) \
+	))
+#define DUK_HOBJECT_H_GET_BASE(heap,h) \
+	((h)->shape->hash)
+#define DUK_HOBJECT_P_COMPUTE_SIZE(n_ent,n_arr,n_hash) \
+	( \
+		(n_ent) * sizeof(duk_propvalue) + \
+		(n_arr) * sizeof(duk_tval) \
+	)
+#define DUK_HOBJECT_P_SET_REALLOC_PTRS(p_base,set_e_pv,set_a,n_ent)  do { \
+		(set_e_pv) = (duk_propvalue *) (void *) (p_base); \
+		(set_a) = (duk_tval *) (void *) ((set_e_pv) + (n_ent)); \
+	} while (0)
+#elif defined(DUK_USE_HOBJECT_LAYOUT_1)
 /* LAYOUT 1 */
 #define DUK_HOBJECT_E_GET_KEY_BASE(heap,h) \
 	((duk_hstring **) (void *) ( \
@@ -531,7 +574,23 @@
 #define DUK_HOBJECT_H_GET_INDEX(heap,h,i)            (DUK_HOBJECT_H_GET_BASE((heap), (h))[(i)])
 #define DUK_HOBJECT_H_GET_INDEX_PTR(heap,h,i)        (&DUK_HOBJECT_H_GET_BASE((heap), (h))[(i)])
 
+/* With shapes, keys and flags can only be written through a dictionary shape;
+ * call sites must use DUK_HOBJECT_ENSURE_DICT_SHAPE() first.
+ */
+#if defined(DUK_USE_HOBJECT_SHAPES)
+#define DUK_HOBJECT_ASSERT_E_WRITABLE(h)  DUK_ASSERT(DUK_HSHAPE_IS_DICT((h)->shape))
+#define DUK_HOBJECT_ENSURE_DICT_SHAPE(thr,h)  do { \
+		if (DUK_HSHAPE_IS_SHARED((h)->shape)) { \
+			duk_hobject_shape_make_dict((thr), (h)); \
+		} \
+	} while (0)
+#else
+#define DUK_HOBJECT_ASSERT_E_WRITABLE(h)  do { } while (0)
+#define DUK_HOBJECT_ENSURE_DICT_SHAPE(thr,h)  do { } while (0)
+#endif
+
 #define DUK_HOBJECT_E_SET_KEY(heap,h,i,k)  do { \
+		DUK_HOBJECT_ASSERT_E_WRITABLE((h)); \
 		DUK_HOBJECT_E_GET_KEY((heap), (h), (i)) = (k); \
 	} while (0)
 #define DUK_HOBJECT_E_SET_VALUE(heap,h,i,v)  do { \
@@ -547,6 +606,7 @@
 		DUK_HOBJECT_E_GET_VALUE((heap), (h), (i)).a.set = (v); \
 	} while (0)
 #define DUK_HOBJECT_E_SET_FLAGS(heap,h,i,f)  do { \
+		DUK_HOBJECT_ASSERT_E_WRITABLE((h)); \
 		DUK_HOBJECT_E_GET_FLAGS((heap), (h), (i)) = (duk_uint8_t) (f); \
 	} while (0)
 #define DUK_HOBJECT_A_SET_VALUE(heap,h,i,v)  do { \
@@ -559,10 +619,12 @@
 	} while (0)
 
 #define DUK_HOBJECT_E_SET_FLAG_BITS(heap,h,i,mask)  do { \
+		DUK_HOBJECT_ASSERT_E_WRITABLE((h)); \
 		DUK_HOBJECT_E_GET_FLAGS_BASE((heap), (h))[(i)] |= (mask); \
 	} while (0)
 
 #define DUK_HOBJECT_E_CLEAR_FLAG_BITS(heap,h,i,mask)  do { \
+		DUK_HOBJECT_ASSERT_E_WRITABLE((h)); \
 		DUK_HOBJECT_E_GET_FLAGS_BASE((heap), (h))[(i)] &= ~(mask); \
 	} while (0)
 
@@ -616,7 +678,13 @@
 #define DUK_HOBJECT_POSTINC_ENEXT(h) ((h)->e_next++)
 #define DUK_HOBJECT_GET_ASIZE(h) ((h)->a_size)
 #define DUK_HOBJECT_SET_ASIZE(h,v) do { (h)->a_size = (v); } while (0)
-#if defined(DUK_USE_HOBJECT_HASH_PART)
+#if defined(DUK_USE_HOBJECT_SHAPES) && defined(DUK_USE_HOBJECT_HASH_PART)
+/* Hash part size is a property of the shape; it's set up when the
+ * (dictionary) shape is allocated.
+ */
+#define DUK_HOBJECT_GET_HSIZE(h) ((h)->shape->h_size)
+#define DUK_HOBJECT_SET_HSIZE(h,v) do { DUK_ASSERT((h)->shape->h_size == (v)); } while (0)
+#elif defined(DUK_USE_HOBJECT_HASH_PART)
 #define DUK_HOBJECT_GET_HSIZE(h) ((h)->h_size)
 #define DUK_HOBJECT_SET_HSIZE(h,v) do { (h)->h_size = (v); } while (0)
 #else
@@ -824,6 +892,10 @@ struct duk_hobject {
 	 *  'props' also contains internal properties distinguished with a non-BMP
 	 *  prefix.  Often used properties should be placed early in 'props' whenever
 	 *  possible to make accessing them as fast a possible.
+	 *
+	 *  With DUK_USE_HOBJECT_SHAPES the entry keys, flags, and hash part are
+	 *  not stored in 'props' at all but in a (possibly shared) duk_hshape,
+	 *  and 'props' only contains e_size entry values and a_size array values.
 	 */
 
 #if defined(DUK_USE_HEAPPTR16)
@@ -852,10 +924,17 @@ struct duk_hobject {
 	duk_uint32_t e_size;  /* entry part size */
 	duk_uint32_t e_next;  /* index for next new key ([0,e_next[ are gc reachable) */
 	duk_uint32_t a_size;  /* array part size (entirely gc reachable) */
-#if defined(DUK_USE_HOBJECT_HASH_PART)
+#if defined(DUK_USE_HOBJECT_HASH_PART) && !defined(DUK_USE_HOBJECT_SHAPES)
 	duk_uint32_t h_size;  /* hash part size or 0 if unused */
 #endif
 #endif
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* Entry part keys, flags, and hash part; never NULL except for an
+	 * object whose refcounts have been finalized (about to be freed).
+	 */
+	duk_hshape *shape;
+#endif
 };
 
 /*
@@ -885,6 +964,12 @@ DUK_INTERNAL_DECL duk_hthread *duk_hthread_alloc(duk_hthread *thr, duk_uint_t ho
 DUK_INTERNAL_DECL duk_hdecenv *duk_hdecenv_alloc(duk_hthread *thr, duk_uint_t hobject_flags);
 DUK_INTERNAL_DECL duk_hobjenv *duk_hobjenv_alloc(duk_hthread *thr, duk_uint_t hobject_flags);
 DUK_INTERNAL_DECL duk_hproxy *duk_hproxy_alloc(duk_hthread *thr, duk_uint_t hobject_flags);
+#if defined(DUK_USE_PROMISE_BUILTIN)
+DUK_INTERNAL_DECL duk_hpromise *duk_hpromise_alloc(duk_hthread *thr, duk_uint_t hobject_flags);
+#endif
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+DUK_INTERNAL_DECL duk_hmapset *duk_hmapset_alloc(duk_hthread *thr, duk_uint_t hobject_flags);
+#endif
 
 /* resize */
 DUK_INTERNAL_DECL void duk_hobject_realloc_props(duk_hthread *thr,
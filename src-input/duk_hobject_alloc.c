@@ -37,6 +37,12 @@ DUK_LOCAL void duk__init_object_parts(duk_heap *heap, duk_uint_t hobject_flags,
 	DUK_ASSERT_HEAPHDR_LINKS(heap, &obj->hdr);
 	DUK_HEAP_INSERT_INTO_HEAP_ALLOCATED(heap, &obj->hdr);
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* All objects start out with the empty root shape. */
+	obj->shape = &heap->shape_root;
+	DUK_HSHAPE_INCREF(obj->shape);
+#endif
+
 	/* obj->props is intentionally left as NULL, and duk_hobject_props.c must deal
 	 * with this properly.  This is intentional: empty objects consume a minimum
 	 * amount of memory.  Further, an initial allocation might fail and cause
@@ -107,6 +113,12 @@ DUK_INTERNAL duk_hcompfunc *duk_hcompfunc_alloc(duk_hthread *thr, duk_uint_t hob
 #endif
 	res->lex_env = NULL;
 	res->var_env = NULL;
+#if defined(DUK_USE_PROP_IC)
+	res->propic = NULL;
+#endif
+#if defined(DUK_USE_JIT_X64)
+	res->jit = NULL;
+#endif
 #endif
 
 	return res;
@@ -269,3 +281,39 @@ DUK_INTERNAL duk_hproxy *duk_hproxy_alloc(duk_hthread *thr, duk_uint_t hobject_f
 
 	return res;
 }
+
+#if defined(DUK_USE_PROMISE_BUILTIN)
+DUK_INTERNAL duk_hpromise *duk_hpromise_alloc(duk_hthread *thr, duk_uint_t hobject_flags) {
+	duk_hpromise *res;
+
+	res = (duk_hpromise *) duk__hobject_alloc_init(thr, hobject_flags, sizeof(duk_hpromise));
+	DUK_TVAL_SET_UNDEFINED(&res->result);
+#if defined(DUK_USE_EXPLICIT_NULL_INIT)
+	res->reactions = NULL;
+#endif
+
+	DUK_ASSERT(res->reactions == NULL);
+	DUK_ASSERT(res->state == DUK_HPROMISE_STATE_PENDING);
+	DUK_ASSERT(res->resolve_id == 0);
+
+	return res;
+}
+#endif  /* DUK_USE_PROMISE_BUILTIN */
+
+#if defined(DUK_USE_MAP_SET_BUILTIN)
+DUK_INTERNAL duk_hmapset *duk_hmapset_alloc(duk_hthread *thr, duk_uint_t hobject_flags) {
+	duk_hmapset *res;
+
+	res = (duk_hmapset *) duk__hobject_alloc_init(thr, hobject_flags, sizeof(duk_hmapset));
+#if defined(DUK_USE_EXPLICIT_NULL_INIT)
+	res->entries = NULL;
+#endif
+
+	DUK_ASSERT(res->entries == NULL);
+	DUK_ASSERT(res->e_size == 0);
+	DUK_ASSERT(res->h_size == 0);
+	DUK_ASSERT(res->kind == DUK_HMAPSET_KIND_MAP);
+
+	return res;
+}
+#endif  /* DUK_USE_MAP_SET_BUILTIN */
@@ -88,6 +88,9 @@
 #if (DUK_STRIDX_FLOAT64_ARRAY > 255)
 #error constant too large
 #endif
+#if defined(DUK_USE_PROMISE_BUILTIN) && (DUK_STRIDX_PROMISE > 255)
+#error constant too large
+#endif
 #if (DUK_STRIDX_EMPTY_STRING > 255)
 #error constant too large
 #endif
@@ -124,6 +127,10 @@ DUK_INTERNAL duk_uint8_t duk_class_number_to_stridx[32] = {
 	DUK_STRIDX_UINT32_ARRAY,
 	DUK_STRIDX_FLOAT32_ARRAY,
 	DUK_STRIDX_FLOAT64_ARRAY,
-	DUK_STRIDX_EMPTY_STRING,  /* UNUSED, intentionally empty */
-	DUK_STRIDX_EMPTY_STRING,  /* UNUSED, intentionally empty */
+#if defined(DUK_USE_PROMISE_BUILTIN)
+	DUK_STRIDX_PROMISE,
+#else
+	DUK_STRIDX_EMPTY_STRING,  /* PROMISE, disabled */
+#endif
+	DUK_STRIDX_UC_OBJECT,     /* MAPSET, ES2015 uses @@toStringTag for the class name */
 };
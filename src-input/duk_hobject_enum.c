@@ -117,6 +117,7 @@ DUK_LOCAL void duk__sort_enum_keys_es6(duk_hthread *thr, duk_hobject *h_obj, duk
 		return;  /* Zero or one element(s). */
 	}
 
+	DUK_HOBJECT_ASSERT_E_WRITABLE(h_obj);
 	keys = DUK_HOBJECT_E_GET_KEY_BASE(thr->heap, h_obj);
 
 	for (idx = idx_start + 1; idx < idx_end; idx++) {
@@ -209,6 +210,11 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_hthread *thr, duk_small_uint
 	duk_push_bare_object(thr);
 	res = duk_known_hobject(thr, -1);
 
+	/* Enumerator keys are arbitrary and are sorted in place, so don't
+	 * bother with a shared shape.
+	 */
+	DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, res);
+
 	/* [enum_target res] */
 
 	/* Target must be stored so that we can recheck whether or not
@@ -158,9 +158,11 @@ DUK_LOCAL duk_uint32_t duk__to_property_key(duk_hthread *thr, duk_idx_t idx, duk
 		 * is.  For symbols the array index check below is unnecessary
 		 * (they're never valid array indices) but checking that the
 		 * string is a symbol would make the plain string path slower
-		 * unnecessarily.
+		 * unnecessarily.  A rope is flattened; the result remains
+		 * reachable through the rope.
 		 */
 		h = DUK_TVAL_GET_STRING(tv_dst);
+		h = DUK_HSTRING_FLATTEN(thr, h);
 	} else {
 		h = duk_to_property_key_hstring(thr, idx);
 	}
@@ -520,6 +522,9 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	duk_uint32_t new_e_next;
 	duk_uint_fast32_t i;
 	duk_size_t array_copy_size;
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	duk_hshape *new_shape;
+#endif
 #if defined(DUK_USE_ASSERTIONS)
 	duk_bool_t prev_error_not_allowed;
 #endif
@@ -536,6 +541,18 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 
 	DUK_STATS_INC(thr->heap, stats_object_realloc_props);
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* An object with a shared shape keeps its shape (and thus its hash
+	 * part) unless the array part is abandoned; only the values are
+	 * reallocated.  Otherwise a new dictionary shape is created.
+	 */
+	DUK_ASSERT(obj->shape != NULL);
+	if (DUK_HSHAPE_IS_SHARED(obj->shape) && !abandon_array) {
+		DUK_ASSERT(new_e_size >= DUK_HOBJECT_GET_ENEXT(obj));
+		new_h_size = DUK_HOBJECT_GET_HSIZE(obj);
+	}
+#endif
+
 	/*
 	 *  Pre resize assertions.
 	 */
@@ -553,7 +570,10 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	 *  on low RAM platforms requiring alignment.
 	 */
 
-#if defined(DUK_USE_HOBJECT_LAYOUT_2) || defined(DUK_USE_HOBJECT_LAYOUT_3)
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	DUK_DDD(DUK_DDDPRINT("using shapes, no need to pad e_size: %ld", (long) new_e_size));
+	new_e_size_adjusted = new_e_size;
+#elif defined(DUK_USE_HOBJECT_LAYOUT_2) || defined(DUK_USE_HOBJECT_LAYOUT_3)
 	DUK_DDD(DUK_DDDPRINT("using layout 2 or 3, no need to pad e_size: %ld", (long) new_e_size));
 	new_e_size_adjusted = new_e_size;
 #elif defined(DUK_USE_HOBJECT_LAYOUT_1) && (DUK_HOBJECT_ALIGN_TARGET == 1)
@@ -626,12 +646,17 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	thr->heap->pf_prevent_count++;                 /* Avoid finalizers. */
 	DUK_ASSERT(thr->heap->pf_prevent_count != 0);  /* Wrap. */
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	new_shape = NULL;
+#endif
 	new_alloc_size = DUK_HOBJECT_P_COMPUTE_SIZE(new_e_size_adjusted, new_a_size, new_h_size);
 	DUK_DDD(DUK_DDDPRINT("new hobject allocation size is %ld", (long) new_alloc_size));
 	if (new_alloc_size == 0) {
 		DUK_ASSERT(new_e_size_adjusted == 0);
 		DUK_ASSERT(new_a_size == 0);
+#if !defined(DUK_USE_HOBJECT_SHAPES)
 		DUK_ASSERT(new_h_size == 0);
+#endif
 		new_p = NULL;
 	} else {
 		/* Alloc may trigger mark-and-sweep but no compaction, and
@@ -652,11 +677,34 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 		}
 	}
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (DUK_HSHAPE_IS_DICT(obj->shape) || abandon_array) {
+		new_shape = duk_hshape_alloc_dict(thr, new_e_size_adjusted, new_h_size);
+		if (new_shape == NULL) {
+			goto alloc_failed;
+		}
+	}
+#endif
+
 	/* Set up pointers to the new property area: this is hidden behind a macro
 	 * because it is memory layout specific.
 	 */
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	DUK_HOBJECT_P_SET_REALLOC_PTRS(new_p, new_e_pv, new_a, new_e_size_adjusted);
+	new_e_k = NULL;
+	new_e_f = NULL;
+	new_h = NULL;
+	if (new_shape != NULL) {
+		new_e_k = new_shape->keys;
+		new_e_f = new_shape->flags;
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+		new_h = new_shape->hash;
+#endif
+	}
+#else
 	DUK_HOBJECT_P_SET_REALLOC_PTRS(new_p, new_e_k, new_e_pv, new_e_f, new_a, new_h,
 	                               new_e_size_adjusted, new_a_size, new_h_size);
+#endif
 	DUK_UNREF(new_h);  /* happens when hash part dropped */
 	new_e_next = 0;
 
@@ -776,12 +824,27 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 			continue;
 		}
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+		DUK_ASSERT(new_p != NULL && new_e_pv != NULL);
+		if (new_shape != NULL) {
+			/* The old shape's reference is released below. */
+			DUK_ASSERT(new_e_k != NULL && new_e_f != NULL);
+			new_e_k[new_e_next] = key;
+			new_e_f[new_e_next] = DUK_HOBJECT_E_GET_FLAGS(thr->heap, obj, i);
+			DUK_HSTRING_INCREF(thr, key);
+		} else {
+			/* Shared shape, keys stay at the same indices. */
+			DUK_ASSERT(new_e_next == i);
+		}
+		new_e_pv[new_e_next] = DUK_HOBJECT_E_GET_VALUE(thr->heap, obj, i);
+#else
 		DUK_ASSERT(new_p != NULL && new_e_k != NULL &&
 		           new_e_pv != NULL && new_e_f != NULL);
 
 		new_e_k[new_e_next] = key;
 		new_e_pv[new_e_next] = DUK_HOBJECT_E_GET_VALUE(thr->heap, obj, i);
 		new_e_f[new_e_next] = DUK_HOBJECT_E_GET_FLAGS(thr->heap, obj, i);
+#endif
 		new_e_next++;
 	}
 	/* the entries [new_e_next, new_e_size_adjusted[ are left uninitialized on purpose (ok, not gc reachable) */
@@ -830,6 +893,11 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	 */
 
 #if defined(DUK_USE_HOBJECT_HASH_PART)
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (new_shape == NULL) {
+		DUK_DDD(DUK_DDDPRINT("shared shape, hash part kept as is"));
+	} else
+#endif
 	if (new_h_size == 0) {
 		DUK_DDD(DUK_DDDPRINT("no hash part, no rehash"));
 	} else {
@@ -898,6 +966,12 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 
 	DUK_FREE_CHECKED(thr, DUK_HOBJECT_GET_PROPS(thr->heap, obj));  /* NULL obj->p is OK */
 	DUK_HOBJECT_SET_PROPS(thr->heap, obj, new_p);
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (new_shape != NULL) {
+		duk_hshape_decref(thr->heap, obj->shape, 1 /*decref_keys*/);
+		obj->shape = new_shape;
+	}
+#endif
 	DUK_HOBJECT_SET_ESIZE(obj, new_e_size_adjusted);
 	DUK_HOBJECT_SET_ENEXT(obj, new_e_next);
 	DUK_HOBJECT_SET_ASIZE(obj, new_a_size);
@@ -940,6 +1014,12 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	DUK_D(DUK_DPRINT("object property table resize failed"));
 
 	DUK_FREE_CHECKED(thr, new_p);  /* OK for NULL. */
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (new_shape != NULL) {
+		/* Keys in the new shape are not INCREF'd yet. */
+		duk_hshape_decref(thr->heap, new_shape, 0 /*decref_keys*/);
+	}
+#endif
 
 	thr->heap->pf_prevent_count--;
 	thr->heap->ms_base_flags = prev_ms_base_flags;
@@ -952,6 +1032,75 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	DUK_WO_NORETURN(return;);
 }
 
+/*
+ *  Switch an object with a shared shape to a private dictionary shape so
+ *  that its keys and flags can be modified in place.  Entry indices are
+ *  unchanged, the hash part (if any) is rebuilt.  Throws on alloc failure.
+ */
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+DUK_INTERNAL void duk_hobject_shape_make_dict(duk_hthread *thr, duk_hobject *obj) {
+	duk_hshape *old_shape;
+	duk_hshape *new_shape;
+	duk_uint32_t e_size;
+	duk_uint32_t h_size;
+	duk_uint_fast32_t i;
+	duk_uint_fast32_t n;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(obj != NULL);
+	DUK_ASSERT(!DUK_HEAPHDR_HAS_READONLY((duk_heaphdr *) obj));
+
+	old_shape = obj->shape;
+	DUK_ASSERT_HSHAPE_VALID(old_shape);
+	if (DUK_HSHAPE_IS_DICT(old_shape)) {
+		return;
+	}
+
+	e_size = DUK_HOBJECT_GET_ESIZE(obj);
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+	h_size = duk__get_default_h_size(e_size);
+#else
+	h_size = 0;
+#endif
+	new_shape = duk_hshape_alloc_dict(thr, e_size, h_size);
+	if (DUK_UNLIKELY(new_shape == NULL)) {
+		DUK_ERROR_ALLOC_FAILED(thr);
+		DUK_WO_NORETURN(return;);
+	}
+
+	n = DUK_HOBJECT_GET_ENEXT(obj);
+	DUK_ASSERT(n == old_shape->e_next);
+	for (i = 0; i < n; i++) {
+		duk_hstring *key;
+
+		key = old_shape->keys[i];
+		DUK_ASSERT(key != NULL);
+		new_shape->keys[i] = key;
+		new_shape->flags[i] = old_shape->flags[i];
+		DUK_HSTRING_INCREF(thr, key);
+
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+		if (h_size > 0) {
+			duk_uint32_t mask;
+			duk_uint32_t j;
+
+			mask = h_size - 1;
+			j = DUK_HSTRING_GET_HASH(key) & mask;
+			while (new_shape->hash[j] != DUK__HASH_UNUSED) {
+				j = (j + 1) & mask;
+			}
+			new_shape->hash[j] = (duk_uint32_t) i;
+		}
+#endif
+	}
+
+	DUK_DDD(DUK_DDDPRINT("object %p switched to dictionary shape, %ld keys", (void *) obj, (long) n));
+	obj->shape = new_shape;
+	duk_hshape_decref(thr->heap, old_shape, 1 /*decref_keys*/);
+}
+#endif  /* DUK_USE_HOBJECT_SHAPES */
+
 /*
  *  Helpers to resize properties allocation on specific needs.
  */
@@ -1225,8 +1374,16 @@ DUK_INTERNAL duk_bool_t duk_hobject_find_existing_entry(duk_heap *heap, duk_hobj
 			DUK_ASSERT_DISABLE(i >= 0);  /* unsigned */
 			DUK_ASSERT(i < DUK_HOBJECT_GET_HSIZE(obj));
 			t = h_base[i];
+#if defined(DUK_USE_HOBJECT_SHAPES)
+			/* A shared key table may contain keys beyond the object's
+			 * own prefix [0,e_next[, so 't' is only bounded by the table.
+			 */
+			DUK_ASSERT(t == DUK__HASH_UNUSED || t == DUK__HASH_DELETED ||
+			           (t < obj->shape->owner->tab_size));
+#else
 			DUK_ASSERT(t == DUK__HASH_UNUSED || t == DUK__HASH_DELETED ||
 			           (t < DUK_HOBJECT_GET_ESIZE(obj)));  /* t >= 0 always true, unsigned */
+#endif
 
 			if (t == DUK__HASH_UNUSED) {
 				break;
@@ -1234,8 +1391,18 @@ DUK_INTERNAL duk_bool_t duk_hobject_find_existing_entry(duk_heap *heap, duk_hobj
 				DUK_DDD(DUK_DDDPRINT("lookup miss (deleted) i=%ld, t=%ld",
 				                     (long) i, (long) t));
 			} else {
+#if defined(DUK_USE_HOBJECT_SHAPES)
+				if (DUK_HOBJECT_E_GET_KEY(heap, obj, t) == key) {
+					if (DUK_UNLIKELY(t >= DUK_HOBJECT_GET_ENEXT(obj))) {
+						/* Keys are unique within a table: key
+						 * belongs to a descendant shape only.
+						 */
+						break;
+					}
+#else
 				DUK_ASSERT(t < DUK_HOBJECT_GET_ESIZE(obj));
 				if (DUK_HOBJECT_E_GET_KEY(heap, obj, t) == key) {
+#endif
 					DUK_DDD(DUK_DDDPRINT("lookup hit i=%ld, t=%ld -> key %p",
 					                     (long) i, (long) t, (void *) key));
 					*e_idx = (duk_int_t) t;
@@ -1316,12 +1483,16 @@ DUK_INTERNAL duk_tval *duk_hobject_find_existing_array_entry_tval_ptr(duk_heap *
  *  Allocate and initialize a new entry, resizing the properties allocation
  *  if necessary.  Returns entry index (e_idx) or throws an error if alloc fails.
  *
- *  Sets the key of the entry (increasing the key's refcount), and updates
- *  the hash part if it exists.  Caller must set value and flags, and update
+ *  Sets the key and flags of the entry (increasing the key's refcount), and
+ *  updates the hash part if it exists.  Caller must set value, and update
  *  the entry value refcount.  A decref for the previous value is not necessary.
+ *
+ *  With shapes, the key and flags are set by transitioning to a (shared)
+ *  shape with the key appended; if that's not possible the object switches
+ *  to a dictionary shape which is then updated like a plain entry part.
  */
 
-DUK_LOCAL duk_int_t duk__hobject_alloc_entry_checked(duk_hthread *thr, duk_hobject *obj, duk_hstring *key) {
+DUK_LOCAL duk_int_t duk__hobject_alloc_entry_checked(duk_hthread *thr, duk_hobject *obj, duk_hstring *key, duk_small_uint_t flags) {
 	duk_uint32_t idx;
 
 	DUK_ASSERT(thr != NULL);
@@ -1345,10 +1516,36 @@ DUK_LOCAL duk_int_t duk__hobject_alloc_entry_checked(duk_hthread *thr, duk_hobje
 		duk__grow_props_for_new_entry_item(thr, obj);
 	}
 	DUK_ASSERT(DUK_HOBJECT_GET_ENEXT(obj) < DUK_HOBJECT_GET_ESIZE(obj));
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (DUK_LIKELY(DUK_HSHAPE_IS_SHARED(obj->shape))) {
+		duk_hshape *new_shape;
+
+		new_shape = duk_hshape_transition(thr, obj->shape, key, flags);
+		if (DUK_LIKELY(new_shape != NULL)) {
+			/* New shape holds a reference to the old one, so this
+			 * never frees anything.
+			 */
+			DUK_ASSERT(new_shape->parent == obj->shape);
+			DUK_ASSERT(obj->shape->refcount > 1);
+			duk_hshape_decref(thr->heap, obj->shape, 1 /*decref_keys*/);
+			obj->shape = new_shape;
+
+			idx = DUK_HOBJECT_POSTINC_ENEXT(obj);
+			DUK_ASSERT(idx + 1U == new_shape->e_next);
+			DUK_ASSERT(DUK_HOBJECT_E_GET_KEY(thr->heap, obj, idx) == key);
+			DUK_ASSERT(DUK_HOBJECT_E_GET_FLAGS(thr->heap, obj, idx) == flags);
+			return (duk_int_t) idx;
+		}
+		duk_hobject_shape_make_dict(thr, obj);
+	}
+#endif
+
 	idx = DUK_HOBJECT_POSTINC_ENEXT(obj);
 
 	/* previous value is assumed to be garbage, so don't touch it */
 	DUK_HOBJECT_E_SET_KEY(thr->heap, obj, idx, key);
+	DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, idx, flags);
 	DUK_HSTRING_INCREF(thr, key);
 
 #if defined(DUK_USE_HOBJECT_HASH_PART)
@@ -4092,14 +4289,13 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
 	 * refcount; may need a props allocation resize but doesn't
 	 * 'recheck' the valstack.
 	 */
-	e_idx = duk__hobject_alloc_entry_checked(thr, orig, key);
+	e_idx = duk__hobject_alloc_entry_checked(thr, orig, key, DUK_PROPDESC_FLAGS_WEC);
 	DUK_ASSERT(e_idx >= 0);
 
 	tv = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, orig, e_idx);
 	/* prev value can be garbage, no decref */
 	DUK_TVAL_SET_TVAL(tv, tv_val);
 	DUK_TVAL_INCREF(thr, tv);
-	DUK_HOBJECT_E_SET_FLAGS(thr->heap, orig, e_idx, DUK_PROPDESC_FLAGS_WEC);
 	goto entry_updated;
 
  entry_updated:
@@ -4257,12 +4453,63 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
  *  ECMAScript compliant [[Delete]](P, Throw).
  */
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+/* Delete the most recently added entry of an object with a shared shape by
+ * reverting to the parent shape, which keeps the shape shared.  Used e.g.
+ * for temporary properties added and removed in a stack-like fashion.
+ */
+DUK_LOCAL void duk__hobject_delete_last_shared_entry(duk_hthread *thr, duk_hobject *obj) {
+	duk_hshape *old_shape;
+	duk_uint32_t e_idx;
+
+	old_shape = obj->shape;
+	DUK_ASSERT(DUK_HSHAPE_IS_SHARED(old_shape));
+	DUK_ASSERT(old_shape->parent != NULL);
+	DUK_ASSERT(DUK_HOBJECT_GET_ENEXT(obj) == old_shape->e_next);
+	DUK_ASSERT(DUK_HOBJECT_GET_ENEXT(obj) > 0);
+
+	e_idx = DUK_HOBJECT_GET_ENEXT(obj) - 1;
+
+	/* Remove value without side effects so that the object remains
+	 * stable until the shape has been switched.
+	 */
+	if (DUK_HOBJECT_E_SLOT_IS_ACCESSOR(thr->heap, obj, e_idx)) {
+		duk_hobject *tmp;
+
+		tmp = DUK_HOBJECT_E_GET_VALUE_GETTER(thr->heap, obj, e_idx);
+		DUK_HOBJECT_E_SET_VALUE_GETTER(thr->heap, obj, e_idx, NULL);
+		DUK_UNREF(tmp);
+		DUK_HOBJECT_DECREF_NORZ_ALLOWNULL(thr, tmp);
+
+		tmp = DUK_HOBJECT_E_GET_VALUE_SETTER(thr->heap, obj, e_idx);
+		DUK_HOBJECT_E_SET_VALUE_SETTER(thr->heap, obj, e_idx, NULL);
+		DUK_UNREF(tmp);
+		DUK_HOBJECT_DECREF_NORZ_ALLOWNULL(thr, tmp);
+	} else {
+		duk_tval *tv;
+
+		tv = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, obj, e_idx);
+		DUK_TVAL_SET_UNDEFINED_UPDREF_NORZ(thr, tv);
+	}
+
+	obj->shape = old_shape->parent;
+	DUK_HSHAPE_INCREF(obj->shape);
+	DUK_HOBJECT_SET_ENEXT(obj, e_idx);
+	duk_hshape_decref(thr->heap, old_shape, 1 /*decref_keys*/);
+
+	DUK_REFZERO_CHECK_SLOW(thr);
+}
+#endif  /* DUK_USE_HOBJECT_SHAPES */
+
 DUK_INTERNAL duk_bool_t duk_hobject_delprop_raw(duk_hthread *thr, duk_hobject *obj, duk_hstring *key, duk_small_uint_t flags) {
 	duk_propdesc desc;
 	duk_tval *tv;
 	duk_uint32_t arr_idx;
 	duk_bool_t throw_flag;
 	duk_bool_t force_flag;
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	duk_bool_t rc;
+#endif
 
 	throw_flag = (flags & DUK_DELPROP_FLAG_THROW);
 	force_flag = (flags & DUK_DELPROP_FLAG_FORCE);
@@ -4313,6 +4560,23 @@ DUK_INTERNAL duk_bool_t duk_hobject_delprop_raw(duk_hthread *thr, duk_hobject *o
 	} else {
 		DUK_ASSERT(desc.a_idx < 0);
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+		/* A shared shape can't be modified in place: deleting the
+		 * most recently added key reverts to the parent shape, other
+		 * deletes switch the object to a dictionary shape.
+		 */
+		if (DUK_HSHAPE_IS_SHARED(obj->shape)) {
+			if ((duk_uint32_t) desc.e_idx + 1U == DUK_HOBJECT_GET_ENEXT(obj)) {
+				duk__hobject_delete_last_shared_entry(thr, obj);
+				goto success;
+			}
+			duk_hobject_shape_make_dict(thr, obj);
+			rc = duk_hobject_find_existing_entry(thr->heap, obj, key, &desc.e_idx, &desc.h_idx);
+			DUK_UNREF(rc);
+			DUK_ASSERT(rc != 0);
+		}
+#endif
+
 		/* remove hash entry (no decref) */
 #if defined(DUK_USE_HOBJECT_HASH_PART)
 		if (desc.h_idx >= 0) {
@@ -4652,7 +4916,10 @@ DUK_INTERNAL void duk_hobject_define_property_internal(duk_hthread *thr, duk_hob
 				goto error_internal;
 			}
 
-			DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, desc.e_idx, propflags);
+			if (DUK_HOBJECT_E_GET_FLAGS(thr->heap, obj, desc.e_idx) != propflags) {
+				DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, obj);
+				DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, desc.e_idx, propflags);
+			}
 			tv1 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, obj, desc.e_idx);
 		} else if (desc.a_idx >= 0) {
 			if (flags & DUK_PROPDESC_FLAG_NO_OVERWRITE) {
@@ -4708,9 +4975,8 @@ DUK_INTERNAL void duk_hobject_define_property_internal(duk_hthread *thr, duk_hob
 	}
 
 	DUK_DDD(DUK_DDDPRINT("property does not exist, object belongs in entry part -> allocate new entry and write value and attributes"));
-	e_idx = duk__hobject_alloc_entry_checked(thr, obj, key);  /* increases key refcount */
+	e_idx = duk__hobject_alloc_entry_checked(thr, obj, key, propflags);  /* increases key refcount */
 	DUK_ASSERT(e_idx >= 0);
-	DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, e_idx, propflags);
 	tv1 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, obj, e_idx);
 	/* new entry: previous value is garbage; set to undefined to share write_value */
 	DUK_TVAL_SET_UNDEFINED(tv1);
@@ -5310,15 +5576,13 @@ duk_bool_t duk_hobject_define_property_helper(duk_hthread *thr,
 			}
 
 			/* write to entry part */
-			e_idx = duk__hobject_alloc_entry_checked(thr, obj, key);
+			e_idx = duk__hobject_alloc_entry_checked(thr, obj, key, new_flags);
 			DUK_ASSERT(e_idx >= 0);
 
 			DUK_HOBJECT_E_SET_VALUE_GETTER(thr->heap, obj, e_idx, get);
 			DUK_HOBJECT_E_SET_VALUE_SETTER(thr->heap, obj, e_idx, set);
 			DUK_HOBJECT_INCREF_ALLOWNULL(thr, get);
 			DUK_HOBJECT_INCREF_ALLOWNULL(thr, set);
-
-			DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, e_idx, new_flags);
 			goto success_exotics;
 		} else {
 			duk_int_t e_idx;
@@ -5363,13 +5627,11 @@ duk_bool_t duk_hobject_define_property_helper(duk_hthread *thr,
 			}
 
 			/* write to entry part */
-			e_idx = duk__hobject_alloc_entry_checked(thr, obj, key);
+			e_idx = duk__hobject_alloc_entry_checked(thr, obj, key, new_flags);
 			DUK_ASSERT(e_idx >= 0);
 			tv2 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, obj, e_idx);
 			DUK_TVAL_SET_TVAL(tv2, &tv);
 			DUK_TVAL_INCREF(thr, tv2);
-
-			DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, e_idx, new_flags);
 			goto success_exotics;
 		}
 		DUK_UNREACHABLE();
@@ -5549,6 +5811,7 @@ duk_bool_t duk_hobject_define_property_helper(duk_hthread *thr,
 
 			DUK_ASSERT(curr.e_idx >= 0);
 			DUK_ASSERT(!DUK_HOBJECT_E_SLOT_IS_ACCESSOR(thr->heap, obj, curr.e_idx));
+			DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, obj);  /* may throw, before any changes */
 
 			tv1 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, obj, curr.e_idx);
 			DUK_TVAL_SET_UNDEFINED_UPDREF_NORZ(thr, tv1);  /* XXX: just decref */
@@ -5586,6 +5849,7 @@ duk_bool_t duk_hobject_define_property_helper(duk_hthread *thr,
 			DUK_DDD(DUK_DDDPRINT("convert property to data property"));
 
 			DUK_ASSERT(DUK_HOBJECT_E_SLOT_IS_ACCESSOR(thr->heap, obj, curr.e_idx));
+			DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, obj);  /* may throw, before any changes */
 			tmp = DUK_HOBJECT_E_GET_VALUE_GETTER(thr->heap, obj, curr.e_idx);
 			DUK_UNREF(tmp);
 			DUK_HOBJECT_E_SET_VALUE_GETTER(thr->heap, obj, curr.e_idx, NULL);
@@ -5708,7 +5972,11 @@ duk_bool_t duk_hobject_define_property_helper(duk_hthread *thr,
 
 	DUK_DDD(DUK_DDDPRINT("update existing property attributes"));
 	if (curr.e_idx >= 0) {
-		DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, curr.e_idx, new_flags);
+		/* Avoid unsharing the object's shape when only the value changes. */
+		if (DUK_HOBJECT_E_GET_FLAGS(thr->heap, obj, curr.e_idx) != new_flags) {
+			DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, obj);
+			DUK_HOBJECT_E_SET_FLAGS(thr->heap, obj, curr.e_idx, new_flags);
+		}
 	} else {
 		/* For Array .length the only allowed transition is for .length
 		 * to become non-writable.
@@ -6014,6 +6282,7 @@ DUK_INTERNAL void duk_hobject_object_seal_freeze_helper(duk_hthread *thr, duk_ho
 
 	duk__abandon_array_checked(thr, obj);
 	DUK_ASSERT(DUK_HOBJECT_GET_ASIZE(obj) == 0);
+	DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, obj);  /* flags are modified in place below */
 
 	for (i = 0; i < DUK_HOBJECT_GET_ENEXT(obj); i++) {
 		duk_uint8_t *fp;
@@ -0,0 +1,458 @@
+/*
+ *  Object shapes (hidden classes).
+ *
+ *  See duk_hshape.h for the data model.  Shapes are not heap objects, so
+ *  all allocation and freeing happens here explicitly: shapes are freed when
+ *  their internal reference count drops to zero.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+
+/*
+ *  Helpers
+ */
+
+DUK_LOCAL duk_uint32_t duk__hshape_trans_hash(duk_hshape *parent, duk_hstring *key, duk_small_uint_t flags) {
+	duk_uint32_t res;
+
+	res = DUK_HSTRING_GET_HASH(key);
+	res ^= (duk_uint32_t) (((duk_uintptr_t) parent) >> 4);
+	res ^= (duk_uint32_t) flags * 0x9e3779b1UL;
+	return res;
+}
+
+/* Round up to next power of two, with a minimum of DUK_HSHAPE_MIN_TABLE_SIZE. */
+DUK_LOCAL duk_uint32_t duk__hshape_table_size(duk_uint32_t n) {
+	duk_uint32_t res;
+
+	res = DUK_HSHAPE_MIN_TABLE_SIZE;
+	while (res < n) {
+		res <<= 1;
+	}
+	return res;
+}
+
+/* Shape allocation happens in contexts where an error throw is not allowed
+ * (e.g. duk_hobject_realloc_props()) and where the object being modified is
+ * in an inconsistent state, so prevent finalizers and object compaction for
+ * the duration of the allocation.  Returns NULL on failure.
+ */
+DUK_LOCAL duk_hshape *duk__hshape_alloc(duk_hthread *thr, duk_uint32_t tab_size, duk_uint32_t h_size) {
+	duk_heap *heap;
+	duk_small_uint_t prev_ms_base_flags;
+	duk_hshape *res;
+	duk_size_t alloc_size;
+	duk_uint8_t *p;
+
+	heap = thr->heap;
+	DUK_ASSERT(tab_size <= DUK_HOBJECT_MAX_PROPERTIES);
+	DUK_ASSERT(h_size == 0 || h_size >= tab_size);
+
+	alloc_size = sizeof(duk_hshape) +
+	             (duk_size_t) tab_size * (sizeof(duk_hstring *) + sizeof(duk_uint8_t)) +
+	             (duk_size_t) h_size * sizeof(duk_uint32_t);
+
+	prev_ms_base_flags = heap->ms_base_flags;
+	heap->ms_base_flags |= DUK_MS_FLAG_NO_OBJECT_COMPACTION;
+	heap->pf_prevent_count++;
+	DUK_ASSERT(heap->pf_prevent_count != 0);  /* Wrap. */
+
+	res = (duk_hshape *) DUK_ALLOC(heap, alloc_size);
+
+	DUK_ASSERT(heap->pf_prevent_count > 0);
+	heap->pf_prevent_count--;
+	heap->ms_base_flags = prev_ms_base_flags;
+
+	if (DUK_UNLIKELY(res == NULL)) {
+		return NULL;
+	}
+
+	duk_memzero((void *) res, sizeof(duk_hshape));
+	res->refcount = 1;
+	res->owner = res;
+	res->tab_size = tab_size;
+
+	p = (duk_uint8_t *) (res + 1);
+	if (tab_size > 0) {
+		res->keys = (duk_hstring **) (void *) p;
+		duk_memzero((void *) res->keys, sizeof(duk_hstring *) * tab_size);
+		p += sizeof(duk_hstring *) * tab_size;
+	}
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+	if (h_size > 0) {
+		res->hash = (duk_uint32_t *) (void *) p;
+		res->h_size = h_size;
+		duk_memset((void *) res->hash, 0xff, sizeof(duk_uint32_t) * h_size);
+		p += sizeof(duk_uint32_t) * h_size;
+	}
+#else
+	DUK_ASSERT(h_size == 0);
+	DUK_UNREF(h_size);
+#endif
+	if (tab_size > 0) {
+		res->flags = p;
+		duk_memzero((void *) res->flags, tab_size);
+	}
+
+	return res;
+}
+
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+DUK_LOCAL void duk__hshape_hash_insert(duk_hshape *tab, duk_hstring *key, duk_uint32_t idx) {
+	duk_uint32_t mask;
+	duk_uint32_t i;
+
+	DUK_ASSERT(tab->h_size > 0);
+	mask = tab->h_size - 1;
+	i = DUK_HSTRING_GET_HASH(key) & mask;
+	for (;;) {
+		if (tab->hash[i] == DUK_HOBJECT_HASHIDX_UNUSED) {
+			tab->hash[i] = idx;
+			return;
+		}
+		DUK_ASSERT(tab->hash[i] != DUK_HOBJECT_HASHIDX_DELETED);
+		i = (i + 1) & mask;
+	}
+}
+#endif
+
+/*
+ *  Transition table
+ */
+
+DUK_LOCAL void duk__hshape_trans_unlink(duk_heap *heap, duk_hshape *shape) {
+	duk_hshape **pp;
+
+	DUK_ASSERT(DUK_HSHAPE_IS_SHARED(shape));
+	DUK_ASSERT(shape->parent != NULL);
+	DUK_ASSERT(shape->e_next > 0);
+
+	if (heap->shape_trans == NULL) {
+		return;
+	}
+
+	pp = heap->shape_trans + (shape->trans_hash & (heap->shape_trans_size - 1));
+	while (*pp != NULL) {
+		if (*pp == shape) {
+			*pp = shape->trans_next;
+			shape->trans_next = NULL;
+			DUK_ASSERT(heap->shape_trans_count > 0);
+			heap->shape_trans_count--;
+			return;
+		}
+		pp = &(*pp)->trans_next;
+	}
+
+	/* Not found: shape was created when the transition table could not be
+	 * grown, which is fine.
+	 */
+}
+
+/* Grow transition table, load factor 1.  Uses raw allocation so that no GC
+ * is triggered; a failure is harmless and just leaves the table as is.
+ */
+DUK_LOCAL void duk__hshape_trans_grow(duk_heap *heap) {
+	duk_uint32_t new_size;
+	duk_hshape **new_tab;
+	duk_uint32_t i;
+
+	new_size = (heap->shape_trans == NULL ? DUK_HSHAPE_TRANS_MIN_SIZE : heap->shape_trans_size * 2U);
+	if (new_size > DUK_HSHAPE_TRANS_MAX_SIZE) {
+		return;
+	}
+	new_tab = (duk_hshape **) DUK_ALLOC_RAW(heap, sizeof(duk_hshape *) * new_size);
+	if (new_tab == NULL) {
+		DUK_D(DUK_DPRINT("failed to grow shape transition table, ignoring"));
+		return;
+	}
+	duk_memzero((void *) new_tab, sizeof(duk_hshape *) * new_size);
+
+	if (heap->shape_trans != NULL) {
+		for (i = 0; i < heap->shape_trans_size; i++) {
+			duk_hshape *s;
+			duk_hshape *next;
+
+			for (s = heap->shape_trans[i]; s != NULL; s = next) {
+				duk_uint32_t j;
+
+				next = s->trans_next;
+				j = s->trans_hash & (new_size - 1);
+				s->trans_next = new_tab[j];
+				new_tab[j] = s;
+			}
+		}
+		DUK_FREE_RAW(heap, (void *) heap->shape_trans);
+	}
+
+	heap->shape_trans = new_tab;
+	heap->shape_trans_size = new_size;
+}
+
+DUK_LOCAL duk_hshape *duk__hshape_trans_lookup(duk_heap *heap, duk_hshape *parent, duk_hstring *key, duk_small_uint_t flags) {
+	duk_hshape *s;
+	duk_uint32_t h;
+
+	if (heap->shape_trans == NULL) {
+		return NULL;
+	}
+	h = duk__hshape_trans_hash(parent, key, flags);
+	s = heap->shape_trans[h & (heap->shape_trans_size - 1)];
+	while (s != NULL) {
+		DUK_ASSERT(s->e_next > 0);
+		if (s->trans_hash == h &&
+		    s->parent == parent &&
+		    s->keys[s->e_next - 1] == key &&
+		    s->flags[s->e_next - 1] == (duk_uint8_t) flags) {
+			return s;
+		}
+		s = s->trans_next;
+	}
+	return NULL;
+}
+
+DUK_LOCAL void duk__hshape_trans_insert(duk_heap *heap, duk_hshape *shape) {
+	duk_uint32_t i;
+
+	DUK_ASSERT(shape->parent != NULL);
+	DUK_ASSERT(shape->e_next > 0);
+	DUK_ASSERT(shape->trans_next == NULL);
+
+	if (heap->shape_trans == NULL || heap->shape_trans_count >= heap->shape_trans_size) {
+		duk__hshape_trans_grow(heap);
+		if (heap->shape_trans == NULL) {
+			return;
+		}
+	}
+
+	i = shape->trans_hash & (heap->shape_trans_size - 1);
+	shape->trans_next = heap->shape_trans[i];
+	heap->shape_trans[i] = shape;
+	heap->shape_trans_count++;
+}
+
+/*
+ *  Heap init and free
+ */
+
+DUK_INTERNAL void duk_hshape_heap_init(duk_heap *heap) {
+	DUK_ASSERT(heap != NULL);
+
+	duk_memzero((void *) &heap->shape_root, sizeof(duk_hshape));
+	heap->shape_root.refcount = 1;  /* Never freed. */
+	heap->shape_root.id = DUK_HSHAPE_ID_ROOT;
+	heap->shape_next_id = DUK_HSHAPE_ID_ROOT + 1;
+	heap->shape_trans = NULL;
+	heap->shape_trans_size = 0;
+	heap->shape_trans_count = 0;
+	heap->shape_mark_gen = 0;
+
+	/* Transition table is created lazily. */
+}
+
+DUK_INTERNAL void duk_hshape_heap_free(duk_heap *heap) {
+	DUK_ASSERT(heap != NULL);
+
+	/* All objects have been freed, so all shapes except the root are gone
+	 * and the transition table is empty.
+	 */
+	DUK_ASSERT(heap->shape_trans_count == 0);
+	DUK_ASSERT(heap->shape_root.refcount == 1);
+
+	if (heap->shape_trans != NULL) {
+		DUK_FREE_RAW(heap, (void *) heap->shape_trans);
+		heap->shape_trans = NULL;
+	}
+}
+
+/*
+ *  Shape creation
+ */
+
+DUK_INTERNAL duk_hshape *duk_hshape_alloc_dict(duk_hthread *thr, duk_uint32_t tab_size, duk_uint32_t h_size) {
+	duk_hshape *res;
+
+	DUK_ASSERT(thr != NULL);
+
+	res = duk__hshape_alloc(thr, tab_size, h_size);
+	if (res != NULL) {
+		res->shape_flags = DUK_HSHAPE_FLAG_DICT;
+		DUK_ASSERT_HSHAPE_VALID(res);
+	}
+	return res;
+}
+
+/* Find or create the shared shape for 'shape' plus 'key' with 'flags'.
+ * Returns a new reference (caller must decref 'shape' if the object moves
+ * over to the result), or NULL if the object should switch to a dictionary
+ * shape instead (too many keys or out of memory).  Never throws.
+ */
+DUK_INTERNAL duk_hshape *duk_hshape_transition(duk_hthread *thr, duk_hshape *shape, duk_hstring *key, duk_small_uint_t flags) {
+	duk_heap *heap;
+	duk_hshape *res;
+	duk_hshape *tab;
+	duk_uint32_t n;
+	duk_uint32_t i;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(key != NULL);
+	DUK_ASSERT_HSHAPE_VALID(shape);
+	DUK_ASSERT(DUK_HSHAPE_IS_SHARED(shape));
+
+	heap = thr->heap;
+	n = shape->e_next;
+	if (n >= DUK_HSHAPE_MAX_SHARED_KEYS) {
+		DUK_DD(DUK_DDPRINT("shape has %ld keys, object goes dictionary", (long) n));
+		return NULL;
+	}
+
+	res = duk__hshape_trans_lookup(heap, shape, key, flags);
+	if (res != NULL) {
+		DUK_HSHAPE_INCREF(res);
+		return res;
+	}
+
+	/* The table of 'shape' can be used as is if the slot after our
+	 * prefix is unused (append in place) or already contains the same
+	 * key and flags (left behind by a freed sibling).
+	 */
+	tab = shape->owner;
+	if (tab != NULL && n < tab->tab_size &&
+	    (tab->tab_used == n ||
+	     (tab->keys[n] == key && tab->flags[n] == (duk_uint8_t) flags))) {
+		res = duk__hshape_alloc(thr, 0, 0);
+		if (res == NULL) {
+			return NULL;
+		}
+		/* Allocation may have run mark-and-sweep (but no finalizers
+		 * or compaction), which cannot affect 'tab' because 'shape'
+		 * is alive.
+		 */
+		if (tab->tab_used == n) {
+			tab->keys[n] = key;
+			tab->flags[n] = (duk_uint8_t) flags;
+			DUK_HSTRING_INCREF(thr, key);
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+			if (tab->h_size > 0) {
+				duk__hshape_hash_insert(tab, key, n);
+			}
+#endif
+			tab->tab_used++;
+		}
+		DUK_ASSERT(tab->keys[n] == key);
+		res->owner = tab;
+		res->tab_size = 0;
+		res->keys = tab->keys;
+		res->flags = tab->flags;
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+		res->hash = tab->hash;
+		res->h_size = tab->h_size;
+#endif
+	} else {
+		duk_uint32_t tab_size;
+		duk_uint32_t h_size;
+
+		tab_size = duk__hshape_table_size(n + 1);
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+		h_size = (tab_size >= DUK_USE_HOBJECT_HASH_PROP_LIMIT ? tab_size * 2U : 0U);
+#else
+		h_size = 0;
+#endif
+		res = duk__hshape_alloc(thr, tab_size, h_size);
+		if (res == NULL) {
+			return NULL;
+		}
+		for (i = 0; i < n; i++) {
+			duk_hstring *k;
+
+			k = shape->keys[i];
+			DUK_ASSERT(k != NULL);
+			res->keys[i] = k;
+			res->flags[i] = shape->flags[i];
+			DUK_HSTRING_INCREF(thr, k);
+		}
+		res->keys[n] = key;
+		res->flags[n] = (duk_uint8_t) flags;
+		DUK_HSTRING_INCREF(thr, key);
+		res->tab_used = n + 1;
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+		if (h_size > 0) {
+			for (i = 0; i <= n; i++) {
+				duk__hshape_hash_insert(res, res->keys[i], i);
+			}
+		}
+#endif
+	}
+
+	res->e_next = n + 1;
+	res->id = heap->shape_next_id;
+	if (DUK_LIKELY(res->id != DUK_HSHAPE_ID_NONE)) {
+		heap->shape_next_id = (res->id < DUK_HSHAPE_ID_MAX ? res->id + 1 : DUK_HSHAPE_ID_NONE);
+	}
+	res->trans_hash = duk__hshape_trans_hash(shape, key, flags);
+	res->parent = shape;
+	DUK_HSHAPE_INCREF(shape);
+	duk__hshape_trans_insert(heap, res);
+
+	DUK_ASSERT_HSHAPE_VALID(res);
+	DUK_DDD(DUK_DDDPRINT("created shape %p from %p, key %!O, flags 0x%02lx, shared table: %ld",
+	                     (void *) res, (void *) shape, (duk_heaphdr *) key, (unsigned long) flags,
+	                     (long) (res->owner != res)));
+	return res;
+}
+
+/*
+ *  Shape freeing
+ *
+ *  When 'decref_keys' is set the key references held by key tables are
+ *  released; this is only done from refcount finalization and property
+ *  table reallocation.  Otherwise keys are not touched at all, which is
+ *  required when freeing the heap (keys may already be freed).
+ */
+
+DUK_INTERNAL void duk_hshape_decref(duk_heap *heap, duk_hshape *shape, duk_bool_t decref_keys) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(shape != NULL);
+
+	/* Iterate up the parent chain instead of recursing. */
+	while (shape != NULL) {
+		duk_hshape *parent;
+
+		DUK_ASSERT(shape->refcount > 0);
+		if (--shape->refcount > 0) {
+			return;
+		}
+		DUK_ASSERT(shape != &heap->shape_root);
+
+		parent = shape->parent;
+		if (parent != NULL) {
+			duk__hshape_trans_unlink(heap, shape);
+		}
+
+#if defined(DUK_USE_REFERENCE_COUNTING)
+		if (decref_keys && shape->owner == shape) {
+			duk_hthread *thr;
+			duk_uint32_t i;
+
+			thr = heap->heap_thread;
+			DUK_ASSERT(thr != NULL);
+			for (i = 0; i < shape->tab_size; i++) {
+				duk_hstring *k;
+
+				k = shape->keys[i];
+				if (k != NULL) {
+					DUK_HSTRING_DECREF_NORZ(thr, k);
+				}
+			}
+		}
+#else
+		DUK_UNREF(decref_keys);
+#endif
+
+		DUK_FREE(heap, (void *) shape);
+		shape = parent;
+	}
+}
+
+#endif  /* DUK_USE_HOBJECT_SHAPES */
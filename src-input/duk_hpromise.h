@@ -0,0 +1,65 @@
+/*
+ *  Promise object representation.
+ *
+ *  The [[PromiseState]], [[PromiseResult]] and the fulfill/reject reaction
+ *  lists of ES2015 Section 25.4.6 are stored directly in the object instead
+ *  of internal properties.  Reactions are kept in a single duk_tval array,
+ *  DUK_HPROMISE_REACTION_SIZE entries per reaction:
+ *
+ *    [0] derived promise (a duk_hpromise) or undefined
+ *    [1] onFulfilled handler or undefined
+ *    [2] onRejected handler or undefined
+ *
+ *  A reaction is the pair of PromiseReaction records created by a single
+ *  .then() call.  Derived promises are always native promises created by
+ *  .then() so there's no need for a generic capability: the derived promise
+ *  is resolved or rejected directly when the reaction job runs.
+ *
+ *  Resolving functions (ES2015 Section 25.4.1.3) are only created when they
+ *  are visible to user code, i.e. for the executor of 'new Promise()' and
+ *  for non-native thenables.  At most one resolving function pair of a
+ *  promise can be live at any time: 'resolve_id' identifies it and the
+ *  functions of earlier pairs are no-ops ([[AlreadyResolved]] is true).
+ */
+
+#if !defined(DUK_HPROMISE_H_INCLUDED)
+#define DUK_HPROMISE_H_INCLUDED
+
+#define DUK_HPROMISE_STATE_PENDING       0
+#define DUK_HPROMISE_STATE_FULFILLED     1
+#define DUK_HPROMISE_STATE_REJECTED      2
+
+#define DUK_HPROMISE_REACTION_SIZE       3
+
+#define DUK_ASSERT_HPROMISE_VALID(h) do { \
+		DUK_ASSERT((h) != NULL); \
+		DUK_ASSERT(DUK_HOBJECT_IS_PROMISE((duk_hobject *) (h))); \
+		DUK_ASSERT((h)->state <= DUK_HPROMISE_STATE_REJECTED); \
+		DUK_ASSERT((h)->state == DUK_HPROMISE_STATE_PENDING || (h)->reactions_count == 0); \
+		DUK_ASSERT((h)->reactions_count <= (h)->reactions_size); \
+		DUK_ASSERT((h)->reactions_size == 0 || (h)->reactions != NULL); \
+	} while (0)
+
+struct duk_hpromise {
+	/* Shared object part. */
+	duk_hobject obj;
+
+	/* [[PromiseResult]], undefined while pending. */
+	duk_tval result;
+
+	/* Pending reactions, separate allocation, see above.  Counts are in
+	 * reactions (not duk_tvals).
+	 */
+	duk_tval *reactions;
+	duk_uint32_t reactions_count;
+	duk_uint32_t reactions_size;
+
+	/* Id of the live resolving function pair, 0 if none. */
+	duk_uint32_t resolve_id;
+	duk_uint32_t resolve_id_next;
+
+	/* [[PromiseState]], DUK_HPROMISE_STATE_xxx. */
+	duk_small_uint_t state;
+};
+
+#endif  /* DUK_HPROMISE_H_INCLUDED */
@@ -0,0 +1,148 @@
+/*
+ *  Object shapes (hidden classes), used when DUK_USE_HOBJECT_SHAPES is
+ *  enabled.
+ *
+ *  A shape describes the entry part keys and property attribute flags of an
+ *  object; the object itself only stores the entry part values (and the
+ *  array part).  Objects created by the same code path add the same keys in
+ *  the same order, and end up sharing a single shape.
+ *
+ *  There are two kinds of shapes:
+ *
+ *    - Shared shapes are immutable and form a transition tree rooted at
+ *      heap->shape_root (the empty shape).  A child shape is the parent
+ *      shape with one more key (with given attribute flags) appended.
+ *      Transitions are recorded in a heap wide hash table keyed by
+ *      (parent, key, flags) so that objects adding the same keys in the
+ *      same order find the same shapes.
+ *
+ *    - Dictionary shapes are owned by a single object and are mutated in
+ *      place, exactly like the entry part of an object without shapes:
+ *      keys may be deleted (set to NULL), attribute flags may be changed,
+ *      and the hash part may contain DELETED markers.  An object switches
+ *      to a dictionary shape when it is about to be modified in a way a
+ *      shared shape can't express (delete, attribute change, array part
+ *      abandon) or when it grows beyond DUK_HSHAPE_MAX_SHARED_KEYS keys.
+ *
+ *  Shapes are not heap objects: they have a separate, internal reference
+ *  count which is maintained regardless of DUK_USE_REFERENCE_COUNTING.
+ *  References come from objects and child shapes (a child keeps its parent
+ *  alive).  The transition table is a weak reference; a shape removes itself
+ *  from the table when it is freed.
+ *
+ *  Key table layout.  The keys, flags, and optional hash index live in a
+ *  "key table" allocated together with the shape owning it:
+ *
+ *    sizeof(duk_hshape)
+ *    tab_size * sizeof(duk_hstring *)    keys (unused slots are NULL)
+ *    h_size * sizeof(duk_uint32_t)       (opt) hash index, same format as
+ *                                        the duk_hobject hash part
+ *    tab_size * sizeof(duk_uint8_t)      flags
+ *
+ *  A shared key table is append-only and is shared along a transition chain
+ *  to avoid O(n^2) memory for an object built key by key: when a child is
+ *  created from a parent whose table has free space and no other child has
+ *  appended to it, the key is appended in place and the child references the
+ *  same table.  Each shared shape only "sees" the prefix [0,e_next[ of the
+ *  table, and keys within one table are always unique, so a hash hit beyond
+ *  e_next means the key is not present.  The shape owning a table ('owner')
+ *  is always the shape itself or one of its ancestors, so walking the parent
+ *  chain reaches every table a shape depends on.
+ *
+ *  The key table holds a reference to every non-NULL key in [0,tab_size[.
+ *  Key references are released when the owning shape is freed as part of
+ *  refcount finalization of the last object using it; when freeing the heap
+ *  (or without reference counting) shapes are freed without touching keys.
+ */
+
+#if !defined(DUK_HSHAPE_H_INCLUDED)
+#define DUK_HSHAPE_H_INCLUDED
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+
+#if defined(DUK_USE_HEAPPTR16) || defined(DUK_USE_OBJSIZES16) || defined(DUK_USE_ROM_OBJECTS)
+#error DUK_USE_HOBJECT_SHAPES is not compatible with DUK_USE_HEAPPTR16, DUK_USE_OBJSIZES16, or DUK_USE_ROM_OBJECTS
+#endif
+
+/* Shape flags. */
+#define DUK_HSHAPE_FLAG_DICT                 (1U << 0)  /* dictionary shape: owned by a single object, mutable */
+
+#define DUK_HSHAPE_IS_DICT(s)                (((s)->shape_flags & DUK_HSHAPE_FLAG_DICT) != 0)
+#define DUK_HSHAPE_IS_SHARED(s)              (((s)->shape_flags & DUK_HSHAPE_FLAG_DICT) == 0)
+
+/* Objects growing beyond this many keys switch to a dictionary shape.
+ * Shared shapes are intended for "struct like" objects; large objects
+ * are typically used as lookup tables and benefit little from sharing.
+ */
+#define DUK_HSHAPE_MAX_SHARED_KEYS           64
+
+/* Shape ids: shared shapes get a unique, never reused id which lookup
+ * caches can use to identify a layout without holding a reference to the
+ * shape.  Dictionary shapes (and shared shapes created after the id space
+ * has been exhausted) have DUK_HSHAPE_ID_NONE and are never cached.
+ */
+#define DUK_HSHAPE_ID_NONE                   0UL
+#define DUK_HSHAPE_ID_ROOT                   1UL
+#define DUK_HSHAPE_ID_MAX                    0xfffffffeUL
+
+/* Minimum size for a new shared key table. */
+#define DUK_HSHAPE_MIN_TABLE_SIZE            4
+
+/* Initial and maximum bucket count for the heap wide transition table. */
+#define DUK_HSHAPE_TRANS_MIN_SIZE            64
+#define DUK_HSHAPE_TRANS_MAX_SIZE            (1UL << 24)
+
+#define DUK_HSHAPE_INCREF(s) do { \
+		(s)->refcount++; \
+		DUK_ASSERT((s)->refcount != 0);  /* Wrap. */ \
+	} while (0)
+
+#define DUK_ASSERT_HSHAPE_VALID(s) do { \
+		DUK_ASSERT((s) != NULL); \
+		DUK_ASSERT((s)->refcount > 0); \
+		DUK_ASSERT(DUK_HSHAPE_IS_DICT((s)) || (s)->owner == NULL || (s)->e_next <= (s)->owner->tab_used); \
+		DUK_ASSERT(DUK_HSHAPE_IS_SHARED((s)) || ((s)->owner == (s) && (s)->parent == NULL)); \
+	} while (0)
+
+struct duk_hshape {
+	/* Lookup pointers into the key table visible through this shape,
+	 * NULL for the empty root shape.  For shared shapes only the prefix
+	 * [0,e_next[ of the table belongs to the shape.
+	 */
+	duk_hstring **keys;
+	duk_uint8_t *flags;
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+	duk_uint32_t *hash;
+	duk_uint32_t h_size;  /* hash index size or 0 if unused */
+#endif
+	duk_uint32_t e_next;  /* shared shapes: number of keys; dictionary shapes: unused */
+	duk_uint32_t id;      /* shared shapes: unique id; dictionary shapes: DUK_HSHAPE_ID_NONE */
+
+	duk_uint32_t refcount;  /* objects and child shapes referencing this shape */
+	duk_hshape *parent;     /* shared shapes: shape this one was derived from */
+	duk_hshape *owner;      /* shape owning the key table: this shape or an ancestor */
+	duk_hshape *trans_next; /* next shape in transition table chain */
+	duk_uint32_t trans_hash;  /* transition hash, cached so that keys need not be accessed when freeing */
+
+	/* Key table allocated with this shape; used only if owner == this. */
+	duk_uint32_t tab_size;
+	duk_uint32_t tab_used;  /* shared tables: index for next appended key */
+
+	duk_uint32_t mark_gen;  /* mark-and-sweep round which last marked this shape */
+	duk_small_uint_t shape_flags;
+};
+
+/*
+ *  Prototypes
+ */
+
+DUK_INTERNAL_DECL void duk_hshape_heap_init(duk_heap *heap);
+DUK_INTERNAL_DECL void duk_hshape_heap_free(duk_heap *heap);
+DUK_INTERNAL_DECL duk_hshape *duk_hshape_alloc_dict(duk_hthread *thr, duk_uint32_t tab_size, duk_uint32_t h_size);
+DUK_INTERNAL_DECL duk_hshape *duk_hshape_transition(duk_hthread *thr, duk_hshape *shape, duk_hstring *key, duk_small_uint_t flags);
+DUK_INTERNAL_DECL void duk_hshape_decref(duk_heap *heap, duk_hshape *shape, duk_bool_t decref_keys);
+
+DUK_INTERNAL_DECL void duk_hobject_shape_make_dict(duk_hthread *thr, duk_hobject *obj);
+
+#endif  /* DUK_USE_HOBJECT_SHAPES */
+#endif  /* DUK_HSHAPE_H_INCLUDED */
@@ -50,6 +50,7 @@
 #define DUK_HSTRING_FLAG_EVAL_OR_ARGUMENTS          DUK_HEAPHDR_USER_FLAG(6)  /* string is 'eval' or 'arguments' */
 #define DUK_HSTRING_FLAG_EXTDATA                    DUK_HEAPHDR_USER_FLAG(7)  /* string data is external (duk_hstring_external) */
 #define DUK_HSTRING_FLAG_PINNED_LITERAL             DUK_HEAPHDR_USER_FLAG(8)  /* string is a literal, and pinned */
+#define DUK_HSTRING_FLAG_ROPE                       DUK_HEAPHDR_USER_FLAG(9)  /* string is an uninterned rope (duk_hstring_rope) */
 
 #define DUK_HSTRING_HAS_ASCII(x)                    DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ASCII)
 #define DUK_HSTRING_HAS_ARRIDX(x)                   DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ARRIDX)
@@ -60,6 +61,7 @@
 #define DUK_HSTRING_HAS_EVAL_OR_ARGUMENTS(x)        DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_EVAL_OR_ARGUMENTS)
 #define DUK_HSTRING_HAS_EXTDATA(x)                  DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_EXTDATA)
 #define DUK_HSTRING_HAS_PINNED_LITERAL(x)           DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_PINNED_LITERAL)
+#define DUK_HSTRING_HAS_ROPE(x)                     DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ROPE)
 
 #define DUK_HSTRING_SET_ASCII(x)                    DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ASCII)
 #define DUK_HSTRING_SET_ARRIDX(x)                   DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ARRIDX)
@@ -70,6 +72,7 @@
 #define DUK_HSTRING_SET_EVAL_OR_ARGUMENTS(x)        DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_EVAL_OR_ARGUMENTS)
 #define DUK_HSTRING_SET_EXTDATA(x)                  DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_EXTDATA)
 #define DUK_HSTRING_SET_PINNED_LITERAL(x)           DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_PINNED_LITERAL)
+#define DUK_HSTRING_SET_ROPE(x)                     DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ROPE)
 
 #define DUK_HSTRING_CLEAR_ASCII(x)                  DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ASCII)
 #define DUK_HSTRING_CLEAR_ARRIDX(x)                 DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ARRIDX)
@@ -80,6 +83,7 @@
 #define DUK_HSTRING_CLEAR_EVAL_OR_ARGUMENTS(x)      DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_EVAL_OR_ARGUMENTS)
 #define DUK_HSTRING_CLEAR_EXTDATA(x)                DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_EXTDATA)
 #define DUK_HSTRING_CLEAR_PINNED_LITERAL(x)         DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_PINNED_LITERAL)
+#define DUK_HSTRING_CLEAR_ROPE(x)                   DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HSTRING_FLAG_ROPE)
 
 #if 0  /* Slightly smaller code without explicit flag, but explicit flag
         * is very useful when 'clen' is dropped.
@@ -89,6 +93,33 @@
 #define DUK_HSTRING_IS_ASCII(x)                     DUK_HSTRING_HAS_ASCII((x))  /* lazily set! */
 #define DUK_HSTRING_IS_EMPTY(x)                     (DUK_HSTRING_GET_BYTELEN((x)) == 0)
 
+/* Ropes are only created by the '+' operator and can appear wherever a
+ * string duk_tval can.  Code which needs string data, the hash, or
+ * interned identity must flatten a string obtained directly from a
+ * duk_tval; duk_get_hstring() and friends flatten automatically.  Byte
+ * length, character length, and the ASCII and symbol flags are valid for
+ * ropes as is.
+ */
+#if defined(DUK_USE_HSTRING_ROPES)
+#if defined(DUK_USE_STRHASH16)
+#error DUK_USE_HSTRING_ROPES is not compatible with DUK_USE_STRHASH16
+#endif
+#if !defined(DUK_USE_HSTRING_CLEN)
+#error DUK_USE_HSTRING_ROPES requires DUK_USE_HSTRING_CLEN
+#endif
+#define DUK_HSTRING_IS_ROPE(x)                      DUK_HSTRING_HAS_ROPE((x))
+#define DUK_HSTRING_FLATTEN(thr,x) \
+	(DUK_HSTRING_IS_ROPE((x)) ? duk_hstring_rope_flatten((thr), (x)) : (x))
+#else
+#define DUK_HSTRING_IS_ROPE(x)                      0
+#define DUK_HSTRING_FLATTEN(thr,x)                  (x)
+#endif
+
+/* Concatenations shorter than this (in bytes) are interned directly; the
+ * rope bookkeeping isn't worth it for short strings.
+ */
+#define DUK_HSTRING_ROPE_MIN_BYTELEN                64
+
 #if defined(DUK_USE_STRHASH16)
 #define DUK_HSTRING_GET_HASH(x)                     ((x)->hdr.h_flags >> 16)
 #define DUK_HSTRING_SET_HASH(x,v) do { \
@@ -231,6 +262,30 @@ struct duk_hstring_external {
 	const duk_uint8_t *extdata;
 };
 
+#if defined(DUK_USE_HSTRING_ROPES)
+/* A rope is the lazy result of 'left + right'.  Its byte length, character
+ * length, and ASCII flag are valid but it has no data, no hash, and it is
+ * not in the string table; the string hash field is unused.  Ropes are kept
+ * in heap->rope_list for mark-and-sweep.
+ *
+ * Only 'left' may be another rope, so a chain built by "s += x" forms a
+ * left spine which is walked iteratively.  When flattened, the interned
+ * result is stored in 'flat' and the children are released so that
+ * intermediate ropes referenced elsewhere behave like plain leaves.
+ */
+struct duk_hstring_rope {
+	duk_hstring str;
+
+	duk_hstring *left;   /* NULL once flattened */
+	duk_hstring *right;  /* never a rope; NULL once flattened */
+	duk_hstring *flat;   /* interned result, NULL until flattened */
+
+	/* heap->rope_list linkage. */
+	duk_hstring_rope *next;
+	duk_hstring_rope *prev;
+};
+#endif  /* DUK_USE_HSTRING_ROPES */
+
 /*
  *  Prototypes
  */
@@ -242,4 +297,13 @@ DUK_INTERNAL_DECL duk_size_t duk_hstring_get_charlen(duk_hstring *h);
 DUK_INTERNAL_DECL void duk_hstring_init_charlen(duk_hstring *h);
 #endif
 
+#if defined(DUK_USE_HSTRING_ROPES)
+DUK_INTERNAL_DECL void duk_hstring_rope_concat(duk_hthread *thr);
+DUK_INTERNAL_DECL duk_hstring *duk_hstring_rope_flatten(duk_hthread *thr, duk_hstring *h);
+DUK_INTERNAL_DECL duk_bool_t duk_hstring_rope_equals(duk_hstring *h1, duk_hstring *h2);
+DUK_INTERNAL_DECL void duk_hstring_rope_free_refzero(duk_heap *heap, duk_hstring_rope *r);
+DUK_INTERNAL_DECL void duk_hstring_rope_free(duk_heap *heap, duk_hstring_rope *r);
+DUK_INTERNAL_DECL void duk_hstring_rope_free_all(duk_heap *heap);
+#endif
+
 #endif  /* DUK_HSTRING_H_INCLUDED */
@@ -0,0 +1,403 @@
+/*
+ *  Rope strings for linear time repeated concatenation.
+ *
+ *  Without ropes each "s += x" copies and interns the whole result, so
+ *  building a string piece by piece is quadratic and fills the string
+ *  table with garbage.  With ropes the '+' operator only allocates a small
+ *  node referring to its two halves; the string is flattened and interned
+ *  when its data or identity is needed.  See duk_hstring.h for the
+ *  representation.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_HSTRING_ROPES)
+
+/* Iterator for walking the leaf chunks of a string from the end. */
+typedef struct {
+	duk_hstring *next;          /* next node to expand, NULL when done */
+	const duk_uint8_t *data;    /* current chunk */
+	duk_size_t len;             /* bytes remaining in current chunk */
+} duk__rope_iter;
+
+DUK_LOCAL void duk__rope_iter_next(duk__rope_iter *it) {
+	duk_hstring *h;
+
+	h = it->next;
+	DUK_ASSERT(h != NULL);
+	if (DUK_HSTRING_IS_ROPE(h)) {
+		duk_hstring_rope *r = (duk_hstring_rope *) h;
+
+		if (r->flat != NULL) {
+			/* A flattened rope may be a child of an unflattened
+			 * one; it behaves like a leaf.
+			 */
+			h = r->flat;
+			it->next = NULL;
+		} else {
+			DUK_ASSERT(r->right != NULL);
+			DUK_ASSERT(r->left != NULL);
+			DUK_ASSERT(!DUK_HSTRING_IS_ROPE(r->right));
+			h = r->right;
+			it->next = r->left;
+		}
+	} else {
+		it->next = NULL;
+	}
+	DUK_ASSERT(!DUK_HSTRING_IS_ROPE(h));
+	it->data = DUK_HSTRING_GET_DATA(h);
+	it->len = DUK_HSTRING_GET_BYTELEN(h);
+}
+
+DUK_LOCAL void duk__rope_link(duk_heap *heap, duk_hstring_rope *r) {
+	r->prev = NULL;
+	r->next = heap->rope_list;
+	if (r->next != NULL) {
+		DUK_ASSERT(r->next->prev == NULL);
+		r->next->prev = r;
+	}
+	heap->rope_list = r;
+}
+
+DUK_LOCAL void duk__rope_unlink(duk_heap *heap, duk_hstring_rope *r) {
+	if (r->prev != NULL) {
+		DUK_ASSERT(r->prev->next == r);
+		r->prev->next = r->next;
+	} else {
+		DUK_ASSERT(heap->rope_list == r);
+		heap->rope_list = r->next;
+	}
+	if (r->next != NULL) {
+		DUK_ASSERT(r->next->prev == r);
+		r->next->prev = r->prev;
+	}
+}
+
+/* ToString() for a concatenation operand, leaving ropes as is (duk_to_string()
+ * would flatten them).
+ */
+DUK_LOCAL duk_hstring *duk__rope_to_hstring(duk_hthread *thr, duk_idx_t idx) {
+	duk_tval *tv;
+	duk_hstring *h;
+
+	tv = DUK_GET_TVAL_NEGIDX(thr, idx);
+	if (!DUK_TVAL_IS_STRING(tv)) {
+		duk_to_string(thr, idx);
+		tv = DUK_GET_TVAL_NEGIDX(thr, idx);
+		DUK_ASSERT(DUK_TVAL_IS_STRING(tv));
+	}
+	h = DUK_TVAL_GET_STRING(tv);
+	DUK_ASSERT(h != NULL);
+	if (DUK_UNLIKELY(DUK_HSTRING_HAS_SYMBOL(h))) {
+		DUK_ERROR_TYPE(thr, DUK_STR_CANNOT_STRING_COERCE_SYMBOL);
+		DUK_WO_NORETURN(return NULL;);
+	}
+	return h;
+}
+
+/*
+ *  Concatenation: [ ... v1 v2 ] -> [ ... ToString(v1) + ToString(v2) ]
+ */
+
+DUK_INTERNAL void duk_hstring_rope_concat(duk_hthread *thr) {
+	duk_heap *heap;
+	duk_hstring *h1;
+	duk_hstring *h2;
+	duk_size_t len1;
+	duk_size_t len2;
+	duk_size_t len;
+	duk_hstring_rope *r;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(duk_get_top(thr) >= 2);  /* Trusted caller. */
+
+	h1 = duk__rope_to_hstring(thr, -2);
+	h2 = duk__rope_to_hstring(thr, -1);
+	len1 = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h1);
+	len2 = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h2);
+	len = len1 + len2;
+
+	if (len2 == 0) {
+		/* Empty input: result is the other input as is, which also
+		 * avoids flattening a rope.
+		 */
+		duk_pop_unsafe(thr);
+		return;
+	} else if (len1 == 0) {
+		duk_remove_m2(thr);
+		return;
+	} else if (len < DUK_HSTRING_ROPE_MIN_BYTELEN) {
+		/* Neither input can be a rope if the result is short. */
+		duk_concat_2(thr);
+		return;
+	}
+	if (DUK_UNLIKELY(len > (duk_size_t) DUK_HSTRING_MAX_BYTELEN)) {
+		DUK_ERROR_RANGE(thr, DUK_STR_RESULT_TOO_LONG);
+		DUK_WO_NORETURN(return;);
+	}
+
+	/* A flattened left input is replaced with its result to keep the
+	 * spine short.  The right input must be a plain string; a rope there
+	 * ("x + s") is flattened which is what a non-rope concat would cost
+	 * anyway.  The results are reachable through the value stack inputs.
+	 */
+	if (DUK_HSTRING_IS_ROPE(h1) && ((duk_hstring_rope *) h1)->flat != NULL) {
+		h1 = ((duk_hstring_rope *) h1)->flat;
+	}
+	h2 = DUK_HSTRING_FLATTEN(thr, h2);
+
+	heap = thr->heap;
+	r = (duk_hstring_rope *) DUK_ALLOC(heap, sizeof(duk_hstring_rope));
+	if (DUK_UNLIKELY(r == NULL)) {
+		DUK_ERROR_ALLOC_FAILED(thr);
+		DUK_WO_NORETURN(return;);
+	}
+	duk_memzero((void *) r, sizeof(duk_hstring_rope));
+#if defined(DUK_USE_EXPLICIT_NULL_INIT)
+	DUK_HEAPHDR_STRING_INIT_NULLS(&r->str.hdr);
+	r->flat = NULL;
+#endif
+	DUK_HEAPHDR_SET_TYPE_AND_FLAGS(&r->str.hdr, DUK_HTYPE_STRING, DUK_HSTRING_FLAG_ROPE);
+	DUK_HSTRING_SET_BYTELEN(&r->str, (duk_uint32_t) len);
+	DUK_HSTRING_SET_CHARLEN(&r->str, DUK_HSTRING_GET_CHARLEN(h1) + DUK_HSTRING_GET_CHARLEN(h2));
+	if (DUK_HSTRING_GET_CHARLEN(&r->str) == len) {
+		DUK_HSTRING_SET_ASCII(&r->str);
+	}
+#if defined(DUK_USE_HSTRING_ARRIDX)
+	/* Too long to be an array index. */
+	r->str.arridx = DUK_HSTRING_NO_ARRAY_INDEX;
+#endif
+	r->left = h1;
+	r->right = h2;
+	DUK_HSTRING_INCREF(thr, h1);
+	DUK_HSTRING_INCREF(thr, h2);
+	duk__rope_link(heap, r);
+	DUK_STATS_INC(heap, stats_strtab_rope_create);
+
+	duk_push_hstring(thr, (duk_hstring *) r);
+	duk_replace(thr, -3);
+	duk_pop_unsafe(thr);
+}
+
+/*
+ *  Flattening.  The result is interned so ordinary pointer comparison works
+ *  for it.  Mark-and-sweep is prevented so that flattening has no side
+ *  effects other than a possible out of memory error; callers may be holding
+ *  value stack pointers.
+ */
+
+DUK_INTERNAL duk_hstring *duk_hstring_rope_flatten(duk_hthread *thr, duk_hstring *h) {
+	duk_heap *heap;
+	duk_hstring_rope *r;
+	duk_hstring *res;
+	duk_hstring *left;
+	duk_uint8_t *buf;
+	duk_size_t blen;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(h != NULL);
+	DUK_ASSERT(DUK_HSTRING_IS_ROPE(h));
+
+	r = (duk_hstring_rope *) h;
+	if (r->flat != NULL) {
+		return r->flat;
+	}
+
+	heap = thr->heap;
+	blen = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h);
+	DUK_ASSERT(blen > 0);
+
+	res = NULL;
+	heap->ms_prevent_count++;
+	DUK_ASSERT(heap->ms_prevent_count != 0);  /* Wrap. */
+	buf = (duk_uint8_t *) DUK_ALLOC(heap, blen);
+	if (DUK_LIKELY(buf != NULL)) {
+		duk__rope_iter it;
+		duk_uint8_t *p;
+
+		p = buf + blen;
+		it.next = h;
+		while (it.next != NULL) {
+			duk__rope_iter_next(&it);
+			DUK_ASSERT((duk_size_t) (p - buf) >= it.len);
+			p -= it.len;
+			duk_memcpy_unsafe((void *) p, (const void *) it.data, it.len);
+		}
+		DUK_ASSERT(p == buf);
+
+		res = duk_heap_strtable_intern(heap, (const duk_uint8_t *) buf, (duk_uint32_t) blen);
+		DUK_FREE(heap, (void *) buf);
+		if (res != NULL) {
+			DUK_HSTRING_INCREF(thr, res);
+		}
+	}
+	DUK_ASSERT(heap->ms_prevent_count > 0);
+	heap->ms_prevent_count--;
+
+	if (DUK_UNLIKELY(res == NULL)) {
+		DUK_ERROR_ALLOC_FAILED(thr);
+		DUK_WO_NORETURN(return NULL;);
+	}
+	DUK_ASSERT(DUK_HSTRING_GET_BYTELEN(res) == blen);
+	DUK_STATS_INC(heap, stats_strtab_rope_flatten);
+
+#if defined(DUK_USE_HSTRING_LAZY_CLEN)
+	/* The rope already knows the character length, save the result
+	 * from computing it again.
+	 */
+#if defined(DUK_USE_STRLEN16)
+	if (res->clen16 == 0 && !DUK_HEAPHDR_HAS_READONLY((duk_heaphdr *) res)) {
+#else
+	if (res->clen == 0 && !DUK_HEAPHDR_HAS_READONLY((duk_heaphdr *) res)) {
+#endif
+		DUK_HSTRING_SET_CHARLEN(res, DUK_HSTRING_GET_CHARLEN(h));
+		if (DUK_HSTRING_HAS_ASCII(h)) {
+			DUK_HSTRING_SET_ASCII(res);
+		}
+	}
+#endif
+	DUK_ASSERT(DUK_HSTRING_GET_CHARLEN(res) == DUK_HSTRING_GET_CHARLEN(h));
+
+	/* Release the children, the spine is no longer needed.  A left rope
+	 * freed here is handled iteratively by refzero.
+	 */
+	r->flat = res;
+	left = r->left;
+	DUK_HSTRING_DECREF_NORZ(thr, r->right);
+	r->left = NULL;
+	r->right = NULL;
+	DUK_HSTRING_DECREF_NORZ(thr, left);
+
+	return res;
+}
+
+/*
+ *  Equality without flattening, used where allocation is not allowed.
+ */
+
+DUK_INTERNAL duk_bool_t duk_hstring_rope_equals(duk_hstring *h1, duk_hstring *h2) {
+	duk__rope_iter it1;
+	duk__rope_iter it2;
+	duk_size_t left;
+
+	DUK_ASSERT(h1 != NULL);
+	DUK_ASSERT(h2 != NULL);
+
+	if (h1 == h2) {
+		return 1;
+	}
+	if (DUK_HSTRING_GET_BYTELEN(h1) != DUK_HSTRING_GET_BYTELEN(h2)) {
+		return 0;
+	}
+	if (DUK_HSTRING_IS_ROPE(h1) && ((duk_hstring_rope *) h1)->flat != NULL) {
+		h1 = ((duk_hstring_rope *) h1)->flat;
+	}
+	if (DUK_HSTRING_IS_ROPE(h2) && ((duk_hstring_rope *) h2)->flat != NULL) {
+		h2 = ((duk_hstring_rope *) h2)->flat;
+	}
+	if (!DUK_HSTRING_IS_ROPE(h1) && !DUK_HSTRING_IS_ROPE(h2)) {
+		/* Both interned. */
+		return (h1 == h2);
+	}
+
+	/* Compare chunk by chunk from the end, chunk boundaries differ in
+	 * general.
+	 */
+	left = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h1);
+	it1.next = h1;
+	it1.len = 0;
+	it2.next = h2;
+	it2.len = 0;
+	while (left > 0) {
+		duk_size_t n;
+
+		while (it1.len == 0) {
+			duk__rope_iter_next(&it1);
+		}
+		while (it2.len == 0) {
+			duk__rope_iter_next(&it2);
+		}
+		n = (it1.len < it2.len ? it1.len : it2.len);
+		DUK_ASSERT(n > 0 && n <= left);
+		it1.len -= n;
+		it2.len -= n;
+		if (duk_memcmp((const void *) (it1.data + it1.len),
+		               (const void *) (it2.data + it2.len),
+		               (size_t) n) != 0) {
+			return 0;
+		}
+		left -= n;
+	}
+	return 1;
+}
+
+/*
+ *  Freeing
+ */
+
+/* Free a rope whose refcount dropped to zero.  A left child rope whose
+ * refcount also drops to zero is freed in the same loop so that a long
+ * spine doesn't cause deep recursion.
+ */
+DUK_INTERNAL void duk_hstring_rope_free_refzero(duk_heap *heap, duk_hstring_rope *r) {
+	duk_hthread *thr;
+	duk_hstring *left;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(heap->heap_thread != NULL);
+	thr = heap->heap_thread;
+
+	for (;;) {
+		DUK_ASSERT(r != NULL);
+		DUK_ASSERT(DUK_HSTRING_IS_ROPE((duk_hstring *) r));
+
+		left = r->left;
+		if (r->right != NULL) {
+			DUK_HSTRING_DECREF_NORZ(thr, r->right);
+		}
+		if (r->flat != NULL) {
+			DUK_HSTRING_DECREF_NORZ(thr, r->flat);
+		}
+		duk__rope_unlink(heap, r);
+		DUK_FREE(heap, (void *) r);
+
+		if (left == NULL) {
+			break;
+		}
+		if (!DUK_HSTRING_IS_ROPE(left)) {
+			DUK_HSTRING_DECREF_NORZ(thr, left);
+			break;
+		}
+		DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT((duk_heaphdr *) left) > 0);
+		if (DUK_HEAPHDR_PREDEC_REFCOUNT((duk_heaphdr *) left) != 0) {
+			break;
+		}
+		r = (duk_hstring_rope *) left;
+	}
+}
+
+/* Free a rope unreachable in mark-and-sweep; children refcounts have been
+ * finalized already.
+ */
+DUK_INTERNAL void duk_hstring_rope_free(duk_heap *heap, duk_hstring_rope *r) {
+	duk__rope_unlink(heap, r);
+	DUK_FREE(heap, (void *) r);
+}
+
+/* Free all ropes in heap destruction; referenced strings are freed
+ * separately.
+ */
+DUK_INTERNAL void duk_hstring_rope_free_all(duk_heap *heap) {
+	duk_hstring_rope *r;
+	duk_hstring_rope *next;
+
+	r = heap->rope_list;
+	while (r != NULL) {
+		next = r->next;
+		DUK_FREE(heap, (void *) r);
+		r = next;
+	}
+	heap->rope_list = NULL;
+}
+
+#endif  /* DUK_USE_HSTRING_ROPES */
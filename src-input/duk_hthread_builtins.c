@@ -321,6 +321,11 @@ DUK_INTERNAL void duk_hthread_create_builtin_objects(duk_hthread *thr) {
 		h = duk_known_hobject(thr, -1);
 		DUK_HOBJECT_SET_CLASS_NUMBER(h, class_num);
 
+		/* Built-ins are unique, have many properties, and are often
+		 * modified by user code, so give them a dictionary shape.
+		 */
+		DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, h);
+
 		if (i < DUK_NUM_BUILTINS) {
 			thr->builtins[i] = h;
 			DUK_HOBJECT_INCREF(thr, &h->hdr);
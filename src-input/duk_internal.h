@@ -59,6 +59,7 @@ DUK_USE_USER_DECLARE()
 #include "duk_refcount.h"
 #include "duk_api_internal.h"
 #include "duk_hstring.h"
+#include "duk_hshape.h"
 #include "duk_hobject.h"
 #include "duk_hcompfunc.h"
 #include "duk_hnatfunc.h"
@@ -69,6 +70,8 @@ DUK_USE_USER_DECLARE()
 #include "duk_henv.h"
 #include "duk_hbuffer.h"
 #include "duk_hproxy.h"
+#include "duk_hpromise.h"
+#include "duk_hmapset.h"
 #include "duk_heap.h"
 #include "duk_debugger.h"
 #include "duk_debug.h"
@@ -76,6 +79,8 @@ DUK_USE_USER_DECLARE()
 #include "duk_unicode.h"
 #include "duk_json.h"
 #include "duk_js.h"
+#include "duk_js_propic.h"
+#include "duk_js_jit_x64.h"
 #include "duk_numconv.h"
 #include "duk_bi_protos.h"
 #include "duk_selftest.h"
@@ -406,30 +406,36 @@ typedef duk_uint32_t duk_instr_t;
 #define DUK_OP_GETPROPC_CR          209
 #define DUK_OP_GETPROPC_RC          210
 #define DUK_OP_GETPROPC_CC          211
-#define DUK_OP_UNUSED212            212
-#define DUK_OP_UNUSED213            213
-#define DUK_OP_UNUSED214            214
-#define DUK_OP_UNUSED215            215
-#define DUK_OP_UNUSED216            216
-#define DUK_OP_UNUSED217            217
-#define DUK_OP_UNUSED218            218
-#define DUK_OP_UNUSED219            219
-#define DUK_OP_UNUSED220            220
-#define DUK_OP_UNUSED221            221
-#define DUK_OP_UNUSED222            222
-#define DUK_OP_UNUSED223            223
-#define DUK_OP_UNUSED224            224
-#define DUK_OP_UNUSED225            225
-#define DUK_OP_UNUSED226            226
-#define DUK_OP_UNUSED227            227
-#define DUK_OP_UNUSED228            228
-#define DUK_OP_UNUSED229            229
-#define DUK_OP_UNUSED230            230
-#define DUK_OP_UNUSED231            231
-#define DUK_OP_UNUSED232            232
-#define DUK_OP_UNUSED233            233
-#define DUK_OP_UNUSED234            234
-#define DUK_OP_UNUSED235            235
+#define DUK_OP_IFLT                 212
+#define DUK_OP_IFLT_RR              212
+#define DUK_OP_IFLT_CR              213
+#define DUK_OP_IFLT_RC              214
+#define DUK_OP_IFLT_CC              215
+#define DUK_OP_IFGT                 216
+#define DUK_OP_IFGT_RR              216
+#define DUK_OP_IFGT_CR              217
+#define DUK_OP_IFGT_RC              218
+#define DUK_OP_IFGT_CC              219
+#define DUK_OP_IFLE                 220
+#define DUK_OP_IFLE_RR              220
+#define DUK_OP_IFLE_CR              221
+#define DUK_OP_IFLE_RC              222
+#define DUK_OP_IFLE_CC              223
+#define DUK_OP_IFGE                 224
+#define DUK_OP_IFGE_RR              224
+#define DUK_OP_IFGE_CR              225
+#define DUK_OP_IFGE_RC              226
+#define DUK_OP_IFGE_CC              227
+#define DUK_OP_IFSEQ                228
+#define DUK_OP_IFSEQ_RR             228
+#define DUK_OP_IFSEQ_CR             229
+#define DUK_OP_IFSEQ_RC             230
+#define DUK_OP_IFSEQ_CC             231
+#define DUK_OP_IFSNEQ               232
+#define DUK_OP_IFSNEQ_RR            232
+#define DUK_OP_IFSNEQ_CR            233
+#define DUK_OP_IFSNEQ_RC            234
+#define DUK_OP_IFSNEQ_CC            235
 #define DUK_OP_UNUSED236            236
 #define DUK_OP_UNUSED237            237
 #define DUK_OP_UNUSED238            238
@@ -474,8 +480,16 @@ typedef duk_uint32_t duk_instr_t;
 #define DUK_BC_CALL_FLAG_CALLED_AS_EVAL     (1U << 2)
 #define DUK_BC_CALL_FLAG_INDIRECT           (1U << 3)
 
+/* DUK_OP_IFLT etc are compare-and-branch superinstructions emitted only
+ * with DUK_USE_EXEC_SUPERINSTRUCTIONS.  They replace a LT/GT/LE/GE/SEQ/SNEQ
+ * instruction which is immediately followed by an IFTRUE_R/IFFALSE_R
+ * testing the comparison result, and consume that instruction too.  The
+ * IFTRUE_R/IFFALSE_R is left in place so that it remains a valid jump
+ * target.
+ */
+
 /* Misc constants and helper macros. */
-#define DUK_BC_LDINT_BIAS           (1L << 15)
+#define DUK_BC_LDINT_BIAS          (1L << 15)
 #define DUK_BC_LDINTX_SHIFT         16
 #define DUK_BC_JUMP_BIAS            (1L << 23)
 
@@ -641,6 +641,7 @@ DUK_LOCAL duk_int_t duk__cleanup_varmap(duk_compiler_ctx *comp_ctx) {
 		tv = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, h_varmap, i);
 		if (!DUK_TVAL_IS_NUMBER(tv)) {
 			DUK_ASSERT(!DUK_TVAL_IS_HEAP_ALLOCATED(tv));
+			DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, h_varmap);
 			DUK_HOBJECT_E_SET_KEY(thr->heap, h_varmap, i, NULL);
 			DUK_HSTRING_DECREF(thr, h_key);
 			/* when key is NULL, value is garbage so no need to set */
@@ -1851,6 +1852,85 @@ DUK_LOCAL void duk__peephole_optimize_bytecode(duk_compiler_ctx *comp_ctx) {
 	}
 }
 
+#if defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+/*
+ *  Superinstruction pass for finished bytecode.
+ *
+ *  Replaces a comparison which is immediately followed by an IFTRUE_R or
+ *  IFFALSE_R testing the comparison result with a compare-and-branch
+ *  superinstruction.  The IFTRUE_R/IFFALSE_R is kept in place (the
+ *  superinstruction consumes it at runtime) so that instruction indices
+ *  and jump targets don't change.  Instructions with different line
+ *  numbers are not combined so that line information stays accurate.
+ */
+
+DUK_LOCAL void duk__superinstr_optimize_bytecode(duk_compiler_ctx *comp_ctx) {
+	duk_compiler_instr *bc;
+	duk_int_t i, n;
+	duk_int_t count_opt;
+
+	bc = (duk_compiler_instr *) (void *) DUK_BW_GET_BASEPTR(comp_ctx->thr, &comp_ctx->curr_func.bw_code);
+	n = (duk_int_t) (DUK_BW_GET_SIZE(comp_ctx->thr, &comp_ctx->curr_func.bw_code) / sizeof(duk_compiler_instr));
+	count_opt = 0;
+
+	for (i = 0; i < n - 1; i++) {
+		duk_instr_t ins;
+		duk_instr_t ins_if;
+		duk_small_uint_t op;
+		duk_small_uint_t op_if;
+		duk_small_uint_t op_fused;
+
+		ins = bc[i].ins;
+		op = (duk_small_uint_t) DUK_DEC_OP(ins);
+
+		/* Reg/const flags are in the low bits of both opcode groups. */
+		switch (op & ~(DUK_BC_REGCONST_B | DUK_BC_REGCONST_C)) {
+		case DUK_OP_LT:
+			op_fused = DUK_OP_IFLT;
+			break;
+		case DUK_OP_GT:
+			op_fused = DUK_OP_IFGT;
+			break;
+		case DUK_OP_LE:
+			op_fused = DUK_OP_IFLE;
+			break;
+		case DUK_OP_GE:
+			op_fused = DUK_OP_IFGE;
+			break;
+		case DUK_OP_SEQ:
+			op_fused = DUK_OP_IFSEQ;
+			break;
+		case DUK_OP_SNEQ:
+			op_fused = DUK_OP_IFSNEQ;
+			break;
+		default:
+			continue;
+		}
+		op_fused += op & (DUK_BC_REGCONST_B | DUK_BC_REGCONST_C);
+
+		ins_if = bc[i + 1].ins;
+		op_if = (duk_small_uint_t) DUK_DEC_OP(ins_if);
+		if ((op_if != DUK_OP_IFTRUE_R && op_if != DUK_OP_IFFALSE_R) ||
+		    DUK_DEC_BC(ins_if) != DUK_DEC_A(ins)) {
+			continue;
+		}
+#if defined(DUK_USE_PC2LINE)
+		if (bc[i].line != bc[i + 1].line) {
+			continue;
+		}
+#endif
+
+		DUK_DDD(DUK_DDDPRINT("combine compare at pc %ld with following if, opcode %ld -> %ld",
+		                     (long) i, (long) op, (long) op_fused));
+		bc[i].ins = (ins & ~DUK_BC_SHIFTED_MASK_OP) | ((duk_instr_t) op_fused << DUK_BC_SHIFT_OP);
+		count_opt++;
+		i++;  /* the IF can't start another combination */
+	}
+
+	DUK_DD(DUK_DDPRINT("combined %ld compare-and-branch superinstructions", (long) count_opt));
+}
+#endif  /* DUK_USE_EXEC_SUPERINSTRUCTIONS */
+
 /*
  *  Intermediate value helpers
  */
@@ -7498,6 +7578,9 @@ DUK_LOCAL void duk__parse_func_body(duk_compiler_ctx *comp_ctx, duk_bool_t expec
 	 */
 
 	duk__peephole_optimize_bytecode(comp_ctx);
+#if defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+	duk__superinstr_optimize_bytecode(comp_ctx);
+#endif
 
 	/*
 	 *  comp_ctx->curr_func is now ready to be converted into an actual
@@ -38,7 +38,7 @@ DUK_LOCAL_DECL void duk__js_execute_bytecode_inner(duk_hthread *entry_thread, du
 		DUK_TVAL_SET_TVAL(duk__tvdst, duk__tvsrc); \
 		DUK_TVAL_SET_UNDEFINED(duk__tvsrc);  /* value stack init policy */ \
 		duk__thr->valstack_top = duk__tvsrc; \
-		DUK_TVAL_DECREF(duk__thr, &duk__tvtmp); \
+		DUK_TVAL_DECREF_DEFER(duk__thr, &duk__tvtmp); \
 	} while (0)
 
 /* XXX: candidate of being an internal shared API call */
@@ -129,7 +129,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_add(duk_hthread *thr, duk_tval *tv
 		v3_hi = (duk_int32_t) (v3 >> 32);
 		if (DUK_LIKELY(v3_hi >= DUK_I64_CONSTANT(-0x8000) && v3_hi <= DUK_I64_CONSTANT(0x7fff))) {
 			tv_z = thr->valstack_bottom + idx_z;
-			DUK_TVAL_SET_FASTINT_UPDREF(thr, tv_z, v3);  /* side effects */
+			DUK_TVAL_SET_FASTINT_UPDREF_DEFER(thr, tv_z, v3);  /* side effects */
 			return;
 		} else {
 			/* overflow, fall through */
@@ -151,7 +151,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_add(duk_hthread *thr, duk_tval *tv
 		DUK_DBLUNION_NORMALIZE_NAN_CHECK(&du);
 		DUK_ASSERT(DUK_DBLUNION_IS_NORMALIZED(&du));
 		tv_z = thr->valstack_bottom + idx_z;
-		DUK_TVAL_SET_NUMBER_UPDREF(thr, tv_z, du.d);  /* side effects */
+		DUK_TVAL_SET_NUMBER_UPDREF_DEFER(thr, tv_z, du.d);  /* side effects */
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 		return;
 	}
@@ -173,7 +173,11 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_add(duk_hthread *thr, duk_tval *tv
 		 * in duk_concat_2() which also fails with TypeError so no
 		 * explicit check is needed.
 		 */
+#if defined(DUK_USE_HSTRING_ROPES)
+		duk_hstring_rope_concat(thr);  /* [... s1 s2] -> [... s1+s2] */
+#else
 		duk_concat_2(thr);  /* [... s1 s2] -> [... s1+s2] */
+#endif
 	} else {
 		duk_double_t d1, d2;
 
@@ -280,7 +284,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_binary_op(duk_hthread *thr, duk_tv
 		v3_hi = (duk_int32_t) (v3 >> 32);
 		if (DUK_LIKELY(v3_hi >= DUK_I64_CONSTANT(-0x8000) && v3_hi <= DUK_I64_CONSTANT(0x7fff))) {
 			tv_z = thr->valstack_bottom + idx_z;
-			DUK_TVAL_SET_FASTINT_UPDREF(thr, tv_z, v3);  /* side effects */
+			DUK_TVAL_SET_FASTINT_UPDREF_DEFER(thr, tv_z, v3);  /* side effects */
 			return;
 		}
 		/* fall through if overflow etc */
@@ -345,7 +349,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_binary_op(duk_hthread *thr, duk_tv
 	DUK_DBLUNION_NORMALIZE_NAN_CHECK(&du);
 	DUK_ASSERT(DUK_DBLUNION_IS_NORMALIZED(&du));
 	tv_z = thr->valstack_bottom + idx_z;
-	DUK_TVAL_SET_NUMBER_UPDREF(thr, tv_z, du.d);  /* side effects */
+	DUK_TVAL_SET_NUMBER_UPDREF_DEFER(thr, tv_z, du.d);  /* side effects */
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 }
 
@@ -458,7 +462,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_bitwise_binary_op(duk_hthread *thr, duk_
 
  fastint_result_set:
 	tv_z = thr->valstack_bottom + idx_z;
-	DUK_TVAL_SET_FASTINT_UPDREF(thr, tv_z, fi3);  /* side effects */
+	DUK_TVAL_SET_FASTINT_UPDREF_DEFER(thr, tv_z, fi3);  /* side effects */
 #else  /* DUK_USE_FASTINT */
 	d3 = (duk_double_t) i3;
 
@@ -471,7 +475,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_bitwise_binary_op(duk_hthread *thr, duk_
 	duk_replace(thr, (duk_idx_t) idx_z);
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
 	tv_z = thr->valstack_bottom + idx_z;
-	DUK_TVAL_SET_NUMBER_UPDREF(thr, tv_z, d3);  /* side effects */
+	DUK_TVAL_SET_NUMBER_UPDREF_DEFER(thr, tv_z, d3);  /* side effects */
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 #endif  /* DUK_USE_FASTINT */
 }
@@ -510,7 +514,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_unary_op(duk_hthread *thr, duk_uin
 			if (DUK_LIKELY(v1 != DUK_FASTINT_MIN && v1 != 0)) {
 				v2 = -v1;
 				tv = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
-				DUK_TVAL_SET_FASTINT_UPDREF(thr, tv, v2);
+				DUK_TVAL_SET_FASTINT_UPDREF_DEFER(thr, tv, v2);
 				return;
 			}
 		} else {
@@ -518,7 +522,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_unary_op(duk_hthread *thr, duk_uin
 			DUK_ASSERT(opcode == DUK_OP_UNP);
 			v2 = v1;
 			tv = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
-			DUK_TVAL_SET_FASTINT_UPDREF(thr, tv, v2);
+			DUK_TVAL_SET_FASTINT_UPDREF_DEFER(thr, tv, v2);
 			return;
 		}
 		/* fall through if overflow etc */
@@ -539,7 +543,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_unary_op(duk_hthread *thr, duk_uin
 		DUK_ASSERT(DUK_DBLUNION_IS_NORMALIZED(&du));
 #if defined(DUK_USE_FASTINT)
 		tv = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
-		DUK_TVAL_SET_NUMBER_CHKFAST_UPDREF(thr, tv, du.d);  /* always 'fast', i.e. inlined */
+		DUK_TVAL_SET_NUMBER_CHKFAST_UPDREF_DEFER(thr, tv, du.d);  /* always 'fast', i.e. inlined */
 		return;
 #endif
 	} else {
@@ -551,7 +555,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_arith_unary_op(duk_hthread *thr, duk_uin
 
 	/* XXX: size optimize: push+replace? */
 	tv = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
-	DUK_TVAL_SET_NUMBER_UPDREF(thr, tv, du.d);
+	DUK_TVAL_SET_NUMBER_UPDREF_DEFER(thr, tv, du.d);
 }
 
 DUK_LOCAL DUK__INLINE_PERF void duk__vm_bitwise_not(duk_hthread *thr, duk_uint_fast_t idx_src, duk_uint_fast_t idx_dst) {
@@ -585,7 +589,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_bitwise_not(duk_hthread *thr, duk_uint_f
 	/* Result is always fastint compatible. */
 	i2 = ~i1;
 	tv = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
-	DUK_TVAL_SET_I32_UPDREF(thr, tv, i2);  /* side effects */
+	DUK_TVAL_SET_I32_UPDREF_DEFER(thr, tv, i2);  /* side effects */
 }
 
 DUK_LOCAL DUK__INLINE_PERF void duk__vm_logical_not(duk_hthread *thr, duk_uint_fast_t idx_src, duk_uint_fast_t idx_dst) {
@@ -612,7 +616,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__vm_logical_not(duk_hthread *thr, duk_uint_f
 	res ^= 1;
 	tv = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
 	/* XXX: size optimize: push+replace? */
-	DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv, res);  /* side effects */
+	DUK_TVAL_SET_BOOLEAN_UPDREF_DEFER(thr, tv, res);  /* side effects */
 }
 
 /* XXX: size optimized variant */
@@ -646,7 +650,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__prepost_incdec_reg_helper(duk_hthread *thr,
 		DUK_TVAL_SET_FASTINT(tv_src, y_fi);  /* no need for refcount update */
 
 		z_fi = (op & 0x02) ? x_fi : y_fi;
-		DUK_TVAL_SET_FASTINT_UPDREF(thr, tv_dst, z_fi);  /* side effects */
+		DUK_TVAL_SET_FASTINT_UPDREF_DEFER(thr, tv_dst, z_fi);  /* side effects */
 		return;
 	}
  skip_fastint:
@@ -689,7 +693,7 @@ DUK_LOCAL DUK__INLINE_PERF void duk__prepost_incdec_reg_helper(duk_hthread *thr,
 	}
 
 	z = (op & 0x02) ? x : y;
-	DUK_TVAL_SET_NUMBER_UPDREF(thr, tv_dst, z);  /* side effects */
+	DUK_TVAL_SET_NUMBER_UPDREF_DEFER(thr, tv_dst, z);  /* side effects */
 }
 
 DUK_LOCAL DUK__INLINE_PERF void duk__prepost_incdec_var_helper(duk_hthread *thr, duk_small_uint_t idx_dst, duk_tval *tv_id, duk_small_uint_t op, duk_small_uint_t is_strict) {
@@ -753,6 +757,207 @@ DUK_LOCAL DUK__INLINE_PERF void duk__prepost_incdec_var_helper(duk_hthread *thr,
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 }
 
+/*
+ *  Property access inline caches, see duk_js_propic.h.
+ */
+
+#if defined(DUK_USE_PROP_IC) && !defined(DUK_USE_EXEC_PREFER_SIZE)
+/* Inline cache probe for the GETPROP/PUTPROP instruction at index 'pc'
+ * of 'fun', whose key 'tv_key' is a constant.  Returns a pointer to the
+ * value slot of the property (own or in the immediate prototype), or NULL
+ * if the generic property access path must be used.  A miss updates the
+ * cache.  No side effects.
+ *
+ * Kept out of line so that only the monomorphic own property check in
+ * duk__propic_lookup() is inlined into the executor.
+ */
+DUK_LOCAL DUK_NOINLINE duk_tval *duk__propic_probe(duk_hthread *thr, duk_hcompfunc *fun, duk_uint32_t pc, duk_hobject *obj, duk_tval *tv_key, duk_bool_t is_put) {
+	duk_propic *ic;
+	duk_propic_entry *ent;
+	duk_uint32_t id;
+	duk_small_uint_t i;
+
+	ic = fun->propic;
+	if (DUK_UNLIKELY(ic == NULL)) {
+		return duk_propic_fill(thr, fun, pc, NULL, obj, tv_key, is_put);
+	}
+	DUK_PROPIC_FIND_ENTRY(ic, pc, ent);
+	if (DUK_LIKELY(DUK_PROPIC_OBJECT_IS_CACHEABLE(obj))) {
+		id = obj->shape->id;
+		for (i = 0; i < DUK_PROPIC_WAYS; i++) {
+			duk_hobject *holder;
+
+			if (ent->shape_id[i] != id) {
+				continue;
+			}
+			holder = obj;
+			if (ent->holder_id[i] != DUK_HSHAPE_ID_NONE) {
+				DUK_ASSERT(!is_put);
+				holder = DUK_HOBJECT_GET_PROTOTYPE(thr->heap, obj);
+				if (holder == NULL ||
+				    !DUK_PROPIC_OBJECT_IS_CACHEABLE(holder) ||
+				    holder->shape->id != ent->holder_id[i]) {
+					continue;
+				}
+			}
+			DUK_ASSERT(ent->slot[i] < DUK_HOBJECT_GET_ENEXT(holder));
+			DUK_ASSERT(!DUK_HOBJECT_E_SLOT_IS_ACCESSOR(thr->heap, holder, ent->slot[i]));
+			DUK_ASSERT(!is_put || DUK_HOBJECT_E_SLOT_IS_WRITABLE(thr->heap, holder, ent->slot[i]));
+			DUK_STATS_INC(thr->heap, stats_propic_hit);
+			return DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, holder, ent->slot[i]);
+		}
+	}
+
+	if (ent->used >= DUK_PROPIC_WAYS) {
+		/* Megamorphic or uncacheable site. */
+		return NULL;
+	}
+	return duk_propic_fill(thr, fun, pc, ent, obj, tv_key, is_put);
+}
+
+/* Inline cache lookup for the GETPROP/PUTPROP instruction preceding
+ * 'curr_pc'.  The common case, an own property hit in the first way of a
+ * table entry found without probing, is handled inline.
+ */
+DUK_LOCAL DUK__INLINE_PERF duk_tval *duk__propic_lookup(duk_hthread *thr, duk_hcompfunc *fun, duk_instr_t *curr_pc, duk_tval *tv_obj, duk_tval *tv_key, duk_bool_t is_put) {
+	duk_propic *ic;
+	duk_propic_entry *ent;
+	duk_hobject *obj;
+	duk_uint32_t pc;
+
+	if (DUK_UNLIKELY(!DUK_TVAL_IS_OBJECT(tv_obj))) {
+		return NULL;
+	}
+	obj = DUK_TVAL_GET_OBJECT(tv_obj);
+	DUK_ASSERT(obj != NULL);
+	DUK_ASSERT(obj->shape != NULL);
+
+	pc = (duk_uint32_t) (curr_pc - DUK_HCOMPFUNC_GET_CODE_BASE(thr->heap, fun)) - 1U;
+	ic = fun->propic;
+	if (DUK_LIKELY(ic != NULL)) {
+		ent = DUK_PROPIC_GET_ENTRIES(ic) + (pc & ic->mask);
+		if (DUK_LIKELY(ent->pc == pc)) {
+			if (DUK_LIKELY(ent->shape_id[0] == obj->shape->id &&
+			               ent->holder_id[0] == DUK_HSHAPE_ID_NONE &&
+			               DUK_PROPIC_OBJECT_IS_CACHEABLE(obj))) {
+				DUK_ASSERT(ent->slot[0] < DUK_HOBJECT_GET_ENEXT(obj));
+				DUK_ASSERT(!DUK_HOBJECT_E_SLOT_IS_ACCESSOR(thr->heap, obj, ent->slot[0]));
+				DUK_ASSERT(!is_put || DUK_HOBJECT_E_SLOT_IS_WRITABLE(thr->heap, obj, ent->slot[0]));
+				DUK_STATS_INC(thr->heap, stats_propic_hit);
+				return DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, obj, ent->slot[0]);
+			}
+			if (ent->shape_id[0] == DUK_PROPIC_ID_UNUSED && ent->used >= DUK_PROPIC_WAYS) {
+				/* Uncacheable site, nothing to probe. */
+				return NULL;
+			}
+		}
+	}
+	return duk__propic_probe(thr, fun, pc, obj, tv_key, is_put);
+}
+#endif  /* DUK_USE_PROP_IC && !DUK_USE_EXEC_PREFER_SIZE */
+
+/*
+ *  Opcode helpers for JIT compiled code, see duk_js_jit_x64.h.  These
+ *  wrap the executor helpers so that native code performs exactly the same
+ *  operations as the executor.  Native code keeps *thr->ptr_curr_pc in
+ *  sync before calling them.
+ */
+
+#if defined(DUK_USE_JIT_X64)
+DUK_INTERNAL void duk_jit_x64_op_add(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint_fast_t idx_z) {
+	duk__vm_arith_add(thr, tv_x, tv_y, (duk_small_uint_fast_t) idx_z);
+}
+
+DUK_INTERNAL void duk_jit_x64_op_arith(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint_fast_t idx_z, duk_small_uint_fast_t opcode) {
+	duk__vm_arith_binary_op(thr, tv_x, tv_y, idx_z, opcode);
+}
+
+DUK_INTERNAL void duk_jit_x64_op_bitwise(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint_fast_t idx_z, duk_small_uint_fast_t opcode) {
+	duk__vm_bitwise_binary_op(thr, tv_x, tv_y, (duk_small_uint_fast_t) idx_z, opcode);
+}
+
+DUK_INTERNAL void duk_jit_x64_op_unary(duk_hthread *thr, duk_uint_fast_t idx_src, duk_uint_fast_t idx_dst, duk_small_uint_fast_t opcode) {
+	switch (opcode) {
+	case DUK_OP_BNOT:
+		duk__vm_bitwise_not(thr, idx_src, idx_dst);
+		break;
+	case DUK_OP_LNOT:
+		duk__vm_logical_not(thr, idx_src, idx_dst);
+		break;
+	default:
+		DUK_ASSERT(opcode == DUK_OP_UNM || opcode == DUK_OP_UNP);
+		duk__vm_arith_unary_op(thr, idx_src, idx_dst, opcode);
+		break;
+	}
+}
+
+DUK_INTERNAL void duk_jit_x64_op_incdec(duk_hthread *thr, duk_tval *tv_dst, duk_tval *tv_src, duk_small_uint_fast_t opcode) {
+	duk__prepost_incdec_reg_helper(thr, tv_dst, tv_src, (duk_small_uint_t) opcode);
+}
+
+DUK_INTERNAL void duk_jit_x64_op_getprop(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_uint_fast_t idx_dst) {
+	(void) duk_hobject_getprop(thr, tv_obj, tv_key);
+	DUK__REPLACE_TO_TVPTR(thr, DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst));
+}
+
+DUK_INTERNAL void duk_jit_x64_op_putprop(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_tval *tv_val, duk_small_uint_fast_t is_strict) {
+	(void) duk_hobject_putprop(thr, tv_obj, tv_key, tv_val, (duk_bool_t) is_strict);
+}
+
+#if defined(DUK_USE_PROP_IC) && !defined(DUK_USE_EXEC_PREFER_SIZE)
+/* Only for instructions with an inline cache entry (constant key). */
+DUK_INTERNAL void duk_jit_x64_op_getprop_ic(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_uint_fast_t idx_dst) {
+	duk_tval *tv_val;
+
+	tv_val = duk__propic_lookup(thr, (duk_hcompfunc *) DUK_ACT_GET_FUNC(thr->callstack_curr), *thr->ptr_curr_pc, tv_obj, tv_key, 0 /*is_put*/);
+	if (DUK_LIKELY(tv_val != NULL)) {
+		duk_tval *tv_out = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
+		DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr, tv_out, tv_val);
+		return;
+	}
+	duk_jit_x64_op_getprop(thr, tv_obj, tv_key, idx_dst);
+}
+
+DUK_INTERNAL void duk_jit_x64_op_putprop_ic(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_tval *tv_val, duk_small_uint_fast_t is_strict) {
+	duk_tval *tv_slot;
+
+	tv_slot = duk__propic_lookup(thr, (duk_hcompfunc *) DUK_ACT_GET_FUNC(thr->callstack_curr), *thr->ptr_curr_pc, tv_obj, tv_key, 1 /*is_put*/);
+	if (DUK_LIKELY(tv_slot != NULL)) {
+		DUK_TVAL_SET_TVAL_UPDREF(thr, tv_slot, tv_val);
+		return;
+	}
+	duk_jit_x64_op_putprop(thr, tv_obj, tv_key, tv_val, is_strict);
+}
+#endif  /* DUK_USE_PROP_IC && !DUK_USE_EXEC_PREFER_SIZE */
+
+/* Count a function entry or backward jump towards JIT compilation and
+ * compile when the threshold is reached.  Returns the JIT state if native
+ * code can be entered, NULL otherwise.
+ */
+DUK_LOCAL DUK_NOINLINE duk_jitfunc *duk__executor_jit_count(duk_hthread *thr, duk_hcompfunc *fun) {
+	duk_jitfunc *jf;
+
+	jf = fun->jit;
+	DUK_ASSERT(jf != NULL);
+
+	if (jf->state == DUK_JIT_X64_STATE_COUNTING) {
+		if (++jf->counter < DUK_JIT_X64_THRESHOLD) {
+			return NULL;
+		}
+		duk_jit_x64_compile(thr->heap, fun);
+	}
+	if (jf->state != DUK_JIT_X64_STATE_COMPILED) {
+		return NULL;
+	}
+#if defined(DUK_USE_DEBUGGER_SUPPORT)
+	if (duk_debug_is_attached(thr->heap)) {
+		return NULL;
+	}
+#endif
+	return jf;
+}
+#endif  /* DUK_USE_JIT_X64 */
+
 /*
  *  Longjmp and other control flow transfer for the bytecode executor.
  *
@@ -1532,6 +1737,13 @@ DUK_LOCAL duk_small_uint_t duk__handle_return(duk_hthread *thr, duk_activation *
 
 	DUK_ASSERT(thr != NULL);
 	DUK_ASSERT(entry_act != NULL);
+
+	/* Function return is a reconciliation point for refzero handling
+	 * deferred by register writes.  May have side effects, so before
+	 * looking up value stack pointers.
+	 */
+	DUK_REFZERO_DEFER_FLUSH(thr);
+
 	DUK_ASSERT(thr->valstack_top - 1 >= thr->valstack_bottom);
 	tv1 = thr->valstack_top - 1;
 	DUK_TVAL_CHKFAST_INPLACE_FAST(tv1);  /* fastint downgrade check for return values */
@@ -2780,6 +2992,54 @@ DUK_LOCAL duk_bool_t duk__executor_handle_call(duk_hthread *thr, duk_idx_t idx,
 	} while (0)
 #endif
 
+/* Opcode dispatch.  By default dispatch happens using a switch statement
+ * at the top of the dispatch loop.  With DUK_USE_EXEC_COMPUTED_GOTO and a
+ * compiler supporting "labels as values" (GCC, Clang) each opcode handler
+ * also has a label, the initial dispatch jumps through a label table, and
+ * handlers finishing with DUK__NEXT() fetch and dispatch the next opcode
+ * directly so that each handler has an indirect jump of its own which
+ * improves branch prediction.  The interrupt counter is checked as usual
+ * and when it triggers, execution continues through the top of the loop.
+ * Assert and debug builds dispatch through the label table but always
+ * return to the top of the loop for per-opcode checks, and so do JIT
+ * builds so that native code is re-entered after an interpreted opcode.
+ */
+#if defined(DUK_USE_EXEC_COMPUTED_GOTO) && !defined(DUK_USE_EXEC_PREFER_SIZE) && defined(__GNUC__)
+#define DUK__EXEC_COMPUTED_GOTO
+#endif
+
+#if defined(DUK__EXEC_COMPUTED_GOTO)
+#define DUK__LABEL(op)      duk__lbl_##op
+#define DUK__CASE(op)       case op: duk__lbl_##op  /* pasted directly so that 'op' is not expanded */
+#define DUK__DISPATCH()     do { goto *duk__dispatch_table[op]; } while (0)
+#else
+#define DUK__CASE(op)       case op
+#endif
+
+#if defined(DUK__EXEC_COMPUTED_GOTO) && !defined(DUK_USE_ASSERTIONS) && !defined(DUK_USE_DEBUG) && !defined(DUK_USE_JIT_X64)
+#if defined(DUK_USE_INTERRUPT_COUNTER)
+#define DUK__NEXT() { \
+		if (DUK_LIKELY(thr->interrupt_counter > 0)) { \
+			thr->interrupt_counter--; \
+			ins = *curr_pc++; \
+			DUK_STATS_INC(thr->heap, stats_exec_opcodes); \
+			op = (duk_uint8_t) DUK_DEC_OP(ins); \
+			DUK__DISPATCH(); \
+		} \
+		break; \
+	}
+#else  /* DUK_USE_INTERRUPT_COUNTER */
+#define DUK__NEXT() { \
+		ins = *curr_pc++; \
+		DUK_STATS_INC(thr->heap, stats_exec_opcodes); \
+		op = (duk_uint8_t) DUK_DEC_OP(ins); \
+		DUK__DISPATCH(); \
+	}
+#endif  /* DUK_USE_INTERRUPT_COUNTER */
+#else
+#define DUK__NEXT() break
+#endif
+
 #define DUK__SYNC_CURR_PC()  do { \
 		duk_activation *duk__act; \
 		duk__act = thr->callstack_curr; \
@@ -3007,10 +3267,87 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 	duk_int_t int_ctr;
 #endif
 
+#if defined(DUK_USE_JIT_X64)
+	duk_jitfunc *jit_run;         /* non-NULL: enter native code at dispatch */
+	duk_bool_t jit_count;         /* count backward jumps towards compilation */
+#endif
+
 #if defined(DUK_USE_ASSERTIONS)
 	duk_size_t valstack_top_base;    /* valstack top, should match before interpreting each op (no leftovers) */
 #endif
 
+#if defined(DUK__EXEC_COMPUTED_GOTO)
+	/* Opcode handler labels, indexed by opcode number.  Every opcode,
+	 * including unused ones, must have a handler.
+	 */
+	static const void * const duk__dispatch_table[256] = {
+		&&DUK__LABEL(DUK_OP_LDREG), &&DUK__LABEL(DUK_OP_STREG), &&DUK__LABEL(DUK_OP_JUMP), &&DUK__LABEL(DUK_OP_LDCONST),
+		&&DUK__LABEL(DUK_OP_LDINT), &&DUK__LABEL(DUK_OP_LDINTX), &&DUK__LABEL(DUK_OP_LDTHIS), &&DUK__LABEL(DUK_OP_LDUNDEF),
+		&&DUK__LABEL(DUK_OP_LDNULL), &&DUK__LABEL(DUK_OP_LDTRUE), &&DUK__LABEL(DUK_OP_LDFALSE), &&DUK__LABEL(DUK_OP_GETVAR),
+		&&DUK__LABEL(DUK_OP_BNOT), &&DUK__LABEL(DUK_OP_LNOT), &&DUK__LABEL(DUK_OP_UNM), &&DUK__LABEL(DUK_OP_UNP),
+		&&DUK__LABEL(DUK_OP_EQ_RR), &&DUK__LABEL(DUK_OP_EQ_CR), &&DUK__LABEL(DUK_OP_EQ_RC), &&DUK__LABEL(DUK_OP_EQ_CC),
+		&&DUK__LABEL(DUK_OP_NEQ_RR), &&DUK__LABEL(DUK_OP_NEQ_CR), &&DUK__LABEL(DUK_OP_NEQ_RC), &&DUK__LABEL(DUK_OP_NEQ_CC),
+		&&DUK__LABEL(DUK_OP_SEQ_RR), &&DUK__LABEL(DUK_OP_SEQ_CR), &&DUK__LABEL(DUK_OP_SEQ_RC), &&DUK__LABEL(DUK_OP_SEQ_CC),
+		&&DUK__LABEL(DUK_OP_SNEQ_RR), &&DUK__LABEL(DUK_OP_SNEQ_CR), &&DUK__LABEL(DUK_OP_SNEQ_RC), &&DUK__LABEL(DUK_OP_SNEQ_CC),
+		&&DUK__LABEL(DUK_OP_GT_RR), &&DUK__LABEL(DUK_OP_GT_CR), &&DUK__LABEL(DUK_OP_GT_RC), &&DUK__LABEL(DUK_OP_GT_CC),
+		&&DUK__LABEL(DUK_OP_GE_RR), &&DUK__LABEL(DUK_OP_GE_CR), &&DUK__LABEL(DUK_OP_GE_RC), &&DUK__LABEL(DUK_OP_GE_CC),
+		&&DUK__LABEL(DUK_OP_LT_RR), &&DUK__LABEL(DUK_OP_LT_CR), &&DUK__LABEL(DUK_OP_LT_RC), &&DUK__LABEL(DUK_OP_LT_CC),
+		&&DUK__LABEL(DUK_OP_LE_RR), &&DUK__LABEL(DUK_OP_LE_CR), &&DUK__LABEL(DUK_OP_LE_RC), &&DUK__LABEL(DUK_OP_LE_CC),
+		&&DUK__LABEL(DUK_OP_IFTRUE_R), &&DUK__LABEL(DUK_OP_IFTRUE_C), &&DUK__LABEL(DUK_OP_IFFALSE_R), &&DUK__LABEL(DUK_OP_IFFALSE_C),
+		&&DUK__LABEL(DUK_OP_ADD_RR), &&DUK__LABEL(DUK_OP_ADD_CR), &&DUK__LABEL(DUK_OP_ADD_RC), &&DUK__LABEL(DUK_OP_ADD_CC),
+		&&DUK__LABEL(DUK_OP_SUB_RR), &&DUK__LABEL(DUK_OP_SUB_CR), &&DUK__LABEL(DUK_OP_SUB_RC), &&DUK__LABEL(DUK_OP_SUB_CC),
+		&&DUK__LABEL(DUK_OP_MUL_RR), &&DUK__LABEL(DUK_OP_MUL_CR), &&DUK__LABEL(DUK_OP_MUL_RC), &&DUK__LABEL(DUK_OP_MUL_CC),
+		&&DUK__LABEL(DUK_OP_DIV_RR), &&DUK__LABEL(DUK_OP_DIV_CR), &&DUK__LABEL(DUK_OP_DIV_RC), &&DUK__LABEL(DUK_OP_DIV_CC),
+		&&DUK__LABEL(DUK_OP_MOD_RR), &&DUK__LABEL(DUK_OP_MOD_CR), &&DUK__LABEL(DUK_OP_MOD_RC), &&DUK__LABEL(DUK_OP_MOD_CC),
+		&&DUK__LABEL(DUK_OP_EXP_RR), &&DUK__LABEL(DUK_OP_EXP_CR), &&DUK__LABEL(DUK_OP_EXP_RC), &&DUK__LABEL(DUK_OP_EXP_CC),
+		&&DUK__LABEL(DUK_OP_BAND_RR), &&DUK__LABEL(DUK_OP_BAND_CR), &&DUK__LABEL(DUK_OP_BAND_RC), &&DUK__LABEL(DUK_OP_BAND_CC),
+		&&DUK__LABEL(DUK_OP_BOR_RR), &&DUK__LABEL(DUK_OP_BOR_CR), &&DUK__LABEL(DUK_OP_BOR_RC), &&DUK__LABEL(DUK_OP_BOR_CC),
+		&&DUK__LABEL(DUK_OP_BXOR_RR), &&DUK__LABEL(DUK_OP_BXOR_CR), &&DUK__LABEL(DUK_OP_BXOR_RC), &&DUK__LABEL(DUK_OP_BXOR_CC),
+		&&DUK__LABEL(DUK_OP_BASL_RR), &&DUK__LABEL(DUK_OP_BASL_CR), &&DUK__LABEL(DUK_OP_BASL_RC), &&DUK__LABEL(DUK_OP_BASL_CC),
+		&&DUK__LABEL(DUK_OP_BLSR_RR), &&DUK__LABEL(DUK_OP_BLSR_CR), &&DUK__LABEL(DUK_OP_BLSR_RC), &&DUK__LABEL(DUK_OP_BLSR_CC),
+		&&DUK__LABEL(DUK_OP_BASR_RR), &&DUK__LABEL(DUK_OP_BASR_CR), &&DUK__LABEL(DUK_OP_BASR_RC), &&DUK__LABEL(DUK_OP_BASR_CC),
+		&&DUK__LABEL(DUK_OP_INSTOF_RR), &&DUK__LABEL(DUK_OP_INSTOF_CR), &&DUK__LABEL(DUK_OP_INSTOF_RC), &&DUK__LABEL(DUK_OP_INSTOF_CC),
+		&&DUK__LABEL(DUK_OP_IN_RR), &&DUK__LABEL(DUK_OP_IN_CR), &&DUK__LABEL(DUK_OP_IN_RC), &&DUK__LABEL(DUK_OP_IN_CC),
+		&&DUK__LABEL(DUK_OP_GETPROP_RR), &&DUK__LABEL(DUK_OP_GETPROP_CR), &&DUK__LABEL(DUK_OP_GETPROP_RC), &&DUK__LABEL(DUK_OP_GETPROP_CC),
+		&&DUK__LABEL(DUK_OP_PUTPROP_RR), &&DUK__LABEL(DUK_OP_PUTPROP_CR), &&DUK__LABEL(DUK_OP_PUTPROP_RC), &&DUK__LABEL(DUK_OP_PUTPROP_CC),
+		&&DUK__LABEL(DUK_OP_DELPROP_RR), &&DUK__LABEL(DUK_OP_DELPROP_CR_UNUSED), &&DUK__LABEL(DUK_OP_DELPROP_RC), &&DUK__LABEL(DUK_OP_DELPROP_CC_UNUSED),
+		&&DUK__LABEL(DUK_OP_PREINCR), &&DUK__LABEL(DUK_OP_PREDECR), &&DUK__LABEL(DUK_OP_POSTINCR), &&DUK__LABEL(DUK_OP_POSTDECR),
+		&&DUK__LABEL(DUK_OP_PREINCV), &&DUK__LABEL(DUK_OP_PREDECV), &&DUK__LABEL(DUK_OP_POSTINCV), &&DUK__LABEL(DUK_OP_POSTDECV),
+		&&DUK__LABEL(DUK_OP_PREINCP_RR), &&DUK__LABEL(DUK_OP_PREINCP_CR), &&DUK__LABEL(DUK_OP_PREINCP_RC), &&DUK__LABEL(DUK_OP_PREINCP_CC),
+		&&DUK__LABEL(DUK_OP_PREDECP_RR), &&DUK__LABEL(DUK_OP_PREDECP_CR), &&DUK__LABEL(DUK_OP_PREDECP_RC), &&DUK__LABEL(DUK_OP_PREDECP_CC),
+		&&DUK__LABEL(DUK_OP_POSTINCP_RR), &&DUK__LABEL(DUK_OP_POSTINCP_CR), &&DUK__LABEL(DUK_OP_POSTINCP_RC), &&DUK__LABEL(DUK_OP_POSTINCP_CC),
+		&&DUK__LABEL(DUK_OP_POSTDECP_RR), &&DUK__LABEL(DUK_OP_POSTDECP_CR), &&DUK__LABEL(DUK_OP_POSTDECP_RC), &&DUK__LABEL(DUK_OP_POSTDECP_CC),
+		&&DUK__LABEL(DUK_OP_DECLVAR_RR), &&DUK__LABEL(DUK_OP_DECLVAR_CR), &&DUK__LABEL(DUK_OP_DECLVAR_RC), &&DUK__LABEL(DUK_OP_DECLVAR_CC),
+		&&DUK__LABEL(DUK_OP_REGEXP_RR), &&DUK__LABEL(DUK_OP_REGEXP_CR), &&DUK__LABEL(DUK_OP_REGEXP_RC), &&DUK__LABEL(DUK_OP_REGEXP_CC),
+		&&DUK__LABEL(DUK_OP_CLOSURE), &&DUK__LABEL(DUK_OP_TYPEOF), &&DUK__LABEL(DUK_OP_TYPEOFID), &&DUK__LABEL(DUK_OP_PUTVAR),
+		&&DUK__LABEL(DUK_OP_DELVAR), &&DUK__LABEL(DUK_OP_RETREG), &&DUK__LABEL(DUK_OP_RETUNDEF), &&DUK__LABEL(DUK_OP_RETCONST),
+		&&DUK__LABEL(DUK_OP_RETCONSTN), &&DUK__LABEL(DUK_OP_LABEL), &&DUK__LABEL(DUK_OP_ENDLABEL), &&DUK__LABEL(DUK_OP_BREAK),
+		&&DUK__LABEL(DUK_OP_CONTINUE), &&DUK__LABEL(DUK_OP_TRYCATCH), &&DUK__LABEL(DUK_OP_ENDTRY), &&DUK__LABEL(DUK_OP_ENDCATCH),
+		&&DUK__LABEL(DUK_OP_ENDFIN), &&DUK__LABEL(DUK_OP_THROW), &&DUK__LABEL(DUK_OP_INVLHS), &&DUK__LABEL(DUK_OP_CSREG),
+		&&DUK__LABEL(DUK_OP_CSVAR_RR), &&DUK__LABEL(DUK_OP_CSVAR_CR), &&DUK__LABEL(DUK_OP_CSVAR_RC), &&DUK__LABEL(DUK_OP_CSVAR_CC),
+		&&DUK__LABEL(DUK_OP_CALL0), &&DUK__LABEL(DUK_OP_CALL1), &&DUK__LABEL(DUK_OP_CALL2), &&DUK__LABEL(DUK_OP_CALL3),
+		&&DUK__LABEL(DUK_OP_CALL4), &&DUK__LABEL(DUK_OP_CALL5), &&DUK__LABEL(DUK_OP_CALL6), &&DUK__LABEL(DUK_OP_CALL7),
+		&&DUK__LABEL(DUK_OP_CALL8), &&DUK__LABEL(DUK_OP_CALL9), &&DUK__LABEL(DUK_OP_CALL10), &&DUK__LABEL(DUK_OP_CALL11),
+		&&DUK__LABEL(DUK_OP_CALL12), &&DUK__LABEL(DUK_OP_CALL13), &&DUK__LABEL(DUK_OP_CALL14), &&DUK__LABEL(DUK_OP_CALL15),
+		&&DUK__LABEL(DUK_OP_NEWOBJ), &&DUK__LABEL(DUK_OP_NEWARR), &&DUK__LABEL(DUK_OP_MPUTOBJ), &&DUK__LABEL(DUK_OP_MPUTOBJI),
+		&&DUK__LABEL(DUK_OP_INITSET), &&DUK__LABEL(DUK_OP_INITGET), &&DUK__LABEL(DUK_OP_MPUTARR), &&DUK__LABEL(DUK_OP_MPUTARRI),
+		&&DUK__LABEL(DUK_OP_SETALEN), &&DUK__LABEL(DUK_OP_INITENUM), &&DUK__LABEL(DUK_OP_NEXTENUM), &&DUK__LABEL(DUK_OP_NEWTARGET),
+		&&DUK__LABEL(DUK_OP_DEBUGGER), &&DUK__LABEL(DUK_OP_NOP), &&DUK__LABEL(DUK_OP_INVALID), &&DUK__LABEL(DUK_OP_UNUSED207),
+		&&DUK__LABEL(DUK_OP_GETPROPC_RR), &&DUK__LABEL(DUK_OP_GETPROPC_CR), &&DUK__LABEL(DUK_OP_GETPROPC_RC), &&DUK__LABEL(DUK_OP_GETPROPC_CC),
+		&&DUK__LABEL(DUK_OP_IFLT_RR), &&DUK__LABEL(DUK_OP_IFLT_CR), &&DUK__LABEL(DUK_OP_IFLT_RC), &&DUK__LABEL(DUK_OP_IFLT_CC),
+		&&DUK__LABEL(DUK_OP_IFGT_RR), &&DUK__LABEL(DUK_OP_IFGT_CR), &&DUK__LABEL(DUK_OP_IFGT_RC), &&DUK__LABEL(DUK_OP_IFGT_CC),
+		&&DUK__LABEL(DUK_OP_IFLE_RR), &&DUK__LABEL(DUK_OP_IFLE_CR), &&DUK__LABEL(DUK_OP_IFLE_RC), &&DUK__LABEL(DUK_OP_IFLE_CC),
+		&&DUK__LABEL(DUK_OP_IFGE_RR), &&DUK__LABEL(DUK_OP_IFGE_CR), &&DUK__LABEL(DUK_OP_IFGE_RC), &&DUK__LABEL(DUK_OP_IFGE_CC),
+		&&DUK__LABEL(DUK_OP_IFSEQ_RR), &&DUK__LABEL(DUK_OP_IFSEQ_CR), &&DUK__LABEL(DUK_OP_IFSEQ_RC), &&DUK__LABEL(DUK_OP_IFSEQ_CC),
+		&&DUK__LABEL(DUK_OP_IFSNEQ_RR), &&DUK__LABEL(DUK_OP_IFSNEQ_CR), &&DUK__LABEL(DUK_OP_IFSNEQ_RC), &&DUK__LABEL(DUK_OP_IFSNEQ_CC),
+		&&DUK__LABEL(DUK_OP_UNUSED236), &&DUK__LABEL(DUK_OP_UNUSED237), &&DUK__LABEL(DUK_OP_UNUSED238), &&DUK__LABEL(DUK_OP_UNUSED239),
+		&&DUK__LABEL(DUK_OP_UNUSED240), &&DUK__LABEL(DUK_OP_UNUSED241), &&DUK__LABEL(DUK_OP_UNUSED242), &&DUK__LABEL(DUK_OP_UNUSED243),
+		&&DUK__LABEL(DUK_OP_UNUSED244), &&DUK__LABEL(DUK_OP_UNUSED245), &&DUK__LABEL(DUK_OP_UNUSED246), &&DUK__LABEL(DUK_OP_UNUSED247),
+		&&DUK__LABEL(DUK_OP_UNUSED248), &&DUK__LABEL(DUK_OP_UNUSED249), &&DUK__LABEL(DUK_OP_UNUSED250), &&DUK__LABEL(DUK_OP_UNUSED251),
+		&&DUK__LABEL(DUK_OP_UNUSED252), &&DUK__LABEL(DUK_OP_UNUSED253), &&DUK__LABEL(DUK_OP_UNUSED254), &&DUK__LABEL(DUK_OP_UNUSED255)
+	};
+#endif
+
 	/* Optimized reg/const access macros assume sizeof(duk_tval) to be
 	 * either 8 or 16.  Heap allocation checks this even without asserts
 	 * enabled now because it can't be autodetected in duk_config.h.
@@ -3107,6 +3444,18 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		}
 #endif  /* DUK_USE_DEBUGGER_SUPPORT */
 
+#if defined(DUK_USE_JIT_X64)
+		/* Function entry (or return to the function) counts towards
+		 * compilation.  Compilation has no side effects.
+		 */
+		jit_run = NULL;
+		jit_count = 0;
+		if (fun->jit != NULL) {
+			jit_run = duk__executor_jit_count(thr, fun);
+			jit_count = (fun->jit->state == DUK_JIT_X64_STATE_COUNTING);
+		}
+#endif
+
 #if defined(DUK_USE_ASSERTIONS)
 		valstack_top_base = (duk_size_t) (thr->valstack_top - thr->valstack);
 #endif
@@ -3189,6 +3538,23 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		thr->heap->inst_count_exec++;
 #endif
 
+#if defined(DUK_USE_JIT_X64)
+		/* Run native code until it reaches an instruction it can't
+		 * handle, then interpret that instruction.
+		 */
+		if (jit_run != NULL) {
+#if defined(DUK_USE_DEBUGGER_SUPPORT)
+			if (DUK_UNLIKELY(duk_debug_is_attached(thr->heap))) {
+				jit_run = NULL;
+			} else
+#endif
+			{
+				DUK_ASSERT(jit_run == DUK__FUN()->jit);
+				curr_pc = jit_run->bcode + jit_run->entry(thr, (duk_uint32_t) (curr_pc - jit_run->bcode));
+			}
+		}
+#endif
+
 #if defined(DUK_USE_ASSERTIONS) || defined(DUK_USE_DEBUG)
 		{
 			duk_activation *act;
@@ -3240,6 +3606,9 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * will (at least usually) omit a bounds check.
 		 */
 		op = (duk_uint8_t) DUK_DEC_OP(ins);
+#if defined(DUK__EXEC_COMPUTED_GOTO)
+		DUK__DISPATCH();
+#endif
 		switch (op) {
 
 		/* Some useful macros.  These access inner executor variables
@@ -3256,16 +3625,16 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_TOP_A_BREAK(); \
 	}
 #else
-#define DUK__REPLACE_TOP_A_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_A(ins)); break; }
-#define DUK__REPLACE_TOP_BC_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_BC(ins)); break; }
+#define DUK__REPLACE_TOP_A_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_A(ins)); DUK__NEXT(); }
+#define DUK__REPLACE_TOP_BC_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_BC(ins)); DUK__NEXT(); }
 #define DUK__REPLACE_BOOL_A_BREAK(bval) { \
 		duk_bool_t duk__bval; \
 		duk_tval *duk__tvdst; \
 		duk__bval = (bval); \
 		DUK_ASSERT(duk__bval == 0 || duk__bval == 1); \
 		duk__tvdst = DUK__REGP_A(ins); \
-		DUK_TVAL_SET_BOOLEAN_UPDREF(thr, duk__tvdst, duk__bval); \
-		break; \
+		DUK_TVAL_SET_BOOLEAN_UPDREF_DEFER(thr, duk__tvdst, duk__bval); \
+		DUK__NEXT(); \
 	}
 #endif
 
@@ -3277,31 +3646,31 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * duk_dup() + duk_replace(), but because they're used quite a lot
 		 * they're currently intentionally not size optimized.
 		 */
-		case DUK_OP_LDREG: {
+		DUK__CASE(DUK_OP_LDREG): {
 			duk_tval *tv1, *tv2;
 
 			tv1 = DUK__REGP_A(ins);
 			tv2 = DUK__REGP_BC(ins);
-			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv1, tv2);  /* side effects */
-			break;
+			DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr, tv1, tv2);  /* side effects */
+			DUK__NEXT();
 		}
 
-		case DUK_OP_STREG: {
+		DUK__CASE(DUK_OP_STREG): {
 			duk_tval *tv1, *tv2;
 
 			tv1 = DUK__REGP_A(ins);
 			tv2 = DUK__REGP_BC(ins);
-			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv2, tv1);  /* side effects */
-			break;
+			DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr, tv2, tv1);  /* side effects */
+			DUK__NEXT();
 		}
 
-		case DUK_OP_LDCONST: {
+		DUK__CASE(DUK_OP_LDCONST): {
 			duk_tval *tv1, *tv2;
 
 			tv1 = DUK__REGP_A(ins);
 			tv2 = DUK__CONSTP_BC(ins);
-			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv1, tv2);  /* side effects */
-			break;
+			DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr, tv1, tv2);  /* side effects */
+			DUK__NEXT();
 		}
 
 		/* LDINT and LDINTX are intended to load an arbitrary signed
@@ -3309,14 +3678,14 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * This also guarantees all values remain fastints.
 		 */
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_LDINT: {
+		DUK__CASE(DUK_OP_LDINT): {
 			duk_int32_t val;
 
 			val = (duk_int32_t) DUK_DEC_BC(ins) - (duk_int32_t) DUK_BC_LDINT_BIAS;
 			duk_push_int(thr, val);
 			DUK__REPLACE_TOP_A_BREAK();
 		}
-		case DUK_OP_LDINTX: {
+		DUK__CASE(DUK_OP_LDINTX): {
 			duk_int32_t val;
 
 			val = (duk_int32_t) duk_get_int(thr, DUK_DEC_A(ins));
@@ -3325,16 +3694,16 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_LDINT: {
+		DUK__CASE(DUK_OP_LDINT): {
 			duk_tval *tv1;
 			duk_int32_t val;
 
 			val = (duk_int32_t) DUK_DEC_BC(ins) - (duk_int32_t) DUK_BC_LDINT_BIAS;
 			tv1 = DUK__REGP_A(ins);
-			DUK_TVAL_SET_I32_UPDREF(thr, tv1, val);  /* side effects */
-			break;
+			DUK_TVAL_SET_I32_UPDREF_DEFER(thr, tv1, val);  /* side effects */
+			DUK__NEXT();
 		}
-		case DUK_OP_LDINTX: {
+		DUK__CASE(DUK_OP_LDINTX): {
 			duk_tval *tv1;
 			duk_int32_t val;
 
@@ -3348,102 +3717,102 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			val = (duk_int32_t) DUK_TVAL_GET_NUMBER(tv1);
 #endif
 			val = (duk_int32_t) ((duk_uint32_t) val << DUK_BC_LDINTX_SHIFT) + (duk_int32_t) DUK_DEC_BC(ins);  /* no bias */
-			DUK_TVAL_SET_I32_UPDREF(thr, tv1, val);  /* side effects */
-			break;
+			DUK_TVAL_SET_I32_UPDREF_DEFER(thr, tv1, val);  /* side effects */
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_LDTHIS: {
+		DUK__CASE(DUK_OP_LDTHIS): {
 			duk_push_this(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
-		case DUK_OP_LDUNDEF: {
+		DUK__CASE(DUK_OP_LDUNDEF): {
 			duk_to_undefined(thr, (duk_idx_t) DUK_DEC_BC(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDNULL: {
+		DUK__CASE(DUK_OP_LDNULL): {
 			duk_to_null(thr, (duk_idx_t) DUK_DEC_BC(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDTRUE: {
+		DUK__CASE(DUK_OP_LDTRUE): {
 			duk_push_true(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
-		case DUK_OP_LDFALSE: {
+		DUK__CASE(DUK_OP_LDFALSE): {
 			duk_push_false(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_LDTHIS: {
+		DUK__CASE(DUK_OP_LDTHIS): {
 			/* Note: 'this' may be bound to any value, not just an object */
 			duk_tval *tv1, *tv2;
 
 			tv1 = DUK__REGP_BC(ins);
 			tv2 = thr->valstack_bottom - 1;  /* 'this binding' is just under bottom */
 			DUK_ASSERT(tv2 >= thr->valstack);
-			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv1, tv2);  /* side effects */
-			break;
+			DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr, tv1, tv2);  /* side effects */
+			DUK__NEXT();
 		}
-		case DUK_OP_LDUNDEF: {
+		DUK__CASE(DUK_OP_LDUNDEF): {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
-			DUK_TVAL_SET_UNDEFINED_UPDREF(thr, tv1);  /* side effects */
-			break;
+			DUK_TVAL_SET_UNDEFINED_UPDREF_DEFER(thr, tv1);  /* side effects */
+			DUK__NEXT();
 		}
-		case DUK_OP_LDNULL: {
+		DUK__CASE(DUK_OP_LDNULL): {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
-			DUK_TVAL_SET_NULL_UPDREF(thr, tv1);  /* side effects */
-			break;
+			DUK_TVAL_SET_NULL_UPDREF_DEFER(thr, tv1);  /* side effects */
+			DUK__NEXT();
 		}
-		case DUK_OP_LDTRUE: {
+		DUK__CASE(DUK_OP_LDTRUE): {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
-			DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv1, 1);  /* side effects */
-			break;
+			DUK_TVAL_SET_BOOLEAN_UPDREF_DEFER(thr, tv1, 1);  /* side effects */
+			DUK__NEXT();
 		}
-		case DUK_OP_LDFALSE: {
+		DUK__CASE(DUK_OP_LDFALSE): {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
-			DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv1, 0);  /* side effects */
-			break;
+			DUK_TVAL_SET_BOOLEAN_UPDREF_DEFER(thr, tv1, 0);  /* side effects */
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
-		case DUK_OP_BNOT: {
+		DUK__CASE(DUK_OP_BNOT): {
 			duk__vm_bitwise_not(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_LNOT: {
+		DUK__CASE(DUK_OP_LNOT): {
 			duk__vm_logical_not(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_UNM:
-		case DUK_OP_UNP: {
+		DUK__CASE(DUK_OP_UNM):
+		DUK__CASE(DUK_OP_UNP): {
 			duk__vm_arith_unary_op(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins), op);
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_UNM: {
+		DUK__CASE(DUK_OP_UNM): {
 			duk__vm_arith_unary_op(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins), DUK_OP_UNM);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_UNP: {
+		DUK__CASE(DUK_OP_UNP): {
 			duk__vm_arith_unary_op(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins), DUK_OP_UNP);
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_TYPEOF: {
+		DUK__CASE(DUK_OP_TYPEOF): {
 			duk_small_uint_t stridx;
 
 			stridx = duk_js_typeof_stridx(DUK__REGP_BC(ins));
@@ -3452,7 +3821,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_TYPEOF: {
+		DUK__CASE(DUK_OP_TYPEOF): {
 			duk_tval *tv;
 			duk_small_uint_t stridx;
 			duk_hstring *h_str;
@@ -3462,12 +3831,12 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK_ASSERT_STRIDX_VALID(stridx);
 			h_str = DUK_HTHREAD_GET_STRING(thr, stridx);
 			tv = DUK__REGP_A(ins);
-			DUK_TVAL_SET_STRING_UPDREF(thr, tv, h_str);
-			break;
+			DUK_TVAL_SET_STRING_UPDREF_DEFER(thr, tv, h_str);
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
-		case DUK_OP_TYPEOFID: {
+		DUK__CASE(DUK_OP_TYPEOFID): {
 			duk_small_uint_t stridx;
 #if !defined(DUK_USE_EXEC_PREFER_SIZE)
 			duk_hstring *h_str;
@@ -3502,7 +3871,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
 			h_str = DUK_HTHREAD_GET_STRING(thr, stridx);
 			tv = DUK__REGP_A(ins);
-			DUK_TVAL_SET_STRING_UPDREF(thr, tv, h_str);
+			DUK_TVAL_SET_STRING_UPDREF_DEFER(thr, tv, h_str);
 			break;
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 		}
@@ -3536,58 +3905,58 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_BOOL_A_BREAK(tmp); \
 	}
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_EQ_RR:
-		case DUK_OP_EQ_CR:
-		case DUK_OP_EQ_RC:
-		case DUK_OP_EQ_CC:
+		DUK__CASE(DUK_OP_EQ_RR):
+		DUK__CASE(DUK_OP_EQ_CR):
+		DUK__CASE(DUK_OP_EQ_RC):
+		DUK__CASE(DUK_OP_EQ_CC):
 			DUK__EQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_NEQ_RR:
-		case DUK_OP_NEQ_CR:
-		case DUK_OP_NEQ_RC:
-		case DUK_OP_NEQ_CC:
+		DUK__CASE(DUK_OP_NEQ_RR):
+		DUK__CASE(DUK_OP_NEQ_CR):
+		DUK__CASE(DUK_OP_NEQ_RC):
+		DUK__CASE(DUK_OP_NEQ_CC):
 			DUK__NEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_SEQ_RR:
-		case DUK_OP_SEQ_CR:
-		case DUK_OP_SEQ_RC:
-		case DUK_OP_SEQ_CC:
+		DUK__CASE(DUK_OP_SEQ_RR):
+		DUK__CASE(DUK_OP_SEQ_CR):
+		DUK__CASE(DUK_OP_SEQ_RC):
+		DUK__CASE(DUK_OP_SEQ_CC):
 			DUK__SEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_SNEQ_RR:
-		case DUK_OP_SNEQ_CR:
-		case DUK_OP_SNEQ_RC:
-		case DUK_OP_SNEQ_CC:
+		DUK__CASE(DUK_OP_SNEQ_RR):
+		DUK__CASE(DUK_OP_SNEQ_CR):
+		DUK__CASE(DUK_OP_SNEQ_RC):
+		DUK__CASE(DUK_OP_SNEQ_CC):
 			DUK__SNEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_EQ_RR:
+		DUK__CASE(DUK_OP_EQ_RR):
 			DUK__EQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_EQ_CR:
+		DUK__CASE(DUK_OP_EQ_CR):
 			DUK__EQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_EQ_RC:
+		DUK__CASE(DUK_OP_EQ_RC):
 			DUK__EQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_EQ_CC:
+		DUK__CASE(DUK_OP_EQ_CC):
 			DUK__EQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_NEQ_RR:
+		DUK__CASE(DUK_OP_NEQ_RR):
 			DUK__NEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_NEQ_CR:
+		DUK__CASE(DUK_OP_NEQ_CR):
 			DUK__NEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_NEQ_RC:
+		DUK__CASE(DUK_OP_NEQ_RC):
 			DUK__NEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_NEQ_CC:
+		DUK__CASE(DUK_OP_NEQ_CC):
 			DUK__NEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SEQ_RR:
+		DUK__CASE(DUK_OP_SEQ_RR):
 			DUK__SEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SEQ_CR:
+		DUK__CASE(DUK_OP_SEQ_CR):
 			DUK__SEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SEQ_RC:
+		DUK__CASE(DUK_OP_SEQ_RC):
 			DUK__SEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SEQ_CC:
+		DUK__CASE(DUK_OP_SEQ_CC):
 			DUK__SEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SNEQ_RR:
+		DUK__CASE(DUK_OP_SNEQ_RR):
 			DUK__SNEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SNEQ_CR:
+		DUK__CASE(DUK_OP_SNEQ_CR):
 			DUK__SNEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SNEQ_RC:
+		DUK__CASE(DUK_OP_SNEQ_RC):
 			DUK__SNEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SNEQ_CC:
+		DUK__CASE(DUK_OP_SNEQ_CC):
 			DUK__SNEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
@@ -3602,353 +3971,502 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #define DUK__LT_BODY(barg,carg) DUK__COMPARE_BODY((barg), (carg), DUK_COMPARE_FLAG_EVAL_LEFT_FIRST)
 #define DUK__LE_BODY(barg,carg) DUK__COMPARE_BODY((carg), (barg), DUK_COMPARE_FLAG_NEGATE)
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_GT_RR:
-		case DUK_OP_GT_CR:
-		case DUK_OP_GT_RC:
-		case DUK_OP_GT_CC:
+		DUK__CASE(DUK_OP_GT_RR):
+		DUK__CASE(DUK_OP_GT_CR):
+		DUK__CASE(DUK_OP_GT_RC):
+		DUK__CASE(DUK_OP_GT_CC):
 			DUK__GT_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_GE_RR:
-		case DUK_OP_GE_CR:
-		case DUK_OP_GE_RC:
-		case DUK_OP_GE_CC:
+		DUK__CASE(DUK_OP_GE_RR):
+		DUK__CASE(DUK_OP_GE_CR):
+		DUK__CASE(DUK_OP_GE_RC):
+		DUK__CASE(DUK_OP_GE_CC):
 			DUK__GE_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_LT_RR:
-		case DUK_OP_LT_CR:
-		case DUK_OP_LT_RC:
-		case DUK_OP_LT_CC:
+		DUK__CASE(DUK_OP_LT_RR):
+		DUK__CASE(DUK_OP_LT_CR):
+		DUK__CASE(DUK_OP_LT_RC):
+		DUK__CASE(DUK_OP_LT_CC):
 			DUK__LT_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_LE_RR:
-		case DUK_OP_LE_CR:
-		case DUK_OP_LE_RC:
-		case DUK_OP_LE_CC:
+		DUK__CASE(DUK_OP_LE_RR):
+		DUK__CASE(DUK_OP_LE_CR):
+		DUK__CASE(DUK_OP_LE_RC):
+		DUK__CASE(DUK_OP_LE_CC):
 			DUK__LE_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_GT_RR:
+		DUK__CASE(DUK_OP_GT_RR):
 			DUK__GT_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GT_CR:
+		DUK__CASE(DUK_OP_GT_CR):
 			DUK__GT_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GT_RC:
+		DUK__CASE(DUK_OP_GT_RC):
 			DUK__GT_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GT_CC:
+		DUK__CASE(DUK_OP_GT_CC):
 			DUK__GT_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GE_RR:
+		DUK__CASE(DUK_OP_GE_RR):
 			DUK__GE_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GE_CR:
+		DUK__CASE(DUK_OP_GE_CR):
 			DUK__GE_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GE_RC:
+		DUK__CASE(DUK_OP_GE_RC):
 			DUK__GE_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GE_CC:
+		DUK__CASE(DUK_OP_GE_CC):
 			DUK__GE_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LT_RR:
+		DUK__CASE(DUK_OP_LT_RR):
 			DUK__LT_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LT_CR:
+		DUK__CASE(DUK_OP_LT_CR):
 			DUK__LT_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LT_RC:
+		DUK__CASE(DUK_OP_LT_RC):
 			DUK__LT_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LT_CC:
+		DUK__CASE(DUK_OP_LT_CC):
 			DUK__LT_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LE_RR:
+		DUK__CASE(DUK_OP_LE_RR):
 			DUK__LE_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LE_CR:
+		DUK__CASE(DUK_OP_LE_CR):
 			DUK__LE_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LE_RC:
+		DUK__CASE(DUK_OP_LE_RC):
 			DUK__LE_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LE_CC:
+		DUK__CASE(DUK_OP_LE_CC):
 			DUK__LE_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* No size optimized variant at present for IF. */
-		case DUK_OP_IFTRUE_R: {
+		DUK__CASE(DUK_OP_IFTRUE_R): {
 			if (duk_js_toboolean(DUK__REGP_BC(ins)) != 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_IFTRUE_C: {
+		DUK__CASE(DUK_OP_IFTRUE_C): {
 			if (duk_js_toboolean(DUK__CONSTP_BC(ins)) != 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_IFFALSE_R: {
+		DUK__CASE(DUK_OP_IFFALSE_R): {
 			if (duk_js_toboolean(DUK__REGP_BC(ins)) == 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_IFFALSE_C: {
+		DUK__CASE(DUK_OP_IFFALSE_C): {
 			if (duk_js_toboolean(DUK__CONSTP_BC(ins)) == 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
 
+#if defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+		/* Compare-and-branch superinstructions: compare like the plain
+		 * opcode and write the result to A (it may be read later), then
+		 * consume the IFTRUE_R/IFFALSE_R following the instruction.  Two
+		 * numbers are compared inline; everything else goes through the
+		 * same helpers as the plain opcodes.
+		 */
+#define DUK__IFCMP_BRANCH(bval) { \
+		duk_bool_t duk__bval; \
+		duk_tval *duk__tvdst; \
+		duk_instr_t duk__ins_if; \
+		duk__bval = (bval); \
+		DUK_ASSERT(duk__bval == 0 || duk__bval == 1); \
+		duk__tvdst = DUK__REGP_A(ins); \
+		DUK_TVAL_SET_BOOLEAN_UPDREF_DEFER(thr, duk__tvdst, duk__bval); \
+		duk__ins_if = *curr_pc++; \
+		DUK_ASSERT(DUK_DEC_OP(duk__ins_if) == DUK_OP_IFTRUE_R || DUK_DEC_OP(duk__ins_if) == DUK_OP_IFFALSE_R); \
+		DUK_ASSERT(DUK_DEC_BC(duk__ins_if) == DUK_DEC_A(ins)); \
+		if (duk__bval == (duk_bool_t) (DUK_DEC_OP(duk__ins_if) == DUK_OP_IFTRUE_R)) { \
+			curr_pc++; \
+		} \
+		DUK__NEXT(); \
+	}
+#if defined(DUK_USE_FASTINT)
+#define DUK__IFCMP_BODY(barg,carg,cmpop,slowexpr) { \
+		duk_tval *duk__tvb; \
+		duk_tval *duk__tvc; \
+		duk_bool_t tmp; \
+		duk__tvb = (barg); \
+		duk__tvc = (carg); \
+		if (DUK_TVAL_IS_FASTINT(duk__tvb) && DUK_TVAL_IS_FASTINT(duk__tvc)) { \
+			tmp = (DUK_TVAL_GET_FASTINT(duk__tvb) cmpop DUK_TVAL_GET_FASTINT(duk__tvc)); \
+		} else if (DUK_TVAL_IS_NUMBER(duk__tvb) && DUK_TVAL_IS_NUMBER(duk__tvc)) { \
+			tmp = (DUK_TVAL_GET_NUMBER(duk__tvb) cmpop DUK_TVAL_GET_NUMBER(duk__tvc)); \
+		} else { \
+			tmp = (slowexpr); \
+		} \
+		DUK__IFCMP_BRANCH(tmp); \
+	}
+#else
+#define DUK__IFCMP_BODY(barg,carg,cmpop,slowexpr) { \
+		duk_tval *duk__tvb; \
+		duk_tval *duk__tvc; \
+		duk_bool_t tmp; \
+		duk__tvb = (barg); \
+		duk__tvc = (carg); \
+		if (DUK_TVAL_IS_NUMBER(duk__tvb) && DUK_TVAL_IS_NUMBER(duk__tvc)) { \
+			tmp = (DUK_TVAL_GET_NUMBER(duk__tvb) cmpop DUK_TVAL_GET_NUMBER(duk__tvc)); \
+		} else { \
+			tmp = (slowexpr); \
+		} \
+		DUK__IFCMP_BRANCH(tmp); \
+	}
+#endif
+#define DUK__IFLT_BODY(barg,carg) \
+	DUK__IFCMP_BODY((barg), (carg), <, duk_js_compare_helper(thr, duk__tvb, duk__tvc, DUK_COMPARE_FLAG_EVAL_LEFT_FIRST))
+#define DUK__IFGT_BODY(barg,carg) \
+	DUK__IFCMP_BODY((barg), (carg), >, duk_js_compare_helper(thr, duk__tvc, duk__tvb, 0))
+#define DUK__IFLE_BODY(barg,carg) \
+	DUK__IFCMP_BODY((barg), (carg), <=, duk_js_compare_helper(thr, duk__tvc, duk__tvb, DUK_COMPARE_FLAG_NEGATE))
+#define DUK__IFGE_BODY(barg,carg) \
+	DUK__IFCMP_BODY((barg), (carg), >=, duk_js_compare_helper(thr, duk__tvb, duk__tvc, DUK_COMPARE_FLAG_EVAL_LEFT_FIRST | DUK_COMPARE_FLAG_NEGATE))
+#define DUK__IFSEQ_BODY(barg,carg) \
+	DUK__IFCMP_BODY((barg), (carg), ==, duk_js_strict_equals(duk__tvb, duk__tvc))
+#define DUK__IFSNEQ_BODY(barg,carg) \
+	DUK__IFCMP_BODY((barg), (carg), !=, duk_js_strict_equals(duk__tvb, duk__tvc) ^ 1)
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_ADD_RR:
-		case DUK_OP_ADD_CR:
-		case DUK_OP_ADD_RC:
-		case DUK_OP_ADD_CC: {
+		DUK__CASE(DUK_OP_IFLT_RR):
+		DUK__CASE(DUK_OP_IFLT_CR):
+		DUK__CASE(DUK_OP_IFLT_RC):
+		DUK__CASE(DUK_OP_IFLT_CC):
+			DUK__IFLT_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFGT_RR):
+		DUK__CASE(DUK_OP_IFGT_CR):
+		DUK__CASE(DUK_OP_IFGT_RC):
+		DUK__CASE(DUK_OP_IFGT_CC):
+			DUK__IFGT_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFLE_RR):
+		DUK__CASE(DUK_OP_IFLE_CR):
+		DUK__CASE(DUK_OP_IFLE_RC):
+		DUK__CASE(DUK_OP_IFLE_CC):
+			DUK__IFLE_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFGE_RR):
+		DUK__CASE(DUK_OP_IFGE_CR):
+		DUK__CASE(DUK_OP_IFGE_RC):
+		DUK__CASE(DUK_OP_IFGE_CC):
+			DUK__IFGE_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFSEQ_RR):
+		DUK__CASE(DUK_OP_IFSEQ_CR):
+		DUK__CASE(DUK_OP_IFSEQ_RC):
+		DUK__CASE(DUK_OP_IFSEQ_CC):
+			DUK__IFSEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFSNEQ_RR):
+		DUK__CASE(DUK_OP_IFSNEQ_CR):
+		DUK__CASE(DUK_OP_IFSNEQ_RC):
+		DUK__CASE(DUK_OP_IFSNEQ_CC):
+			DUK__IFSNEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
+#else  /* DUK_USE_EXEC_PREFER_SIZE */
+		DUK__CASE(DUK_OP_IFLT_RR):
+			DUK__IFLT_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFLT_CR):
+			DUK__IFLT_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFLT_RC):
+			DUK__IFLT_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFLT_CC):
+			DUK__IFLT_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFGT_RR):
+			DUK__IFGT_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFGT_CR):
+			DUK__IFGT_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFGT_RC):
+			DUK__IFGT_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFGT_CC):
+			DUK__IFGT_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFLE_RR):
+			DUK__IFLE_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFLE_CR):
+			DUK__IFLE_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFLE_RC):
+			DUK__IFLE_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFLE_CC):
+			DUK__IFLE_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFGE_RR):
+			DUK__IFGE_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFGE_CR):
+			DUK__IFGE_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFGE_RC):
+			DUK__IFGE_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFGE_CC):
+			DUK__IFGE_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFSEQ_RR):
+			DUK__IFSEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFSEQ_CR):
+			DUK__IFSEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFSEQ_RC):
+			DUK__IFSEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFSEQ_CC):
+			DUK__IFSEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFSNEQ_RR):
+			DUK__IFSNEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFSNEQ_CR):
+			DUK__IFSNEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_IFSNEQ_RC):
+			DUK__IFSNEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_IFSNEQ_CC):
+			DUK__IFSNEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
+#endif  /* DUK_USE_EXEC_PREFER_SIZE */
+#endif  /* DUK_USE_EXEC_SUPERINSTRUCTIONS */
+
+#if defined(DUK_USE_EXEC_PREFER_SIZE)
+		DUK__CASE(DUK_OP_ADD_RR):
+		DUK__CASE(DUK_OP_ADD_CR):
+		DUK__CASE(DUK_OP_ADD_RC):
+		DUK__CASE(DUK_OP_ADD_CC): {
 			/* XXX: could leave value on stack top and goto replace_top_a; */
 			duk__vm_arith_add(thr, DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_ADD_RR: {
+		DUK__CASE(DUK_OP_ADD_RR): {
 			duk__vm_arith_add(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_ADD_CR: {
+		DUK__CASE(DUK_OP_ADD_CR): {
 			duk__vm_arith_add(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_ADD_RC: {
+		DUK__CASE(DUK_OP_ADD_RC): {
 			duk__vm_arith_add(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_ADD_CC: {
+		DUK__CASE(DUK_OP_ADD_CC): {
 			duk__vm_arith_add(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_SUB_RR:
-		case DUK_OP_SUB_CR:
-		case DUK_OP_SUB_RC:
-		case DUK_OP_SUB_CC:
-		case DUK_OP_MUL_RR:
-		case DUK_OP_MUL_CR:
-		case DUK_OP_MUL_RC:
-		case DUK_OP_MUL_CC:
-		case DUK_OP_DIV_RR:
-		case DUK_OP_DIV_CR:
-		case DUK_OP_DIV_RC:
-		case DUK_OP_DIV_CC:
-		case DUK_OP_MOD_RR:
-		case DUK_OP_MOD_CR:
-		case DUK_OP_MOD_RC:
-		case DUK_OP_MOD_CC:
+		DUK__CASE(DUK_OP_SUB_RR):
+		DUK__CASE(DUK_OP_SUB_CR):
+		DUK__CASE(DUK_OP_SUB_RC):
+		DUK__CASE(DUK_OP_SUB_CC):
+		DUK__CASE(DUK_OP_MUL_RR):
+		DUK__CASE(DUK_OP_MUL_CR):
+		DUK__CASE(DUK_OP_MUL_RC):
+		DUK__CASE(DUK_OP_MUL_CC):
+		DUK__CASE(DUK_OP_DIV_RR):
+		DUK__CASE(DUK_OP_DIV_CR):
+		DUK__CASE(DUK_OP_DIV_RC):
+		DUK__CASE(DUK_OP_DIV_CC):
+		DUK__CASE(DUK_OP_MOD_RR):
+		DUK__CASE(DUK_OP_MOD_CR):
+		DUK__CASE(DUK_OP_MOD_RC):
+		DUK__CASE(DUK_OP_MOD_CC):
 #if defined(DUK_USE_ES7_EXP_OPERATOR)
-		case DUK_OP_EXP_RR:
-		case DUK_OP_EXP_CR:
-		case DUK_OP_EXP_RC:
-		case DUK_OP_EXP_CC:
+		DUK__CASE(DUK_OP_EXP_RR):
+		DUK__CASE(DUK_OP_EXP_CR):
+		DUK__CASE(DUK_OP_EXP_RC):
+		DUK__CASE(DUK_OP_EXP_CC):
 #endif  /* DUK_USE_ES7_EXP_OPERATOR */
 		{
 			/* XXX: could leave value on stack top and goto replace_top_a; */
 			duk__vm_arith_binary_op(thr, DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins), DUK_DEC_A(ins), op);
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_SUB_RR: {
+		DUK__CASE(DUK_OP_SUB_RR): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_SUB_CR: {
+		DUK__CASE(DUK_OP_SUB_CR): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_SUB_RC: {
+		DUK__CASE(DUK_OP_SUB_RC): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_SUB_CC: {
+		DUK__CASE(DUK_OP_SUB_CC): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_RR: {
+		DUK__CASE(DUK_OP_MUL_RR): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_CR: {
+		DUK__CASE(DUK_OP_MUL_CR): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_RC: {
+		DUK__CASE(DUK_OP_MUL_RC): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_CC: {
+		DUK__CASE(DUK_OP_MUL_CC): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_RR: {
+		DUK__CASE(DUK_OP_DIV_RR): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_CR: {
+		DUK__CASE(DUK_OP_DIV_CR): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_RC: {
+		DUK__CASE(DUK_OP_DIV_RC): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_CC: {
+		DUK__CASE(DUK_OP_DIV_CC): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_RR: {
+		DUK__CASE(DUK_OP_MOD_RR): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_CR: {
+		DUK__CASE(DUK_OP_MOD_CR): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_RC: {
+		DUK__CASE(DUK_OP_MOD_RC): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_CC: {
+		DUK__CASE(DUK_OP_MOD_CC): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
 #if defined(DUK_USE_ES7_EXP_OPERATOR)
-		case DUK_OP_EXP_RR: {
+		DUK__CASE(DUK_OP_EXP_RR): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_EXP_CR: {
+		DUK__CASE(DUK_OP_EXP_CR): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_EXP_RC: {
+		DUK__CASE(DUK_OP_EXP_RC): {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_EXP_CC: {
+		DUK__CASE(DUK_OP_EXP_CC): {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_ES7_EXP_OPERATOR */
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_BAND_RR:
-		case DUK_OP_BAND_CR:
-		case DUK_OP_BAND_RC:
-		case DUK_OP_BAND_CC:
-		case DUK_OP_BOR_RR:
-		case DUK_OP_BOR_CR:
-		case DUK_OP_BOR_RC:
-		case DUK_OP_BOR_CC:
-		case DUK_OP_BXOR_RR:
-		case DUK_OP_BXOR_CR:
-		case DUK_OP_BXOR_RC:
-		case DUK_OP_BXOR_CC:
-		case DUK_OP_BASL_RR:
-		case DUK_OP_BASL_CR:
-		case DUK_OP_BASL_RC:
-		case DUK_OP_BASL_CC:
-		case DUK_OP_BLSR_RR:
-		case DUK_OP_BLSR_CR:
-		case DUK_OP_BLSR_RC:
-		case DUK_OP_BLSR_CC:
-		case DUK_OP_BASR_RR:
-		case DUK_OP_BASR_CR:
-		case DUK_OP_BASR_RC:
-		case DUK_OP_BASR_CC: {
+		DUK__CASE(DUK_OP_BAND_RR):
+		DUK__CASE(DUK_OP_BAND_CR):
+		DUK__CASE(DUK_OP_BAND_RC):
+		DUK__CASE(DUK_OP_BAND_CC):
+		DUK__CASE(DUK_OP_BOR_RR):
+		DUK__CASE(DUK_OP_BOR_CR):
+		DUK__CASE(DUK_OP_BOR_RC):
+		DUK__CASE(DUK_OP_BOR_CC):
+		DUK__CASE(DUK_OP_BXOR_RR):
+		DUK__CASE(DUK_OP_BXOR_CR):
+		DUK__CASE(DUK_OP_BXOR_RC):
+		DUK__CASE(DUK_OP_BXOR_CC):
+		DUK__CASE(DUK_OP_BASL_RR):
+		DUK__CASE(DUK_OP_BASL_CR):
+		DUK__CASE(DUK_OP_BASL_RC):
+		DUK__CASE(DUK_OP_BASL_CC):
+		DUK__CASE(DUK_OP_BLSR_RR):
+		DUK__CASE(DUK_OP_BLSR_CR):
+		DUK__CASE(DUK_OP_BLSR_RC):
+		DUK__CASE(DUK_OP_BLSR_CC):
+		DUK__CASE(DUK_OP_BASR_RR):
+		DUK__CASE(DUK_OP_BASR_CR):
+		DUK__CASE(DUK_OP_BASR_RC):
+		DUK__CASE(DUK_OP_BASR_CC): {
 			/* XXX: could leave value on stack top and goto replace_top_a; */
 			duk__vm_bitwise_binary_op(thr, DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins), DUK_DEC_A(ins), op);
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_BAND_RR: {
+		DUK__CASE(DUK_OP_BAND_RR): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BAND_CR: {
+		DUK__CASE(DUK_OP_BAND_CR): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BAND_RC: {
+		DUK__CASE(DUK_OP_BAND_RC): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BAND_CC: {
+		DUK__CASE(DUK_OP_BAND_CC): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_RR: {
+		DUK__CASE(DUK_OP_BOR_RR): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_CR: {
+		DUK__CASE(DUK_OP_BOR_CR): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_RC: {
+		DUK__CASE(DUK_OP_BOR_RC): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_CC: {
+		DUK__CASE(DUK_OP_BOR_CC): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_RR: {
+		DUK__CASE(DUK_OP_BXOR_RR): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_CR: {
+		DUK__CASE(DUK_OP_BXOR_CR): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_RC: {
+		DUK__CASE(DUK_OP_BXOR_RC): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_CC: {
+		DUK__CASE(DUK_OP_BXOR_CC): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_RR: {
+		DUK__CASE(DUK_OP_BASL_RR): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_CR: {
+		DUK__CASE(DUK_OP_BASL_CR): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_RC: {
+		DUK__CASE(DUK_OP_BASL_RC): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_CC: {
+		DUK__CASE(DUK_OP_BASL_CC): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_RR: {
+		DUK__CASE(DUK_OP_BLSR_RR): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_CR: {
+		DUK__CASE(DUK_OP_BLSR_CR): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_RC: {
+		DUK__CASE(DUK_OP_BLSR_RC): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_CC: {
+		DUK__CASE(DUK_OP_BLSR_CC): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_RR: {
+		DUK__CASE(DUK_OP_BASR_RR): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_CR: {
+		DUK__CASE(DUK_OP_BASR_CR): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_RC: {
+		DUK__CASE(DUK_OP_BASR_RC): {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_CC: {
+		DUK__CASE(DUK_OP_BASR_CC): {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
@@ -3966,104 +4484,104 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_BOOL_A_BREAK(tmp); \
 	}
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_INSTOF_RR:
-		case DUK_OP_INSTOF_CR:
-		case DUK_OP_INSTOF_RC:
-		case DUK_OP_INSTOF_CC:
+		DUK__CASE(DUK_OP_INSTOF_RR):
+		DUK__CASE(DUK_OP_INSTOF_CR):
+		DUK__CASE(DUK_OP_INSTOF_RC):
+		DUK__CASE(DUK_OP_INSTOF_CC):
 			DUK__INSTOF_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_IN_RR:
-		case DUK_OP_IN_CR:
-		case DUK_OP_IN_RC:
-		case DUK_OP_IN_CC:
+		DUK__CASE(DUK_OP_IN_RR):
+		DUK__CASE(DUK_OP_IN_CR):
+		DUK__CASE(DUK_OP_IN_RC):
+		DUK__CASE(DUK_OP_IN_CC):
 			DUK__IN_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_INSTOF_RR:
+		DUK__CASE(DUK_OP_INSTOF_RR):
 			DUK__INSTOF_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_INSTOF_CR:
+		DUK__CASE(DUK_OP_INSTOF_CR):
 			DUK__INSTOF_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_INSTOF_RC:
+		DUK__CASE(DUK_OP_INSTOF_RC):
 			DUK__INSTOF_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_INSTOF_CC:
+		DUK__CASE(DUK_OP_INSTOF_CC):
 			DUK__INSTOF_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_IN_RR:
+		DUK__CASE(DUK_OP_IN_RR):
 			DUK__IN_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_IN_CR:
+		DUK__CASE(DUK_OP_IN_CR):
 			DUK__IN_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_IN_RC:
+		DUK__CASE(DUK_OP_IN_RC):
 			DUK__IN_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_IN_CC:
+		DUK__CASE(DUK_OP_IN_CC):
 			DUK__IN_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* Pre/post inc/dec for register variables, important for loops. */
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_PREINCR:
-		case DUK_OP_PREDECR:
-		case DUK_OP_POSTINCR:
-		case DUK_OP_POSTDECR: {
+		DUK__CASE(DUK_OP_PREINCR):
+		DUK__CASE(DUK_OP_PREDECR):
+		DUK__CASE(DUK_OP_POSTINCR):
+		DUK__CASE(DUK_OP_POSTDECR): {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), op);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREINCV:
-		case DUK_OP_PREDECV:
-		case DUK_OP_POSTINCV:
-		case DUK_OP_POSTDECV: {
+		DUK__CASE(DUK_OP_PREINCV):
+		DUK__CASE(DUK_OP_PREDECV):
+		DUK__CASE(DUK_OP_POSTINCV):
+		DUK__CASE(DUK_OP_POSTDECV): {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), op, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_PREINCR: {
+		DUK__CASE(DUK_OP_PREINCR): {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_PREINCR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREDECR: {
+		DUK__CASE(DUK_OP_PREDECR): {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_PREDECR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTINCR: {
+		DUK__CASE(DUK_OP_POSTINCR): {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_POSTINCR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTDECR: {
+		DUK__CASE(DUK_OP_POSTDECR): {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_POSTDECR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREINCV: {
+		DUK__CASE(DUK_OP_PREINCV): {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_PREINCV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREDECV: {
+		DUK__CASE(DUK_OP_PREDECV): {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_PREDECV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTINCV: {
+		DUK__CASE(DUK_OP_POSTINCV): {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_POSTINCV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTDECV: {
+		DUK__CASE(DUK_OP_POSTDECV): {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_POSTDECV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* XXX: Move to separate helper, optimize for perf/size separately. */
 		/* Preinc/predec for object properties. */
-		case DUK_OP_PREINCP_RR:
-		case DUK_OP_PREINCP_CR:
-		case DUK_OP_PREINCP_RC:
-		case DUK_OP_PREINCP_CC:
-		case DUK_OP_PREDECP_RR:
-		case DUK_OP_PREDECP_CR:
-		case DUK_OP_PREDECP_RC:
-		case DUK_OP_PREDECP_CC:
-		case DUK_OP_POSTINCP_RR:
-		case DUK_OP_POSTINCP_CR:
-		case DUK_OP_POSTINCP_RC:
-		case DUK_OP_POSTINCP_CC:
-		case DUK_OP_POSTDECP_RR:
-		case DUK_OP_POSTDECP_CR:
-		case DUK_OP_POSTDECP_RC:
-		case DUK_OP_POSTDECP_CC: {
+		DUK__CASE(DUK_OP_PREINCP_RR):
+		DUK__CASE(DUK_OP_PREINCP_CR):
+		DUK__CASE(DUK_OP_PREINCP_RC):
+		DUK__CASE(DUK_OP_PREINCP_CC):
+		DUK__CASE(DUK_OP_PREDECP_RR):
+		DUK__CASE(DUK_OP_PREDECP_CR):
+		DUK__CASE(DUK_OP_PREDECP_RC):
+		DUK__CASE(DUK_OP_PREDECP_CC):
+		DUK__CASE(DUK_OP_POSTINCP_RR):
+		DUK__CASE(DUK_OP_POSTINCP_CR):
+		DUK__CASE(DUK_OP_POSTINCP_RC):
+		DUK__CASE(DUK_OP_POSTINCP_CC):
+		DUK__CASE(DUK_OP_POSTDECP_RR):
+		DUK__CASE(DUK_OP_POSTDECP_CR):
+		DUK__CASE(DUK_OP_POSTDECP_RC):
+		DUK__CASE(DUK_OP_POSTDECP_CC): {
 			duk_tval *tv_obj;
 			duk_tval *tv_key;
 			duk_tval *tv_val;
@@ -4124,7 +4642,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 #else
 			tv_dst = DUK__REGP_A(ins);
-			DUK_TVAL_SET_NUMBER_UPDREF(thr, tv_dst, z);
+			DUK_TVAL_SET_NUMBER_UPDREF_DEFER(thr, tv_dst, z);
 			break;
 #endif
 		}
@@ -4165,8 +4683,49 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * of e.g. GETPROP; 'A' must contain a register-only value. \
 		 */ \
 		(void) duk_hobject_putprop(thr, (aarg), (barg), (carg), DUK__STRICT()); \
-		break; \
+		DUK__NEXT(); \
 	}
+#if defined(DUK_USE_PROP_IC) && !defined(DUK_USE_EXEC_PREFER_SIZE)
+#define DUK__GETPROP_IC_BODY(barg,carg) { \
+		/* Inline cache hit: no side effects until the target \
+		 * register is updated. \
+		 */ \
+		duk_tval *tv__val; \
+		tv__val = duk__propic_lookup(thr, DUK__FUN(), curr_pc, (barg), (carg), 0 /*is_put*/); \
+		if (DUK_LIKELY(tv__val != NULL)) { \
+			duk_tval *tv__out = DUK__REGP_A(ins); \
+			DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr, tv__out, tv__val); \
+			DUK__NEXT(); \
+		} \
+	} \
+	DUK__GETPROP_BODY((barg), (carg))
+#define DUK__GETPROPC_IC_BODY(barg,carg) { \
+		/* Non-callable values go through the slow path which \
+		 * throws the appropriate error. \
+		 */ \
+		duk_tval *tv__val; \
+		tv__val = duk__propic_lookup(thr, DUK__FUN(), curr_pc, (barg), (carg), 0 /*is_put*/); \
+		if (DUK_LIKELY(tv__val != NULL && duk_is_callable_tval(thr, tv__val))) { \
+			duk_tval *tv__out = DUK__REGP_A(ins); \
+			DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr, tv__out, tv__val); \
+			DUK__NEXT(); \
+		} \
+	} \
+	DUK__GETPROPC_BODY((barg), (carg))
+#define DUK__PUTPROP_IC_BODY(aarg,barg,carg) { \
+		duk_tval *tv__slot; \
+		tv__slot = duk__propic_lookup(thr, DUK__FUN(), curr_pc, (aarg), (barg), 1 /*is_put*/); \
+		if (DUK_LIKELY(tv__slot != NULL)) { \
+			DUK_TVAL_SET_TVAL_UPDREF(thr, tv__slot, (carg)); \
+			DUK__NEXT(); \
+		} \
+	} \
+	DUK__PUTPROP_BODY((aarg), (barg), (carg))
+#else
+#define DUK__GETPROP_IC_BODY(barg,carg) DUK__GETPROP_BODY((barg), (carg))
+#define DUK__GETPROPC_IC_BODY(barg,carg) DUK__GETPROPC_BODY((barg), (carg))
+#define DUK__PUTPROP_IC_BODY(aarg,barg,carg) DUK__PUTPROP_BODY((aarg), (barg), (carg))
+#endif  /* DUK_USE_PROP_IC && !DUK_USE_EXEC_PREFER_SIZE */
 #define DUK__DELPROP_BODY(barg,carg) { \
 		/* A -> result reg \
 		 * B -> object reg \
@@ -4178,64 +4737,64 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_BOOL_A_BREAK(rc); \
 	}
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_GETPROP_RR:
-		case DUK_OP_GETPROP_CR:
-		case DUK_OP_GETPROP_RC:
-		case DUK_OP_GETPROP_CC:
+		DUK__CASE(DUK_OP_GETPROP_RR):
+		DUK__CASE(DUK_OP_GETPROP_CR):
+		DUK__CASE(DUK_OP_GETPROP_RC):
+		DUK__CASE(DUK_OP_GETPROP_CC):
 			DUK__GETPROP_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #if defined(DUK_USE_VERBOSE_ERRORS)
-		case DUK_OP_GETPROPC_RR:
-		case DUK_OP_GETPROPC_CR:
-		case DUK_OP_GETPROPC_RC:
-		case DUK_OP_GETPROPC_CC:
+		DUK__CASE(DUK_OP_GETPROPC_RR):
+		DUK__CASE(DUK_OP_GETPROPC_CR):
+		DUK__CASE(DUK_OP_GETPROPC_RC):
+		DUK__CASE(DUK_OP_GETPROPC_CC):
 			DUK__GETPROPC_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #endif
-		case DUK_OP_PUTPROP_RR:
-		case DUK_OP_PUTPROP_CR:
-		case DUK_OP_PUTPROP_RC:
-		case DUK_OP_PUTPROP_CC:
+		DUK__CASE(DUK_OP_PUTPROP_RR):
+		DUK__CASE(DUK_OP_PUTPROP_CR):
+		DUK__CASE(DUK_OP_PUTPROP_RC):
+		DUK__CASE(DUK_OP_PUTPROP_CC):
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_DELPROP_RR:
-		case DUK_OP_DELPROP_RC:  /* B is always reg */
+		DUK__CASE(DUK_OP_DELPROP_RR):
+		DUK__CASE(DUK_OP_DELPROP_RC):  /* B is always reg */
 			DUK__DELPROP_BODY(DUK__REGP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_GETPROP_RR:
+		DUK__CASE(DUK_OP_GETPROP_RR):
 			DUK__GETPROP_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROP_CR:
+		DUK__CASE(DUK_OP_GETPROP_CR):
 			DUK__GETPROP_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROP_RC:
-			DUK__GETPROP_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GETPROP_CC:
+		DUK__CASE(DUK_OP_GETPROP_RC):
+			DUK__GETPROP_IC_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_GETPROP_CC):
 			DUK__GETPROP_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #if defined(DUK_USE_VERBOSE_ERRORS)
-		case DUK_OP_GETPROPC_RR:
+		DUK__CASE(DUK_OP_GETPROPC_RR):
 			DUK__GETPROPC_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROPC_CR:
+		DUK__CASE(DUK_OP_GETPROPC_CR):
 			DUK__GETPROPC_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROPC_RC:
-			DUK__GETPROPC_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GETPROPC_CC:
+		DUK__CASE(DUK_OP_GETPROPC_RC):
+			DUK__GETPROPC_IC_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_GETPROPC_CC):
 			DUK__GETPROPC_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif
-		case DUK_OP_PUTPROP_RR:
+		DUK__CASE(DUK_OP_PUTPROP_RR):
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_PUTPROP_CR:
-			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_PUTPROP_RC:
+		DUK__CASE(DUK_OP_PUTPROP_CR):
+			DUK__PUTPROP_IC_BODY(DUK__REGP_A(ins), DUK__CONSTP_B(ins), DUK__REGP_C(ins));
+		DUK__CASE(DUK_OP_PUTPROP_RC):
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_PUTPROP_CC:
-			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_DELPROP_RR:  /* B is always reg */
+		DUK__CASE(DUK_OP_PUTPROP_CC):
+			DUK__PUTPROP_IC_BODY(DUK__REGP_A(ins), DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
+		DUK__CASE(DUK_OP_DELPROP_RR):  /* B is always reg */
 			DUK__DELPROP_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_DELPROP_RC:
+		DUK__CASE(DUK_OP_DELPROP_RC):
 			DUK__DELPROP_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* No fast path for DECLVAR now, it's quite a rare instruction. */
-		case DUK_OP_DECLVAR_RR:
-		case DUK_OP_DECLVAR_CR:
-		case DUK_OP_DECLVAR_RC:
-		case DUK_OP_DECLVAR_CC: {
+		DUK__CASE(DUK_OP_DECLVAR_RR):
+		DUK__CASE(DUK_OP_DECLVAR_CR):
+		DUK__CASE(DUK_OP_DECLVAR_RC):
+		DUK__CASE(DUK_OP_DECLVAR_CC): {
 			duk_activation *act;
 			duk_small_uint_fast_t a = DUK_DEC_A(ins);
 			duk_tval *tv1;
@@ -4281,17 +4840,17 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			}
 
 			duk_pop_unsafe(thr);
-			break;
+			DUK__NEXT();
 		}
 
 #if defined(DUK_USE_REGEXP_SUPPORT)
 		/* The compiler should never emit DUK_OP_REGEXP if there is no
 		 * regexp support.
 		 */
-		case DUK_OP_REGEXP_RR:
-		case DUK_OP_REGEXP_CR:
-		case DUK_OP_REGEXP_RC:
-		case DUK_OP_REGEXP_CC: {
+		DUK__CASE(DUK_OP_REGEXP_RR):
+		DUK__CASE(DUK_OP_REGEXP_CR):
+		DUK__CASE(DUK_OP_REGEXP_RC):
+		DUK__CASE(DUK_OP_REGEXP_CC): {
 			/* A -> target register
 			 * B -> bytecode (also contains flags)
 			 * C -> escaped source
@@ -4305,10 +4864,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #endif  /* DUK_USE_REGEXP_SUPPORT */
 
 		/* XXX: 'c' is unused, use whole BC, etc. */
-		case DUK_OP_CSVAR_RR:
-		case DUK_OP_CSVAR_CR:
-		case DUK_OP_CSVAR_RC:
-		case DUK_OP_CSVAR_CC: {
+		DUK__CASE(DUK_OP_CSVAR_RR):
+		DUK__CASE(DUK_OP_CSVAR_CR):
+		DUK__CASE(DUK_OP_CSVAR_RC):
+		DUK__CASE(DUK_OP_CSVAR_CC): {
 			/* The speciality of calling through a variable binding is that the
 			 * 'this' value may be provided by the variable lookup: E5 Section 6.b.i.
 			 *
@@ -4338,10 +4897,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			/* Could add direct value stack handling. */
 			duk_replace(thr, (duk_idx_t) (idx + 1));  /* 'this' binding */
 			duk_replace(thr, (duk_idx_t) idx);        /* variable value (function, we hope, not checked here) */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_CLOSURE: {
+		DUK__CASE(DUK_OP_CLOSURE): {
 			duk_activation *act;
 			duk_hcompfunc *fun_act;
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
@@ -4386,7 +4945,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 
-		case DUK_OP_GETVAR: {
+		DUK__CASE(DUK_OP_GETVAR): {
 			duk_activation *act;
 			duk_tval *tv1;
 			duk_hstring *name;
@@ -4402,7 +4961,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 
-		case DUK_OP_PUTVAR: {
+		DUK__CASE(DUK_OP_PUTVAR): {
 			duk_activation *act;
 			duk_tval *tv1;
 			duk_hstring *name;
@@ -4419,10 +4978,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			tv1 = DUK__REGP_A(ins);  /* val */
 			act = thr->callstack_curr;
 			duk_js_putvar_activation(thr, act, name, tv1, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_DELVAR: {
+		DUK__CASE(DUK_OP_DELVAR): {
 			duk_activation *act;
 			duk_tval *tv1;
 			duk_hstring *name;
@@ -4437,13 +4996,20 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_BOOL_A_BREAK(rc);
 		}
 
-		case DUK_OP_JUMP: {
+		DUK__CASE(DUK_OP_JUMP): {
 			/* Note: without explicit cast to signed, MSVC will
 			 * apparently generate a large positive jump when the
 			 * bias-corrected value would normally be negative.
 			 */
 			curr_pc += (duk_int_fast_t) DUK_DEC_ABC(ins) - (duk_int_fast_t) DUK_BC_JUMP_BIAS;
-			break;
+#if defined(DUK_USE_JIT_X64)
+			if (DUK_UNLIKELY(jit_count) && DUK_DEC_ABC(ins) < DUK_BC_JUMP_BIAS) {
+				/* Backward jump: count loop iterations too. */
+				jit_run = duk__executor_jit_count(thr, DUK__FUN());
+				jit_count = (DUK__FUN()->jit->state == DUK_JIT_X64_STATE_COUNTING);
+			}
+#endif
+			DUK__NEXT();
 		}
 
 #define DUK__RETURN_SHARED() do { \
@@ -4461,10 +5027,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		return; \
 	} while (0)
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_RETREG:
-		case DUK_OP_RETCONST:
-		case DUK_OP_RETCONSTN:
-		case DUK_OP_RETUNDEF: {
+		DUK__CASE(DUK_OP_RETREG):
+		DUK__CASE(DUK_OP_RETCONST):
+		DUK__CASE(DUK_OP_RETCONSTN):
+		DUK__CASE(DUK_OP_RETUNDEF): {
 			 /* BC -> return value reg/const */
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -4482,7 +5048,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__RETURN_SHARED();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_RETREG: {
+		DUK__CASE(DUK_OP_RETREG): {
 			duk_tval *tv;
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -4493,7 +5059,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__RETURN_SHARED();
 		}
 		/* This will be unused without refcounting. */
-		case DUK_OP_RETCONST: {
+		DUK__CASE(DUK_OP_RETCONST): {
 			duk_tval *tv;
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -4503,7 +5069,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			thr->valstack_top++;
 			DUK__RETURN_SHARED();
 		}
-		case DUK_OP_RETCONSTN: {
+		DUK__CASE(DUK_OP_RETCONSTN): {
 			duk_tval *tv;
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -4516,7 +5082,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			thr->valstack_top++;
 			DUK__RETURN_SHARED();
 		}
-		case DUK_OP_RETUNDEF: {
+		DUK__CASE(DUK_OP_RETUNDEF): {
 			DUK__SYNC_AND_NULL_CURR_PC();
 			thr->valstack_top++;  /* value at valstack top is already undefined by valstack policy */
 			DUK_ASSERT(DUK_TVAL_IS_UNDEFINED(thr->valstack_top));
@@ -4524,7 +5090,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
-		case DUK_OP_LABEL: {
+		DUK__CASE(DUK_OP_LABEL): {
 			duk_activation *act;
 			duk_catcher *cat;
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
@@ -4550,10 +5116,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			                     (long) cat->idx_base, (duk_heaphdr *) cat->h_varname, (long) DUK_CAT_GET_LABEL(cat)));
 
 			curr_pc += 2;  /* skip jump slots */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDLABEL: {
+		DUK__CASE(DUK_OP_ENDLABEL): {
 			duk_activation *act;
 #if (defined(DUK_USE_DEBUG_LEVEL) && (DUK_USE_DEBUG_LEVEL >= 2)) || defined(DUK_USE_ASSERTIONS)
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
@@ -4569,10 +5135,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			duk_hthread_catcher_unwind_nolexenv_norz(thr, act);
 
 			/* no need to unwind callstack */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_BREAK: {
+		DUK__CASE(DUK_OP_BREAK): {
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -4580,7 +5146,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			goto restart_execution;
 		}
 
-		case DUK_OP_CONTINUE: {
+		DUK__CASE(DUK_OP_CONTINUE): {
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -4589,23 +5155,23 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		}
 
 		/* XXX: move to helper, too large to be inline here */
-		case DUK_OP_TRYCATCH: {
+		DUK__CASE(DUK_OP_TRYCATCH): {
 			duk__handle_op_trycatch(thr, ins, curr_pc);
 			curr_pc += 2;  /* skip jump slots */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDTRY: {
+		DUK__CASE(DUK_OP_ENDTRY): {
 			curr_pc = duk__handle_op_endtry(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDCATCH: {
+		DUK__CASE(DUK_OP_ENDCATCH): {
 			duk__handle_op_endcatch(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDFIN: {
+		DUK__CASE(DUK_OP_ENDFIN): {
 			/* Sync and NULL early. */
 			DUK__SYNC_AND_NULL_CURR_PC();
 
@@ -4617,7 +5183,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			goto restart_execution;
 		}
 
-		case DUK_OP_THROW: {
+		DUK__CASE(DUK_OP_THROW): {
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
 
 			/* Note: errors are augmented when they are created, not
@@ -4648,10 +5214,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK_ASSERT(thr->heap->lj.jmpbuf_ptr != NULL);  /* always in executor */
 			duk_err_longjmp(thr);
 			DUK_UNREACHABLE();
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_CSREG: {
+		DUK__CASE(DUK_OP_CSREG): {
 			/*
 			 *  Assuming a register binds to a variable declared within this
 			 *  function (a declarative binding), the 'this' for the call
@@ -4687,7 +5253,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK_TVAL_DECREF(thr, &tv_tmp1);
 			DUK_TVAL_DECREF(thr, &tv_tmp2);
 #endif
-			break;
+			DUK__NEXT();
 		}
 
 
@@ -4697,14 +5263,14 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * stack resize would be large).
 		 */
 
-		case DUK_OP_CALL0:
-		case DUK_OP_CALL1:
-		case DUK_OP_CALL2:
-		case DUK_OP_CALL3:
-		case DUK_OP_CALL4:
-		case DUK_OP_CALL5:
-		case DUK_OP_CALL6:
-		case DUK_OP_CALL7: {
+		DUK__CASE(DUK_OP_CALL0):
+		DUK__CASE(DUK_OP_CALL1):
+		DUK__CASE(DUK_OP_CALL2):
+		DUK__CASE(DUK_OP_CALL3):
+		DUK__CASE(DUK_OP_CALL4):
+		DUK__CASE(DUK_OP_CALL5):
+		DUK__CASE(DUK_OP_CALL6):
+		DUK__CASE(DUK_OP_CALL7): {
 			/* Opcode packs 4 flag bits: 1 for indirect, 3 map
 			 * 1:1 to three lowest call handling flags.
 			 *
@@ -4748,17 +5314,17 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			 * status after returning.  This is now handled by call handling
 			 * and heap->dbg_force_restart.
 			 */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_CALL8:
-		case DUK_OP_CALL9:
-		case DUK_OP_CALL10:
-		case DUK_OP_CALL11:
-		case DUK_OP_CALL12:
-		case DUK_OP_CALL13:
-		case DUK_OP_CALL14:
-		case DUK_OP_CALL15: {
+		DUK__CASE(DUK_OP_CALL8):
+		DUK__CASE(DUK_OP_CALL9):
+		DUK__CASE(DUK_OP_CALL10):
+		DUK__CASE(DUK_OP_CALL11):
+		DUK__CASE(DUK_OP_CALL12):
+		DUK__CASE(DUK_OP_CALL13):
+		DUK__CASE(DUK_OP_CALL14):
+		DUK__CASE(DUK_OP_CALL15): {
 			/* Indirect variant. */
 			duk_uint_fast_t nargs;
 			duk_idx_t idx;
@@ -4785,10 +5351,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			fun = DUK__FUN();
 #endif
 			duk_set_top_unsafe(thr, (duk_idx_t) fun->nregs);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_NEWOBJ: {
+		DUK__CASE(DUK_OP_NEWOBJ): {
 			duk_push_object(thr);
 #if defined(DUK_USE_ASSERTIONS)
 			{
@@ -4807,7 +5373,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
 
-		case DUK_OP_NEWARR: {
+		DUK__CASE(DUK_OP_NEWARR): {
 			duk_push_array(thr);
 #if defined(DUK_USE_ASSERTIONS)
 			{
@@ -4834,8 +5400,8 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
 
-		case DUK_OP_MPUTOBJ:
-		case DUK_OP_MPUTOBJI: {
+		DUK__CASE(DUK_OP_MPUTOBJ):
+		DUK__CASE(DUK_OP_MPUTOBJI): {
 			duk_idx_t obj_idx;
 			duk_uint_fast_t idx, idx_end;
 			duk_small_uint_fast_t count;
@@ -4887,17 +5453,17 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 				                           DUK_DEFPROP_SET_CONFIGURABLE);
 				idx += 2;
 			} while (idx < idx_end);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INITSET:
-		case DUK_OP_INITGET: {
+		DUK__CASE(DUK_OP_INITSET):
+		DUK__CASE(DUK_OP_INITGET): {
 			duk__handle_op_initset_initget(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_MPUTARR:
-		case DUK_OP_MPUTARRI: {
+		DUK__CASE(DUK_OP_MPUTARR):
+		DUK__CASE(DUK_OP_MPUTARRI): {
 			duk_idx_t obj_idx;
 			duk_uint_fast_t idx, idx_end;
 			duk_small_uint_fast_t count;
@@ -4965,10 +5531,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			 * 'arr_idx' type.
 			 */
 			duk_set_length(thr, obj_idx, (duk_size_t) (duk_uarridx_t) arr_idx);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_SETALEN: {
+		DUK__CASE(DUK_OP_SETALEN): {
 			duk_tval *tv1;
 			duk_hobject *h;
 			duk_uint32_t len;
@@ -4987,26 +5553,26 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			len = (duk_uint32_t) DUK_TVAL_GET_NUMBER(tv1);
 #endif
 			((duk_harray *) h)->length = len;
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INITENUM: {
+		DUK__CASE(DUK_OP_INITENUM): {
 			duk__handle_op_initenum(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_NEXTENUM: {
+		DUK__CASE(DUK_OP_NEXTENUM): {
 			curr_pc += duk__handle_op_nextenum(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INVLHS: {
+		DUK__CASE(DUK_OP_INVLHS): {
 			DUK_ERROR_REFERENCE(thr, DUK_STR_INVALID_LVALUE);
 			DUK_WO_NORETURN(return;);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_DEBUGGER: {
+		DUK__CASE(DUK_OP_DEBUGGER): {
 			/* Opcode only emitted by compiler when debugger
 			 * support is enabled.  Ignore it silently without
 			 * debugger support, in case it has been loaded
@@ -5025,24 +5591,24 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #else
 			DUK_D(DUK_DPRINT("DEBUGGER statement ignored, no debugger support"));
 #endif
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_NOP: {
+		DUK__CASE(DUK_OP_NOP): {
 			/* Nop, ignored, but ABC fields may carry a value e.g.
 			 * for indirect opcode handling.
 			 */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INVALID: {
+		DUK__CASE(DUK_OP_INVALID): {
 			DUK_ERROR_FMT1(thr, DUK_ERR_ERROR, "INVALID opcode (%ld)", (long) DUK_DEC_ABC(ins));
 			DUK_WO_NORETURN(return;);
-			break;
+			DUK__NEXT();
 		}
 
 #if defined(DUK_USE_ES6)
-		case DUK_OP_NEWTARGET: {
+		DUK__CASE(DUK_OP_NEWTARGET): {
 			duk_push_new_target(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
@@ -5050,65 +5616,69 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 
 #if !defined(DUK_USE_EXEC_PREFER_SIZE)
 #if !defined(DUK_USE_ES7_EXP_OPERATOR)
-		case DUK_OP_EXP_RR:
-		case DUK_OP_EXP_CR:
-		case DUK_OP_EXP_RC:
-		case DUK_OP_EXP_CC:
+		DUK__CASE(DUK_OP_EXP_RR):
+		DUK__CASE(DUK_OP_EXP_CR):
+		DUK__CASE(DUK_OP_EXP_RC):
+		DUK__CASE(DUK_OP_EXP_CC):
 #endif
 #if !defined(DUK_USE_ES6)
-		case DUK_OP_NEWTARGET:
+		DUK__CASE(DUK_OP_NEWTARGET):
 #endif
 #if !defined(DUK_USE_VERBOSE_ERRORS)
-		case DUK_OP_GETPROPC_RR:
-		case DUK_OP_GETPROPC_CR:
-		case DUK_OP_GETPROPC_RC:
-		case DUK_OP_GETPROPC_CC:
+		DUK__CASE(DUK_OP_GETPROPC_RR):
+		DUK__CASE(DUK_OP_GETPROPC_CR):
+		DUK__CASE(DUK_OP_GETPROPC_RC):
+		DUK__CASE(DUK_OP_GETPROPC_CC):
+#endif
+		DUK__CASE(DUK_OP_DELPROP_CR_UNUSED):
+		DUK__CASE(DUK_OP_DELPROP_CC_UNUSED):
+		DUK__CASE(DUK_OP_UNUSED207):
+#if !defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+		DUK__CASE(DUK_OP_IFLT_RR):
+		DUK__CASE(DUK_OP_IFLT_CR):
+		DUK__CASE(DUK_OP_IFLT_RC):
+		DUK__CASE(DUK_OP_IFLT_CC):
+		DUK__CASE(DUK_OP_IFGT_RR):
+		DUK__CASE(DUK_OP_IFGT_CR):
+		DUK__CASE(DUK_OP_IFGT_RC):
+		DUK__CASE(DUK_OP_IFGT_CC):
+		DUK__CASE(DUK_OP_IFLE_RR):
+		DUK__CASE(DUK_OP_IFLE_CR):
+		DUK__CASE(DUK_OP_IFLE_RC):
+		DUK__CASE(DUK_OP_IFLE_CC):
+		DUK__CASE(DUK_OP_IFGE_RR):
+		DUK__CASE(DUK_OP_IFGE_CR):
+		DUK__CASE(DUK_OP_IFGE_RC):
+		DUK__CASE(DUK_OP_IFGE_CC):
+		DUK__CASE(DUK_OP_IFSEQ_RR):
+		DUK__CASE(DUK_OP_IFSEQ_CR):
+		DUK__CASE(DUK_OP_IFSEQ_RC):
+		DUK__CASE(DUK_OP_IFSEQ_CC):
+		DUK__CASE(DUK_OP_IFSNEQ_RR):
+		DUK__CASE(DUK_OP_IFSNEQ_CR):
+		DUK__CASE(DUK_OP_IFSNEQ_RC):
+		DUK__CASE(DUK_OP_IFSNEQ_CC):
 #endif
-		case DUK_OP_UNUSED207:
-		case DUK_OP_UNUSED212:
-		case DUK_OP_UNUSED213:
-		case DUK_OP_UNUSED214:
-		case DUK_OP_UNUSED215:
-		case DUK_OP_UNUSED216:
-		case DUK_OP_UNUSED217:
-		case DUK_OP_UNUSED218:
-		case DUK_OP_UNUSED219:
-		case DUK_OP_UNUSED220:
-		case DUK_OP_UNUSED221:
-		case DUK_OP_UNUSED222:
-		case DUK_OP_UNUSED223:
-		case DUK_OP_UNUSED224:
-		case DUK_OP_UNUSED225:
-		case DUK_OP_UNUSED226:
-		case DUK_OP_UNUSED227:
-		case DUK_OP_UNUSED228:
-		case DUK_OP_UNUSED229:
-		case DUK_OP_UNUSED230:
-		case DUK_OP_UNUSED231:
-		case DUK_OP_UNUSED232:
-		case DUK_OP_UNUSED233:
-		case DUK_OP_UNUSED234:
-		case DUK_OP_UNUSED235:
-		case DUK_OP_UNUSED236:
-		case DUK_OP_UNUSED237:
-		case DUK_OP_UNUSED238:
-		case DUK_OP_UNUSED239:
-		case DUK_OP_UNUSED240:
-		case DUK_OP_UNUSED241:
-		case DUK_OP_UNUSED242:
-		case DUK_OP_UNUSED243:
-		case DUK_OP_UNUSED244:
-		case DUK_OP_UNUSED245:
-		case DUK_OP_UNUSED246:
-		case DUK_OP_UNUSED247:
-		case DUK_OP_UNUSED248:
-		case DUK_OP_UNUSED249:
-		case DUK_OP_UNUSED250:
-		case DUK_OP_UNUSED251:
-		case DUK_OP_UNUSED252:
-		case DUK_OP_UNUSED253:
-		case DUK_OP_UNUSED254:
-		case DUK_OP_UNUSED255:
+		DUK__CASE(DUK_OP_UNUSED236):
+		DUK__CASE(DUK_OP_UNUSED237):
+		DUK__CASE(DUK_OP_UNUSED238):
+		DUK__CASE(DUK_OP_UNUSED239):
+		DUK__CASE(DUK_OP_UNUSED240):
+		DUK__CASE(DUK_OP_UNUSED241):
+		DUK__CASE(DUK_OP_UNUSED242):
+		DUK__CASE(DUK_OP_UNUSED243):
+		DUK__CASE(DUK_OP_UNUSED244):
+		DUK__CASE(DUK_OP_UNUSED245):
+		DUK__CASE(DUK_OP_UNUSED246):
+		DUK__CASE(DUK_OP_UNUSED247):
+		DUK__CASE(DUK_OP_UNUSED248):
+		DUK__CASE(DUK_OP_UNUSED249):
+		DUK__CASE(DUK_OP_UNUSED250):
+		DUK__CASE(DUK_OP_UNUSED251):
+		DUK__CASE(DUK_OP_UNUSED252):
+		DUK__CASE(DUK_OP_UNUSED253):
+		DUK__CASE(DUK_OP_UNUSED254):
+		DUK__CASE(DUK_OP_UNUSED255):
 		/* Force all case clauses to map to an actual handler
 		 * so that the compiler can emit a jump without a bounds
 		 * check: the switch argument is a duk_uint8_t so that
@@ -5123,7 +5693,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			/* Default case catches invalid/unsupported opcodes. */
 			DUK_D(DUK_DPRINT("invalid opcode: %ld - %!I", (long) op, ins));
 			DUK__INTERNAL_ERROR("invalid opcode");
-			break;
+			DUK__NEXT();
 		}
 
 		}  /* end switch */
@@ -0,0 +1,1121 @@
+/*
+ *  Baseline template JIT for x86-64 (DUK_USE_JIT_X64).
+ *
+ *  See duk_js_jit_x64.h for an overview.  Generated code layout:
+ *
+ *    +----------------------------+  <- mapping start
+ *    | label table: int32 offset  |     native code offset of each
+ *    | per bytecode instruction   |     instruction from mapping start
+ *    +----------------------------+
+ *    | prologue + entry dispatch  |  <- entry point
+ *    | exit epilogue              |
+ *    | instruction templates      |
+ *    +----------------------------+
+ *
+ *  Register use in generated code: rbx = thr, r12 = thr->ptr_curr_pc
+ *  (pointer to the executor's curr_pc), r13 is saved for stack alignment.
+ *  Other registers are scratch and only live within a template.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_JIT_X64)
+
+#include <sys/mman.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/* Upper bound for the size of a single instruction template. */
+#define DUK__JIT_MAX_TEMPLATE   320
+
+/* Fixed size prologue and epilogue (upper bound). */
+#define DUK__JIT_MAX_FIXED      64
+
+/* x86-64 register numbers. */
+#define DUK__RAX  0
+#define DUK__RCX  1
+#define DUK__RDX  2
+#define DUK__RBX  3
+#define DUK__RSI  6
+#define DUK__RDI  7
+#define DUK__R8   8
+#define DUK__R9   9
+
+#define DUK__JIT_FN(fn)  ((duk_uint64_t) (duk_uintptr_t) (fn))
+
+/* Inline fast paths operate on the unpacked duk_tval layout directly;
+ * other configurations only use the C helpers.
+ */
+#if defined(DUK_USE_FASTINT) && !defined(DUK_USE_PACKED_TVAL)
+#define DUK__JIT_INLINE_FASTINT
+#define DUK__TV_T(idx)  ((duk_uint32_t) ((idx) * sizeof(duk_tval) + offsetof(duk_tval, t)))
+#define DUK__TV_V(idx)  ((duk_uint32_t) ((idx) * sizeof(duk_tval) + offsetof(duk_tval, v)))
+
+/* Condition codes for jcc/setcc. */
+#define DUK__CC_E   0x04U
+#define DUK__CC_NE  0x05U
+#define DUK__CC_AE  0x03U
+#define DUK__CC_L   0x0cU
+#define DUK__CC_GE  0x0dU
+#define DUK__CC_LE  0x0eU
+#define DUK__CC_G   0x0fU
+#endif
+
+typedef struct {
+	duk_uint32_t off;    /* offset of rel32 field */
+	duk_uint32_t pc;     /* target instruction */
+} duk__jit_fixup;
+
+typedef struct {
+	duk_uint8_t *base;        /* mapping start */
+	duk_size_t size;          /* mapping size */
+	duk_size_t off;           /* current emit offset */
+	duk_size_t exit_off;      /* offset of exit epilogue */
+	duk_instr_t *bcode;
+	duk_tval *consts;
+	duk_uint32_t n;           /* instruction count */
+	duk__jit_fixup *fixups;
+	duk_uint32_t nfixups;
+#if defined(DUK__JIT_INLINE_FASTINT)
+	duk_uint32_t slow_jumps[4];  /* fast path jumps to slow path */
+	duk_uint32_t nslow_jumps;
+	duk_uint32_t done_jump;      /* fast path jump over slow path */
+#endif
+} duk__jit_emitter;
+
+/*
+ *  C helpers for opcodes which need no executor internals.
+ */
+
+DUK_LOCAL void duk__jit_op_copy(duk_hthread *thr, duk_tval *tv_dst, duk_tval *tv_src) {
+	DUK_TVAL_SET_TVAL_UPDREF(thr, tv_dst, tv_src);  /* side effects */
+}
+
+DUK_LOCAL void duk__jit_op_ldint(duk_hthread *thr, duk_tval *tv_dst, duk_int32_t val) {
+	DUK_TVAL_SET_I32_UPDREF(thr, tv_dst, val);  /* side effects */
+}
+
+DUK_LOCAL void duk__jit_op_ldintx(duk_hthread *thr, duk_tval *tv_dst, duk_uint32_t bc) {
+	duk_int32_t val;
+
+	DUK_ASSERT(DUK_TVAL_IS_NUMBER(tv_dst));
+#if defined(DUK_USE_FASTINT)
+	DUK_ASSERT(DUK_TVAL_IS_FASTINT(tv_dst));
+	val = DUK_TVAL_GET_FASTINT_I32(tv_dst);
+#else
+	val = (duk_int32_t) DUK_TVAL_GET_NUMBER(tv_dst);
+#endif
+	val = (duk_int32_t) ((duk_uint32_t) val << DUK_BC_LDINTX_SHIFT) + (duk_int32_t) bc;  /* no bias */
+	DUK_TVAL_SET_I32_UPDREF(thr, tv_dst, val);  /* side effects */
+}
+
+DUK_LOCAL void duk__jit_op_ldundef(duk_hthread *thr, duk_tval *tv_dst) {
+	DUK_TVAL_SET_UNDEFINED_UPDREF(thr, tv_dst);  /* side effects */
+}
+
+DUK_LOCAL void duk__jit_op_ldnull(duk_hthread *thr, duk_tval *tv_dst) {
+	DUK_TVAL_SET_NULL_UPDREF(thr, tv_dst);  /* side effects */
+}
+
+DUK_LOCAL void duk__jit_op_ldbool(duk_hthread *thr, duk_tval *tv_dst, duk_uint32_t val) {
+	DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv_dst, (duk_bool_t) val);  /* side effects */
+}
+
+/* Relational comparison writing the result to register 'idx_dst'; the
+ * result is also returned for an immediately following branch.
+ */
+DUK_LOCAL duk_bool_t duk__jit_op_compare(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint32_t idx_dst, duk_uint32_t flags) {
+	duk_bool_t res;
+	duk_tval *tv_dst;
+
+	res = duk_js_compare_helper(thr, tv_x, tv_y, (duk_small_uint_t) flags);
+	DUK_ASSERT(res == 0 || res == 1);
+	tv_dst = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
+	DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv_dst, res);  /* side effects */
+	return res;
+}
+
+DUK_LOCAL duk_bool_t duk__jit_op_equals(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint32_t idx_dst, duk_uint32_t flags, duk_uint32_t negate) {
+	duk_bool_t res;
+	duk_tval *tv_dst;
+
+	res = duk_js_equals_helper(thr, tv_x, tv_y, (duk_small_uint_t) flags);
+	DUK_ASSERT(res == 0 || res == 1);
+	res ^= (duk_bool_t) negate;
+	tv_dst = DUK_GET_TVAL_POSIDX(thr, (duk_idx_t) idx_dst);
+	DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv_dst, res);  /* side effects */
+	return res;
+}
+
+/*
+ *  Machine code emission.
+ */
+
+DUK_LOCAL void duk__jit_u8(duk__jit_emitter *e, duk_uint8_t x) {
+	DUK_ASSERT(e->off < e->size);
+	e->base[e->off++] = x;
+}
+
+DUK_LOCAL void duk__jit_u32(duk__jit_emitter *e, duk_uint32_t x) {
+	duk_small_uint_t i;
+
+	for (i = 0; i < 4; i++) {
+		duk__jit_u8(e, (duk_uint8_t) (x & 0xffU));
+		x >>= 8;
+	}
+}
+
+DUK_LOCAL void duk__jit_u64(duk__jit_emitter *e, duk_uint64_t x) {
+	duk_small_uint_t i;
+
+	for (i = 0; i < 8; i++) {
+		duk__jit_u8(e, (duk_uint8_t) (x & 0xffU));
+		x >>= 8;
+	}
+}
+
+/* mov r64, imm64 */
+DUK_LOCAL void duk__jit_mov_imm64(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint64_t val) {
+	duk__jit_u8(e, (duk_uint8_t) (0x48U | (reg >> 3)));
+	duk__jit_u8(e, (duk_uint8_t) (0xb8U + (reg & 0x07U)));
+	duk__jit_u64(e, val);
+}
+
+/* mov r32, imm32 (zero extends to 64 bits) */
+DUK_LOCAL void duk__jit_mov_imm32(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t val) {
+	if (reg >= 8) {
+		duk__jit_u8(e, 0x41U);
+	}
+	duk__jit_u8(e, (duk_uint8_t) (0xb8U + (reg & 0x07U)));
+	duk__jit_u32(e, val);
+}
+
+/* mov r64, [rbx + disp32] */
+DUK_LOCAL void duk__jit_load_thr_field(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t disp) {
+	duk__jit_u8(e, (duk_uint8_t) (0x48U | ((reg >> 3) << 2)));
+	duk__jit_u8(e, 0x8bU);
+	duk__jit_u8(e, (duk_uint8_t) (0x80U | ((reg & 0x07U) << 3) | DUK__RBX));
+	duk__jit_u32(e, disp);
+}
+
+/* reg = pointer to register 'idx' of the current activation.  Loaded from
+ * thr->valstack_bottom for every use because helpers may resize the value
+ * stack.
+ */
+DUK_LOCAL void duk__jit_regp(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t idx) {
+	duk__jit_load_thr_field(e, reg, (duk_uint32_t) offsetof(duk_hthread, valstack_bottom));
+	if (idx > 0) {
+		/* add r64, imm32 */
+		duk__jit_u8(e, (duk_uint8_t) (0x48U | (reg >> 3)));
+		duk__jit_u8(e, 0x81U);
+		duk__jit_u8(e, (duk_uint8_t) (0xc0U | (reg & 0x07U)));
+		duk__jit_u32(e, idx * (duk_uint32_t) sizeof(duk_tval));
+	}
+}
+
+DUK_LOCAL void duk__jit_constp(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t idx) {
+	duk__jit_mov_imm64(e, reg, DUK__JIT_FN(e->consts + idx));
+}
+
+DUK_LOCAL void duk__jit_regconstp(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t idx, duk_bool_t is_const) {
+	if (is_const) {
+		duk__jit_constp(e, reg, idx);
+	} else {
+		duk__jit_regp(e, reg, idx);
+	}
+}
+
+/* Store the executor pc (pointing after instruction 'pc') so that errors
+ * and side effects see an up-to-date pc: mov rax, imm64; mov [r12], rax.
+ */
+DUK_LOCAL void duk__jit_sync_pc(duk__jit_emitter *e, duk_uint32_t pc) {
+	duk__jit_mov_imm64(e, DUK__RAX, DUK__JIT_FN(e->bcode + pc + 1));
+	duk__jit_u8(e, 0x49U);
+	duk__jit_u8(e, 0x89U);
+	duk__jit_u8(e, 0x04U);
+	duk__jit_u8(e, 0x24U);
+}
+
+/* mov rdi, rbx */
+DUK_LOCAL void duk__jit_arg_thr(duk__jit_emitter *e) {
+	duk__jit_u8(e, 0x48U);
+	duk__jit_u8(e, 0x89U);
+	duk__jit_u8(e, 0xdfU);
+}
+
+/* mov rax, imm64; call rax */
+DUK_LOCAL void duk__jit_call(duk__jit_emitter *e, duk_uint64_t fn) {
+	duk__jit_mov_imm64(e, DUK__RAX, fn);
+	duk__jit_u8(e, 0xffU);
+	duk__jit_u8(e, 0xd0U);
+}
+
+/* test eax, eax */
+DUK_LOCAL void duk__jit_test_eax(duk__jit_emitter *e) {
+	duk__jit_u8(e, 0x85U);
+	duk__jit_u8(e, 0xc0U);
+}
+
+DUK_LOCAL void duk__jit_rel32_to_pc(duk__jit_emitter *e, duk_uint32_t target_pc) {
+	DUK_ASSERT(target_pc < e->n);
+	DUK_ASSERT(e->nfixups < e->n * 2U);
+	e->fixups[e->nfixups].off = (duk_uint32_t) e->off;
+	e->fixups[e->nfixups].pc = target_pc;
+	e->nfixups++;
+	duk__jit_u32(e, 0);
+}
+
+DUK_LOCAL void duk__jit_jmp_pc(duk__jit_emitter *e, duk_uint32_t target_pc) {
+	duk__jit_u8(e, 0xe9U);
+	duk__jit_rel32_to_pc(e, target_pc);
+}
+
+/* jz/jnz rel32 */
+DUK_LOCAL void duk__jit_jcc_pc(duk__jit_emitter *e, duk_bool_t jump_if_nonzero, duk_uint32_t target_pc) {
+	duk__jit_u8(e, 0x0fU);
+	duk__jit_u8(e, jump_if_nonzero ? 0x85U : 0x84U);
+	duk__jit_rel32_to_pc(e, target_pc);
+}
+
+/* Return to the executor, which continues at instruction 'pc'. */
+DUK_LOCAL void duk__jit_exit(duk__jit_emitter *e, duk_uint32_t pc) {
+	duk__jit_mov_imm32(e, DUK__RAX, pc);
+	duk__jit_u8(e, 0xe9U);
+	duk__jit_u32(e, (duk_uint32_t) ((duk_int32_t) e->exit_off - (duk_int32_t) (e->off + 4)));
+}
+
+DUK_LOCAL void duk__jit_prologue(duk__jit_emitter *e) {
+	duk_size_t lea_end;
+
+	/* push rbx; push r12; push r13 (keeps the stack 16-byte aligned) */
+	duk__jit_u8(e, 0x53U);
+	duk__jit_u8(e, 0x41U);
+	duk__jit_u8(e, 0x54U);
+	duk__jit_u8(e, 0x41U);
+	duk__jit_u8(e, 0x55U);
+
+	/* mov rbx, rdi */
+	duk__jit_u8(e, 0x48U);
+	duk__jit_u8(e, 0x89U);
+	duk__jit_u8(e, 0xfbU);
+
+	/* mov r12, [rdi + offsetof(ptr_curr_pc)] */
+	duk__jit_u8(e, 0x4cU);
+	duk__jit_u8(e, 0x8bU);
+	duk__jit_u8(e, 0xa7U);
+	duk__jit_u32(e, (duk_uint32_t) offsetof(duk_hthread, ptr_curr_pc));
+
+	/* lea rax, [rip + label table] */
+	duk__jit_u8(e, 0x48U);
+	duk__jit_u8(e, 0x8dU);
+	duk__jit_u8(e, 0x05U);
+	lea_end = e->off + 4;
+	duk__jit_u32(e, (duk_uint32_t) (-(duk_int32_t) lea_end));
+
+	/* mov esi, esi (zero extend pc) */
+	duk__jit_u8(e, 0x89U);
+	duk__jit_u8(e, 0xf6U);
+
+	/* movsxd rcx, dword [rax + rsi*4]; add rcx, rax; jmp rcx */
+	duk__jit_u8(e, 0x48U);
+	duk__jit_u8(e, 0x63U);
+	duk__jit_u8(e, 0x0cU);
+	duk__jit_u8(e, 0xb0U);
+	duk__jit_u8(e, 0x48U);
+	duk__jit_u8(e, 0x01U);
+	duk__jit_u8(e, 0xc1U);
+	duk__jit_u8(e, 0xffU);
+	duk__jit_u8(e, 0xe1U);
+
+	/* Exit epilogue, eax = next pc: pop r13; pop r12; pop rbx; ret */
+	e->exit_off = e->off;
+	duk__jit_u8(e, 0x41U);
+	duk__jit_u8(e, 0x5dU);
+	duk__jit_u8(e, 0x41U);
+	duk__jit_u8(e, 0x5cU);
+	duk__jit_u8(e, 0x5bU);
+	duk__jit_u8(e, 0xc3U);
+}
+
+#if defined(DUK_USE_INTERRUPT_COUNTER)
+/* Backward jump: decrement the interrupt counter like the executor would
+ * and exit to the executor at the jump target when it runs out.
+ */
+DUK_LOCAL void duk__jit_interrupt_check(duk__jit_emitter *e, duk_uint32_t target_pc) {
+#if defined(DUK_USE_DEBUG)
+	/* Keep dispatch count in sync for the executor cross-check:
+	 * mov rax, [rbx + offsetof(heap)]; add dword [rax + disp32], 1
+	 */
+	duk__jit_load_thr_field(e, DUK__RAX, (duk_uint32_t) offsetof(duk_hthread, heap));
+	duk__jit_u8(e, 0x83U);
+	duk__jit_u8(e, 0x80U);
+	duk__jit_u32(e, (duk_uint32_t) offsetof(duk_heap, inst_count_exec));
+	duk__jit_u8(e, 0x01U);
+#endif
+
+	/* sub dword [rbx + offsetof(interrupt_counter)], 1 */
+	duk__jit_u8(e, 0x83U);
+	duk__jit_u8(e, 0xabU);
+	duk__jit_u32(e, (duk_uint32_t) offsetof(duk_hthread, interrupt_counter));
+	duk__jit_u8(e, 0x01U);
+
+	/* jg over the exit (mov eax, imm32 + jmp rel32 = 10 bytes) */
+	duk__jit_u8(e, 0x7fU);
+	duk__jit_u8(e, 0x0aU);
+	duk__jit_exit(e, target_pc);
+}
+#endif
+
+#if defined(DUK__JIT_INLINE_FASTINT)
+/*
+ *  Inline fast paths.  A fast path handles the common case (fastint
+ *  operands, destination not heap allocated) without side effects so it
+ *  needs no pc sync; anything else jumps to the slow path which is the
+ *  normal helper call:
+ *
+ *    duk__jit_fast_begin()       rax = thr->valstack_bottom
+ *    <fast path, duk__jit_jcc_slow() on mismatch>
+ *    duk__jit_fast_end()         jmp done; slow:
+ *    <helper call>
+ *    duk__jit_fast_finish()      done:
+ */
+
+DUK_LOCAL void duk__jit_patch_rel32(duk__jit_emitter *e, duk_uint32_t off) {
+	duk_int32_t rel = (duk_int32_t) e->off - (duk_int32_t) (off + 4);
+	duk_memcpy((void *) (e->base + off), (const void *) &rel, 4);
+}
+
+DUK_LOCAL void duk__jit_fast_begin(duk__jit_emitter *e) {
+	e->nslow_jumps = 0;
+	duk__jit_load_thr_field(e, DUK__RAX, (duk_uint32_t) offsetof(duk_hthread, valstack_bottom));
+}
+
+DUK_LOCAL void duk__jit_jcc_slow(duk__jit_emitter *e, duk_small_uint_t cc) {
+	DUK_ASSERT(e->nslow_jumps < sizeof(e->slow_jumps) / sizeof(duk_uint32_t));
+	duk__jit_u8(e, 0x0fU);
+	duk__jit_u8(e, (duk_uint8_t) (0x80U + cc));
+	e->slow_jumps[e->nslow_jumps++] = (duk_uint32_t) e->off;
+	duk__jit_u32(e, 0);
+}
+
+DUK_LOCAL void duk__jit_fast_end(duk__jit_emitter *e) {
+	duk_uint32_t i;
+
+	duk__jit_u8(e, 0xe9U);
+	e->done_jump = (duk_uint32_t) e->off;
+	duk__jit_u32(e, 0);
+	for (i = 0; i < e->nslow_jumps; i++) {
+		duk__jit_patch_rel32(e, e->slow_jumps[i]);
+	}
+}
+
+DUK_LOCAL void duk__jit_fast_finish(duk__jit_emitter *e) {
+	duk__jit_patch_rel32(e, e->done_jump);
+}
+
+/* cmp dword [rax + disp32], imm8 */
+DUK_LOCAL void duk__jit_cmp_tag(duk__jit_emitter *e, duk_uint32_t disp, duk_uint32_t tag) {
+	DUK_ASSERT(tag < 0x80U);
+	duk__jit_u8(e, 0x83U);
+	duk__jit_u8(e, 0xb8U);
+	duk__jit_u32(e, disp);
+	duk__jit_u8(e, (duk_uint8_t) tag);
+}
+
+/* mov dword [rax + disp32], imm32 */
+DUK_LOCAL void duk__jit_store_imm32(duk__jit_emitter *e, duk_uint32_t disp, duk_uint32_t val) {
+	duk__jit_u8(e, 0xc7U);
+	duk__jit_u8(e, 0x80U);
+	duk__jit_u32(e, disp);
+	duk__jit_u32(e, val);
+}
+
+/* mov r64, [rax + disp32] / mov [rax + disp32], r64 for rcx/rdx */
+DUK_LOCAL void duk__jit_load64(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t disp) {
+	duk__jit_u8(e, 0x48U);
+	duk__jit_u8(e, 0x8bU);
+	duk__jit_u8(e, (duk_uint8_t) (0x80U | (reg << 3)));
+	duk__jit_u32(e, disp);
+}
+
+DUK_LOCAL void duk__jit_store64(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t disp) {
+	duk__jit_u8(e, 0x48U);
+	duk__jit_u8(e, 0x89U);
+	duk__jit_u8(e, (duk_uint8_t) (0x80U | (reg << 3)));
+	duk__jit_u32(e, disp);
+}
+
+/* Slow path unless register 'idx' can be overwritten without a refcount
+ * update.
+ */
+DUK_LOCAL void duk__jit_check_dst(duk__jit_emitter *e, duk_uint32_t idx) {
+	duk__jit_cmp_tag(e, DUK__TV_T(idx), DUK_TAG_STRING);
+	duk__jit_jcc_slow(e, DUK__CC_AE);
+}
+
+/* Store fastint in rcx to register 'idx'. */
+DUK_LOCAL void duk__jit_store_fastint_rcx(duk__jit_emitter *e, duk_uint32_t idx) {
+	duk__jit_store_imm32(e, DUK__TV_T(idx), DUK_TAG_FASTINT);
+	duk__jit_store64(e, DUK__RCX, DUK__TV_V(idx));
+}
+
+/* Slow path unless rcx is within the fastint range (uses rdx). */
+DUK_LOCAL void duk__jit_check_fastint_range_rcx(duk__jit_emitter *e) {
+	/* mov rdx, rcx; shl rdx, 16; sar rdx, 16; cmp rdx, rcx */
+	duk__jit_u8(e, 0x48U); duk__jit_u8(e, 0x89U); duk__jit_u8(e, 0xcaU);
+	duk__jit_u8(e, 0x48U); duk__jit_u8(e, 0xc1U); duk__jit_u8(e, 0xe2U); duk__jit_u8(e, 0x10U);
+	duk__jit_u8(e, 0x48U); duk__jit_u8(e, 0xc1U); duk__jit_u8(e, 0xfaU); duk__jit_u8(e, 0x10U);
+	duk__jit_u8(e, 0x48U); duk__jit_u8(e, 0x39U); duk__jit_u8(e, 0xcaU);
+	duk__jit_jcc_slow(e, DUK__CC_NE);
+}
+
+/* Check that operand B/C (register or constant) is a fastint.  Returns
+ * zero if a constant operand is not a fastint, i.e. the fast path would
+ * never apply.
+ */
+DUK_LOCAL duk_bool_t duk__jit_check_fastint_operand(duk__jit_emitter *e, duk_uint32_t idx, duk_bool_t is_const) {
+	if (is_const) {
+		return DUK_TVAL_IS_FASTINT(e->consts + idx);
+	}
+	duk__jit_cmp_tag(e, DUK__TV_T(idx), DUK_TAG_FASTINT);
+	duk__jit_jcc_slow(e, DUK__CC_NE);
+	return 1;
+}
+
+/* Load fastint operand into 'reg' (64-bit value, or low 32 bits). */
+DUK_LOCAL void duk__jit_load_fastint_operand(duk__jit_emitter *e, duk_small_uint_t reg, duk_uint32_t idx, duk_bool_t is_const) {
+	if (is_const) {
+		duk__jit_mov_imm64(e, reg, (duk_uint64_t) DUK_TVAL_GET_FASTINT(e->consts + idx));
+	} else {
+		duk__jit_load64(e, reg, DUK__TV_V(idx));
+	}
+}
+
+/* Fastint operands B and C checked, loaded into rcx and rdx. */
+DUK_LOCAL duk_bool_t duk__jit_fast_fastint_operands(duk__jit_emitter *e, duk_instr_t ins, duk_bool_t b_const, duk_bool_t c_const) {
+	if (!duk__jit_check_fastint_operand(e, DUK_DEC_B(ins), b_const) ||
+	    !duk__jit_check_fastint_operand(e, DUK_DEC_C(ins), c_const)) {
+		return 0;
+	}
+	duk__jit_load_fastint_operand(e, DUK__RCX, DUK_DEC_B(ins), b_const);
+	duk__jit_load_fastint_operand(e, DUK__RDX, DUK_DEC_C(ins), c_const);
+	return 1;
+}
+
+/* ADD, SUB, BAND, BOR, BXOR with fastint operands. */
+DUK_LOCAL duk_bool_t duk__jit_fast_binary(duk__jit_emitter *e, duk_instr_t ins, duk_small_uint_t base, duk_bool_t b_const, duk_bool_t c_const) {
+	duk_uint8_t opbyte;
+
+	switch (base) {
+	case DUK_OP_ADD: opbyte = 0x01U; break;
+	case DUK_OP_SUB: opbyte = 0x29U; break;
+	case DUK_OP_BAND: opbyte = 0x21U; break;
+	case DUK_OP_BOR: opbyte = 0x09U; break;
+	case DUK_OP_BXOR: opbyte = 0x31U; break;
+	default: return 0;
+	}
+	if ((b_const && !DUK_TVAL_IS_FASTINT(e->consts + DUK_DEC_B(ins))) ||
+	    (c_const && !DUK_TVAL_IS_FASTINT(e->consts + DUK_DEC_C(ins)))) {
+		return 0;
+	}
+
+	duk__jit_fast_begin(e);
+	(void) duk__jit_fast_fastint_operands(e, ins, b_const, c_const);
+	duk__jit_check_dst(e, DUK_DEC_A(ins));
+	if (base == DUK_OP_ADD || base == DUK_OP_SUB) {
+		/* add/sub rcx, rdx: 48-bit inputs can't overflow 64 bits. */
+		duk__jit_u8(e, 0x48U); duk__jit_u8(e, opbyte); duk__jit_u8(e, 0xd1U);
+		duk__jit_check_fastint_range_rcx(e);
+	} else {
+		/* ToInt32() of a fastint is its low 32 bits:
+		 * and/or/xor ecx, edx; movsxd rcx, ecx
+		 */
+		duk__jit_u8(e, opbyte); duk__jit_u8(e, 0xd1U);
+		duk__jit_u8(e, 0x48U); duk__jit_u8(e, 0x63U); duk__jit_u8(e, 0xc9U);
+	}
+	duk__jit_store_fastint_rcx(e, DUK_DEC_A(ins));
+	duk__jit_fast_end(e);
+	return 1;
+}
+
+/* Comparison of fastint operands; the boolean result is written to A and
+ * left in eax like the slow path helpers do.
+ */
+DUK_LOCAL duk_bool_t duk__jit_fast_compare(duk__jit_emitter *e, duk_instr_t ins, duk_small_uint_t cc, duk_bool_t b_const, duk_bool_t c_const) {
+	if ((b_const && !DUK_TVAL_IS_FASTINT(e->consts + DUK_DEC_B(ins))) ||
+	    (c_const && !DUK_TVAL_IS_FASTINT(e->consts + DUK_DEC_C(ins)))) {
+		return 0;
+	}
+
+	duk__jit_fast_begin(e);
+	(void) duk__jit_fast_fastint_operands(e, ins, b_const, c_const);
+	duk__jit_check_dst(e, DUK_DEC_A(ins));
+	/* cmp rcx, rdx; setcc cl; movzx ecx, cl */
+	duk__jit_u8(e, 0x48U); duk__jit_u8(e, 0x39U); duk__jit_u8(e, 0xd1U);
+	duk__jit_u8(e, 0x0fU); duk__jit_u8(e, (duk_uint8_t) (0x90U + cc)); duk__jit_u8(e, 0xc1U);
+	duk__jit_u8(e, 0x0fU); duk__jit_u8(e, 0xb6U); duk__jit_u8(e, 0xc9U);
+	duk__jit_store_imm32(e, DUK__TV_T(DUK_DEC_A(ins)), DUK_TAG_BOOLEAN);
+	/* mov dword [rax + disp32], ecx; mov eax, ecx */
+	duk__jit_u8(e, 0x89U); duk__jit_u8(e, 0x88U); duk__jit_u32(e, DUK__TV_V(DUK_DEC_A(ins)));
+	duk__jit_u8(e, 0x89U); duk__jit_u8(e, 0xc8U);
+	duk__jit_fast_end(e);
+	return 1;
+}
+
+/* PREINCR, PREDECR, POSTINCR, POSTDECR of a fastint register. */
+DUK_LOCAL duk_bool_t duk__jit_fast_incdec(duk__jit_emitter *e, duk_instr_t ins, duk_small_uint_t op) {
+	duk_uint32_t idx_dst = DUK_DEC_A(ins);
+	duk_uint32_t idx_src = DUK_DEC_BC(ins);
+
+	duk__jit_fast_begin(e);
+	(void) duk__jit_check_fastint_operand(e, idx_src, 0);
+	duk__jit_check_dst(e, idx_dst);
+	duk__jit_load64(e, DUK__RCX, DUK__TV_V(idx_src));
+	/* mov r8, rcx (old value); add/sub rcx, 1 */
+	duk__jit_u8(e, 0x49U); duk__jit_u8(e, 0x89U); duk__jit_u8(e, 0xc8U);
+	duk__jit_u8(e, 0x48U); duk__jit_u8(e, 0x83U); duk__jit_u8(e, (op & 0x01U) ? 0xe9U : 0xc1U); duk__jit_u8(e, 0x01U);
+	duk__jit_check_fastint_range_rcx(e);
+	duk__jit_store64(e, DUK__RCX, DUK__TV_V(idx_src));
+	if (op & 0x02U) {
+		/* mov rcx, r8 */
+		duk__jit_u8(e, 0x4cU); duk__jit_u8(e, 0x89U); duk__jit_u8(e, 0xc1U);
+	}
+	duk__jit_store_fastint_rcx(e, idx_dst);
+	duk__jit_fast_end(e);
+	return 1;
+}
+
+/* LDREG, STREG, LDCONST of a value which is not heap allocated. */
+DUK_LOCAL duk_bool_t duk__jit_fast_copy(duk__jit_emitter *e, duk_uint32_t idx_dst, duk_uint32_t idx_src, duk_bool_t src_const) {
+	duk_tval *tv_const;
+
+	if (src_const) {
+		tv_const = e->consts + idx_src;
+		if (DUK_TVAL_IS_HEAP_ALLOCATED(tv_const)) {
+			return 0;
+		}
+		duk__jit_fast_begin(e);
+		duk__jit_check_dst(e, idx_dst);
+		duk__jit_store_imm32(e, DUK__TV_T(idx_dst), (duk_uint32_t) DUK_TVAL_GET_TAG(tv_const));
+		duk__jit_mov_imm64(e, DUK__RCX, (duk_uint64_t) tv_const->v.fi);
+		duk__jit_store64(e, DUK__RCX, DUK__TV_V(idx_dst));
+	} else {
+		duk__jit_fast_begin(e);
+		duk__jit_check_dst(e, idx_dst);
+		duk__jit_cmp_tag(e, DUK__TV_T(idx_src), DUK_TAG_STRING);
+		duk__jit_jcc_slow(e, DUK__CC_AE);
+		duk__jit_load64(e, DUK__RCX, DUK__TV_T(idx_src));
+		duk__jit_load64(e, DUK__RDX, DUK__TV_V(idx_src));
+		duk__jit_store64(e, DUK__RCX, DUK__TV_T(idx_dst));
+		duk__jit_store64(e, DUK__RDX, DUK__TV_V(idx_dst));
+	}
+	duk__jit_fast_end(e);
+	return 1;
+}
+
+/* LDINT, LDUNDEF, LDNULL, LDTRUE, LDFALSE: 'tag' and 'val' stored as is. */
+DUK_LOCAL duk_bool_t duk__jit_fast_load(duk__jit_emitter *e, duk_uint32_t idx_dst, duk_uint32_t tag, duk_int64_t val) {
+	duk__jit_fast_begin(e);
+	duk__jit_check_dst(e, idx_dst);
+	duk__jit_store_imm32(e, DUK__TV_T(idx_dst), tag);
+	duk__jit_mov_imm64(e, DUK__RCX, (duk_uint64_t) val);
+	duk__jit_store64(e, DUK__RCX, DUK__TV_V(idx_dst));
+	duk__jit_fast_end(e);
+	return 1;
+}
+
+/* IFTRUE_R/IFFALSE_R of a boolean register: eax = boolean value. */
+DUK_LOCAL duk_bool_t duk__jit_fast_toboolean(duk__jit_emitter *e, duk_uint32_t idx) {
+	duk__jit_fast_begin(e);
+	duk__jit_cmp_tag(e, DUK__TV_T(idx), DUK_TAG_BOOLEAN);
+	duk__jit_jcc_slow(e, DUK__CC_NE);
+	/* mov eax, dword [rax + disp32] */
+	duk__jit_u8(e, 0x8bU); duk__jit_u8(e, 0x80U); duk__jit_u32(e, DUK__TV_V(idx));
+	duk__jit_fast_end(e);
+	return 1;
+}
+#endif  /* DUK__JIT_INLINE_FASTINT */
+
+/* Branch on the boolean in eax for a comparison at 'pc' whose result is
+ * tested by the IFTRUE_R/IFFALSE_R at pc + 1: the IF is skipped in native
+ * code.  Returns zero if the pattern doesn't apply.
+ */
+DUK_LOCAL duk_bool_t duk__jit_compare_branch(duk__jit_emitter *e, duk_uint32_t pc, duk_instr_t ins) {
+	duk_instr_t ins_if;
+	duk_small_uint_t op_if;
+
+	if (pc + 3 >= e->n) {
+		return 0;
+	}
+	ins_if = e->bcode[pc + 1];
+	op_if = (duk_small_uint_t) DUK_DEC_OP(ins_if);
+	if ((op_if != DUK_OP_IFTRUE_R && op_if != DUK_OP_IFFALSE_R) ||
+	    DUK_DEC_BC(ins_if) != DUK_DEC_A(ins)) {
+		return 0;
+	}
+
+	/* IFTRUE skips the next instruction when true, IFFALSE when false. */
+	duk__jit_test_eax(e);
+	duk__jit_jcc_pc(e, op_if == DUK_OP_IFTRUE_R, pc + 3);
+	duk__jit_jmp_pc(e, pc + 2);
+	return 1;
+}
+
+/* Emit the template for instruction 'pc'.  Returns zero if the function
+ * can't be compiled.
+ */
+#if defined(DUK__JIT_INLINE_FASTINT)
+/* Emit an inline fast path (expression returns nonzero if emitted) before
+ * the helper call slow path.
+ */
+#define DUK__JIT_FAST(expr) do { \
+		has_fast = (expr); \
+	} while (0)
+#define DUK__JIT_FAST_FINISH() do { \
+		if (has_fast) { \
+			duk__jit_fast_finish(e); \
+		} \
+	} while (0)
+#else
+#define DUK__JIT_FAST(expr) do { } while (0)
+#define DUK__JIT_FAST_FINISH() do { } while (0)
+#endif
+
+DUK_LOCAL duk_bool_t duk__jit_emit_instr(duk__jit_emitter *e, duk_uint32_t pc, duk_bool_t is_strict) {
+	duk_instr_t ins;
+	duk_small_uint_t op;
+	duk_bool_t b_const;
+	duk_bool_t c_const;
+#if defined(DUK__JIT_INLINE_FASTINT)
+	duk_bool_t has_fast = 0;
+#endif
+
+	ins = e->bcode[pc];
+	op = (duk_small_uint_t) DUK_DEC_OP(ins);
+	b_const = (op & DUK_BC_REGCONST_B) != 0;
+	c_const = (op & DUK_BC_REGCONST_C) != 0;
+
+	switch (op) {
+	case DUK_OP_LDREG:
+	case DUK_OP_STREG:
+	case DUK_OP_LDCONST: {
+		duk_uint32_t idx_dst = (op == DUK_OP_STREG ? DUK_DEC_BC(ins) : DUK_DEC_A(ins));
+		duk_uint32_t idx_src = (op == DUK_OP_STREG ? DUK_DEC_A(ins) : DUK_DEC_BC(ins));
+
+		DUK__JIT_FAST(duk__jit_fast_copy(e, idx_dst, idx_src, op == DUK_OP_LDCONST));
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regp(e, DUK__RSI, idx_dst);
+		duk__jit_regconstp(e, DUK__RDX, idx_src, op == DUK_OP_LDCONST);
+		duk__jit_call(e, DUK__JIT_FN(duk__jit_op_copy));
+		DUK__JIT_FAST_FINISH();
+		return 1;
+	}
+	case DUK_OP_LDINT:
+	case DUK_OP_LDINTX:
+		if (op == DUK_OP_LDINT) {
+			duk_int32_t val = (duk_int32_t) DUK_DEC_BC(ins) - (duk_int32_t) DUK_BC_LDINT_BIAS;
+
+			DUK__JIT_FAST(duk__jit_fast_load(e, DUK_DEC_A(ins), DUK_TAG_FASTINT, (duk_int64_t) val));
+			duk__jit_sync_pc(e, pc);
+			duk__jit_arg_thr(e);
+			duk__jit_regp(e, DUK__RSI, DUK_DEC_A(ins));
+			duk__jit_mov_imm32(e, DUK__RDX, (duk_uint32_t) val);
+			duk__jit_call(e, DUK__JIT_FN(duk__jit_op_ldint));
+			DUK__JIT_FAST_FINISH();
+		} else {
+			duk__jit_sync_pc(e, pc);
+			duk__jit_arg_thr(e);
+			duk__jit_regp(e, DUK__RSI, DUK_DEC_A(ins));
+			duk__jit_mov_imm32(e, DUK__RDX, (duk_uint32_t) DUK_DEC_BC(ins));
+			duk__jit_call(e, DUK__JIT_FN(duk__jit_op_ldintx));
+		}
+		return 1;
+	case DUK_OP_LDUNDEF:
+	case DUK_OP_LDNULL:
+	case DUK_OP_LDTRUE:
+	case DUK_OP_LDFALSE:
+		DUK__JIT_FAST(duk__jit_fast_load(e, DUK_DEC_BC(ins),
+		                                 (op == DUK_OP_LDUNDEF ? DUK_TAG_UNDEFINED : (op == DUK_OP_LDNULL ? DUK_TAG_NULL : DUK_TAG_BOOLEAN)),
+		                                 (op == DUK_OP_LDTRUE ? 1 : 0)));
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regp(e, DUK__RSI, DUK_DEC_BC(ins));
+		if (op == DUK_OP_LDUNDEF) {
+			duk__jit_call(e, DUK__JIT_FN(duk__jit_op_ldundef));
+		} else if (op == DUK_OP_LDNULL) {
+			duk__jit_call(e, DUK__JIT_FN(duk__jit_op_ldnull));
+		} else {
+			duk__jit_mov_imm32(e, DUK__RDX, (op == DUK_OP_LDTRUE ? 1U : 0U));
+			duk__jit_call(e, DUK__JIT_FN(duk__jit_op_ldbool));
+		}
+		DUK__JIT_FAST_FINISH();
+		return 1;
+	case DUK_OP_BNOT:
+	case DUK_OP_LNOT:
+	case DUK_OP_UNM:
+	case DUK_OP_UNP:
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_mov_imm32(e, DUK__RSI, DUK_DEC_BC(ins));
+		duk__jit_mov_imm32(e, DUK__RDX, DUK_DEC_A(ins));
+		duk__jit_mov_imm32(e, DUK__RCX, op);
+		duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_unary));
+		return 1;
+	case DUK_OP_PREINCR:
+	case DUK_OP_PREDECR:
+	case DUK_OP_POSTINCR:
+	case DUK_OP_POSTDECR:
+		DUK__JIT_FAST(duk__jit_fast_incdec(e, ins, op));
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regp(e, DUK__RSI, DUK_DEC_A(ins));
+		duk__jit_regp(e, DUK__RDX, DUK_DEC_BC(ins));
+		duk__jit_mov_imm32(e, DUK__RCX, op);
+		duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_incdec));
+		DUK__JIT_FAST_FINISH();
+		return 1;
+	case DUK_OP_IFTRUE_R:
+	case DUK_OP_IFTRUE_C:
+	case DUK_OP_IFFALSE_R:
+	case DUK_OP_IFFALSE_C:
+		/* duk_js_toboolean() has no side effects, no pc sync. */
+		if (pc + 2 >= e->n) {
+			return 0;
+		}
+		if (op == DUK_OP_IFTRUE_C || op == DUK_OP_IFFALSE_C) {
+			/* Constant condition: resolve at compile time. */
+			if (duk_js_toboolean(e->consts + DUK_DEC_BC(ins)) == (op == DUK_OP_IFTRUE_C)) {
+				duk__jit_jmp_pc(e, pc + 2);
+			}
+			return 1;
+		}
+		DUK__JIT_FAST(duk__jit_fast_toboolean(e, DUK_DEC_BC(ins)));
+		duk__jit_regp(e, DUK__RDI, DUK_DEC_BC(ins));
+		duk__jit_call(e, DUK__JIT_FN(duk_js_toboolean));
+		DUK__JIT_FAST_FINISH();
+		duk__jit_test_eax(e);
+		duk__jit_jcc_pc(e, op == DUK_OP_IFTRUE_R, pc + 2);
+		return 1;
+	case DUK_OP_JUMP: {
+		duk_int32_t target;
+
+		target = (duk_int32_t) pc + 1 + (duk_int32_t) DUK_DEC_ABC(ins) - (duk_int32_t) DUK_BC_JUMP_BIAS;
+		if (target < 0 || (duk_uint32_t) target >= e->n) {
+			return 0;
+		}
+#if defined(DUK_USE_INTERRUPT_COUNTER)
+		if ((duk_uint32_t) target <= pc) {
+			duk__jit_interrupt_check(e, (duk_uint32_t) target);
+		}
+#endif
+		duk__jit_jmp_pc(e, (duk_uint32_t) target);
+		return 1;
+	}
+	case DUK_OP_NOP:
+		return 1;
+	default:
+		break;
+	}
+
+	/* Opcode groups with reg/const variants. */
+	switch (op & ~(DUK_BC_REGCONST_B | DUK_BC_REGCONST_C)) {
+	case DUK_OP_ADD:
+	case DUK_OP_SUB:
+	case DUK_OP_MUL:
+	case DUK_OP_DIV:
+	case DUK_OP_MOD:
+#if defined(DUK_USE_ES7_EXP_OPERATOR)
+	case DUK_OP_EXP:
+#endif
+	case DUK_OP_BAND:
+	case DUK_OP_BOR:
+	case DUK_OP_BXOR:
+	case DUK_OP_BASL:
+	case DUK_OP_BLSR:
+	case DUK_OP_BASR: {
+		duk_small_uint_t base = op & ~(DUK_BC_REGCONST_B | DUK_BC_REGCONST_C);
+
+		DUK__JIT_FAST(duk__jit_fast_binary(e, ins, base, b_const, c_const));
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regconstp(e, DUK__RSI, DUK_DEC_B(ins), b_const);
+		duk__jit_regconstp(e, DUK__RDX, DUK_DEC_C(ins), c_const);
+		duk__jit_mov_imm32(e, DUK__RCX, DUK_DEC_A(ins));
+		if (base == DUK_OP_ADD) {
+			duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_add));
+		} else {
+			duk__jit_mov_imm32(e, DUK__R8, base);
+			if (base >= DUK_OP_BAND) {
+				duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_bitwise));
+			} else {
+				duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_arith));
+			}
+		}
+		DUK__JIT_FAST_FINISH();
+		return 1;
+	}
+	case DUK_OP_EQ:
+	case DUK_OP_NEQ:
+	case DUK_OP_SEQ:
+	case DUK_OP_SNEQ:
+#if defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+	case DUK_OP_IFSEQ:
+	case DUK_OP_IFSNEQ:
+#endif
+	{
+		duk_small_uint_t base = op & ~(DUK_BC_REGCONST_B | DUK_BC_REGCONST_C);
+		duk_bool_t is_strict_eq = (base != DUK_OP_EQ && base != DUK_OP_NEQ);
+		duk_bool_t negate = (base == DUK_OP_NEQ || base == DUK_OP_SNEQ);
+		duk_bool_t is_fused = 0;
+
+#if defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+		if (base == DUK_OP_IFSEQ || base == DUK_OP_IFSNEQ) {
+			negate = (base == DUK_OP_IFSNEQ);
+			is_fused = 1;
+		}
+#endif
+		DUK__JIT_FAST(duk__jit_fast_compare(e, ins, negate ? DUK__CC_NE : DUK__CC_E, b_const, c_const));
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regconstp(e, DUK__RSI, DUK_DEC_B(ins), b_const);
+		duk__jit_regconstp(e, DUK__RDX, DUK_DEC_C(ins), c_const);
+		duk__jit_mov_imm32(e, DUK__RCX, DUK_DEC_A(ins));
+		duk__jit_mov_imm32(e, DUK__R8, is_strict_eq ? DUK_EQUALS_FLAG_STRICT : 0U);
+		duk__jit_mov_imm32(e, DUK__R9, negate ? 1U : 0U);
+		duk__jit_call(e, DUK__JIT_FN(duk__jit_op_equals));
+		DUK__JIT_FAST_FINISH();
+		if (!duk__jit_compare_branch(e, pc, ins) && is_fused) {
+			/* Superinstruction must consume the following IF. */
+			return 0;
+		}
+		return 1;
+	}
+	case DUK_OP_LT:
+	case DUK_OP_GT:
+	case DUK_OP_LE:
+	case DUK_OP_GE:
+#if defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+	case DUK_OP_IFLT:
+	case DUK_OP_IFGT:
+	case DUK_OP_IFLE:
+	case DUK_OP_IFGE:
+#endif
+	{
+		duk_small_uint_t base = op & ~(DUK_BC_REGCONST_B | DUK_BC_REGCONST_C);
+		duk_bool_t swap;
+		duk_uint32_t flags;
+		duk_bool_t is_fused = 0;
+
+#if defined(DUK_USE_EXEC_SUPERINSTRUCTIONS)
+		if (base == DUK_OP_IFLT) {
+			base = DUK_OP_LT;
+			is_fused = 1;
+		} else if (base == DUK_OP_IFGT) {
+			base = DUK_OP_GT;
+			is_fused = 1;
+		} else if (base == DUK_OP_IFLE) {
+			base = DUK_OP_LE;
+			is_fused = 1;
+		} else if (base == DUK_OP_IFGE) {
+			base = DUK_OP_GE;
+			is_fused = 1;
+		}
+#endif
+		/* Same argument order and flags as the executor. */
+		if (base == DUK_OP_LT) {
+			swap = 0;
+			flags = DUK_COMPARE_FLAG_EVAL_LEFT_FIRST;
+			DUK__JIT_FAST(duk__jit_fast_compare(e, ins, DUK__CC_L, b_const, c_const));
+		} else if (base == DUK_OP_GT) {
+			swap = 1;
+			flags = 0;
+			DUK__JIT_FAST(duk__jit_fast_compare(e, ins, DUK__CC_G, b_const, c_const));
+		} else if (base == DUK_OP_LE) {
+			swap = 1;
+			flags = DUK_COMPARE_FLAG_NEGATE;
+			DUK__JIT_FAST(duk__jit_fast_compare(e, ins, DUK__CC_LE, b_const, c_const));
+		} else {
+			swap = 0;
+			flags = DUK_COMPARE_FLAG_EVAL_LEFT_FIRST | DUK_COMPARE_FLAG_NEGATE;
+			DUK__JIT_FAST(duk__jit_fast_compare(e, ins, DUK__CC_GE, b_const, c_const));
+		}
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regconstp(e, swap ? DUK__RDX : DUK__RSI, DUK_DEC_B(ins), b_const);
+		duk__jit_regconstp(e, swap ? DUK__RSI : DUK__RDX, DUK_DEC_C(ins), c_const);
+		duk__jit_mov_imm32(e, DUK__RCX, DUK_DEC_A(ins));
+		duk__jit_mov_imm32(e, DUK__R8, flags);
+		duk__jit_call(e, DUK__JIT_FN(duk__jit_op_compare));
+		DUK__JIT_FAST_FINISH();
+		if (!duk__jit_compare_branch(e, pc, ins) && is_fused) {
+			return 0;
+		}
+		return 1;
+	}
+	case DUK_OP_GETPROP:
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regconstp(e, DUK__RSI, DUK_DEC_B(ins), b_const);
+		duk__jit_regconstp(e, DUK__RDX, DUK_DEC_C(ins), c_const);
+		duk__jit_mov_imm32(e, DUK__RCX, DUK_DEC_A(ins));
+#if defined(DUK_USE_PROP_IC) && !defined(DUK_USE_EXEC_PREFER_SIZE)
+		if (DUK_PROPIC_OP_IS_CACHED(op)) {
+			duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_getprop_ic));
+			return 1;
+		}
+#endif
+		duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_getprop));
+		return 1;
+	case DUK_OP_PUTPROP:
+		/* A is the object (register), B the key, C the value. */
+		duk__jit_sync_pc(e, pc);
+		duk__jit_arg_thr(e);
+		duk__jit_regp(e, DUK__RSI, DUK_DEC_A(ins));
+		duk__jit_regconstp(e, DUK__RDX, DUK_DEC_B(ins), b_const);
+		duk__jit_regconstp(e, DUK__RCX, DUK_DEC_C(ins), c_const);
+		duk__jit_mov_imm32(e, DUK__R8, is_strict ? 1U : 0U);
+#if defined(DUK_USE_PROP_IC) && !defined(DUK_USE_EXEC_PREFER_SIZE)
+		if (DUK_PROPIC_OP_IS_CACHED(op)) {
+			duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_putprop_ic));
+			return 1;
+		}
+#endif
+		duk__jit_call(e, DUK__JIT_FN(duk_jit_x64_op_putprop));
+		return 1;
+	default:
+		break;
+	}
+
+	/* No template: executor interprets the instruction. */
+	duk__jit_exit(e, pc);
+	return 1;
+}
+
+/*
+ *  JIT state management
+ */
+
+/* Allocate JIT state for 'fun' (a function template), NULL on failure. */
+DUK_INTERNAL duk_jitfunc *duk_jit_x64_alloc(duk_heap *heap, duk_hcompfunc *fun) {
+	duk_jitfunc *jf;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(fun != NULL);
+
+	jf = (duk_jitfunc *) DUK_ALLOC(heap, sizeof(duk_jitfunc));
+	if (DUK_UNLIKELY(jf == NULL)) {
+		DUK_D(DUK_DPRINT("failed to allocate JIT state for function %p, ignoring", (void *) fun));
+		return NULL;
+	}
+	jf->refcount = 1;
+	jf->state = DUK_JIT_X64_STATE_COUNTING;
+	jf->counter = 0;
+	jf->bcode = DUK_HCOMPFUNC_GET_CODE_BASE(heap, fun);
+	jf->entry = NULL;
+	jf->code = NULL;
+	jf->code_size = 0;
+	return jf;
+}
+
+DUK_INTERNAL void duk_jit_x64_decref(duk_heap *heap, duk_jitfunc *jf) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(jf != NULL);
+	DUK_ASSERT(jf->refcount > 0);
+
+	if (--jf->refcount == 0) {
+		if (jf->code != NULL) {
+			(void) munmap(jf->code, jf->code_size);
+		}
+		DUK_FREE(heap, (void *) jf);
+	}
+}
+
+/* Compile 'fun' into native code.  On failure the JIT state is marked so
+ * that compilation is not retried.  Called from the executor: there are no
+ * side effects (raw allocation only).
+ */
+DUK_INTERNAL void duk_jit_x64_compile(duk_heap *heap, duk_hcompfunc *fun) {
+	duk_jitfunc *jf;
+	duk__jit_emitter e;
+	duk_size_t code_start;
+	duk_uint32_t pc;
+	duk_uint32_t i;
+	duk_int32_t *labels;
+	duk_bool_t is_strict;
+	void *mem;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(fun != NULL);
+	jf = fun->jit;
+	DUK_ASSERT(jf != NULL);
+	DUK_ASSERT(jf->state == DUK_JIT_X64_STATE_COUNTING);
+	DUK_ASSERT(jf->bcode == DUK_HCOMPFUNC_GET_CODE_BASE(heap, fun));
+
+	jf->state = DUK_JIT_X64_STATE_FAILED;
+
+	duk_memzero((void *) &e, sizeof(e));
+	e.bcode = jf->bcode;
+	e.consts = DUK_HCOMPFUNC_GET_CONSTS_BASE(heap, fun);
+	e.n = (duk_uint32_t) DUK_HCOMPFUNC_GET_CODE_COUNT(heap, fun);
+	if (e.n == 0 || e.n > 0x100000UL) {
+		return;
+	}
+	is_strict = DUK_HOBJECT_HAS_STRICT((duk_hobject *) fun);
+
+	e.fixups = (duk__jit_fixup *) DUK_ALLOC_RAW(heap, sizeof(duk__jit_fixup) * e.n * 2U);
+	if (e.fixups == NULL) {
+		return;
+	}
+
+	code_start = ((duk_size_t) e.n * sizeof(duk_int32_t) + 15U) & ~((duk_size_t) 15U);
+	e.size = code_start + DUK__JIT_MAX_FIXED + (duk_size_t) e.n * DUK__JIT_MAX_TEMPLATE;
+	mem = mmap(NULL, e.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mem == MAP_FAILED) {
+		DUK_D(DUK_DPRINT("JIT mmap failed for function %p", (void *) fun));
+		DUK_FREE_RAW(heap, (void *) e.fixups);
+		return;
+	}
+	e.base = (duk_uint8_t *) mem;
+	labels = (duk_int32_t *) mem;
+	e.off = code_start;
+
+	duk__jit_prologue(&e);
+	for (pc = 0; pc < e.n; pc++) {
+		DUK_ASSERT(e.size - e.off >= DUK__JIT_MAX_TEMPLATE);
+		labels[pc] = (duk_int32_t) e.off;
+		if (!duk__jit_emit_instr(&e, pc, is_strict)) {
+			DUK_D(DUK_DPRINT("JIT compilation of function %p failed at pc %ld", (void *) fun, (long) pc));
+			goto fail;
+		}
+		DUK_ASSERT(e.off - (duk_size_t) labels[pc] <= DUK__JIT_MAX_TEMPLATE);
+	}
+
+	for (i = 0; i < e.nfixups; i++) {
+		duk_uint32_t off = e.fixups[i].off;
+		duk_int32_t rel = labels[e.fixups[i].pc] - (duk_int32_t) (off + 4);
+		duk_memcpy((void *) (e.base + off), (const void *) &rel, 4);
+	}
+
+	if (mprotect(mem, e.size, PROT_READ | PROT_EXEC) != 0) {
+		DUK_D(DUK_DPRINT("JIT mprotect failed for function %p", (void *) fun));
+		goto fail;
+	}
+	DUK_FREE_RAW(heap, (void *) e.fixups);
+
+	jf->code = mem;
+	jf->code_size = e.size;
+	jf->entry = (duk_jit_x64_entry) (duk_uintptr_t) (e.base + code_start);
+	jf->state = DUK_JIT_X64_STATE_COMPILED;
+	DUK_DD(DUK_DDPRINT("JIT compiled function %p: %ld instructions, %ld bytes of code",
+	                   (void *) fun, (long) e.n, (long) (e.off - code_start)));
+	return;
+
+ fail:
+	(void) munmap(mem, e.size);
+	DUK_FREE_RAW(heap, (void *) e.fixups);
+}
+
+#endif  /* DUK_USE_JIT_X64 */
@@ -0,0 +1,84 @@
+/*
+ *  Baseline template JIT for x86-64 (DUK_USE_JIT_X64).
+ *
+ *  Hot functions are translated into x86-64 machine code by emitting a
+ *  fixed code template per bytecode instruction: the template calls the
+ *  same C helpers the executor uses for the opcode, while jumps and
+ *  conditional branches become native branches so that opcode fetch,
+ *  decode, and dispatch disappear.  Opcodes without a template (calls,
+ *  returns, try/catch, variable lookups, etc) are left to the executor:
+ *  native code returns the index of such an instruction, the executor
+ *  interprets it and then re-enters native code at the next instruction.
+ *
+ *  A function is compiled once its shared JIT state has counted
+ *  DUK_JIT_X64_THRESHOLD function entries and backward jumps.  The state
+ *  and the machine code are shared by a function template and all its
+ *  closures (they share bytecode and constants).  Native code is not
+ *  entered while a debugger is attached, and native backward jumps
+ *  decrement the executor interrupt counter and exit to the executor when
+ *  it runs out so that interrupts (debugger, execution timeout) work as
+ *  usual.  Errors thrown by helpers longjmp past native frames, which
+ *  keep the executor's current pc up-to-date before each helper call.
+ *
+ *  The generated code uses the System V AMD64 calling convention.
+ */
+
+#if !defined(DUK_JS_JIT_X64_H_INCLUDED)
+#define DUK_JS_JIT_X64_H_INCLUDED
+
+#if defined(DUK_USE_JIT_X64)
+
+#if !defined(DUK_F_X64) || !defined(DUK_F_UNIX)
+#error DUK_USE_JIT_X64 requires an x64 Unix target
+#endif
+
+/* Entry count (function entries and backward jumps) triggering compilation. */
+#define DUK_JIT_X64_THRESHOLD            1000
+
+#define DUK_JIT_X64_STATE_COUNTING       0   /* not compiled yet */
+#define DUK_JIT_X64_STATE_COMPILED       1   /* 'entry' is valid */
+#define DUK_JIT_X64_STATE_FAILED         2   /* compilation failed, don't retry */
+
+/* Native entry point: start executing at instruction index 'pc' and return
+ * the index of the instruction the executor should interpret next.
+ */
+typedef duk_uint32_t (*duk_jit_x64_entry)(duk_hthread *thr, duk_uint32_t pc);
+
+struct duk_jitfunc {
+	duk_uint32_t refcount;      /* function template and closures sharing the state */
+	duk_uint32_t state;         /* DUK_JIT_X64_STATE_xxx */
+	duk_uint32_t counter;       /* entries and backward jumps while counting */
+	duk_instr_t *bcode;         /* bytecode base, for pc <-> instruction index */
+	duk_jit_x64_entry entry;    /* native code entry point when compiled */
+	void *code;                 /* executable mapping */
+	duk_size_t code_size;       /* size of executable mapping */
+};
+
+#define DUK_JITFUNC_INCREF(jf) do { \
+		(jf)->refcount++; \
+		DUK_ASSERT((jf)->refcount != 0);  /* Wrap. */ \
+	} while (0)
+
+/*
+ *  Prototypes
+ */
+
+DUK_INTERNAL_DECL duk_jitfunc *duk_jit_x64_alloc(duk_heap *heap, duk_hcompfunc *fun);
+DUK_INTERNAL_DECL void duk_jit_x64_decref(duk_heap *heap, duk_jitfunc *jf);
+DUK_INTERNAL_DECL void duk_jit_x64_compile(duk_heap *heap, duk_hcompfunc *fun);
+
+/* Opcode helpers called from native code, defined in duk_js_executor.c. */
+DUK_INTERNAL_DECL void duk_jit_x64_op_add(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint_fast_t idx_z);
+DUK_INTERNAL_DECL void duk_jit_x64_op_arith(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint_fast_t idx_z, duk_small_uint_fast_t opcode);
+DUK_INTERNAL_DECL void duk_jit_x64_op_bitwise(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y, duk_uint_fast_t idx_z, duk_small_uint_fast_t opcode);
+DUK_INTERNAL_DECL void duk_jit_x64_op_unary(duk_hthread *thr, duk_uint_fast_t idx_src, duk_uint_fast_t idx_dst, duk_small_uint_fast_t opcode);
+DUK_INTERNAL_DECL void duk_jit_x64_op_incdec(duk_hthread *thr, duk_tval *tv_dst, duk_tval *tv_src, duk_small_uint_fast_t opcode);
+DUK_INTERNAL_DECL void duk_jit_x64_op_getprop(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_uint_fast_t idx_dst);
+DUK_INTERNAL_DECL void duk_jit_x64_op_putprop(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_tval *tv_val, duk_small_uint_fast_t is_strict);
+#if defined(DUK_USE_PROP_IC) && !defined(DUK_USE_EXEC_PREFER_SIZE)
+DUK_INTERNAL_DECL void duk_jit_x64_op_getprop_ic(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_uint_fast_t idx_dst);
+DUK_INTERNAL_DECL void duk_jit_x64_op_putprop_ic(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_tval *tv_val, duk_small_uint_fast_t is_strict);
+#endif
+
+#endif  /* DUK_USE_JIT_X64 */
+#endif  /* DUK_JS_JIT_X64_H_INCLUDED */
@@ -573,6 +573,19 @@ DUK_INTERNAL duk_bool_t duk_js_equals_helper(duk_hthread *thr, duk_tval *tv_x, d
 			return DUK_TVAL_GET_POINTER(tv_x) == DUK_TVAL_GET_POINTER(tv_y);
 		}
 		case DUK_TAG_STRING:
+#if defined(DUK_USE_HSTRING_ROPES)
+		{
+			/* Ropes are not interned so they're compared by content.
+			 * This must not allocate: 'thr' may be NULL.
+			 */
+			duk_hstring *h_x = DUK_TVAL_GET_STRING(tv_x);
+			duk_hstring *h_y = DUK_TVAL_GET_STRING(tv_y);
+			if (DUK_UNLIKELY(DUK_HSTRING_IS_ROPE(h_x) || DUK_HSTRING_IS_ROPE(h_y))) {
+				return duk_hstring_rope_equals(h_x, h_y);
+			}
+			return h_x == h_y;
+		}
+#endif
 		case DUK_TAG_OBJECT: {
 			/* Heap pointer comparison suffices for strings and objects.
 			 * Symbols compare equal if they have the same internal
@@ -945,6 +958,8 @@ DUK_INTERNAL duk_bool_t duk_js_compare_helper(duk_hthread *thr, duk_tval *tv_x,
 		duk_hstring *h2 = DUK_TVAL_GET_STRING(tv_y);
 		DUK_ASSERT(h1 != NULL);
 		DUK_ASSERT(h2 != NULL);
+		h1 = DUK_HSTRING_FLATTEN(thr, h1);
+		h2 = DUK_HSTRING_FLATTEN(thr, h2);
 
 		if (DUK_LIKELY(!DUK_HSTRING_HAS_SYMBOL(h1) && !DUK_HSTRING_HAS_SYMBOL(h2))) {
 			rc = duk_js_string_compare(h1, h2);
@@ -0,0 +1,207 @@
+/*
+ *  Property access inline caches (DUK_USE_PROP_IC).
+ *
+ *  See duk_js_propic.h for the data model.  The cache lookup itself is
+ *  inlined into the executor; this file contains table management and the
+ *  slow path which populates cache entries.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_PROP_IC)
+
+/* Allocate an inline cache table for 'fun', or return NULL if the function
+ * has no cacheable instructions or allocation fails.  When 'allow_gc' is
+ * zero a raw allocation is used so that there are no side effects; this is
+ * needed when called from the executor.  The result has refcount 1.
+ */
+DUK_INTERNAL duk_propic *duk_propic_alloc(duk_heap *heap, duk_hcompfunc *fun, duk_bool_t allow_gc) {
+	duk_instr_t *bcode;
+	duk_uint32_t n_code;
+	duk_uint32_t n_cached;
+	duk_uint32_t size;
+	duk_uint32_t pc;
+	duk_size_t alloc_size;
+	duk_propic *ic;
+	duk_propic_entry *ents;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(fun != NULL);
+
+	bcode = DUK_HCOMPFUNC_GET_CODE_BASE(heap, fun);
+	n_code = (duk_uint32_t) DUK_HCOMPFUNC_GET_CODE_COUNT(heap, fun);
+
+	n_cached = 0;
+	for (pc = 0; pc < n_code; pc++) {
+		if (DUK_PROPIC_OP_IS_CACHED(DUK_DEC_OP(bcode[pc]))) {
+			n_cached++;
+		}
+	}
+	if (n_cached == 0) {
+		return NULL;
+	}
+
+	/* Load factor at most 0.5 keeps probe sequences short. */
+	size = 2;
+	while (size < n_cached * 2U) {
+		size <<= 1;
+	}
+
+	alloc_size = sizeof(duk_propic) + (duk_size_t) size * sizeof(duk_propic_entry);
+	if (allow_gc) {
+		ic = (duk_propic *) DUK_ALLOC(heap, alloc_size);
+	} else {
+		ic = (duk_propic *) DUK_ALLOC_RAW(heap, alloc_size);
+	}
+	if (DUK_UNLIKELY(ic == NULL)) {
+		DUK_D(DUK_DPRINT("failed to allocate inline cache for function %p, ignoring", (void *) fun));
+		return NULL;
+	}
+
+	/* All 0xff bytes: unused pc and unused shape ids. */
+	duk_memset((void *) ic, 0xff, alloc_size);
+	ic->refcount = 1;
+	ic->mask = size - 1;
+
+	ents = DUK_PROPIC_GET_ENTRIES(ic);
+	for (pc = 0; pc < n_code; pc++) {
+		duk_uint32_t i;
+
+		if (!DUK_PROPIC_OP_IS_CACHED(DUK_DEC_OP(bcode[pc]))) {
+			continue;
+		}
+		i = pc & ic->mask;
+		while (ents[i].pc != DUK_PROPIC_PC_UNUSED) {
+			i = (i + 1U) & ic->mask;
+		}
+		ents[i].pc = pc;
+		ents[i].used = 0;
+		ents[i].misses = 0;
+	}
+
+	DUK_DD(DUK_DDPRINT("allocated inline cache for function %p: %ld cached instructions, %ld entries",
+	                   (void *) fun, (long) n_cached, (long) size));
+	return ic;
+}
+
+DUK_INTERNAL void duk_propic_decref(duk_heap *heap, duk_propic *ic) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(ic != NULL);
+	DUK_ASSERT(ic->refcount > 0);
+
+	if (--ic->refcount == 0) {
+		DUK_FREE(heap, (void *) ic);
+	}
+}
+
+/* Inline cache miss for the instruction at index 'pc' of 'fun' with base
+ * object 'obj' and constant key 'tv_key'.  'ent' is the cache entry of the
+ * instruction, or NULL if 'fun' has no cache table yet.  Tries to add the
+ * layout of 'obj' to the cache entry and returns a pointer to the property
+ * value on success so that the caller can complete the access without a
+ * full lookup.  Returns NULL if the access is not cacheable, in which case
+ * the caller must use the generic property access path.
+ *
+ * There are no side effects (no allocation which could trigger GC, no
+ * getter calls), so pointers held by the executor remain valid.
+ */
+DUK_INTERNAL duk_tval *duk_propic_fill(duk_hthread *thr, duk_hcompfunc *fun, duk_uint32_t pc, duk_propic_entry *ent, duk_hobject *obj, duk_tval *tv_key, duk_bool_t is_put) {
+	duk_heap *heap;
+	duk_propic *ic;
+	duk_hstring *key;
+	duk_hobject *holder;
+	duk_uint32_t holder_id;
+	duk_int_t e_idx;
+	duk_int_t h_idx;
+	duk_small_uint_t flags;
+	duk_uint32_t way;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(fun != NULL);
+	DUK_ASSERT(obj != NULL);
+	DUK_ASSERT(tv_key != NULL);
+
+	heap = thr->heap;
+	DUK_STATS_INC(heap, stats_propic_miss);
+
+	if (ent == NULL) {
+		DUK_ASSERT(fun->propic == NULL);
+		ic = duk_propic_alloc(heap, fun, 0 /*allow_gc*/);
+		if (ic == NULL) {
+			return NULL;
+		}
+		fun->propic = ic;
+		DUK_PROPIC_FIND_ENTRY(ic, pc, ent);
+	}
+	DUK_ASSERT(ent->pc == pc);
+	DUK_ASSERT(ent->used < DUK_PROPIC_WAYS);
+
+	/* Only plain string keys: array index keys, 'length' (array exotic
+	 * behavior), 'caller' (post-processing of function values), and
+	 * hidden symbols (internal bookkeeping) always take the slow path.
+	 */
+	if (!DUK_TVAL_IS_STRING(tv_key)) {
+		goto uncacheable;
+	}
+	key = DUK_TVAL_GET_STRING(tv_key);
+	if (DUK_HSTRING_GET_ARRIDX_FAST(key) != DUK_HSTRING_NO_ARRAY_INDEX ||
+	    key == DUK_HTHREAD_STRING_LENGTH(thr) ||
+	    key == DUK_HTHREAD_STRING_CALLER(thr) ||
+	    DUK_HSTRING_HAS_HIDDEN(key)) {
+		goto uncacheable;
+	}
+
+	if (!DUK_PROPIC_OBJECT_IS_CACHEABLE(obj) || obj->shape->id == DUK_HSHAPE_ID_NONE) {
+		goto uncacheable;
+	}
+	DUK_ASSERT(DUK_HSHAPE_IS_SHARED(obj->shape));
+
+	holder = obj;
+	holder_id = DUK_HSHAPE_ID_NONE;
+	if (!duk_hobject_find_existing_entry(heap, obj, key, &e_idx, &h_idx)) {
+		if (is_put) {
+			/* Property creation changes the shape, not cached. */
+			goto uncacheable;
+		}
+		holder = DUK_HOBJECT_GET_PROTOTYPE(heap, obj);
+		if (holder == NULL ||
+		    !DUK_PROPIC_OBJECT_IS_CACHEABLE(holder) ||
+		    holder->shape->id == DUK_HSHAPE_ID_NONE) {
+			goto uncacheable;
+		}
+		DUK_ASSERT(DUK_HSHAPE_IS_SHARED(holder->shape));
+		if (!duk_hobject_find_existing_entry(heap, holder, key, &e_idx, &h_idx)) {
+			goto uncacheable;
+		}
+		holder_id = holder->shape->id;
+	}
+	DUK_ASSERT(e_idx >= 0);
+
+	flags = (duk_small_uint_t) DUK_HOBJECT_E_GET_FLAGS(heap, holder, e_idx);
+	if (flags & DUK_PROPDESC_FLAG_ACCESSOR) {
+		goto uncacheable;
+	}
+	if (is_put && !(flags & DUK_PROPDESC_FLAG_WRITABLE)) {
+		goto uncacheable;
+	}
+
+	way = ent->used++;
+	ent->shape_id[way] = obj->shape->id;
+	ent->holder_id[way] = holder_id;
+	ent->slot[way] = (duk_uint32_t) e_idx;
+
+	DUK_DD(DUK_DDPRINT("inline cache fill: fun=%p, pc=%ld, way=%ld, key=%!O, shape_id=%ld, holder_id=%ld, slot=%ld",
+	                   (void *) fun, (long) pc, (long) way, (duk_heaphdr *) key,
+	                   (long) obj->shape->id, (long) holder_id, (long) e_idx));
+
+	return DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(heap, holder, e_idx);
+
+ uncacheable:
+	if (++ent->misses >= DUK_PROPIC_MAX_MISSES) {
+		DUK_DD(DUK_DDPRINT("inline cache site fun=%p, pc=%ld no longer updated", (void *) fun, (long) pc));
+		ent->used = DUK_PROPIC_WAYS;
+	}
+	return NULL;
+}
+
+#endif  /* DUK_USE_PROP_IC */
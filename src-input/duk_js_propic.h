@@ -0,0 +1,112 @@
+/*
+ *  Property access inline caches (DUK_USE_PROP_IC).
+ *
+ *  Each compiled function may have an inline cache table with one entry
+ *  per GETPROP/GETPROPC/PUTPROP instruction which has a constant key.  An
+ *  entry remembers up to DUK_PROPIC_WAYS (receiver shape, holder shape,
+ *  slot) combinations seen at that instruction: the first combination makes
+ *  the site monomorphic, further ones make it polymorphic, and once all ways
+ *  are in use the site is megamorphic and the cache is no longer updated.
+ *  A site whose accesses repeatedly turn out to be uncacheable (e.g. deep
+ *  inheritance or accessors) is likewise no longer updated, so that it only
+ *  pays for a failed probe rather than for repeated cache fill attempts.
+ *
+ *  Layouts are identified using shape ids (see duk_hshape.h) rather than
+ *  shape pointers: ids are never reused so a cache entry can never match a
+ *  different layout even after the original shape has been freed, and the
+ *  cache holds no references that would need to be tracked by GC.  Only
+ *  shared shapes have ids; objects with dictionary shapes are never cached.
+ *
+ *  A cached property is either an own data property of the receiver
+ *  (holder id DUK_HSHAPE_ID_NONE) or, for reads, a data property of the
+ *  receiver's immediate prototype (holder id is the prototype's shape id).
+ *  In the latter case the receiver shape id guarantees the key is not an
+ *  own property, and the prototype pointer is read from the receiver so
+ *  that the holder is always live.
+ *
+ *  The table is shared by a function template and all closures created
+ *  from it, and has a reference count of its own.  Entries are located by
+ *  instruction index using linear probing; all cacheable instructions are
+ *  inserted when the table is created so a probe always terminates.
+ */
+
+#if !defined(DUK_JS_PROPIC_H_INCLUDED)
+#define DUK_JS_PROPIC_H_INCLUDED
+
+#if defined(DUK_USE_PROP_IC)
+
+#if !defined(DUK_USE_HOBJECT_SHAPES)
+#error DUK_USE_PROP_IC requires DUK_USE_HOBJECT_SHAPES
+#endif
+
+/* Number of (receiver, holder, slot) combinations cached per instruction. */
+#define DUK_PROPIC_WAYS                  4
+
+/* Number of uncacheable misses after which a site is no longer updated. */
+#define DUK_PROPIC_MAX_MISSES            8
+
+/* Unused entry pc and unused way shape id; a table is initialized by
+ * filling it with 0xff bytes.
+ */
+#define DUK_PROPIC_PC_UNUSED             0xffffffffUL
+#define DUK_PROPIC_ID_UNUSED             0xffffffffUL
+
+/* Object flags which prevent caching: any exotic [[Get]]/[[Put]] behavior
+ * except for arrays, whose exotic behavior only concerns 'length' and
+ * index keys which are never cached.
+ */
+#define DUK_PROPIC_UNCACHEABLE_FLAGS     (DUK_HOBJECT_EXOTIC_BEHAVIOR_FLAGS & ~DUK_HOBJECT_FLAG_EXOTIC_ARRAY)
+#define DUK_PROPIC_OBJECT_IS_CACHEABLE(h) \
+	(!DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_PROPIC_UNCACHEABLE_FLAGS))
+
+/* Opcodes with an inline cache entry: key must be a constant. */
+#define DUK_PROPIC_OP_IS_CACHED(op) \
+	((op) == DUK_OP_GETPROP_RC || (op) == DUK_OP_GETPROPC_RC || \
+	 (op) == DUK_OP_PUTPROP_CR || (op) == DUK_OP_PUTPROP_CC)
+
+struct duk_propic_entry {
+	duk_uint32_t pc;                          /* instruction index, DUK_PROPIC_PC_UNUSED if unused */
+	duk_uint32_t used;                        /* number of ways in use, DUK_PROPIC_WAYS when no longer updated */
+	duk_uint32_t misses;                      /* number of uncacheable misses */
+	duk_uint32_t shape_id[DUK_PROPIC_WAYS];   /* receiver shape id */
+	duk_uint32_t holder_id[DUK_PROPIC_WAYS];  /* prototype shape id, DUK_HSHAPE_ID_NONE for own property */
+	duk_uint32_t slot[DUK_PROPIC_WAYS];       /* entry part index in holder */
+};
+
+struct duk_propic {
+	duk_uint32_t refcount;  /* function template and closures sharing the table */
+	duk_uint32_t mask;      /* entry count minus one, entry count is a power of two */
+
+	/* Followed by (mask + 1) duk_propic_entry structs. */
+};
+
+#define DUK_PROPIC_GET_ENTRIES(ic)       ((duk_propic_entry *) (void *) ((ic) + 1))
+
+#define DUK_PROPIC_INCREF(ic) do { \
+		(ic)->refcount++; \
+		DUK_ASSERT((ic)->refcount != 0);  /* Wrap. */ \
+	} while (0)
+
+/* Locate the entry for instruction index 'pc', which must be a cached
+ * instruction of the function owning the table.
+ */
+#define DUK_PROPIC_FIND_ENTRY(ic,pc,out_ent) do { \
+		duk_propic_entry *duk__ents = DUK_PROPIC_GET_ENTRIES((ic)); \
+		duk_uint32_t duk__i = (pc) & (ic)->mask; \
+		while (duk__ents[duk__i].pc != (pc)) { \
+			DUK_ASSERT(duk__ents[duk__i].pc != DUK_PROPIC_PC_UNUSED); \
+			duk__i = (duk__i + 1U) & (ic)->mask; \
+		} \
+		(out_ent) = duk__ents + duk__i; \
+	} while (0)
+
+/*
+ *  Prototypes
+ */
+
+DUK_INTERNAL_DECL duk_propic *duk_propic_alloc(duk_heap *heap, duk_hcompfunc *fun, duk_bool_t allow_gc);
+DUK_INTERNAL_DECL void duk_propic_decref(duk_heap *heap, duk_propic *ic);
+DUK_INTERNAL_DECL duk_tval *duk_propic_fill(duk_hthread *thr, duk_hcompfunc *fun, duk_uint32_t pc, duk_propic_entry *ent, duk_hobject *obj, duk_tval *tv_key, duk_bool_t is_put);
+
+#endif  /* DUK_USE_PROP_IC */
+#endif  /* DUK_JS_PROPIC_H_INCLUDED */
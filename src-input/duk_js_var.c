@@ -161,6 +161,32 @@ void duk_js_push_closure(duk_hthread *thr,
 	DUK_HBUFFER_INCREF(thr, DUK_HCOMPFUNC_GET_DATA(thr->heap, fun_clos));
 	duk__inc_data_inner_refcounts(thr, fun_temp);
 
+#if defined(DUK_USE_PROP_IC)
+	/* Inline caches are shared by all closures of the template so that
+	 * e.g. a callback closure created in a loop starts out warm.  Both
+	 * functions are reachable, so a GC triggered here is harmless.
+	 */
+	if (fun_temp->propic == NULL) {
+		fun_temp->propic = duk_propic_alloc(thr->heap, fun_temp, 1 /*allow_gc*/);
+	}
+	fun_clos->propic = fun_temp->propic;
+	if (fun_clos->propic != NULL) {
+		DUK_PROPIC_INCREF(fun_clos->propic);
+	}
+#endif
+#if defined(DUK_USE_JIT_X64)
+	/* JIT state is shared the same way, so that entries of all closures
+	 * count towards compilation and share the native code.
+	 */
+	if (fun_temp->jit == NULL) {
+		fun_temp->jit = duk_jit_x64_alloc(thr->heap, fun_temp);
+	}
+	fun_clos->jit = fun_temp->jit;
+	if (fun_clos->jit != NULL) {
+		DUK_JITFUNC_INCREF(fun_clos->jit);
+	}
+#endif
+
 	fun_clos->nregs = fun_temp->nregs;
 	fun_clos->nargs = fun_temp->nargs;
 #if defined(DUK_USE_DEBUGGER_SUPPORT)
@@ -187,8 +213,13 @@ void duk_js_push_closure(duk_hthread *thr,
 	 * separately if necessary.
 	 */
 
-	/* DUK_HEAPHDR_SET_FLAGS() masks changes to non-duk_heaphdr flags only. */
-	DUK_HEAPHDR_SET_FLAGS((duk_heaphdr *) fun_clos, DUK_HEAPHDR_GET_FLAGS_RAW((duk_heaphdr *) fun_temp));
+	/* DUK_HEAPHDR_SET_FLAGS() masks changes to non-duk_heaphdr flags only.
+	 * The mark state of fun_clos is kept: with incremental mark-and-sweep
+	 * fun_clos may already be grey (queued for scanning) at this point.
+	 */
+	DUK_HEAPHDR_SET_FLAGS((duk_heaphdr *) fun_clos,
+	                      (DUK_HEAPHDR_GET_FLAGS_RAW((duk_heaphdr *) fun_temp) & ~(DUK_HEAPHDR_FLAG_REACHABLE | DUK_HEAPHDR_FLAG_TEMPROOT)) |
+	                      (DUK_HEAPHDR_GET_FLAGS_RAW((duk_heaphdr *) fun_clos) & (DUK_HEAPHDR_FLAG_REACHABLE | DUK_HEAPHDR_FLAG_TEMPROOT)));
 	DUK_DD(DUK_DDPRINT("fun_temp heaphdr flags: 0x%08lx, fun_clos heaphdr flags: 0x%08lx",
 	                   (unsigned long) DUK_HEAPHDR_GET_FLAGS_RAW((duk_heaphdr *) fun_temp),
 	                   (unsigned long) DUK_HEAPHDR_GET_FLAGS_RAW((duk_heaphdr *) fun_clos)));
@@ -1628,6 +1659,7 @@ duk_bool_t duk__declvar_helper(duk_hthread *thr,
 			 * a simple call (like for the ancestor case).
 			 */
 			DUK_DDD(DUK_DDDPRINT("redefine, offending property in global object itself"));
+			DUK_HOBJECT_ENSURE_DICT_SHAPE(thr, holder);
 
 			if (flags & DUK_PROPDESC_FLAG_ACCESSOR) {
 				duk_hobject *tmp;
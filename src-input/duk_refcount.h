@@ -24,6 +24,30 @@
 #define DUK_HEAPHDR_NEEDS_REFCOUNT_UPDATE(h)  1
 #endif  /* DUK_USE_ROM_OBJECTS */
 
+/* Incremental mark-and-sweep write barrier: while marking is in progress
+ * a new reference to an unmarked target shades the target, so that a
+ * reference stored into an already scanned object is never missed.
+ * Every reference store INCREFs its target so INCREF is a natural place
+ * for the barrier; reference moves without an INCREF need an explicit
+ * barrier.  The barrier never allocates or has other side effects.
+ */
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+#define DUK_HEAPHDR_MS_INCR_BARRIER(heap,h) do { \
+		if (DUK_UNLIKELY((heap)->ms_incr_marking != 0U) && !DUK_HEAPHDR_HAS_REACHABLE((h))) { \
+			duk_heap_ms_incr_shade((heap), (h)); \
+		} \
+	} while (0)
+#define DUK_TVAL_MS_INCR_BARRIER(heap,tv) do { \
+		if (DUK_UNLIKELY((heap)->ms_incr_marking != 0U) && DUK_TVAL_IS_HEAP_ALLOCATED((tv)) && \
+		    !DUK_HEAPHDR_HAS_REACHABLE(DUK_TVAL_GET_HEAPHDR((tv)))) { \
+			duk_heap_ms_incr_shade((heap), DUK_TVAL_GET_HEAPHDR((tv))); \
+		} \
+	} while (0)
+#else
+#define DUK_HEAPHDR_MS_INCR_BARRIER(heap,h)  do {} while (0)
+#define DUK_TVAL_MS_INCR_BARRIER(heap,tv)    do {} while (0)
+#endif
+
 /* Fast variants, inline refcount operations except for refzero handling.
  * Can be used explicitly when speed is always more important than size.
  * For a good compiler and a single file build, these are basically the
@@ -38,6 +62,7 @@
 			DUK_ASSERT(DUK_HEAPHDR_HTYPE_VALID(duk__h)); \
 			DUK_HEAPHDR_PREINC_REFCOUNT(duk__h); \
 			DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT(duk__h) != 0);  /* No wrapping. */ \
+			DUK_HEAPHDR_MS_INCR_BARRIER((thr)->heap, duk__h); \
 		} \
 	} while (0)
 #define DUK_TVAL_DECREF_FAST(thr,tv) do { \
@@ -73,6 +98,7 @@
 		if (DUK_HEAPHDR_NEEDS_REFCOUNT_UPDATE(duk__h)) { \
 			DUK_HEAPHDR_PREINC_REFCOUNT(duk__h); \
 			DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT(duk__h) != 0);  /* No wrapping. */ \
+			DUK_HEAPHDR_MS_INCR_BARRIER((thr)->heap, duk__h); \
 		} \
 	} while (0)
 #define DUK_HEAPHDR_DECREF_FAST_RAW(thr,h,rzcall,rzcast) do { \
@@ -94,19 +120,40 @@
 /* Slow variants, call to a helper to reduce code size.
  * Can be used explicitly when size is always more important than speed.
  */
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+/* The write barrier needs the heap which the INCREF helpers don't get. */
+#define DUK_TVAL_INCREF_SLOW(thr,tv)         DUK_TVAL_INCREF_FAST((thr), (tv))
+#else
 #define DUK_TVAL_INCREF_SLOW(thr,tv)         do { duk_tval_incref((tv)); } while (0)
+#endif
 #define DUK_TVAL_DECREF_SLOW(thr,tv)         do { duk_tval_decref((thr), (tv)); } while (0)
 #define DUK_TVAL_DECREF_NORZ_SLOW(thr,tv)    do { duk_tval_decref_norz((thr), (tv)); } while (0)
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+#define DUK_HEAPHDR_INCREF_SLOW(thr,h)       DUK_HEAPHDR_INCREF_FAST((thr), (h))
+#else
 #define DUK_HEAPHDR_INCREF_SLOW(thr,h)       do { duk_heaphdr_incref((duk_heaphdr *) (h)); } while (0)
+#endif
 #define DUK_HEAPHDR_DECREF_SLOW(thr,h)       do { duk_heaphdr_decref((thr), (duk_heaphdr *) (h)); } while (0)
 #define DUK_HEAPHDR_DECREF_NORZ_SLOW(thr,h)  do { duk_heaphdr_decref_norz((thr), (duk_heaphdr *) (h)); } while (0)
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+#define DUK_HSTRING_INCREF_SLOW(thr,h)       DUK_HEAPHDR_INCREF_FAST((thr), (h))
+#else
 #define DUK_HSTRING_INCREF_SLOW(thr,h)       do { duk_heaphdr_incref((duk_heaphdr *) (h)); } while (0)
+#endif
 #define DUK_HSTRING_DECREF_SLOW(thr,h)       do { duk_heaphdr_decref((thr), (duk_heaphdr *) (h)); } while (0)
 #define DUK_HSTRING_DECREF_NORZ_SLOW(thr,h)  do { duk_heaphdr_decref_norz((thr), (duk_heaphdr *) (h)); } while (0)
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+#define DUK_HBUFFER_INCREF_SLOW(thr,h)       DUK_HEAPHDR_INCREF_FAST((thr), (h))
+#else
 #define DUK_HBUFFER_INCREF_SLOW(thr,h)       do { duk_heaphdr_incref((duk_heaphdr *) (h)); } while (0)
+#endif
 #define DUK_HBUFFER_DECREF_SLOW(thr,h)       do { duk_heaphdr_decref((thr), (duk_heaphdr *) (h)); } while (0)
 #define DUK_HBUFFER_DECREF_NORZ_SLOW(thr,h)  do { duk_heaphdr_decref_norz((thr), (duk_heaphdr *) (h)); } while (0)
+#if defined(DUK_USE_MARK_AND_SWEEP_INCREMENTAL)
+#define DUK_HOBJECT_INCREF_SLOW(thr,h)       DUK_HEAPHDR_INCREF_FAST((thr), (h))
+#else
 #define DUK_HOBJECT_INCREF_SLOW(thr,h)       do { duk_heaphdr_incref((duk_heaphdr *) (h)); } while (0)
+#endif
 #define DUK_HOBJECT_DECREF_SLOW(thr,h)       do { duk_heaphdr_decref((thr), (duk_heaphdr *) (h)); } while (0)
 #define DUK_HOBJECT_DECREF_NORZ_SLOW(thr,h)  do { duk_heaphdr_decref_norz((thr), (duk_heaphdr *) (h)); } while (0)
 
@@ -684,6 +731,123 @@
 		DUK_TVAL_SET_U32(duk__dst, duk__val); \
 	} while (0)
 
+/*
+ *  Deferred refzero for executor register writes (DUK_USE_REFZERO_DEFER).
+ *
+ *  When a register write drops the last reference to the old value, the
+ *  refcount is restored to 1 and the value is appended to a small table
+ *  owned by the heap instead of running refzero (and the free cascade and
+ *  finalizers) inline.  The table is reconciled in one batch at function
+ *  return, before mark-and-sweep, and when it fills up.  A value which
+ *  gets referenced again in the meantime simply survives the batch DECREF.
+ */
+
+#if defined(DUK_USE_REFZERO_DEFER)
+#if !defined(DUK_USE_REFERENCE_COUNTING)
+#error DUK_USE_REFZERO_DEFER requires DUK_USE_REFERENCE_COUNTING
+#endif
+
+#define DUK_TVAL_DECREF_DEFER(thr,tv) do { \
+		duk_tval *duk__tv = (tv); \
+		DUK_ASSERT(duk__tv != NULL); \
+		if (DUK_TVAL_NEEDS_REFCOUNT_UPDATE(duk__tv)) { \
+			duk_heaphdr *duk__h = DUK_TVAL_GET_HEAPHDR(duk__tv); \
+			DUK_ASSERT(duk__h != NULL); \
+			DUK_ASSERT(DUK_HEAPHDR_HTYPE_VALID(duk__h)); \
+			DUK_ASSERT(DUK_HEAPHDR_GET_REFCOUNT(duk__h) > 0); \
+			if (DUK_HEAPHDR_PREDEC_REFCOUNT(duk__h) == 0) { \
+				duk_heap_refzero_defer((thr), duk__h); \
+			} \
+		} \
+	} while (0)
+
+#define DUK_TVAL_SET_UNDEFINED_UPDREF_DEFER(thr,tvptr_dst) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_UNDEFINED(tv__dst); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#define DUK_TVAL_SET_NULL_UPDREF_DEFER(thr,tvptr_dst) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_NULL(tv__dst); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#define DUK_TVAL_SET_BOOLEAN_UPDREF_DEFER(thr,tvptr_dst,newval) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_BOOLEAN(tv__dst, (newval)); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#define DUK_TVAL_SET_NUMBER_UPDREF_DEFER(thr,tvptr_dst,newval) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_NUMBER(tv__dst, (newval)); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#define DUK_TVAL_SET_NUMBER_CHKFAST_UPDREF_DEFER(thr,tvptr_dst,newval) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_NUMBER_CHKFAST_FAST(tv__dst, (newval)); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#if defined(DUK_USE_FASTINT)
+#define DUK_TVAL_SET_I48_UPDREF_DEFER(thr,tvptr_dst,newval) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_I48(tv__dst, (newval)); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#define DUK_TVAL_SET_I32_UPDREF_DEFER(thr,tvptr_dst,newval) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_I32(tv__dst, (newval)); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#else
+#define DUK_TVAL_SET_I48_UPDREF_DEFER(thr,tvptr_dst,newval) \
+	DUK_TVAL_SET_NUMBER_UPDREF_DEFER((thr), (tvptr_dst), (duk_double_t) (newval))
+#define DUK_TVAL_SET_I32_UPDREF_DEFER(thr,tvptr_dst,newval) \
+	DUK_TVAL_SET_NUMBER_UPDREF_DEFER((thr), (tvptr_dst), (duk_double_t) (newval))
+#endif  /* DUK_USE_FASTINT */
+#define DUK_TVAL_SET_FASTINT_UPDREF_DEFER     DUK_TVAL_SET_I48_UPDREF_DEFER  /* convenience */
+#define DUK_TVAL_SET_STRING_UPDREF_DEFER(thr,tvptr_dst,newval) do { \
+		duk_tval *tv__dst; duk_tval tv__tmp; tv__dst = (tvptr_dst); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_STRING(tv__dst, (newval)); \
+		DUK_HSTRING_INCREF((thr), (newval)); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+#define DUK_TVAL_SET_TVAL_UPDREF_DEFER(thr,tvptr_dst,tvptr_src) do { \
+		duk_tval *tv__dst, *tv__src; duk_tval tv__tmp; \
+		tv__dst = (tvptr_dst); tv__src = (tvptr_src); \
+		DUK_TVAL_SET_TVAL(&tv__tmp, tv__dst); \
+		DUK_TVAL_SET_TVAL(tv__dst, tv__src); \
+		DUK_TVAL_INCREF_FAST((thr), tv__src); \
+		DUK_TVAL_DECREF_DEFER((thr), &tv__tmp); \
+	} while (0)
+
+/* Reconcile at a point where side effects are allowed (e.g. function return). */
+#define DUK_REFZERO_DEFER_FLUSH(thr) do { \
+		if (DUK_UNLIKELY((thr)->heap->refzero_defer_top != 0U)) { \
+			duk_heap_refzero_defer_flush((thr)->heap, 0 /*skip_finalizers*/); \
+		} \
+	} while (0)
+#else  /* DUK_USE_REFZERO_DEFER */
+#define DUK_TVAL_DECREF_DEFER                       DUK_TVAL_DECREF
+#define DUK_TVAL_SET_UNDEFINED_UPDREF_DEFER         DUK_TVAL_SET_UNDEFINED_UPDREF
+#define DUK_TVAL_SET_NULL_UPDREF_DEFER              DUK_TVAL_SET_NULL_UPDREF
+#define DUK_TVAL_SET_BOOLEAN_UPDREF_DEFER           DUK_TVAL_SET_BOOLEAN_UPDREF
+#define DUK_TVAL_SET_NUMBER_UPDREF_DEFER            DUK_TVAL_SET_NUMBER_UPDREF
+#define DUK_TVAL_SET_NUMBER_CHKFAST_UPDREF_DEFER    DUK_TVAL_SET_NUMBER_CHKFAST_UPDREF
+#define DUK_TVAL_SET_I48_UPDREF_DEFER               DUK_TVAL_SET_I48_UPDREF
+#define DUK_TVAL_SET_I32_UPDREF_DEFER               DUK_TVAL_SET_I32_UPDREF
+#define DUK_TVAL_SET_FASTINT_UPDREF_DEFER           DUK_TVAL_SET_FASTINT_UPDREF
+#define DUK_TVAL_SET_STRING_UPDREF_DEFER            DUK_TVAL_SET_STRING_UPDREF
+#define DUK_TVAL_SET_TVAL_UPDREF_DEFER              DUK_TVAL_SET_TVAL_UPDREF_FAST
+#define DUK_REFZERO_DEFER_FLUSH(thr)                do {} while (0)
+#endif  /* DUK_USE_REFZERO_DEFER */
+
 /*
  *  Prototypes
  */
@@ -705,6 +869,10 @@ DUK_INTERNAL_DECL void duk_hobject_decref_norz(duk_hthread *thr, duk_hobject *h)
 #endif
 DUK_INTERNAL_DECL void duk_heaphdr_refzero(duk_hthread *thr, duk_heaphdr *h);
 DUK_INTERNAL_DECL void duk_heaphdr_refzero_norz(duk_hthread *thr, duk_heaphdr *h);
+#if defined(DUK_USE_REFZERO_DEFER)
+DUK_INTERNAL_DECL void duk_heap_refzero_defer(duk_hthread *thr, duk_heaphdr *h);
+DUK_INTERNAL_DECL void duk_heap_refzero_defer_flush(duk_heap *heap, duk_bool_t skip_finalizers);
+#endif
 #if defined(DUK_USE_FAST_REFCOUNT_DEFAULT)
 DUK_INTERNAL_DECL void duk_hstring_refzero(duk_hthread *thr, duk_hstring *h);  /* no 'norz' variant */
 DUK_INTERNAL_DECL void duk_hbuffer_refzero(duk_hthread *thr, duk_hbuffer *h);  /* no 'norz' variant */
@@ -0,0 +1,44 @@
+/*
+ *  duk_inspect_heap()
+ */
+
+/*===
+*** test_basic (duk_safe_call)
+top after: 1
+result is object: 1
+gcCycles type ok: 1
+gcSlices type ok: 1
+gcPauseMax type ok: 1
+final top: 0
+==> rc=0, result='undefined'
+===*/
+
+static duk_ret_t test_basic(duk_context *ctx, void *udata) {
+	const char *keys[] = { "gcCycles", "gcSlices", "gcPauseMax", NULL };
+	const char **p;
+
+	(void) udata;
+
+	duk_eval_string_noresult(ctx,
+		"var arr = [];\n"
+		"for (var i = 0; i < 100000; i++) { arr.push({ self: arr }); arr = [ arr ]; }\n");
+
+	duk_inspect_heap(ctx);
+	printf("top after: %ld\n", (long) duk_get_top(ctx));
+	printf("result is object: %ld\n", (long) duk_is_object(ctx, -1));
+
+	/* Statistics are only present with incremental mark-and-sweep. */
+	for (p = keys; *p != NULL; p++) {
+		duk_get_prop_string(ctx, -1, *p);
+		printf("%s type ok: %ld\n", *p, (long) (duk_is_undefined(ctx, -1) || duk_is_number(ctx, -1)));
+		duk_pop(ctx);
+	}
+	duk_pop(ctx);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_basic);
+}
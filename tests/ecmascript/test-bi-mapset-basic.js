@@ -0,0 +1,53 @@
+/*
+ *  Map and Set (DUK_USE_MAP_SET_BUILTIN): SameValueZero keys, insertion
+ *  order, forEach() with mutation during iteration, copy construction,
+ *  large tables with deletes, and argument validation.
+ */
+
+/*===
+4 a b n z true Infinity
+A 4
+true false 3
+1,0,late
+obj undefined
+[object Map] [object Set] [object WeakMap] [object WeakSet]
+4 helo
+50000 99999 undefined
+50000 1
+[1,2]
+TypeError
+TypeError
+TypeError
+1 false undefined false
+true
+true true
+0 undefined
+0 0 2 1 Map
+10 1
+===*/
+
+var m = new Map([[1,'a'],['1','b'],[NaN,'n'],[-0,'z']]);
+var zeroKey;
+m.forEach(function (v, k) { if (v === 'z') { zeroKey = k; } });  // -0 is normalized to +0
+print(m.size, m.get(1), m.get('1'), m.get(NaN), m.get(0), m.has(+0), 1 / zeroKey);
+m.set(1, 'A'); print(m.get(1), m.size);
+print(m.delete(1), m.delete(1), m.size);
+var keys=[]; m.forEach(function (v, k, mm) { keys.push(String(k)); if (k === '1') { m.delete(NaN); m.set('late', 1); } }); print(keys.join());
+var o = {}; m.set(o, 'obj'); print(m.get(o), m.get({}));
+print(Object.prototype.toString.call(m), String(new Set()), String(new WeakMap()), String(new WeakSet()));
+var s = new Set('hello'); var a=[]; s.forEach(function(v){a.push(v)}); print(s.size, a.join(''));
+var big = new Map(); for (var i = 0; i < 100000; i++) big.set('k' + i, i);
+for (i = 0; i < 100000; i += 2) big.delete('k' + i);
+print(big.size, big.get('k99999'), big.get('k0'));
+var c = new Map(big); print(c.size, c.get('k1'));
+var ss = new Set(new Map([[1,2]])); ss.forEach(function(v){print(JSON.stringify(v))});
+try { new WeakMap().set(1, 2) } catch (e) { print(e.name) }
+try { Map.prototype.get.call(new WeakMap(), {}) } catch (e) { print(e.name) }
+try { Map() } catch (e) { print(e.name) }
+var wm = new WeakMap(); var k1 = {}; wm.set(k1, {v:1}); print(wm.get(k1).v, wm.has({}), wm.get(1), wm.delete(1));
+(function () { for (var i = 0; i < 1000; i++) { wm.set({}, {big: new Array(100)}); } })();
+Duktape.gc(); print(wm.has(k1));
+var ws = new WeakSet([k1]); print(ws.has(k1), ws.add(k1) === ws);
+m.clear(); print(m.size, m.get('1'));
+print(Map.length, Set.length, Map.prototype.set.length, Set.prototype.add.length, Map.name);
+var cnt=0; var mm = new Map([[1,1],[2,2],[3,3]]); mm.forEach(function(v,k){ cnt++; if (cnt < 10) { mm.clear(); mm.set(k+10, 0);} }); print(cnt, mm.size);
@@ -0,0 +1,43 @@
+/*
+ *  WeakMap values are only kept alive while their key is reachable
+ *  (ephemerons), also through chains of weak entries and when the value
+ *  refers back to its own key.
+ */
+
+/*===
+gc 1
+v finalized
+cycle finalized
+gc 2
+drop root
+bv finalized
+done
+===*/
+
+var wm = new WeakMap();
+var root = {};
+function fin(o) { print(o.name + ' finalized'); }
+function setup() {
+    var k = {}, v = { name: 'v' };
+    Duktape.fin(v, fin);
+    wm.set(k, v);
+    var a = {}, b = {}, bv = { name: 'bv' };
+    Duktape.fin(bv, fin);
+    wm.set(root, a);
+    wm.set(a, b);
+    wm.set(b, bv);
+    var cyc = {}, cv = { name: 'cycle', ref: null };
+    cv.ref = cyc;
+    Duktape.fin(cv, fin);
+    wm.set(cyc, cv);
+}
+setup();
+print('gc 1');
+Duktape.gc();
+print('gc 2');
+Duktape.gc();
+print('drop root');
+root = null;
+Duktape.gc();
+Duktape.gc();
+print('done');
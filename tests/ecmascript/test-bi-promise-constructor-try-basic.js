@@ -1,11 +1,5 @@
 // https://github.com/tc39/proposal-promise-try
 
-/*---
-{
-    "skip": true
-}
----*/
-
 /*@include util-base.js@*/
 
 /*===
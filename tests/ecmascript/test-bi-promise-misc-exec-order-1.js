@@ -17,12 +17,6 @@
 // are important; they may have observable consequences on the reaction
 // ordering guaranteed by ES2015.
 
-/*---
-{
-    "skip": true
-}
----*/
-
 /*===
 P1 executor
 P2 executor
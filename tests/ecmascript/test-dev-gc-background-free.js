@@ -0,0 +1,82 @@
+/*
+ *  Garbage of every heap type (objects with property tables, compiled
+ *  functions, threads with callstacks, buffers, strings) is freed while
+ *  the script keeps allocating.  With DUK_USE_MARK_AND_SWEEP_BACKGROUND_FREE
+ *  the memory is released on a helper thread; live values must be intact.
+ */
+
+/*===
+live 200 19900 true
+strings 200 true
+buffers 200 19900
+threads 50 1225
+gc true
+done
+===*/
+
+var live = [];
+var strs = [];
+var bufs = [];
+var i, j;
+
+function garbage(n) {
+    // Reference cycle so only mark-and-sweep frees it.
+    var o = { n: n, arr: [ n, n + 1, n + 2 ] };
+    o.self = o;
+    o.fn = function () { return o.n; };
+    o.str = 'garbage-' + n + '-' + Math.random();
+    o.buf = new Uint8Array(64 + (n % 64));
+    o.thr = new Duktape.Thread(function (v) { return v; });
+    return o;
+}
+
+for (i = 0; i < 200; i++) {
+    for (j = 0; j < 200; j++) {
+        garbage(j);
+    }
+    live.push({ i: i, self: null });
+    live[i].self = live[i];
+    strs.push('live-' + i);
+    bufs.push(new Uint8Array([ i ]));
+}
+
+var sum = 0;
+var ok = true;
+for (i = 0; i < live.length; i++) {
+    sum += live[i].i;
+    if (live[i].self !== live[i]) { ok = false; }
+}
+print('live', live.length, sum, ok);
+
+ok = true;
+for (i = 0; i < strs.length; i++) {
+    if (strs[i] !== 'live-' + i) { ok = false; }
+}
+print('strings', strs.length, ok);
+
+sum = 0;
+for (i = 0; i < bufs.length; i++) { sum += bufs[i][0]; }
+print('buffers', bufs.length, sum);
+
+// Threads with active callstacks become garbage while suspended.
+sum = 0;
+for (i = 0; i < 50; i++) {
+    var t = new Duktape.Thread(function (v) {
+        function inner(x) { Duktape.Thread.yield(x); return x; }
+        try { inner(v); } catch (e) { }
+        return v;
+    });
+    sum += Duktape.Thread.resume(t, i);
+    t = null;
+    for (j = 0; j < 100; j++) { garbage(j); }
+}
+print('threads', 50, sum);
+
+// Explicit GC waits for the helper thread; repeated calls must be safe.
+for (i = 0; i < 10; i++) {
+    garbage(i);
+    Duktape.gc();
+}
+print('gc', live[199].self.i === 199);
+
+print('done');
@@ -0,0 +1,85 @@
+/*
+ *  Allocation pressure with cyclic garbage, finalizers, weak keys,
+ *  coroutines, closures and concatenated strings.  With incremental
+ *  mark-and-sweep (DUK_USE_MARK_AND_SWEEP_INCREMENTAL) the voluntary GC
+ *  runs in slices interleaved with this code, so live values are mutated
+ *  while a cycle is in progress.
+ */
+
+/*===
+sum 4189583 500 true
+closures 20000 true
+done
+===*/
+
+var keep = [];
+var wm = new WeakMap();
+var finCount = 0;
+var rescued = [];
+var fns = [];
+
+function mk(i) {
+    var o = { id: i, self: null, arr: [i, 'x' + i] };
+    o.self = o;
+    return o;
+}
+
+function mkClosure(i) {
+    return function () { return i; };
+}
+
+for (var round = 0; round < 30; round++) {
+    for (var i = 0; i < 3000; i++) {
+        var o = mk(i);
+        if (i % 7 === 0) { keep.push(o); }
+        if (i % 11 === 0) {
+            var k = {};
+            wm.set(k, { v: i });
+            if (i % 22 === 0) { keep.push(k); }
+        }
+        if (i % 97 === 0) {
+            var f = { n: i };
+            Duktape.fin(f, function (x) {
+                finCount++;
+                if (x.n % 2 === 0) { rescued.push(x); }
+            });
+        }
+        var s = '';
+        for (var j = 0; j < 5; j++) { s += 'abc' + j; }
+        keep.push(s);
+        fns.push(mkClosure(i));
+    }
+
+    // Live coroutine whose value stack changes between slices.
+    var t = new Duktape.Thread(function (v) {
+        var acc = [];
+        for (var q = 0; q < 500; q++) {
+            acc.push({ q: q });
+            Duktape.Thread.yield(acc.length);
+        }
+        return acc.length;
+    });
+    var r;
+    for (var q = 0; q < 501; q++) { r = Duktape.Thread.resume(t, q); }
+
+    if (keep.length > 20000) { keep = keep.slice(10000); }
+    if (fns.length > 20000) { fns = fns.slice(fns.length - 20000); }
+    if (rescued.length > 50) { rescued = []; }
+}
+
+var sum = 0;
+for (i = 0; i < keep.length; i++) {
+    var v = keep[i];
+    if (typeof v === 'object' && v.self === v) { sum += v.arr[0]; }
+    if (typeof v === 'object' && wm.has(v)) { sum += wm.get(v).v; }
+}
+print('sum', sum, r, finCount > 0);
+
+var ok = true;
+for (i = 0; i < fns.length; i++) {
+    if (fns[i]() !== (i + 3000 * 30 - fns.length) % 3000) { ok = false; }
+}
+print('closures', fns.length, ok);
+
+Duktape.gc();
+print('done');
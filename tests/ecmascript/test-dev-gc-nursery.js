@@ -0,0 +1,100 @@
+/*
+ *  Short-lived reference cycles mixed with objects which survive through
+ *  old objects, the value stack, closures, finalizers and WeakMaps.  With
+ *  DUK_USE_MARK_AND_SWEEP_NURSERY minor collections run while this code
+ *  allocates and must only free unreachable cycles.
+ */
+
+/*===
+survivors 100 true true
+closures 100 4950
+finalizers true true
+weak 100 4950
+thread 300
+done
+===*/
+
+var old = { list: [] };
+var closures = [];
+var finalized = 0;
+var rescued = null;
+var wm = new WeakMap();
+var wmKeys = [];
+var i, j;
+
+function makeCycle(n) {
+    var a = { n: n };
+    var b = { a: a };
+    a.b = b;
+    a.fn = function () { return a.n; };
+    return a;
+}
+
+for (i = 0; i < 100; i++) {
+    // Garbage cycles, several nursery fulls worth.
+    for (j = 0; j < 500; j++) {
+        makeCycle(j);
+    }
+
+    // A young cycle stored into an old object survives.
+    old.list.push(makeCycle(i));
+
+    // A closure keeping its scope alive.
+    closures.push((function (v) {
+        var scope = { v: v };
+        scope.self = scope;
+        return function () { return scope.self.v; };
+    })(i));
+
+    // Finalizer on a garbage cycle; one of them is rescued.
+    var f = { id: i };
+    f.self = f;
+    Duktape.fin(f, function (o) {
+        finalized++;
+        if (o.id === 50) { rescued = o; }
+    });
+    f = null;
+
+    // Young WeakMap keys, reachable only through wmKeys.
+    var k = { k: i };
+    k.self = k;
+    wm.set(k, { v: i });
+    wmKeys.push(k);
+}
+
+var ok = true;
+for (i = 0; i < old.list.length; i++) {
+    var c = old.list[i];
+    if (c.b.a !== c || c.fn() !== i) { ok = false; }
+}
+print('survivors', old.list.length, ok, old.list[99].b.a.b.a.n === 99);
+
+var sum = 0;
+for (i = 0; i < closures.length; i++) { sum += closures[i](); }
+print('closures', closures.length, sum);
+
+Duktape.gc();
+Duktape.gc();
+print('finalizers', finalized > 0, rescued !== null && rescued.self === rescued);
+
+sum = 0;
+for (i = 0; i < wmKeys.length; i++) { sum += wm.get(wmKeys[i]).v; }
+print('weak', wmKeys.length, sum);
+
+// Coroutine whose value stack holds young objects across yields.
+var t = new Duktape.Thread(function () {
+    var acc = [];
+    for (var q = 0; q < 300; q++) {
+        var x = { q: q };
+        x.self = x;
+        acc.push(x);
+        for (var z = 0; z < 50; z++) { makeCycle(z); }
+        Duktape.Thread.yield(0);
+    }
+    return acc.length;
+});
+var r;
+for (i = 0; i < 301; i++) { r = Duktape.Thread.resume(t); }
+print('thread', r);
+
+print('done');
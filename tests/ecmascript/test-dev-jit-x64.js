@@ -0,0 +1,101 @@
+/*
+ *  Hot functions may be compiled into native code (DUK_USE_JIT_X64).
+ *  Exercise loops long enough to trigger compilation with arithmetic,
+ *  comparisons, property access, calls, and errors thrown from native
+ *  code.  Results must be identical to interpreted execution.
+ */
+
+/*===
+arithmetic
+639611632 4999950000 33334 4294967295 -0
+compare
+50000 25000 15535 1 2
+property
+100000 100000 undefined
+calls
+98 4950000
+error
+TypeError 3000 71
+RangeError 7000 79
+done
+===*/
+
+function arithmeticTest() {
+    var i, a = 0, b = 0, c = 0, d = 0, e;
+    for (i = 0; i < 100000; i++) {
+        a = (a + i * 7 - 3) | 0;
+        b += i;
+        if (i % 3 === 0) { c++; }
+        d = (d << 1 | 1) >>> 0;
+        e = -(i & 0);
+    }
+    print(a, b, c, d, 1 / e < 0 ? '-0' : '+0');
+}
+
+function compareTest() {
+    var i, lt = 0, ge = 0, seq = 0, strs = 0, mixed = 0;
+    for (i = 0; i < 100000; i++) {
+        if (i < 50000) { lt++; }
+        if (i >= 75000) { ge++; }
+        if ('x' + i === 'x' + (i & 0xffff) && i > 50000) { seq++; }
+        if (i == '99999') { strs++; }
+        if (i === 12345 || i != i + 0 || i <= 1.5 && i > 0.5) { mixed++; }
+    }
+    print(lt, ge, seq, strs, mixed);
+}
+
+function propertyTest() {
+    var obj = { count: 0 };
+    var arr = [];
+    var i;
+    for (i = 0; i < 100000; i++) {
+        obj.count = obj.count + 1;
+        arr[i] = i;
+    }
+    print(obj.count, arr.length, obj.missing);
+}
+
+function callTest() {
+    function add(x, y) { return x + y; }
+    var i, res = 0;
+    for (i = 0; i < 100000; i++) {
+        res = add(res, i % 100);
+    }
+    print(add(49, 49), res);
+}
+
+function errorTest() {
+    var i, obj = null;
+    try {
+        for (i = 0; i < 100000; i++) {
+            if (i === 3000) { obj.prop = 1; }
+        }
+    } catch (e) {
+        // Native code keeps the pc in sync so the line number is correct.
+        print(e.name, i, e.lineNumber);
+    }
+    try {
+        for (i = 0; i < 100000; i++) {
+            if (i === 7000) { (1).toFixed(1000); }
+        }
+    } catch (e) {
+        print(e.name, i, e.lineNumber);
+    }
+}
+
+try {
+    print('arithmetic');
+    arithmeticTest();
+    print('compare');
+    compareTest();
+    print('property');
+    propertyTest();
+    print('calls');
+    callTest();
+    print('error');
+    errorTest();
+} catch (e) {
+    print(e.stack || e);
+}
+
+print('done');
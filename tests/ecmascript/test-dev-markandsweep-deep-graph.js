@@ -0,0 +1,78 @@
+/*
+ *  Mark-and-sweep must mark deep object graphs completely, whether it
+ *  recurses (with DUK_USE_MARK_AND_SWEEP_RECLIMIT and temproot heap scans)
+ *  or uses an explicit mark stack (DUK_USE_MARK_AND_SWEEP_MARK_STACK).
+ */
+
+/*===
+list 20000 199990000
+nested 20000
+ring 5000 true
+wide 100000 4999950000
+done
+===*/
+
+function checkList(head) {
+    var n = 0, sum = 0;
+    for (var p = head; p !== null; p = p.next) {
+        n++;
+        sum += p.value;
+    }
+    print('list', n, sum);
+}
+
+// Long linked list, mixed with garbage so that sweeping has work to do.
+var head = null;
+var i;
+for (i = 0; i < 20000; i++) {
+    head = { value: i, next: head, junk: [ { i: i } ] };
+    head.junk = null;
+}
+
+// Deeply nested arrays.
+var nested = [];
+for (i = 0; i < 20000; i++) {
+    nested = [ nested ];
+}
+
+// Deep cycle, reachable only through one entry point.
+var ring = { id: 0 };
+var last = ring;
+for (i = 1; i < 5000; i++) {
+    last.next = { id: i };
+    last = last.next;
+}
+last.next = ring;
+
+// Wide object, many children at the same depth.
+var wide = [];
+for (i = 0; i < 100000; i++) {
+    wide.push({ v: i });
+}
+
+Duktape.gc();
+Duktape.gc();
+
+checkList(head);
+
+var depth = 0;
+for (var a = nested; a.length > 0; a = a[0]) {
+    depth++;
+}
+print('nested', depth);
+
+var n = 0;
+var p = ring;
+do {
+    n++;
+    p = p.next;
+} while (p !== ring);
+print('ring', n, last.next === ring);
+
+var sum = 0;
+for (i = 0; i < wide.length; i++) {
+    sum += wide[i].v;
+}
+print('wide', wide.length, sum);
+
+print('done');
@@ -0,0 +1,210 @@
+/*
+ *  Objects with the same keys added in the same order may share a shape
+ *  (DUK_USE_HOBJECT_SHAPES).  Exercise operations which must not leak
+ *  from one object to another sharing the same shape.
+ */
+
+/*===
+basic
+1 2 undefined
+3 4 5
+x,y
+x,y,z
+y,x
+delete
+a,c 1 undefined 3
+a,b 1 2
+a,b,c 1 2 3
+a,b 1 2
+a,b,d 1 2 4
+attributes
+x,y
+y
+true false
+true true
+10
+100
+accessor
+getter:1 getter:2
+1 2
+data:1 2
+many keys
+100 0 99
+99 98
+undefined 99
+0 1 2 3
+freeze
+true false
+false
+1 1
+2
+enumeration
+2,10,b,a,c
+2,10,b,a,c
+gc
+0 1 2
+done
+===*/
+
+function basicTest() {
+    function Point(x, y) {
+        this.x = x;
+        this.y = y;
+    }
+    var p1 = new Point(1, 2);
+    var p2 = new Point(3, 4);
+    p2.z = 5;
+
+    print(p1.x, p1.y, p1.z);
+    print(p2.x, p2.y, p2.z);
+    print(Object.keys(p1));
+    print(Object.keys(p2));
+
+    var q = {};
+    q.y = 1;
+    q.x = 2;
+    print(Object.keys(q));
+}
+
+function deleteTest() {
+    var o1 = { a: 1, b: 2, c: 3 };
+    var o2 = { a: 1, b: 2, c: 3 };
+    var o3 = { a: 1, b: 2, c: 3 };
+
+    // Delete from middle.
+    delete o1.b;
+    print(Object.keys(o1), o1.a, o1.b, o1.c);
+
+    // Delete last key.
+    delete o2.c;
+    print(Object.keys(o2), o2.a, o2.b);
+
+    // Unaffected.
+    print(Object.keys(o3), o3.a, o3.b, o3.c);
+
+    // Delete last key, then add a different key.
+    delete o3.c;
+    print(Object.keys(o3), o3.a, o3.b);
+    o3.d = 4;
+    print(Object.keys(o3), o3.a, o3.b, o3.d);
+}
+
+function attributesTest() {
+    var o1 = { x: 1, y: 2 };
+    var o2 = { x: 1, y: 2 };
+
+    Object.defineProperty(o1, 'x', { enumerable: false });
+    print(Object.keys(o2));
+    print(Object.keys(o1));
+
+    Object.defineProperty(o1, 'y', { writable: false });
+    print(Object.getOwnPropertyDescriptor(o2, 'y').writable,
+          Object.getOwnPropertyDescriptor(o1, 'y').writable);
+
+    // Value only update keeps attributes.
+    Object.defineProperty(o2, 'y', { value: 10 });
+    print(Object.getOwnPropertyDescriptor(o2, 'y').writable,
+          Object.getOwnPropertyDescriptor(o2, 'y').enumerable);
+    print(o2.y);
+    o2.y = 100;
+    print(o2.y);
+}
+
+function accessorTest() {
+    var o1 = { v: 1, w: 2 };
+    var o2 = { v: 1, w: 2 };
+    var o3 = { v: 1, w: 2 };
+
+    Object.defineProperty(o1, 'v', { get: function () { return 'getter:1'; } });
+    Object.defineProperty(o1, 'w', { get: function () { return 'getter:2'; } });
+    print(o1.v, o1.w);
+    print(o2.v, o2.w);
+
+    Object.defineProperty(o3, 'v', { get: function () { return 'tmp'; }, configurable: true });
+    Object.defineProperty(o3, 'v', { value: 'data:1' });
+    print(o3.v, o3.w);
+}
+
+function manyKeysTest() {
+    var objs = [];
+    var i, j, o;
+
+    for (i = 0; i < 4; i++) {
+        o = {};
+        for (j = 0; j < 100; j++) {
+            o['key' + j] = j;
+        }
+        objs.push(o);
+    }
+
+    print(Object.keys(objs[0]).length, objs[1].key0, objs[2].key99);
+    print(objs[3].key99, objs[3].key98);
+    delete objs[3].key50;
+    print(objs[3].key50, objs[2].key99);
+    print(objs[0].key0, objs[1].key1, objs[2].key2, objs[3].key3);
+}
+
+function freezeTest() {
+    var o1 = { a: 1 };
+    var o2 = { a: 1 };
+
+    Object.freeze(o1);
+    print(Object.isFrozen(o1), Object.isFrozen(o2));
+    print(Object.isExtensible(o1));
+    o1.a = 2;
+    o2.a = 2;
+    print(o1.a, 1);
+    print(o2.a);
+}
+
+function enumerationTest() {
+    var o1 = { b: 1, a: 2, 10: 3, c: 4, 2: 5 };
+    var o2 = { b: 1, a: 2, 10: 3, c: 4, 2: 5 };
+    var k, res = [];
+
+    for (k in o1) {
+        res.push(k);
+    }
+    print(res);
+    print(Object.keys(o2));
+}
+
+function gcTest() {
+    var i, o;
+    var keep = [];
+
+    for (i = 0; i < 1000; i++) {
+        o = { a: i };
+        o['k' + (i % 10)] = i;
+        if (i % 100 === 0) {
+            keep.push(o);
+        }
+    }
+    o = null;
+    Duktape.gc();
+    Duktape.gc();
+    print(keep[0].a, keep[1].a / 100, keep[2].k0 / 100);
+}
+
+try {
+    print('basic');
+    basicTest();
+    print('delete');
+    deleteTest();
+    print('attributes');
+    attributesTest();
+    print('accessor');
+    accessorTest();
+    print('many keys');
+    manyKeysTest();
+    print('freeze');
+    freezeTest();
+    print('enumeration');
+    enumerationTest();
+    print('gc');
+    gcTest();
+} catch (e) {
+    print(e.stack || e);
+}
+
+print('done');
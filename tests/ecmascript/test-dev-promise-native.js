@@ -0,0 +1,80 @@
+/*
+ *  Native Promise (DUK_USE_PROMISE_BUILTIN).  Jobs are queued on the heap
+ *  and only run when the host drains the queue with duk_run_jobs(); the
+ *  command line tool does that after each script.  Exercise job ordering,
+ *  thenable adoption, .finally() pass-through, and combinators.
+ */
+
+/*===
+sync start
+sync end
+tick 1
+adopt native 10
+finally
+tick 2
+adopt thenable 20
+finally value 30
+finally error Error finally
+all 1,2,3
+race first
+allReject nope
+try 3
+chain 5
+===*/
+
+var thenable = {
+    then: function (resolve) {
+        resolve(20);
+    }
+};
+
+print('sync start');
+
+Promise.resolve().then(function () {
+    print('tick 1');
+}).then(function () {
+    print('tick 2');
+});
+
+Promise.resolve(Promise.resolve(10)).then(function (v) {
+    print('adopt native', v);
+});
+
+Promise.resolve(thenable).then(function (v) {
+    print('adopt thenable', v);
+});
+
+Promise.resolve(30).finally(function () {
+    print('finally');
+    return 'ignored';
+}).then(function (v) {
+    print('finally value', v);
+}).then(function () {
+    return Promise.resolve(1).finally(function () {
+        throw new Error('finally');
+    });
+}).catch(function (e) {
+    print('finally error', e.name, e.message);
+}).then(function () {
+    return Promise.all([ 1, Promise.resolve(2), 3 ]);
+}).then(function (v) {
+    print('all', v);
+    return Promise.race([ new Promise(function () {}), Promise.resolve('first') ]);
+}).then(function (v) {
+    print('race', v);
+    return Promise.all([ Promise.reject('nope'), 1 ]);
+}).catch(function (e) {
+    print('allReject', e);
+    return Promise.try(function (a, b) { return a + b; }, 1, 2);
+}).then(function (v) {
+    print('try', v);
+    var p = Promise.resolve(0);
+    for (var i = 0; i < 5; i++) {
+        p = p.then(function (v) { return v + 1; });
+    }
+    return p;
+}).then(function (v) {
+    print('chain', v);
+});
+
+print('sync end');
@@ -0,0 +1,247 @@
+/*
+ *  Property reads and writes with a constant key may be served by an inline
+ *  cache (DUK_USE_PROP_IC).  Exercise cases where a cached layout must not
+ *  be reused: shape changes, prototype changes, shadowing, accessors,
+ *  non-writable properties, and polymorphic/megamorphic sites.
+ */
+
+/*===
+monomorphic
+499500 499500
+shadowing
+proto proto own own
+proto2
+prototype change
+a b b
+proto value update
+1 2 3
+accessors
+getter:1 getter:2
+setter:10
+undefined
+read-only
+1 1
+TypeError
+polymorphic
+10 20 30 40 50 60
+write 11 21 31 41 51 61
+arrays
+3 3 3
+length: 2 undefined 7
+calls
+method-A method-B
+TypeError
+delete
+1
+undefined
+done
+===*/
+
+function readX(o) {
+    return o.x;
+}
+
+function writeX(o, v) {
+    o.x = v;
+}
+
+function readM(o) {
+    return o.m;
+}
+
+function monomorphicTest() {
+    var sum1 = 0, sum2 = 0;
+    var i, o;
+
+    for (i = 0; i < 1000; i++) {
+        o = { x: i, y: -i };
+        sum1 += readX(o);
+        writeX(o, i);
+        sum2 += o.x;
+    }
+    print(sum1, sum2);
+}
+
+function shadowingTest() {
+    function F() {}
+    F.prototype.m = 'proto';
+    var a = new F();
+    var b = new F();
+    var res = [];
+
+    res.push(readM(a));
+    res.push(readM(b));
+    a.m = 'own';  // a changes shape
+    res.push(readM(a));
+    res.push(readM(a));
+    print(res.join(' '));
+
+    // Same receiver shape as before, prototype value changed.
+    F.prototype.m = 'proto2';
+    print(readM(b));
+}
+
+function prototypeChangeTest() {
+    // Two prototypes with the same shape: reads must come from the
+    // actual prototype of each receiver.
+    var p1 = { m: 'a' };
+    var p2 = { m: 'b' };
+    var o = Object.create(p1);
+    var res = [];
+
+    res.push(readM(o));
+    Object.setPrototypeOf(o, p2);
+    res.push(readM(o));
+    Object.setPrototypeOf(o, { other: 1, m: 'c' });
+    res[2] = readM(Object.create(p2));
+    print(res.join(' '));
+}
+
+function protoValueUpdateTest() {
+    var p = { m: 1 };
+    var o = Object.create(p);
+    var res = [];
+
+    res.push(readM(o));
+    p.m = 2;
+    res.push(readM(o));
+    p.m = 3;
+    res.push(readM(o));
+    print(res.join(' '));
+}
+
+function accessorTest() {
+    var count = 0;
+    var o1 = { x: 1 };
+    var o2 = {};
+    Object.defineProperty(o2, 'x', {
+        get: function () { return 'getter:' + (++count); },
+        set: function (v) { print('setter:' + v); },
+        configurable: true
+    });
+
+    readX(o1);
+    print(readX(o2), readX(o2));
+    writeX(o1, 5);
+    writeX(o2, 10);
+    print(o2.y);
+}
+
+function readOnlyTest() {
+    var o = { x: 1, y: 2 };
+    writeX(o, 1);
+    Object.freeze(o);
+    writeX(o, 2);  // non-strict: silently ignored
+    print(o.x, readX(o));
+
+    try {
+        (function () {
+            'use strict';
+            o.x = 3;
+        })();
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+function polymorphicTest() {
+    var objs = [
+        { x: 10 },
+        { a: 1, x: 20 },
+        { a: 1, b: 2, x: 30 },
+        { b: 1, x: 40 },
+        { c: 1, x: 50 },
+        { d: 1, e: 2, f: 3, x: 60 }
+    ];
+    var res = [];
+    var i, round;
+
+    // Several rounds so that the site goes megamorphic and stays correct.
+    for (round = 0; round < 3; round++) {
+        res = [];
+        for (i = 0; i < objs.length; i++) {
+            res.push(readX(objs[i]));
+        }
+    }
+    print(res.join(' '));
+
+    for (round = 0; round < 3; round++) {
+        for (i = 0; i < objs.length; i++) {
+            writeX(objs[i], (i + 1) * 10 + 1);
+        }
+    }
+    res = [];
+    for (i = 0; i < objs.length; i++) {
+        res.push(objs[i].x);
+    }
+    print('write', res.join(' '));
+}
+
+function arrayTest() {
+    function readLength(o) {
+        return o.length;
+    }
+    var arr = [];
+    var i;
+
+    // Array.prototype methods through the same site.
+    for (i = 0; i < 3; i++) {
+        arr.push(i);
+    }
+    print(arr.length, arr.length, arr.length);
+
+    // A plain object and an array may have the same shape; 'length' is
+    // an exotic property for arrays.
+    var plain = { length: 7 };
+    var a2 = [ 1, 2 ];
+    print('length:', readLength(a2), readLength({}), readLength(plain));
+}
+
+function callTest() {
+    function callM(o) {
+        return o.m();
+    }
+    var A = { m: function () { return 'method-A'; } };
+    var B = { m: function () { return 'method-B'; } };
+    print(callM(A), callM(B));
+    B.m = 123;
+    try {
+        callM(B);
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+function deleteTest() {
+    var o = { x: 1, y: 2 };
+    print(readX(o));
+    delete o.x;
+    print(readX(o));
+}
+
+try {
+    print('monomorphic');
+    monomorphicTest();
+    print('shadowing');
+    shadowingTest();
+    print('prototype change');
+    prototypeChangeTest();
+    print('proto value update');
+    protoValueUpdateTest();
+    print('accessors');
+    accessorTest();
+    print('read-only');
+    readOnlyTest();
+    print('polymorphic');
+    polymorphicTest();
+    print('arrays');
+    arrayTest();
+    print('calls');
+    callTest();
+    print('delete');
+    deleteTest();
+} catch (e) {
+    print(e.stack || e);
+}
+
+print('done');
@@ -0,0 +1,100 @@
+/*
+ *  Register writes dropping the last reference to a value.  With
+ *  DUK_USE_REFZERO_DEFER refzero handling for such writes is deferred to
+ *  function return (or a full deferral table); values must be freed
+ *  exactly once and values referenced again in between must survive.
+ */
+
+/*===
+finalized after return: true
+overflow 1000 1000
+revived 3 3
+strings true
+cascade 10000
+done
+===*/
+
+var count = 0;
+
+function fin() {
+    count++;
+}
+
+function makeFin() {
+    var o = {};
+    Duktape.fin(o, fin);  // no closure, so 'o' is not part of a cycle
+    return o;
+}
+
+// Finalizer runs at the latest when the function returns.
+function test1() {
+    var x = makeFin();
+    x = null;
+}
+count = 0;
+test1();
+print('finalized after return:', count === 1);
+
+// Many more deferred values than fit in the table in a single call.
+function test2() {
+    var i, x;
+    for (i = 0; i < 1000; i++) {
+        x = makeFin();
+        x = 123;
+    }
+    return count;
+}
+count = 0;
+test2();
+print('overflow', count, 1000);
+
+// A value whose register is overwritten but which is referenced again
+// (here through a property) before reconciliation.
+function test3() {
+    var holder = {};
+    var x = { v: 1 };
+    var y = x;
+    x = null;
+    holder.a = y;
+    y = null;
+    x = holder.a;
+    x = null;
+    x = holder.a;
+    holder.b = x;
+    x = 1;
+    return [ holder.a.v + holder.b.v + 1, holder.a === holder.b ? 3 : 0 ];
+}
+var r = test3();
+print('revived', r[0], r[1]);
+
+// Strings are weakly referenced by the string table; a string released by
+// a register write and interned again must not be freed under the new
+// reference.
+function test4() {
+    var s = 'abc' + Math.floor(Math.random() * 1);
+    var keep;
+    s = null;
+    keep = 'abc' + String(0);
+    return keep;
+}
+var ok = true;
+for (var i = 0; i < 1000; i++) {
+    if (test4() !== 'abc0') { ok = false; }
+}
+print('strings', ok);
+
+// Freeing a long chain through a deferred value.
+function test5() {
+    var head = null;
+    var i;
+    for (i = 0; i < 10000; i++) {
+        head = { next: head, i: i };
+    }
+    var n = 0;
+    for (var p = head; p; p = p.next) { n++; }
+    head = null;
+    return n;
+}
+print('cascade', test5());
+
+print('done');
@@ -0,0 +1,98 @@
+/*
+ *  Long concatenation results may be represented internally as ropes
+ *  (DUK_USE_HSTRING_ROPES).  They must be indistinguishable from ordinary
+ *  strings wherever content or identity matters.
+ */
+
+/*===
+length 20000 20000
+chars ab0ab1 ba true
+equal true true false true
+compare true false false
+key 123 true 123
+map 2 true abc
+json 20008 true
+methods true 10000 -1 true
+string object 20000 true
+symbol TypeError
+prefix 20001 true
+gc 20000 true
+nested true
+done
+===*/
+
+function build(n) {
+    var s = '';
+    for (var i = 0; i < n; i++) {
+        s += 'ab' + (i % 10);
+    }
+    return s;
+}
+
+var s1 = build(6667).substring(0, 20000);
+var s2 = build(6667);
+s2 = s2.substring(0, 20000);
+
+// Ropes built by separate loops, compared before any flattening.
+var r1 = '';
+var r2 = '';
+for (var i = 0; i < 10000; i++) {
+    r1 += 'xy';
+    r2 += 'xy';
+}
+print('length', r1.length, s1.length);
+print('chars', s1.substring(0, 6), s1.charAt(19999) + s1[19998], s1 === s2);
+print('equal', r1 === r2, r1 == r2, r1 === r2 + 'z', (r1 + 'z') === (r2 + 'z'));
+print('compare', r1 < r1 + 'a', r1 < r2, 'a' + r1 > r2);
+
+// Property keys must use the interned string.
+var obj = {};
+obj[r1] = 123;
+print('key', obj[r2], r2 in obj, obj['xy'.repeat(10000)]);
+
+// Map keys are compared by identity of interned strings.
+var m = new Map();
+m.set(r1, 'abc');
+m.set(r2, 'abc');
+m.set(r1 + 'q', 'def');
+print('map', m.size, m.has(r2), m.get(r1));
+
+// JSON serialization reads string data.
+var js = JSON.stringify({ a: r1 });
+print('json', js.length, JSON.parse(js).a === r2);
+
+// String built-ins.
+print('methods', r1.indexOf('yx') === 1, r1.split('x').length - 1, r1.indexOf('z'),
+      r1.toUpperCase() === r2.toUpperCase());
+
+// String objects hold an ordinary string.
+var so = new String(r1);
+print('string object', so.length, so.valueOf() === r2);
+
+// Symbol operand must still fail.
+try {
+    print(r1 + Symbol('foo'));
+} catch (e) {
+    print('symbol', e.name);
+}
+
+// Prepending a rope works too.
+var p = '!' + r1;
+print('prefix', p.length, p.substring(1) === r2);
+
+// Ropes survive mark-and-sweep with a long spine.
+var g = '';
+for (i = 0; i < 10000; i++) {
+    g += 'xy';
+}
+Duktape.gc();
+Duktape.gc();
+print('gc', g.length, g === r1);
+
+// A flattened rope used as the left side of a further concatenation.
+var n1 = r1 + 'tail';
+var n2 = n1 + 'more';
+obj[n1] = 1;  // flattens n1
+print('nested', n2 === r2 + 'tailmore');
+
+print('done');
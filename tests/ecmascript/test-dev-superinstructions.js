@@ -0,0 +1,141 @@
+/*
+ *  A comparison immediately followed by a conditional jump on its result
+ *  may be compiled into a compare-and-branch superinstruction
+ *  (DUK_USE_EXEC_SUPERINSTRUCTIONS).  Exercise number and non-number
+ *  operands, NaN, coercion order, and use of the comparison result after
+ *  the branch.
+ */
+
+/*===
+loops
+45 45 55 55 10 10
+numbers
+true false true false false true
+false false true true true false
+false false false false false true
+false true false true false true
+strings
+true false true false
+coercion
+valueOf a
+valueOf b
+lt
+valueOf b
+valueOf a
+gt
+valueOf a
+valueOf b
+le
+valueOf b
+valueOf a
+ge
+strict equality
+seq 1 1
+sneq 1 "1"
+sneq null undefined
+seq 0 -0
+sneq NaN NaN
+seq abc abc
+sneq obj obj2
+seq obj obj
+loop result value
+true false
+done
+===*/
+
+function loopTest() {
+    var i, a = 0, b = 0, c = 0, d = 0, e = 0, f = 0;
+    for (i = 0; i < 10; i++) { a += i; }
+    for (i = 9; i >= 0; i--) { b += i; }
+    for (i = 1; i <= 10; i++) { c += i; }
+    for (i = 10; i > 0; i--) { d += i; }
+    for (i = 0; i !== 10; i++) { e++; }
+    i = 0;
+    while (true) { if (i === 10) { break; } i++; f++; }
+    print(a, b, c, d, e, f);
+}
+
+function cmp(x, y) {
+    var res = [];
+    if (x < y) { res.push(true); } else { res.push(false); }
+    if (x > y) { res.push(true); } else { res.push(false); }
+    if (x <= y) { res.push(true); } else { res.push(false); }
+    if (x >= y) { res.push(true); } else { res.push(false); }
+    if (x === y) { res.push(true); } else { res.push(false); }
+    if (x !== y) { res.push(true); } else { res.push(false); }
+    return res.join(' ');
+}
+
+function numberTest() {
+    print(cmp(1, 2));
+    print(cmp(0, -0));
+    print(cmp(NaN, 1));
+    print(cmp(2.5, 1));
+}
+
+function stringTest() {
+    var res = [];
+    if ('abc' < 'abd') { res.push(true); } else { res.push(false); }
+    if ('b' < 'abc') { res.push(true); } else { res.push(false); }
+    if ('10' < 9) { res.push(false); } else { res.push(true); }
+    if (undefined >= 0) { res.push(true); } else { res.push(false); }
+    print(res.join(' '));
+}
+
+function coercionTest() {
+    var a = { valueOf: function () { print('valueOf a'); return 1; } };
+    var b = { valueOf: function () { print('valueOf b'); return 2; } };
+
+    // Evaluation order of ToPrimitive() must be left-to-right for all
+    // operators (ES2015+).
+    if (a < b) { print('lt'); }
+    if (b > a) { print('gt'); }
+    if (a <= b) { print('le'); }
+    if (b >= a) { print('ge'); }
+}
+
+function seq(name, x, y) {
+    if (x === y) {
+        print('seq', name);
+    } else {
+        print('sneq', name);
+    }
+}
+
+function strictEqualityTest() {
+    var obj = {};
+    seq('1 1', 1, 1);
+    seq('1 "1"', 1, '1');
+    seq('null undefined', null, undefined);
+    seq('0 -0', 0, -0);
+    seq('NaN NaN', NaN, NaN);
+    seq('abc abc', 'abc', 'ab' + 'c');
+    seq('obj obj2', obj, {});
+    seq('obj obj', obj, obj);
+}
+
+function resultValueTest() {
+    // The comparison result register may be read after the branch.
+    var i = 0, t;
+    while ((t = i < 3)) { i++; }
+    print(i === 3 && t === false ? 'true' : 'false', t);
+}
+
+try {
+    print('loops');
+    loopTest();
+    print('numbers');
+    numberTest();
+    print('strings');
+    stringTest();
+    print('coercion');
+    coercionTest();
+    print('strict equality');
+    strictEqualityTest();
+    print('loop result value');
+    resultValueTest();
+} catch (e) {
+    print(e.stack || e);
+}
+
+print('done');
@@ -329,6 +329,7 @@ def main():
         'duk_bi_function.c',
         'duk_bi_global.c',
         'duk_bi_json.c',
+        'duk_bi_mapset.c',
         'duk_bi_math.c',
         'duk_bi_number.c',
         'duk_bi_object.c',
@@ -367,6 +368,7 @@ def main():
         'duk_hbufobj_misc.c',
         'duk_hcompfunc.h',
         'duk_heap_alloc.c',
+        'duk_heap_bgfree.c',
         'duk_heap.h',
         'duk_heap_hashstring.c',
         'duk_heaphdr.h',
@@ -378,6 +380,7 @@ def main():
         'duk_heap_stringcache.c',
         'duk_heap_stringtable.c',
         'duk_henv.h',
+        'duk_hmapset.h',
         'duk_hnatfunc.h',
         'duk_hobject_alloc.c',
         'duk_hobject_class.c',
@@ -386,9 +389,13 @@ def main():
         'duk_hobject_misc.c',
         'duk_hobject_pc2line.c',
         'duk_hobject_props.c',
+        'duk_hobject_shape.c',
+        'duk_hpromise.h',
         'duk_hproxy.h',
+        'duk_hshape.h',
         'duk_hstring.h',
         'duk_hstring_misc.c',
+        'duk_hstring_rope.c',
         'duk_hthread_alloc.c',
         'duk_hthread_builtins.c',
         'duk_hthread.h',
@@ -403,8 +410,12 @@ def main():
         'duk_js_compiler.h',
         'duk_js_executor.c',
         'duk_js.h',
+        'duk_js_jit_x64.c',
+        'duk_js_jit_x64.h',
         'duk_json.h',
         'duk_js_ops.c',
+        'duk_js_propic.c',
+        'duk_js_propic.h',
         'duk_js_var.c',
         'duk_lexer.c',
         'duk_lexer.h',